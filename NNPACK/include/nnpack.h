@@ -24,6 +24,12 @@ enum nnp_status {
 	nnp_status_invalid_input_channels = 4,
 	/** NNPACK function was called with output_channels == 0. */
 	nnp_status_invalid_output_channels = 5,
+	/** NNPACK function was called with groups == 0, or with input_channels or output_channels not divisible by groups. */
+	nnp_status_invalid_groups = 6,
+	/** NNPACK function was called with NULL quantization parameters, non-positive or non-finite requantization scales, or output_min > output_max */
+	nnp_status_invalid_quantization_parameters = 7,
+	/** NNPACK function was called with NULL network, or with a network in a state which does not allow the call */
+	nnp_status_invalid_network = 8,
 	/** NNPACK function was called with input_size.height == 0 or input_size.width == 0 */
 	nnp_status_invalid_input_size = 10,
 	/** NNPACK function was called with input_stride.height == 0 or input_stride.width == 0 */
@@ -46,6 +52,10 @@ enum nnp_status {
 	nnp_status_invalid_algorithm = 16,
 	/** NNPACK function was called with convolution transform strategy not in nnp_convolution_transform_strategy enum */
 	nnp_status_invalid_transform_strategy = 17,
+	/** NNPACK function was called with NULL convolution plan */
+	nnp_status_invalid_plan = 18,
+	/** NNPACK function was called with kernel_dilation.height == 0 or kernel_dilation.width == 0 */
+	nnp_status_invalid_kernel_dilation = 19,
 	/** NNPACK function was called with output_subsampling.height == 0 or output_subsampling.width == 0 */
 	nnp_status_invalid_output_subsampling = 13,
 	/** NNPACK function was called with activation not in nnp_activation enum */
@@ -83,7 +93,11 @@ enum nnp_status {
 	/** Scratch space buffer is too small */
 	nnp_status_insufficient_buffer = 53,
 	/** Scratch space buffer is not properly aligned */
-	nnp_status_misaligned_buffer = 54
+	nnp_status_misaligned_buffer = 54,
+	/** NNPACK failed to open, read, or write a file */
+	nnp_status_io_error = 55,
+	/** File contents are malformed, or were produced for a different configuration */
+	nnp_status_invalid_file_format = 56
 };
 
 /**
@@ -92,8 +106,45 @@ enum nnp_status {
 enum nnp_activation {
 	/** Identity activation f(x) := x, i.e. no transformation */
 	nnp_activation_identity = 0,
-	/** ReLU activation f(x) := max(0, x) */
+	/**
+	 * ReLU activation f(x) := max(0, x).
+	 * With a float negative_slope parameter, leaky ReLU activation f(x) := x < 0 ? negative_slope * x : x.
+	 */
 	nnp_activation_relu = 1,
+	/** ReLU6 activation f(x) := min(max(0, x), 6) */
+	nnp_activation_relu6 = 2,
+	/** Clamp activation f(x) := min(max(output_min, x), output_max) with parameters in struct nnp_clamp_parameters */
+	nnp_activation_clamp = 3,
+};
+
+/**
+ * @brief Parameters of the clamp activation (nnp_activation_clamp).
+ */
+struct nnp_clamp_parameters {
+	/** Lower bound of the output. Can be -INFINITY. */
+	float output_min;
+	/** Upper bound of the output, not smaller than output_min. Can be INFINITY. */
+	float output_max;
+};
+
+/**
+ * @brief Quantization parameters of an 8-bit convolutional layer (nnp_convolution_inference_q8).
+ * @details Real values of input and output elements are scale * (q - zero_point). Kernel elements are signed and
+ *          symmetric, i.e. their zero point is 0. Accumulators are converted to output with per-channel scales:
+ *          output[c] := clamp(round(accumulator[c] * requantization_scales[c]) + output_zero_point, output_min, output_max),
+ *          where requantization_scales[c] = input_scale * kernel_scale[c] / output_scale.
+ */
+struct nnp_q8_convolution_parameters {
+	/** Quantized value of real 0 in the input. Implicit padding is filled with this value. */
+	uint8_t input_zero_point;
+	/** Quantized value of real 0 in the output. */
+	uint8_t output_zero_point;
+	/** Lower bound of the quantized output. Expresses ReLU-style activations. */
+	uint8_t output_min;
+	/** Upper bound of the quantized output, not smaller than output_min. */
+	uint8_t output_max;
+	/** Array of output_channels positive requantization scales. */
+	const float* requantization_scales;
 };
 
 /**
@@ -110,14 +161,27 @@ enum nnp_convolution_algorithm {
 	nnp_convolution_algorithm_wt8x8 = 3,
 	/** Direct convolution via implicit GEMM. */
 	nnp_convolution_algorithm_implicit_gemm = 4,
-	/** Direct convolution implementation. */
+	/**
+	 * Direct convolution implementation. Supports only 1x1 kernels. Large layers and strided layers run on a packed,
+	 * cache-blocked GEMM engine, small layers stream the input through the 1x1 convolution micro-kernels.
+	 */
 	nnp_convolution_algorithm_direct = 5,
 	/**
 	 * Tiled convolution based on 2D Winograd transform F(3x3, 6x6) with 8x8 blocks in FP16.
-	 * Supports only 3x3 kernels. Implemented only for new ARM processors (with NEON-HP),
-	 * on non-supported processors falls back to nnp_convolution_algorithm_wt8x8.
+	 * Supports only 3x3 kernels. Implemented only for new ARM processors (with NEON-HP) and x86-64 processors with
+	 * AVX2 and F16C, on non-supported processors falls back to nnp_convolution_algorithm_wt8x8.
 	 */
 	nnp_convolution_algorithm_wt8x8_fp16 = 6,
+	/**
+	 * Tiled convolution based on 2D Winograd transform F(2x2, 3x3) with 4x4 blocks. Supports only 3x3 kernels with
+	 * unit stride, and only for inference. Wastes less computation on padding than 8x8 blocks for small images.
+	 */
+	nnp_convolution_algorithm_wt4x4 = 7,
+	/**
+	 * Tiled convolution based on 2D Winograd transform F(4x4, 3x3) with 6x6 blocks. Supports only 3x3 kernels with
+	 * unit stride, and only for inference. Wastes less computation on padding than 8x8 blocks for small images.
+	 */
+	nnp_convolution_algorithm_wt6x6 = 8,
 };
 
 enum nnp_convolution_transform_strategy {
@@ -174,6 +238,131 @@ enum nnp_status nnp_initialize(void);
 
 enum nnp_status nnp_deinitialize(void);
 
+/**
+ * @brief Reserves library-owned workspace memory for subsequent calls on the calling thread.
+ * @details NNPACK functions which are called without a caller-provided workspace buffer take scratch memory from a
+ *          grow-only arena of huge-page backed slabs, which is kept between calls. Reserving the workspace ahead of
+ *          time moves the allocation and page faults out of the first call. The arena grows on demand even without
+ *          a reservation.
+ * @param workspace_size The size of workspace memory, in bytes, to reserve for the calling thread. The required size
+ *                       for a particular layer can be queried by passing NULL workspace_buffer and non-NULL
+ *                       workspace_size to the layer function.
+ */
+enum nnp_status nnp_workspace_reserve(size_t workspace_size);
+
+/**
+ * @brief Releases idle workspace memory held by the library-owned arena.
+ * @details Memory used by concurrently running calls is not released. nnp_deinitialize implicitly calls this function.
+ */
+enum nnp_status nnp_workspace_release(void);
+
+/**
+ * @brief Controls how NNPACK resolves nnp_convolution_algorithm_auto.
+ */
+enum nnp_autotune_mode {
+	/** Always use the built-in heuristic, ignoring tuned choices */
+	nnp_autotune_mode_disabled = 0,
+	/** Use tuned choices for shapes in the tuning cache, and the built-in heuristic for other shapes (default) */
+	nnp_autotune_mode_cached = 1,
+	/** Like nnp_autotune_mode_cached, but convolution plans also tune shapes which are missing from the cache */
+	nnp_autotune_mode_measure = 2,
+};
+
+/**
+ * @brief Sets the autotuning mode for subsequent calls with nnp_convolution_algorithm_auto.
+ * @details One-shot convolution functions only consult the tuning cache and never run measurements, because the
+ *          algorithm must not change between a precompute call and the matching reuse call.
+ */
+enum nnp_status nnp_autotune_set_mode(enum nnp_autotune_mode mode);
+
+/**
+ * @brief Times all eligible convolution algorithms and transform strategies for a layer shape on this machine,
+ *        and records the fastest combination in the in-memory tuning cache.
+ * @details Measurements use synthetic data and library-owned buffers. The time of the reuse strategy excludes the
+ *          kernel transform, as it is amortized over calls. Layer parameters have the same meaning and restrictions
+ *          as for nnp_convolution_inference_batch. The choice is keyed by layer shape, activation, and the number of
+ *          threads in threadpool.
+ * @param[out] algorithm If not NULL, receives the fastest algorithm.
+ * @param[out] transform_strategy If not NULL, receives the transform strategy of the fastest algorithm
+ *                                (nnp_convolution_transform_strategy_compute or nnp_convolution_transform_strategy_reuse).
+ */
+enum nnp_status nnp_convolution_autotune(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	enum nnp_activation activation,
+	pthreadpool_t threadpool,
+	enum nnp_convolution_algorithm* algorithm,
+	enum nnp_convolution_transform_strategy* transform_strategy);
+
+/**
+ * @brief Loads tuned choices from a tuning file into the in-memory tuning cache.
+ * @details Entries from the file replace cached entries for the same shapes. nnp_initialize loads the file named by
+ *          the NNPACK_TUNING_FILE environment variable, if it is set and the file exists.
+ */
+enum nnp_status nnp_autotune_load(const char* path);
+
+/**
+ * @brief Writes all entries of the in-memory tuning cache to a tuning file.
+ * @details nnp_deinitialize saves the cache to the file named by the NNPACK_TUNING_FILE environment variable, if it
+ *          is set and new shapes were tuned since the cache was loaded.
+ */
+enum nnp_status nnp_autotune_save(const char* path);
+
+/**
+ * @brief Removes all entries from the in-memory tuning cache.
+ */
+enum nnp_status nnp_autotune_reset(void);
+
+/**
+ * @brief Counters and occupancy of the library-wide cache of kernel transforms.
+ */
+struct nnp_kernel_cache_stats {
+	/** Number of calls which reused a cached kernel transform. */
+	size_t hits;
+	/** Number of calls which transformed the kernel because it was not in the cache. */
+	size_t misses;
+	/** Number of kernel transforms removed to make room for newer ones. */
+	size_t evictions;
+	/** Number of cached kernel transforms. */
+	size_t entries;
+	/** Total size of cached kernel transforms, in bytes. */
+	size_t size;
+	/** Memory budget of the cache, in bytes. */
+	size_t budget;
+};
+
+/**
+ * @brief Sets the memory budget of the library-wide cache of kernel transforms.
+ * @details With a non-zero budget, one-shot convolution inference functions (other than
+ *          nnp_convolution_inference_bounded, which stays within its workspace) called with
+ *          nnp_convolution_transform_strategy_compute keep the kernel transforms of fast (Fourier and Winograd) and
+ *          GEMM-based algorithms, and reuse them in later calls with the same kernel, layer shape, and algorithm, as if
+ *          the caller precomputed the transform. Kernels are matched by address and by a hash of their contents, so
+ *          kernels updated in place are transformed again. When a new transform does not fit into the budget, the
+ *          least recently used transforms are evicted. Workspace size queries report the workspace for transforming
+ *          the kernel, which also suffices for reusing a cached transform. The budget is 0 (the cache is disabled) by
+ *          default. Lowering the budget evicts transforms which are not in use.
+ * @param budget Memory budget for cached kernel transforms, in bytes. 0 disables the cache.
+ */
+enum nnp_status nnp_kernel_cache_set_budget(size_t budget);
+
+/**
+ * @brief Returns counters and occupancy of the cache of kernel transforms.
+ */
+enum nnp_status nnp_kernel_cache_get_stats(struct nnp_kernel_cache_stats* stats);
+
+/**
+ * @brief Removes all kernel transforms from the cache, and resets its counters. The budget is kept.
+ * @details Transforms used by concurrently running calls are not removed. nnp_deinitialize implicitly calls this
+ *          function.
+ */
+enum nnp_status nnp_kernel_cache_reset(void);
+
 /**
  * @brief Computes output of a 2D convolutional layer from input and kernel tensors.
  * @details This function targets training of convolutional neural networks and performs forward propagation.
@@ -336,11 +525,18 @@ enum nnp_status nnp_convolution_kernel_gradient(
  *
  *    - nnp_convolution_algorithm_auto    -- let the function choose the algorithm.
  *    - nnp_convolution_algorithm_ft8x8   -- tiled convolution based on 2D Fourier transform with 8x8 blocks.
- *                                           Supports kernels up to 8x8.
+ *                                           Supports kernels up to 8x8. Strided convolutions are decomposed into
+ *                                           stride.height x stride.width phases, and support kernels up to 8x8
+ *                                           per phase, i.e. up to 8 * stride.
  *    - nnp_convolution_algorithm_ft16x16 -- tiled convolution based on 2D Fourier transform with 16x16 blocks.
- *                                           Supports kernels up to 16x16.
+ *                                           Supports kernels up to 16x16 (up to 16 * stride for strided
+ *                                           convolutions).
  *    - nnp_convolution_algorithm_wt8x8   -- tiled convolution based on 2D Winograd transform F(3x3, 6x6).
  *                                           Supports only 3x3 kernels.
+ *    - nnp_convolution_algorithm_wt4x4   -- tiled convolution based on 2D Winograd transform F(2x2, 3x3).
+ *                                           Supports only 3x3 kernels with unit stride.
+ *    - nnp_convolution_algorithm_wt6x6   -- tiled convolution based on 2D Winograd transform F(4x4, 3x3).
+ *                                           Supports only 3x3 kernels with unit stride.
  *
  * @param transform_strategy A strategy that guides computation of kernel transforms coefficients.
  *                           Possible values are:
@@ -368,16 +564,23 @@ enum nnp_status nnp_convolution_kernel_gradient(
  *                             If workspace_buffer is NULL and workspace_size is non-NULL, NNPACK would store the size
  *                             of required workspace memory at the workspace_size location, and exit without
  *                             computations.
- *                             If workspace_buffer is NULL and workspace_size is NULL, NNPACK would allocate memory
- *                             before and deallocate after this computation, potentially at significant runtime cost.
+ *                             If workspace_buffer is NULL and workspace_size is NULL, NNPACK would use memory from
+ *                             its internal workspace arena (see nnp_workspace_reserve).
  * @param[in,out] workspace_size Pointer to the size of workspace buffer.
  *                               If workspace_buffer is NULL, NNPACK will write the size of required scratch memory to
  *                               the location specified by this pointer.
  *                               If workspace_buffer is non-NULL, NNPACK expects workspace_size to specify the size of
  *                               the buffer, in bytes.
  *                               If workspace_size is NULL, workspace_buffer must be NULL as well. In this case NNPACK
- *                               would allocate memory before and deallocate after this computation, potentially at
- *                               significant runtime cost.
+ *                               would use memory from its internal workspace arena (see nnp_workspace_reserve).
+ * @param activation Activation applied to the output. The activation is fused into the output transforms, GEMM
+ *                   epilogues and direct convolution tasks, and does not make another pass over the output.
+ * @param activation_parameters Parameters of the activation:
+ *
+ *    - NULL for nnp_activation_identity, nnp_activation_relu6, and for nnp_activation_relu without a negative slope.
+ *    - Pointer to a float negative slope (non-negative) for leaky ReLU (nnp_activation_relu).
+ *    - Pointer to struct nnp_clamp_parameters for nnp_activation_clamp.
+ *
  * @param threadpool A thread pool for parallelization of the computation.
  *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
  * @param[out] profile An optional pointer to profiling structure.
@@ -404,149 +607,810 @@ enum nnp_status nnp_convolution_inference(
 	struct nnp_profile* profile);
 
 /**
- * @brief Computes output of a fully connected layer from input and kernel matrices.
- * @details This function targets training of convolutional neural networks and performs forward propagation.
- *          It is optimized for moderate minibatch sizes (64-128) and can be inefficient on a small minibatch.
- *          For minibatch size 1, use nnp_fully_connected_inference for optimal performance.
- * @param batch_size The number of vectors on the input and output of the fully connected layer.
- * @param input_channels The number of channels (AKA features, dimensions) in the input matrix.
- * @param output_channels The number of channels (AKA features, dimensions) in the output matrix.
- * @param[in]  input  A 2D matrix input[batch_size][input_channels].
- * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels].
- * @param[out] output A 2D matrix output[batch_size][output_channels].
- * @param threadpool A thread pool for parallelization of the computation.
- *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @brief Computes output of a 2D convolutional layer for a minibatch of input images and a kernel tensor.
+ * @details This function targets prediction with convolutional neural networks and performs forward propagation.
+ *          Unlike calling nnp_convolution_inference once per image, it transforms (or packs) the kernel once and
+ *          reuses it for all images in the minibatch, and tiles of all images share the same blocked multiplication.
+ *          With tiled (Fourier or Winograd) algorithms workspace requirements grow linearly with batch_size.
+ *          All other parameters have the same meaning and restrictions as for nnp_convolution_inference.
+ * @param batch_size The number of images on the input and output of the convolutional layer.
+ * @param[in]  input  A 4D tensor input[batch_size][input_channels][input_size.height][input_size.width].
+ * @param[out] output A 4D tensor output[batch_size][output_channels][output_size.height][output_size.width].
  */
-enum nnp_status nnp_fully_connected_output(
+enum nnp_status nnp_convolution_inference_batch(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
 	size_t batch_size,
 	size_t input_channels,
 	size_t output_channels,
-	const float input[],
-	const float kernel[],
-	float output[],
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
 	pthreadpool_t threadpool,
 	struct nnp_profile* profile);
 
 /**
- * @brief Computes output of a fully connected layer for a single input vector and a kernel matrix.
- * @details This function targets prediction with convolutional neural networks and performs forward propagation.
- * @param input_channels The number of channels (AKA features, dimensions) in the input vector.
- * @param output_channels The number of channels (AKA features, dimensions) in the output vector.
- * @param[in]  input  A 1D array input[input_channels] of FP32 elements.
- * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels] of FP32 elements.
- * @param[out] output A 1D array output[output_channels] of FP32 elements.
- * @param threadpool A thread pool for parallelization of the computation.
- *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @brief Computes output of a grouped 2D convolutional layer for a minibatch of input images and a kernel tensor.
+ * @details Input and output channels are split into groups of equal size, and each group of output channels is
+ *          computed only from the matching group of input channels, as in ResNeXt- and ShuffleNet-style networks.
+ *          All groups are computed in the same parallel passes, rather than one call per group.
+ *          With nnp_convolution_algorithm_auto, the algorithm is chosen heuristically, without the tuning cache.
+ *          All other parameters have the same meaning and restrictions as for nnp_convolution_inference_batch.
+ * @param groups The number of groups. Both input_channels and output_channels must be divisible by groups.
+ *               With groups == 1 the function is equivalent to nnp_convolution_inference_batch.
+ * @param[in]  kernel A 4D tensor kernel[output_channels][input_channels / groups][kernel_size.height][kernel_size.width].
+ *                    Output channels [g * output_channels / groups, (g + 1) * output_channels / groups) belong to
+ *                    group g, and convolve input channels [g * input_channels / groups, (g + 1) * input_channels / groups).
  */
-enum nnp_status nnp_fully_connected_inference(
+enum nnp_status nnp_convolution_inference_grouped(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
 	size_t input_channels,
 	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
 	const float* input,
 	const float* kernel,
+	const float* bias,
 	float* output,
-	pthreadpool_t threadpool);
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
 
 /**
- * @brief Computes output of a fully connected layer for a single input vector and a kernel matrix.
- * @details This function targets prediction with convolutional neural networks and performs forward propagation.
- * @param input_channels The number of channels (AKA features, dimensions) in the input vector.
- * @param output_channels The number of channels (AKA features, dimensions) in the output vector.
- * @param[in]  input  A 1D array input[input_channels] of FP32 elements.
- * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels] of FP16 (ARM alternative format) elements.
- * @param[out] output A 1D array output[output_channels] of FP32 elements.
- * @param threadpool A thread pool for parallelization of the computation.
- *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @brief Computes output of a dilated (atrous) 2D convolutional layer for a minibatch of input images.
+ * @details Kernel elements are applied to input pixels kernel_dilation apart, so a kernel_size kernel covers
+ *          (kernel_size - 1) * kernel_dilation + 1 input pixels in each dimension. The dilated kernel is never
+ *          materialized: implicit GEMM gathers input pixels with the dilation stride, and Winograd and FFT algorithms
+ *          split the input into kernel_dilation.height * kernel_dilation.width phases (polyphase decomposition), each
+ *          of which is a dense convolution with the original kernel. Thus, dilated 3x3 layers run on
+ *          nnp_convolution_algorithm_wt8x8. Winograd and FFT algorithms support dilation only without subsampling.
+ *          All other parameters have the same meaning and restrictions as for nnp_convolution_inference_grouped,
+ *          except that input_padding must be less than the dilated kernel size.
+ * @param kernel_dilation Dilation of the kernel. With kernel_dilation 1x1 the function is equivalent to
+ *                        nnp_convolution_inference_grouped.
  */
-enum nnp_status nnp_fully_connected_inference_f16f32(
+enum nnp_status nnp_convolution_inference_dilated(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
 	size_t input_channels,
 	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
 	const float* input,
-	const void* kernel,
+	const float* kernel,
+	const float* bias,
 	float* output,
-	pthreadpool_t threadpool);
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
 
 /**
- * @brief Computes output of a max-pooling layer for an input tensor.
- * @details This function targets both prediction and training of convolutional neural networks and performs forward
- *          propagation. Is is optimized for both large and small minibatch sizes.
- * @param batch_size The number of images on the input and output of the max-pooling layer.
- * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
- * @param input_size Size of input images, excluding implicit zero-padding.
- * @param input_padding Implicit padding of input images. The padding pixels are ignored by the pooling filter, but
- *                      affect the output size.
- * @param pooling_size   Size of the pooling filter. Only 2x2 filter are currently supported.
- * @param pooling_stride Stride of the pooling filter. Only 2x2 strides are currently supported.
- * @param[in]  input  A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
- * @param[out] output A 4D tensor output[batch_size][channels][output_size.height][output_size.width] where
- *                    output_size.height = ceil(
- *                      (input_padding.top + input_size.height + input_padding.bottom - pooling_size.height) /
- *                        pooling_stride.height) + 1
- *                    output_size.width = ceil(
- *                      (input_padding.left + input_size.width + input_padding.right - pooling_size.width) /
- *                        pooling_stride.width) + 1
- * @param threadpool A thread pool for parallelization of the computation.
- *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @brief Computes output of a 2D convolutional layer for a minibatch of channels-last (NHWC) input images.
+ * @details Input and output images are stored as input[batch_size][input_size.height][input_size.width][input_channels]
+ *          and output[batch_size][output_size.height][output_size.width][output_channels], so that they can be passed
+ *          between NHWC producers and consumers without transposition. The kernel and the precomputed kernel
+ *          transforms have the same layout as for nnp_convolution_inference_dilated.
+ *          Winograd and FFT algorithms gather each tile of a channel from the strided input and scatter the output
+ *          tiles, and implicit GEMM gathers input pixels during packing and scatters the output micro-tiles.
+ *          Dilated convolutions and strided FFT convolutions are not supported by tiled algorithms in this layout;
+ *          nnp_convolution_algorithm_auto selects implicit GEMM for them. nnp_convolution_algorithm_direct runs on
+ *          the implicit GEMM engine. All other parameters have the same meaning and restrictions as for
+ *          nnp_convolution_inference_dilated.
  */
-enum nnp_status nnp_max_pooling_output(
+enum nnp_status nnp_convolution_inference_nhwc(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
 	size_t batch_size,
-	size_t channels,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
 	struct nnp_size input_size,
 	struct nnp_padding input_padding,
-	struct nnp_size pooling_size,
-	struct nnp_size pooling_stride,
-	const float input[],
-	float output[],
-	pthreadpool_t threadpool);
-
-/**
- * @brief Computes output of a softmax layer for an input matrix.
- * @details This function targets both prediction and training of convolutional neural networks and performs forward
- *          propagation. Is is optimized for both large and small minibatch sizes.
- * @param batch_size The number of vectors on the input and output of the softmax layer.
- * @param channels   The number of channels (AKA features, dimensions) in both input and output vectors.
- * @param[in]  input  A 2D matrix input[batch_size][channels].
- * @param[out] output A 2D matrix output[batch_size][channels].
- * @param threadpool A thread pool for parallelization of the computation.
- *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
- */
-enum nnp_status nnp_softmax_output(
-    size_t batch_size,
-    size_t channels,
-    const float input[],
-    float output[],
-    pthreadpool_t threadpool);
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
 
 /**
- * @brief Computes output of a rectified linear unit (ReLU) layer for an input matrix.
- * @details This function targets both prediction and training of convolutional neural networks and performs forward
- *          propagation. Is is optimized for both large and small minibatch sizes.
- * @param batch_size The number of vectors on the input and output of the ReLU layer.
- * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
- * @param[in]  input  A 2D matrix input[batch_size][channels].
- * @param[out] output A 2D matrix output[batch_size][channels].
- * @param threadpool A thread pool for parallelization of the computation.
- *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @brief Computes output of a 2D convolutional layer with a residual (skip) connection for a minibatch of input images.
+ * @details Computes output = activation(convolution(input, kernel) + bias + residual), as in residual blocks of ResNet.
+ *          The residual is added by the output transforms of Winograd and FFT algorithms, and by the epilogues of
+ *          implicit GEMM and direct convolution, before the activation, so the output is written once and neither the
+ *          output nor the residual is traversed by a separate pass. All other parameters have the same meaning and
+ *          restrictions as for nnp_convolution_inference_dilated.
+ * @param[in] residual A 4D tensor residual[batch_size][output_channels][output_size.height][output_size.width].
+ *                     The residual may be the same buffer as output, to accumulate the convolution in place.
  */
-enum nnp_status nnp_relu_output(
+enum nnp_status nnp_convolution_inference_residual(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
 	size_t batch_size,
-	size_t channels,
-	const float input[],
-	float output[],
-	float negative_slope,
-	pthreadpool_t threadpool);
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
 
 /**
- * @brief Computes gradient of input of a rectified linear unit (ReLU) layer from gradient of output and input matrices.
- * @details This function targets training of convolutional neural networks and performs backward propagation.
- *          Is is optimized for both large and small minibatch sizes.
- * @param batch_size The number of vectors on the input and output of the ReLU layer.
- * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
- * @param[in]  input  A 2D matrix input[batch_size][channels].
- * @param[out] output A 2D matrix output[batch_size][channels].
- * @param threadpool A thread pool for parallelization of the computation.
- *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @brief Computes output of a 2D convolutional layer followed by a max-pooling layer for a minibatch of input images.
+ * @details Computes output = max_pooling(activation(convolution(input, kernel) + bias)), as in the convolutional
+ *          layers of AlexNet, OverFeat and VGG, without writing the full-resolution convolution output to memory.
+ *          Winograd and FFT algorithms pool output tiles in the output transform when pooling windows do not overlap
+ *          (pooling_size equals pooling_stride) and the output tile is a multiple of the pooling window, e.g. 2x2
+ *          pooling after nnp_convolution_algorithm_wt8x8. Other configurations compute the convolution into the
+ *          workspace and pool it from there, and need a correspondingly larger workspace. All other parameters have
+ *          the same meaning and restrictions as for nnp_convolution_inference_dilated.
+ * @param pooling_size   Size of the max-pooling window. The convolution output is not padded for pooling, and windows
+ *                       are clipped at the bottom and right edges, as in nnp_max_pooling_output.
+ * @param pooling_stride Stride of the max-pooling window. Must not exceed pooling_size.
+ * @param[out] output A 4D tensor output[batch_size][output_channels][pooled_size.height][pooled_size.width] where
+ *                    pooled_size.height = ceil(max(output_size.height - pooling_size.height, 0) /
+ *                      pooling_stride.height) + 1
+ *                    pooled_size.width = ceil(max(output_size.width - pooling_size.width, 0) /
+ *                      pooling_stride.width) + 1
  */
-enum nnp_status nnp_relu_input_gradient(
+enum nnp_status nnp_convolution_inference_max_pooling(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Computes output of a 2D convolutional layer within a bounded workspace.
+ * @details Targets memory-constrained systems, e.g. unikernels booted with a few megabytes of memory, which can not
+ *          provide the workspace of large layers. If the layer needs more than workspace_size bytes of workspace, it
+ *          is computed in parts: in blocks of images of the minibatch, and, if a single image does not fit, in
+ *          horizontal bands of output rows. Each band is computed as a separate convolution of the input rows under
+ *          its kernel windows, padded only at the top and bottom edges of the image, and bands of Winograd and FFT
+ *          algorithms start at output tile boundaries. If the kernel transform fits into the budget next to a band,
+ *          the kernel is transformed once and reused by all bands. With nnp_convolution_algorithm_auto and
+ *          nnp_convolution_transform_strategy_compute, layers whose transformed kernel does not fit fall back to
+ *          implicit GEMM. All other parameters have the same meaning and restrictions as for
+ *          nnp_convolution_inference_dilated.
+ * @param[in] workspace_buffer Buffer of workspace_size bytes for scratch memory, aligned on 64 bytes. If
+ *                             workspace_buffer is NULL, NNPACK would allocate, and release before returning, a
+ *                             buffer of at most workspace_size bytes. Unlike other convolution functions, it does
+ *                             not take the buffer from its internal workspace arena (see nnp_workspace_reserve), whose
+ *                             memory is rounded up to larger blocks.
+ * @param workspace_size The maximum size of workspace memory, in bytes.
+ * @return nnp_status_insufficient_buffer if no split of the layer computes within workspace_size bytes, e.g. if the
+ *         kernel of implicit GEMM does not fit.
+ */
+enum nnp_status nnp_convolution_inference_bounded(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Optional stages of 2D convolution inference (see nnp_convolution_inference_with_options).
+ * @details A zero-initialized structure selects none of them. Stages can be combined, e.g. for a channels-last residual
+ *          block, or for a convolution with fused max-pooling within a bounded workspace.
+ */
+struct nnp_convolution_options {
+	/** Input, residual, and output are channels-last (NHWC) rather than planar (NCHW) tensors. */
+	bool channels_last;
+	/**
+	 * Optional residual (skip) connection, which is added to the convolution output before the activation. It has the
+	 * shape of the convolution output before max-pooling, and may be the same buffer as the output if the output is not
+	 * pooled. NULL if the layer has no residual connection.
+	 */
+	const float* residual;
+	/** Size of the fused max-pooling window. 0x0 or 1x1 if the output is not pooled. */
+	struct nnp_size pooling_size;
+	/** Stride of the max-pooling window. 0x0 selects non-overlapping windows, i.e. a stride of pooling_size. */
+	struct nnp_size pooling_stride;
+	/**
+	 * Maximum size of workspace memory, in bytes. Layers which need more workspace are computed in parts, as by
+	 * nnp_convolution_inference_bounded. 0 if the workspace is not limited.
+	 */
+	size_t workspace_limit;
+};
+
+/**
+ * @brief Computes output of a 2D convolutional layer with optional fused stages for a minibatch of input images.
+ * @details Computes output = max_pooling(activation(convolution(input, kernel) + bias + residual)), where the residual
+ *          connection, max-pooling, and channels-last layout are selected by options and work as in
+ *          nnp_convolution_inference_residual, nnp_convolution_inference_max_pooling, and
+ *          nnp_convolution_inference_nhwc (which call this function with a single option), and a workspace limit
+ *          splits the layer as in nnp_convolution_inference_bounded. All other parameters have the same meaning and
+ *          restrictions as for nnp_convolution_inference_dilated.
+ * @param[out] output A 4D tensor output[batch_size][output_channels][pooled_size.height][pooled_size.width], or
+ *                    output[batch_size][pooled_size.height][pooled_size.width][output_channels] for channels-last
+ *                    layout, where pooled_size is the convolution output size if the output is not pooled.
+ * @param[in] workspace_buffer Without a workspace limit, as for nnp_convolution_inference_dilated. With a workspace
+ *                             limit, workspace_buffer, if not NULL, must hold options->workspace_limit bytes; if it is
+ *                             NULL and workspace_size is not NULL, NNPACK would store the size of workspace memory
+ *                             which the computation within the limit needs at the workspace_size location, and exit
+ *                             without computations.
+ * @param[in,out] workspace_size Without a workspace limit, as for nnp_convolution_inference_dilated. With a workspace
+ *                               limit, it is used only for the workspace size query.
+ * @param[in] options Optional stages of the layer, or NULL for none.
+ */
+enum nnp_status nnp_convolution_inference_with_options(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	const struct nnp_convolution_options* options,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Opaque handle of a convolution plan.
+ * @details A convolution plan captures the convolution algorithm, cache blocking parameters, transformed (or packed)
+ *          kernel, bias, and workspace for a fixed convolution shape, so that repeated executions of the same layer
+ *          skip algorithm selection, kernel transformation, and workspace allocation.
+ */
+typedef struct nnp_convolution_plan* nnp_convolution_plan_t;
+
+/**
+ * @brief Creates a plan for repeated inference with a 2D convolutional layer.
+ * @details The function selects the algorithm (if algorithm is nnp_convolution_algorithm_auto), computes cache
+ *          blocking parameters, transforms (or packs) the kernel, copies the bias, and allocates the workspace.
+ *          With nnp_convolution_algorithm_auto, the algorithm and transform strategy come from the tuning cache
+ *          when the shape was tuned, and the plan tunes the shape itself in nnp_autotune_mode_measure.
+ *          After the plan is created, kernel and bias buffers are no longer referenced and can be released.
+ *          Parameters have the same meaning and restrictions as for nnp_convolution_inference_batch.
+ * @param[out] plan Pointer to a variable which receives the plan handle. It is set only on success.
+ *                  The plan must be released with nnp_convolution_plan_destroy.
+ * @param threadpool A thread pool for parallelization of kernel transformation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_convolution_plan_create(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	nnp_convolution_plan_t* plan);
+
+/**
+ * @brief Creates a plan for repeated inference with a grouped 2D convolutional layer.
+ * @details Parameters have the same meaning and restrictions as for nnp_convolution_plan_create and
+ *          nnp_convolution_inference_grouped. Plans for grouped convolutions do not use the tuning cache.
+ */
+enum nnp_status nnp_convolution_plan_create_grouped(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	nnp_convolution_plan_t* plan);
+
+/**
+ * @brief Creates a plan for repeated inference with a dilated 2D convolutional layer.
+ * @details Parameters have the same meaning and restrictions as for nnp_convolution_plan_create_grouped and
+ *          nnp_convolution_inference_dilated. Plans for dilated convolutions do not use the tuning cache.
+ */
+enum nnp_status nnp_convolution_plan_create_dilated(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	nnp_convolution_plan_t* plan);
+
+/**
+ * @brief Computes output of the convolutional layer described by a plan.
+ * @details Executions of the same plan must not overlap, because they share the plan's workspace.
+ * @param plan A plan created by nnp_convolution_plan_create.
+ * @param[in]  input  A 4D tensor input[batch_size][input_channels][input_size.height][input_size.width].
+ * @param[out] output A 4D tensor output[batch_size][output_channels][output_size.height][output_size.width].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure.
+ *                     If provided, the structure would record time spent in different phases of the computation.
+ */
+enum nnp_status nnp_convolution_plan_execute(
+	nnp_convolution_plan_t plan,
+	const float* input,
+	float* output,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Returns the convolution algorithm chosen for a plan.
+ * @details If the plan was created with nnp_convolution_algorithm_auto, this is the algorithm NNPACK selected.
+ */
+enum nnp_convolution_algorithm nnp_convolution_plan_get_algorithm(nnp_convolution_plan_t plan);
+
+/**
+ * @brief Releases a convolution plan and all memory owned by it. Passing NULL is allowed.
+ */
+void nnp_convolution_plan_destroy(nnp_convolution_plan_t plan);
+
+/**
+ * @brief Computes output of a 2D convolutional layer on 8-bit quantized tensors.
+ * @details This function targets prediction with convolutional neural networks and performs forward propagation.
+ *          Input and output are uint8, the kernel is int8, and products are accumulated in int32 with the int32 bias,
+ *          then requantized to uint8 per output channel (see struct nnp_q8_convolution_parameters).
+ *          The kernel is packed into the workspace on every call.
+ * @param algorithm The type of algorithm to use for convolution. Possible values are:
+ *
+ *    - nnp_convolution_algorithm_auto           -- let the function choose the algorithm.
+ *    - nnp_convolution_algorithm_implicit_gemm  -- tiled int8 GEMM on the implicitly unfolded input. Supports all
+ *                                                  kernel sizes, paddings, and strides.
+ *    - nnp_convolution_algorithm_direct         -- int8 GEMM directly on the input. Supports only 1x1 kernels
+ *                                                  without padding.
+ *
+ * @param batch_size The number of images on the input and output of the convolutional layer.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input images.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output images.
+ * @param input_size Size of input images, excluding implicit zero-padding.
+ * @param input_padding Implicit padding of input images with input_zero_point.
+ * @param kernel_size Kernel size.
+ * @param output_subsampling Subsample region for output, also known as convolution stride.
+ * @param[in]  input  A 4D tensor input[batch_size][input_channels][input_size.height][input_size.width].
+ * @param[in]  kernel A 4D tensor kernel[output_channels][input_channels][kernel_size.height][kernel_size.width].
+ * @param[in]  bias   A 1D array bias[output_channels] in the scale of the accumulators (input_scale * kernel_scale).
+ * @param[out] output A 4D tensor output[batch_size][output_channels][output_size.height][output_size.width] where
+ *                        output_size.height = (input_padding.top + input_size.height + input_padding.bottom -
+ *                                              kernel_size.height) / output_subsampling.height + 1
+ *                        output_size.width  = (input_padding.left + input_size.width + input_padding.right -
+ *                                              kernel_size.width) / output_subsampling.width + 1
+ * @param[in] quantization Zero points, output range, and per-channel requantization scales.
+ * @param[in] workspace_buffer Buffer for the packed kernel, packed input, and accumulators.
+ *                             Buffer must be aligned on 64 bytes.
+ *                             If workspace_buffer is NULL and workspace_size is non-NULL, NNPACK would store the size
+ *                             of required workspace memory at the workspace_size location, and exit without
+ *                             computations.
+ *                             If workspace_buffer is NULL and workspace_size is NULL, NNPACK would use memory from
+ *                             its internal workspace arena (see nnp_workspace_reserve).
+ * @param[in,out] workspace_size Pointer to the size of workspace buffer.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure.
+ *                     If provided, the structure would record time spent in different phases of the computation.
+ */
+enum nnp_status nnp_convolution_inference_q8(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const uint8_t* input,
+	const int8_t* kernel,
+	const int32_t* bias,
+	uint8_t* output,
+	const struct nnp_q8_convolution_parameters* quantization,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Computes output of a 2D depthwise convolutional layer from input and kernel tensors.
+ * @details This function targets prediction with convolutional neural networks and performs forward propagation.
+ *          Each output channel is the convolution of the matching input channel with its own 2D kernel, as in
+ *          MobileNet-style networks. It uses direct convolution, parallelized over channels and rows of the output.
+ * @param channels The number of channels (AKA features, dimensions) in both input and output images.
+ * @param input_size Size of input image, excluding implicit zero-padding.
+ * @param input_padding Implicit zero-padding of input image.
+ * @param kernel_size Kernel size. Only 3x3 and 5x5 kernels are currently supported.
+ * @param output_subsampling Subsample region for output, also known as convolution stride.
+ *                           Only 1x1 and 2x2 strides are currently supported.
+ * @param[in]  input  A 3D tensor input[channels][input_size.height][input_size.width].
+ * @param[in]  kernel A 3D tensor kernel[channels][kernel_size.height][kernel_size.width].
+ * @param[in]  bias   A 1D array bias[channels].
+ * @param[out] output A 3D tensor output[channels][output_size.height][output_size.width] where
+ *                        output_size.height = (input_padding.top + input_size.height + input_padding.bottom -
+ *                                              kernel_size.height) / output_subsampling.height + 1
+ *                        output_size.width  = (input_padding.left + input_size.width + input_padding.right -
+ *                                              kernel_size.width) / output_subsampling.width + 1
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure.
+ *                     If provided, the structure would record time spent in different phases of the computation.
+ */
+enum nnp_status nnp_depthwise_convolution_inference(
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Returns the number of channels per block in the NCHWc tensor layout.
+ * @details The blocked layout stores a tensor with C channels as [batch][ceil(C / c)][height][width][c], where c is
+ *          the returned value (the SIMD width of the host, e.g. 8 on AVX2 and 4 on NEON). Lanes of the last block
+ *          past channel C - 1 hold zeros. Returns 0 if NNPACK is not initialized.
+ */
+size_t nnp_nchwc_channel_block_size(void);
+
+/**
+ * @brief Converts a tensor from the planar NCHW layout to the blocked NCHWc layout.
+ * @param batch_size The number of images in the tensor.
+ * @param channels The number of channels in each image.
+ * @param image_size Size of each channel of the image.
+ * @param[in]  input  A 4D tensor input[batch_size][channels][image_size.height][image_size.width].
+ * @param[out] output A 5D tensor output[batch_size][ceil(channels / c)][image_size.height][image_size.width][c]
+ *                    where c = nnp_nchwc_channel_block_size(). Padding lanes are set to zero.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_convert_nchw_to_nchwc(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	const float* input,
+	float* output,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Converts a tensor from the blocked NCHWc layout back to the planar NCHW layout.
+ * @param batch_size The number of images in the tensor.
+ * @param channels The number of channels in each image.
+ * @param image_size Size of each channel of the image.
+ * @param[in]  input  A 5D tensor input[batch_size][ceil(channels / c)][image_size.height][image_size.width][c]
+ *                    where c = nnp_nchwc_channel_block_size().
+ * @param[out] output A 4D tensor output[batch_size][channels][image_size.height][image_size.width].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_convert_nchwc_to_nchw(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	const float* input,
+	float* output,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a 2D convolutional layer on tensors in the blocked NCHWc layout.
+ * @details This function targets prediction with convolutional neural networks and performs forward propagation.
+ *          Input and output are stored in the NCHWc layout (see nnp_nchwc_channel_block_size), and the direct
+ *          convolution micro-kernel vectorizes across the channels of a block. Output padding lanes are zero, so
+ *          the output of one layer can be passed to the next without converting back to NCHW.
+ *          The kernel is repacked into blocks on every call, using the workspace.
+ * @param batch_size The number of images on the input and output of the convolutional layer.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input images.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output images.
+ * @param input_size Size of input images, excluding implicit zero-padding.
+ * @param input_padding Implicit zero-padding of input images.
+ * @param kernel_size Kernel size.
+ * @param output_subsampling Subsample region for output, also known as convolution stride.
+ * @param[in]  input  A 5D tensor input[batch_size][ceil(input_channels / c)][input_size.height][input_size.width][c]
+ *                    where c = nnp_nchwc_channel_block_size().
+ * @param[in]  kernel A 4D tensor kernel[output_channels][input_channels][kernel_size.height][kernel_size.width].
+ * @param[in]  bias   A 1D array bias[output_channels].
+ * @param[out] output A 5D tensor output[batch_size][ceil(output_channels / c)][output_size.height][output_size.width][c]
+ *                    where
+ *                        output_size.height = (input_padding.top + input_size.height + input_padding.bottom -
+ *                                              kernel_size.height) / output_subsampling.height + 1
+ *                        output_size.width  = (input_padding.left + input_size.width + input_padding.right -
+ *                                              kernel_size.width) / output_subsampling.width + 1
+ * @param[in] workspace_buffer Buffer for the packed kernel. Buffer must be aligned on 64 bytes.
+ *                             If workspace_buffer is NULL and workspace_size is non-NULL, NNPACK would store the size
+ *                             of required workspace memory at the workspace_size location, and exit without
+ *                             computations.
+ *                             If workspace_buffer is NULL and workspace_size is NULL, NNPACK would use memory from
+ *                             its internal workspace arena (see nnp_workspace_reserve).
+ * @param[in,out] workspace_size Pointer to the size of workspace buffer.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure.
+ *                     If provided, the structure would record time spent in different phases of the computation.
+ */
+enum nnp_status nnp_convolution_inference_nchwc(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Computes output of a fully connected layer from input and kernel matrices.
+ * @details This function targets training of convolutional neural networks and performs forward propagation.
+ *          It is optimized for moderate minibatch sizes (64-128) and can be inefficient on a small minibatch.
+ *          For minibatch size 1, use nnp_fully_connected_inference for optimal performance.
+ * @param batch_size The number of vectors on the input and output of the fully connected layer.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input matrix.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output matrix.
+ * @param[in]  input  A 2D matrix input[batch_size][input_channels].
+ * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels].
+ * @param[out] output A 2D matrix output[batch_size][output_channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_fully_connected_output(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	const float input[],
+	const float kernel[],
+	float output[],
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Computes output of a fully connected layer for a single input vector and a kernel matrix.
+ * @details This function targets prediction with convolutional neural networks and performs forward propagation.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input vector.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output vector.
+ * @param[in]  input  A 1D array input[input_channels] of FP32 elements.
+ * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels] of FP32 elements.
+ * @param[out] output A 1D array output[output_channels] of FP32 elements.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_fully_connected_inference(
+	size_t input_channels,
+	size_t output_channels,
+	const float* input,
+	const float* kernel,
+	float* output,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a fully connected layer for a single input vector and a kernel matrix.
+ * @details This function targets prediction with convolutional neural networks and performs forward propagation.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input vector.
+ * @param output_channels The number of channels (AKA features, dimensions) in the output vector.
+ * @param[in]  input  A 1D array input[input_channels] of FP32 elements.
+ * @param[in]  kernel A 2D matrix kernel[output_channels][input_channels] of FP16 (ARM alternative format) elements.
+ * @param[out] output A 1D array output[output_channels] of FP32 elements.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_fully_connected_inference_f16f32(
+	size_t input_channels,
+	size_t output_channels,
+	const float* input,
+	const void* kernel,
+	float* output,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a max-pooling layer for an input tensor.
+ * @details This function targets both prediction and training of convolutional neural networks and performs forward
+ *          propagation. Is is optimized for both large and small minibatch sizes.
+ * @param batch_size The number of images on the input and output of the max-pooling layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output images.
+ * @param input_size Size of input images, excluding implicit zero-padding.
+ * @param input_padding Implicit padding of input images. The padding pixels are ignored by the pooling filter, but
+ *                      affect the output size.
+ * @param pooling_size   Size of the pooling filter. Only 2x2 filter are currently supported.
+ * @param pooling_stride Stride of the pooling filter. Only 2x2 strides are currently supported.
+ * @param[in]  input  A 4D tensor input[batch_size][channels][input_size.height][input_size.width].
+ * @param[out] output A 4D tensor output[batch_size][channels][output_size.height][output_size.width] where
+ *                    output_size.height = ceil(
+ *                      (input_padding.top + input_size.height + input_padding.bottom - pooling_size.height) /
+ *                        pooling_stride.height) + 1
+ *                    output_size.width = ceil(
+ *                      (input_padding.left + input_size.width + input_padding.right - pooling_size.width) /
+ *                        pooling_stride.width) + 1
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_max_pooling_output(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a max-pooling layer for a channels-last (NHWC) input tensor.
+ * @details The pooling window of every output pixel is reduced across all channels at once, so the inner loop runs
+ *          over contiguous channels. All parameters have the same meaning and restrictions as for
+ *          nnp_max_pooling_output, except for the layout of the tensors.
+ * @param[in]  input  A 4D tensor input[batch_size][input_size.height][input_size.width][channels].
+ * @param[out] output A 4D tensor output[batch_size][output_size.height][output_size.width][channels].
+ */
+enum nnp_status nnp_max_pooling_output_nhwc(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a softmax layer for an input matrix.
+ * @details This function targets both prediction and training of convolutional neural networks and performs forward
+ *          propagation. Is is optimized for both large and small minibatch sizes.
+ * @param batch_size The number of vectors on the input and output of the softmax layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output vectors.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_softmax_output(
+    size_t batch_size,
+    size_t channels,
+    const float input[],
+    float output[],
+    pthreadpool_t threadpool);
+
+/**
+ * @brief Computes output of a rectified linear unit (ReLU) layer for an input matrix.
+ * @details This function targets both prediction and training of convolutional neural networks and performs forward
+ *          propagation. Is is optimized for both large and small minibatch sizes.
+ * @param batch_size The number of vectors on the input and output of the ReLU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_relu_output(
+	size_t batch_size,
+	size_t channels,
+	const float input[],
+	float output[],
+	float negative_slope,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Computes gradient of input of a rectified linear unit (ReLU) layer from gradient of output and input matrices.
+ * @details This function targets training of convolutional neural networks and performs backward propagation.
+ *          Is is optimized for both large and small minibatch sizes.
+ * @param batch_size The number of vectors on the input and output of the ReLU layer.
+ * @param channels   The number of channels (AKA features, dimensions) in both input and output matrices.
+ * @param[in]  input  A 2D matrix input[batch_size][channels].
+ * @param[out] output A 2D matrix output[batch_size][channels].
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_relu_input_gradient(
 	size_t batch_size,
 	size_t channels,
 	const float grad_output[],
@@ -555,6 +1419,332 @@ enum nnp_status nnp_relu_input_gradient(
 	float negative_slope,
 	pthreadpool_t threadpool);
 
+/**
+ * @brief Opaque handle of a network.
+ * @details A network is a chain of inference layers, each consuming the output of the previous layer. Layers are
+ *          added with nnp_network_add_* functions, then nnp_network_plan packs all intermediate activations and
+ *          layer workspaces into a single arena, and nnp_network_run computes the whole chain.
+ *          Kernels and biases are referenced, not copied, and must stay valid while the network is used.
+ */
+typedef struct nnp_network* nnp_network_t;
+
+/**
+ * @brief Memory used by a planned network.
+ */
+struct nnp_network_memory {
+	/** Size of the arena which holds all intermediate activations and layer workspaces, in bytes. */
+	size_t arena_size;
+	/** Largest total size of intermediate activations and workspaces live in the same layer, in bytes.
+	 *  No arena can be smaller than this bound. */
+	size_t peak_live_size;
+	/** Total size of intermediate activations and workspaces if each one had its own buffer, in bytes. */
+	size_t unplanned_size;
+	/** Size of kernels transformed by nnp_network_plan and owned by the network, in bytes. */
+	size_t parameters_size;
+};
+
+/**
+ * @brief Creates an empty network for a minibatch of input images.
+ * @param batch_size The number of images on the input and output of the network.
+ * @param input_channels The number of channels (AKA features, dimensions) in the input images.
+ * @param input_size Size of input images, excluding implicit zero-padding.
+ * @param[out] network Pointer to a variable which receives the network handle. It is set only on success.
+ *                     The network must be released with nnp_network_destroy.
+ */
+enum nnp_status nnp_network_create(
+	size_t batch_size,
+	size_t input_channels,
+	struct nnp_size input_size,
+	nnp_network_t* network);
+
+/**
+ * @brief Appends a 2D convolutional layer to a network.
+ * @details Parameters have the same meaning and restrictions as for nnp_convolution_inference_batch; input channels
+ *          and input size are those of the previous layer's output. With nnp_convolution_transform_strategy_precompute
+ *          nnp_network_plan transforms the kernel once into network-owned memory and the layer reuses it in every run,
+ *          after that only the bias is referenced. With nnp_convolution_transform_strategy_compute the kernel is
+ *          transformed in every run. With nnp_convolution_transform_strategy_reuse the kernel must be transformed
+ *          by nnp_convolution_inference_batch with nnp_convolution_transform_strategy_precompute for the same
+ *          algorithm (which can not be nnp_convolution_algorithm_auto) and layer parameters, and the layer reads it
+ *          in every run.
+ */
+enum nnp_status nnp_network_add_convolution(
+	nnp_network_t network,
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t output_channels,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	enum nnp_activation activation,
+	const void* activation_parameters);
+
+/**
+ * @brief Appends a max-pooling layer to a network.
+ * @details Parameters have the same meaning and restrictions as for nnp_max_pooling_output.
+ */
+enum nnp_status nnp_network_add_max_pooling(
+	nnp_network_t network,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride);
+
+/**
+ * @brief Appends a (leaky) ReLU layer to a network.
+ * @details ReLU right after a convolutional layer without activation is fused into that layer. Otherwise the layer
+ *          overwrites its input, unless the input is the network input.
+ */
+enum nnp_status nnp_network_add_relu(
+	nnp_network_t network,
+	float negative_slope);
+
+/**
+ * @brief Appends a fully connected layer to a network.
+ * @details The layer consumes every image of the previous layer's output as a vector of channels x height x width
+ *          elements, and produces output_channels channels of 1x1 size.
+ * @param kernel A 2D matrix kernel[output_channels][input_channels].
+ */
+enum nnp_status nnp_network_add_fully_connected(
+	nnp_network_t network,
+	size_t output_channels,
+	const float* kernel);
+
+/**
+ * @brief Appends a softmax layer to a network.
+ * @details Softmax is computed over all channels x height x width elements of every image. Unless the input is the
+ *          network input, the layer overwrites its input.
+ */
+enum nnp_status nnp_network_add_softmax(
+	nnp_network_t network);
+
+/**
+ * @brief Returns the shape of the network output, i.e. of the output of its last layer.
+ * @param[out] channels Optional pointer to a variable which receives the number of output channels.
+ * @param[out] output_size Optional pointer to a variable which receives the size of output images.
+ */
+enum nnp_status nnp_network_get_output_shape(
+	nnp_network_t network,
+	size_t* channels,
+	struct nnp_size* output_size);
+
+/**
+ * @brief Prepares a network for inference.
+ * @details The function transforms precomputed kernels, queries layer workspaces, and assigns every intermediate
+ *          activation and workspace an offset in a single arena, so that buffers which are live in the same layer
+ *          do not overlap. The network input and output are caller's buffers and take no space in the arena.
+ *          After this call no layers can be added to the network, even if the call fails.
+ * @param threadpool A thread pool for parallelization of kernel transformation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ */
+enum nnp_status nnp_network_plan(
+	nnp_network_t network,
+	pthreadpool_t threadpool);
+
+/**
+ * @brief Returns the memory used by a planned network.
+ */
+enum nnp_status nnp_network_get_memory(
+	nnp_network_t network,
+	struct nnp_network_memory* memory);
+
+/**
+ * @brief Computes the output of a planned network.
+ * @details Runs of the same network must not overlap, because they share the network's arena.
+ * @param[in]  input  A 4D tensor input[batch_size][input_channels][input_size.height][input_size.width].
+ * @param[out] output A 4D tensor with the shape reported by nnp_network_get_output_shape.
+ * @param threadpool A thread pool for parallelization of the computation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] profile An optional pointer to profiling structure. If provided, total records the wall time of the
+ *                     whole network, and other fields sum the respective phases of its convolutional layers.
+ */
+enum nnp_status nnp_network_run(
+	nnp_network_t network,
+	const float* input,
+	float* output,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile);
+
+/**
+ * @brief Releases a network and all memory owned by it. Passing NULL is allowed.
+ */
+void nnp_network_destroy(nnp_network_t network);
+
+/**
+ * @brief Saves a planned network to a model file.
+ * @details The model file holds the network topology and 64-byte-aligned sections with raw kernels, biases, and
+ *          kernels transformed for nnp_convolution_transform_strategy_precompute and _reuse layers, keyed by the
+ *          backend, SIMD width, cache and register blocking which determine the layout of transformed kernels.
+ *          Kernels and biases passed to nnp_network_add_* functions must still be valid.
+ * @param path Path of the model file. An existing file is overwritten.
+ */
+enum nnp_status nnp_network_save(
+	nnp_network_t network,
+	const char* path);
+
+/**
+ * @brief Loads and plans a network from a model file written by nnp_network_save.
+ * @details The file is mapped into memory, and layers read kernels and biases from the mapping without copies.
+ *          If the file was written on the same hardware, convolutional layers reuse transformed kernels from the file,
+ *          and loading costs only page-in time. Otherwise layers transform raw kernels from the file, as
+ *          nnp_network_plan does for nnp_convolution_transform_strategy_precompute.
+ * @param path Path of the model file.
+ * @param batch_size The number of images on the input and output of the network.
+ * @param threadpool A thread pool for parallelization of kernel transformation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] network Pointer to a variable which receives the network handle. It is set only on success.
+ *                     The network must be released with nnp_network_destroy, which also unmaps the file.
+ * @return nnp_status_io_error if the file can not be opened or mapped.
+ * @return nnp_status_invalid_file_format if the file is not a valid model file.
+ * @return nnp_status_unsupported_hardware if a layer has only a transformed kernel, and it was transformed for
+ *         different hardware.
+ */
+enum nnp_status nnp_network_load(
+	const char* path,
+	size_t batch_size,
+	pthreadpool_t threadpool,
+	nnp_network_t* network);
+
+/**
+ * @brief Loads and plans a network from a model file in memory, e.g. a model image linked into the program.
+ * @details Same as nnp_network_load, but layers read kernels and biases from the caller's memory, which must stay
+ *          valid until the network is destroyed. Nothing is copied, and on the same hardware nothing is transformed.
+ * @param model Contents of a model file written by nnp_network_save. Must be aligned to 64 bytes.
+ * @param model_size Size of the model file, in bytes.
+ */
+enum nnp_status nnp_network_load_memory(
+	const void* model,
+	size_t model_size,
+	size_t batch_size,
+	pthreadpool_t threadpool,
+	nnp_network_t* network);
+
+/**
+ * @brief Loads and plans a network which reads layer parameters from a model file in every run.
+ * @details For memory-constrained systems, where kernels of the whole network do not fit into memory. Only the layer
+ *          records are kept in memory. Kernels and biases of each convolutional and fully connected layer are read into
+ *          one of two network-owned buffers before the layer runs: while a layer computes, a helper thread reads the
+ *          parameters of the next one into the other buffer. nnp_network_get_memory reports the size of both buffers
+ *          as parameters_size. Transformed kernels from the file are used if it was written on the same hardware;
+ *          otherwise layers transform raw kernels in every run, as for nnp_convolution_transform_strategy_compute.
+ *          Networks loaded this way can not be saved with nnp_network_save.
+ * @param path Path of the model file, or of a block device which starts with a model file.
+ * @param batch_size The number of images on the input and output of the network.
+ * @param threadpool A thread pool for parallelization of kernel transformation.
+ *                   If threadpool is NULL, the computation would run on the caller thread without parallelization.
+ * @param[out] network Pointer to a variable which receives the network handle. It is set only on success.
+ *                     The network must be released with nnp_network_destroy, which also closes the file.
+ * @return nnp_status_io_error if the file can not be opened or read. nnp_network_run also returns it if reading
+ *         layer parameters fails.
+ * @return nnp_status_invalid_file_format if the file is not a valid model file.
+ */
+enum nnp_status nnp_network_load_streaming(
+	const char* path,
+	size_t batch_size,
+	pthreadpool_t threadpool,
+	nnp_network_t* network);
+
+/**
+ * @brief Reading of layer parameters by a network loaded with nnp_network_load_streaming, summed over all runs.
+ * @details Reading overlaps with computation: io_time - wait_time is the reading time hidden behind computation.
+ *          If wait_time is small relative to the run time, the network runs at the speed of computation.
+ */
+struct nnp_network_stream_profile {
+	/** Time spent by the helper thread reading layer parameters, in seconds. */
+	double io_time;
+	/** Time spent by nnp_network_run waiting for layer parameters, in seconds. */
+	double wait_time;
+	/** Number of bytes of layer parameters read. */
+	size_t bytes_read;
+	/** Number of reads of layer parameters. Parameters still in a buffer from the previous run are not read again. */
+	size_t reads;
+};
+
+/**
+ * @brief Returns statistics of reading layer parameters by a network loaded with nnp_network_load_streaming.
+ * @return nnp_status_invalid_network if the network was not loaded with nnp_network_load_streaming.
+ */
+enum nnp_status nnp_network_get_stream_profile(
+	nnp_network_t network,
+	struct nnp_network_stream_profile* profile);
+
+/**
+ * @brief Type of a layer in a model file.
+ */
+enum nnp_model_layer_type {
+	nnp_model_layer_convolution = 0,
+	nnp_model_layer_max_pooling = 1,
+	nnp_model_layer_relu = 2,
+	nnp_model_layer_fully_connected = 3,
+	nnp_model_layer_softmax = 4,
+};
+
+/**
+ * @brief Parameters of a layer in a model file, with pointers into the model.
+ * @details Kernels and biases can be passed in place to nnp_convolution_inference and nnp_fully_connected_inference.
+ */
+struct nnp_model_layer {
+	enum nnp_model_layer_type type;
+	/** Convolution algorithm. For a transformed kernel, the algorithm it was transformed for. */
+	enum nnp_convolution_algorithm algorithm;
+	/** The number of output channels of convolutional and fully connected layers. */
+	size_t output_channels;
+	/** Implicit input padding of convolutional and pooling layers. */
+	struct nnp_padding input_padding;
+	/** Kernel size of convolutional layers, or pooling size of pooling layers. */
+	struct nnp_size kernel_size;
+	/** Output subsampling of convolutional layers, or pooling stride of pooling layers. */
+	struct nnp_size stride;
+	/** Activation of convolutional layers. */
+	enum nnp_activation activation;
+	/** Activation parameters of convolutional layers, or a pointer to the negative slope of ReLU layers. Can be NULL. */
+	const void* activation_parameters;
+	/** Kernel of convolutional and fully connected layers, or NULL if the model has only the transformed kernel. */
+	const float* kernel;
+	/** Bias of convolutional layers. Can be NULL. */
+	const float* bias;
+	/** Kernel for nnp_convolution_transform_strategy_reuse, or NULL if it is missing or was transformed for different hardware. */
+	const void* transformed_kernel;
+	/** Size of the transformed kernel, in bytes. */
+	size_t transformed_kernel_size;
+};
+
+/**
+ * @brief Returns the parameters of a layer in a model file in memory.
+ * @param model Contents of a model file written by nnp_network_save. Must be aligned to 64 bytes.
+ * @param model_size Size of the model file, in bytes.
+ * @param index Index of the layer in the model. ReLU layers after convolutional layers are fused into them.
+ * @param[out] layer Pointer to a structure which receives the parameters of the layer.
+ * @return nnp_status_invalid_network if the model has fewer than index + 1 layers.
+ */
+enum nnp_status nnp_model_get_layer(
+	const void* model,
+	size_t model_size,
+	size_t index,
+	struct nnp_model_layer* layer);
+
+/**
+ * @brief Model file linked into a read-only section of the program image.
+ * @details Model images are assembled from model files by src/model-image.S, which places the model in a 64-byte
+ *          aligned read-only section and its descriptor in the nnp_model_images section.
+ */
+struct nnp_model_image {
+	/** Name of the model, as set at build time. */
+	const char* name;
+	/** Contents of the model file, aligned to 64 bytes. */
+	const void* data;
+	/** Size of the model file, in bytes. */
+	size_t size;
+};
+
+/**
+ * @brief Looks up a model image linked into the program.
+ * @details The returned model can be passed to nnp_network_load_memory and nnp_model_get_layer.
+ * @return Pointer to the descriptor of the model image, or NULL if no model image with this name is linked.
+ */
+const struct nnp_model_image* nnp_model_image_find(const char* name);
+
 #ifdef __cplusplus
 } /* extern "C" */
 #endif
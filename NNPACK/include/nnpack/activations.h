@@ -1,12 +1,78 @@
 #pragma once
 
+#include <stdbool.h>
 #include <math.h>
 
+#include <nnpack.h>
+#include <nnpack/utils.h>
+
 
 static inline float relu(float data, float negative_slope) {
 	return signbit(data) ? data * negative_slope : data;
 }
 
+/*
+ * Activation of an inference layer with resolved parameters: f(x) := min(max(relu(x, negative_slope), output_min), output_max).
+ * Identity, ReLU, leaky ReLU, ReLU6 and clamp are all special cases, so output epilogues implement them in one loop.
+ */
+struct output_activation {
+	float negative_slope;
+	float output_min;
+	float output_max;
+};
+
+/* Activation and parameters must be validated with validate_convolution_arguments */
+static inline struct output_activation resolve_output_activation(
+	enum nnp_activation activation, const void* activation_parameters)
+{
+	switch (activation) {
+		case nnp_activation_relu:
+			return (struct output_activation) {
+				.negative_slope = activation_parameters != NULL ? *((const float*) activation_parameters) : 0.0f,
+				.output_min = -INFINITY,
+				.output_max = INFINITY,
+			};
+		case nnp_activation_relu6:
+			return (struct output_activation) {
+				.negative_slope = 1.0f,
+				.output_min = 0.0f,
+				.output_max = 6.0f,
+			};
+		case nnp_activation_clamp:
+			return (struct output_activation) {
+				.negative_slope = 1.0f,
+				.output_min = ((const struct nnp_clamp_parameters*) activation_parameters)->output_min,
+				.output_max = ((const struct nnp_clamp_parameters*) activation_parameters)->output_max,
+			};
+		case nnp_activation_identity:
+		default:
+			return (struct output_activation) {
+				.negative_slope = 1.0f,
+				.output_min = -INFINITY,
+				.output_max = INFINITY,
+			};
+	}
+}
+
+static inline bool is_identity_activation(struct output_activation activation) {
+	return activation.negative_slope == 1.0f && activation.output_min == -INFINITY && activation.output_max == INFINITY;
+}
+
+/* Plain ReLU, the only parameterized activation with dedicated output transforms */
+static inline bool is_relu_activation(struct output_activation activation) {
+	return activation.negative_slope == 0.0f && activation.output_min == -INFINITY && activation.output_max == INFINITY;
+}
+
+static inline float activate(float data, struct output_activation activation) {
+	return minf(maxf(relu(data, activation.negative_slope), activation.output_min), activation.output_max);
+}
+
+static inline void activate_block(float* data, size_t count, struct output_activation activation) {
+	for (size_t index = 0; index < count; index++) {
+		data[index] = activate(data[index], activation);
+	}
+}
+
 static inline float grad_relu(float grad_output_data, float input_data, float negative_slope) {
 	return signbit(input_data) ? grad_output_data * negative_slope : grad_output_data;
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <nnpack.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Parameters which identify a convolutional layer in the tuning cache */
+struct nnp_convolution_shape {
+	size_t batch_size;
+	size_t input_channels;
+	size_t output_channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	struct nnp_size output_subsampling;
+	enum nnp_activation activation;
+};
+
+/*
+ * Looks up the tuned algorithm and transform strategy for a layer shape and number of threads.
+ * Returns false if the shape was not tuned, or if autotuning is disabled. transform_strategy may be NULL.
+ */
+bool nnp_autotune_lookup(
+	const struct nnp_convolution_shape* shape,
+	size_t threads_count,
+	enum nnp_convolution_algorithm* algorithm,
+	enum nnp_convolution_transform_strategy* transform_strategy);
+
+/*
+ * Resolves nnp_convolution_algorithm_auto for a convolution plan according to the autotuning mode: looks up the
+ * tuning cache, and, in nnp_autotune_mode_measure, tunes shapes missing from the cache. If neither gives a choice,
+ * algorithm and transform_strategy are left unchanged. transform_strategy may be NULL.
+ */
+enum nnp_status nnp_autotune_select(
+	const struct nnp_convolution_shape* shape,
+	pthreadpool_t threadpool,
+	enum nnp_convolution_algorithm* algorithm,
+	enum nnp_convolution_transform_strategy* transform_strategy);
+
+/*
+ * Returns the algorithm which convolution inference runs for nnp_convolution_algorithm_auto on a dense convolution
+ * of planar tensors, if the shape is not in the tuning cache.
+ */
+enum nnp_convolution_algorithm nnp_convolution_heuristic_algorithm(
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling);
+
+/*
+ * Loads the tuning file named by the NNPACK_TUNING_FILE environment variable, if any.
+ * Called from nnp_initialize; a missing file is not an error.
+ */
+void nnp_autotune_initialize(void);
+
+/*
+ * Saves newly tuned entries to the tuning file named by the NNPACK_TUNING_FILE environment variable, if any,
+ * and releases the tuning cache. Called from nnp_deinitialize.
+ */
+void nnp_autotune_deinitialize(void);
+
+static inline size_t nnp_autotune_threads_count(pthreadpool_t threadpool) {
+	return threadpool == NULL ? 1 : pthreadpool_get_threads_count(threadpool);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -21,6 +21,18 @@ void nnp_sgemm_only_6x8__aarch32_neon(size_t k, size_t update, const float* a, c
 void nnp_sgemm_only_4x3__scalar(size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 void nnp_sgemm_upto_4x3__scalar(uint32_t mr, uint32_t nr, size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 
+/*
+ * Quantized GEMM micro-kernels compute an mr x nr tile of int32 dot products of int8 kernel rows and uint8 input
+ * columns. The reduction is consumed in pairs: a holds k pairs of mr kernel elements as [k][mr][2], and b holds k pairs
+ * of nr input elements as [k][nr][2]. Panels are always packed, and zero-padded, to the full mr and nr; the upto
+ * variants only limit the part of the tile stored to c.
+ */
+void nnp_q8gemm_only_4x8__avx2(size_t k, size_t update, const int8_t* a, const uint8_t* b, int32_t* c, size_t row_stride_c);
+void nnp_q8gemm_upto_4x8__avx2(uint32_t mr, uint32_t nr, size_t k, size_t update, const int8_t* a, const uint8_t* b, int32_t* c, size_t row_stride_c);
+
+void nnp_q8gemm_only_4x4__scalar(size_t k, size_t update, const int8_t* a, const uint8_t* b, int32_t* c, size_t row_stride_c);
+void nnp_q8gemm_upto_4x4__scalar(uint32_t mr, uint32_t nr, size_t k, size_t update, const int8_t* a, const uint8_t* b, int32_t* c, size_t row_stride_c);
+
 void nnp_conv1x1_only_2x4__fma3(size_t input_channels, size_t image_size, const float* input, const float* kernel, float* output);
 void nnp_conv1x1_upto_2x4__fma3(uint32_t mr, uint32_t nr, size_t input_channels, size_t image_size, const float* input, const float* kernel, float* output);
 
@@ -54,6 +66,9 @@ void nnp_s4c6gemm_conjb_transc_upto_2x2__fma3(uint32_t mr, uint32_t nr, size_t k
 void nnp_s8gemm_only_3x4__fma3(size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 void nnp_s8gemm_upto_3x4__fma3(uint32_t mr, uint32_t nr, size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 
+void nnp_h8gemm_only_3x4__avx2(size_t k, size_t update, const void* a, const void* b, void* c, size_t row_stride_c);
+void nnp_h8gemm_upto_3x4__avx2(uint32_t mr, uint32_t nr, size_t k, size_t update, const void* a, const void* b, void* c, size_t row_stride_c);
+
 void nnp_s4gemm_only_3x4__psimd(size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 void nnp_s4gemm_upto_3x4__psimd(uint32_t mr, uint32_t nr, size_t k, size_t update, const float* a, const float* b, float* c, size_t row_stride_c);
 
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <stddef.h>
+
+#include <nnpack/utils.h>
+#include <nnpack/hwinfo.h>
+
+/* Cache blocking of GEMM-based convolutions (implicit GEMM and the packed 1x1 path) */
+struct gemm_blocking {
+	size_t output_channels_subblock_max;
+	size_t output_image_subblock_max;
+	size_t reduction_block_max;
+	size_t output_channels_block_max;
+	size_t output_image_block_max;
+};
+
+/*
+ * Computes GEMM blocking for mr x nr micro-kernels on packed elements of the given size: an mr x reduction block of the
+ * kernel and a reduction block x nr subblock of the input fit into L1 cache, a block of output channels of the packed
+ * kernel fits into L2 cache, and a block of the packed input image fits into L3 cache.
+ * The reduction block is even, so that micro-kernels which consume the reduction in pairs never see a partial pair.
+ */
+static inline struct gemm_blocking gemm_blocking(size_t mr, size_t nr, size_t element_size) {
+	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / element_size;
+	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / element_size;
+	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / element_size;
+
+	const size_t reduction_block_max = round_down(cache_elements_l1 / (mr + nr), 2);
+	return (struct gemm_blocking) {
+		.output_channels_subblock_max = mr,
+		.output_image_subblock_max = nr,
+		.reduction_block_max = reduction_block_max,
+		.output_channels_block_max = round_down(cache_elements_l2 / reduction_block_max, mr),
+		.output_image_block_max = round_down(cache_elements_l3 / reduction_block_max, nr),
+	};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack/utils.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Depthwise convolution micro-kernels compute one output row of one channel.
+ * The caller resolves vertical padding: input points to the first input row which overlaps the kernel, kernel points
+ * to the matching kernel row, and kernel_rows is the number of such rows. Input rows are input_width elements apart.
+ * Horizontal padding is handled by the micro-kernel. The result is bias + convolution, clamped to
+ * [output_min, output_max].
+ */
+void nnp_dwconv3x3__avx2(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+void nnp_dwconv3x3s2__avx2(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+void nnp_dwconv5x5__avx2(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+void nnp_dwconv5x5s2__avx2(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+
+void nnp_dwconv3x3__psimd(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+void nnp_dwconv3x3s2__psimd(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+void nnp_dwconv5x5__psimd(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+void nnp_dwconv5x5s2__psimd(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+
+void nnp_dwconv3x3__scalar(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+void nnp_dwconv3x3s2__scalar(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+void nnp_dwconv5x5__scalar(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+void nnp_dwconv5x5s2__scalar(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max);
+
+/*
+ * Returns the end of the range of output columns [ceil(padding_left / stride), end) which read only columns
+ * inside the input row when the kernel footprint is extent columns wide.
+ */
+static inline size_t depthwise_interior_end(
+	size_t input_width, size_t padding_left, size_t output_width,
+	size_t extent, size_t stride)
+{
+	const size_t interior_start = min(divide_round_up(padding_left, stride), output_width);
+	if (input_width + padding_left < extent) {
+		return interior_start;
+	}
+	return max(min((input_width + padding_left - extent) / stride + 1, output_width), interior_start);
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
@@ -49,9 +49,14 @@ typedef void (*nnp_transform_2d_with_offset)(const void*, void*, size_t, size_t,
 typedef void (*nnp_fast_sgemm_function)(size_t, size_t, const float*, const float*, float*, size_t);
 typedef void (*nnp_full_sgemm_function)(uint32_t, uint32_t, size_t, size_t, const float*, const float*, float*, size_t);
 
+typedef void (*nnp_fast_q8gemm_function)(size_t, size_t, const int8_t*, const uint8_t*, int32_t*, size_t);
+typedef void (*nnp_full_q8gemm_function)(uint32_t, uint32_t, size_t, size_t, const int8_t*, const uint8_t*, int32_t*, size_t);
+
 typedef void (*nnp_fast_conv_function)(size_t, size_t, const float*, const float*, float*);
 typedef void (*nnp_full_conv_function)(uint32_t, uint32_t, size_t, size_t, const float*, const float*, float*);
 
+typedef void (*nnp_depthwise_function)(const float*, const float*, float*, size_t, size_t, size_t, uint32_t, float, float, float);
+
 typedef void (*nnp_fast_tuple_gemm_function)(size_t, size_t, const void*, const void*, void*, size_t);
 typedef void (*nnp_full_tuple_gemm_function)(uint32_t, uint32_t, size_t, size_t, const void*, const void*, void*, size_t);
 
@@ -91,12 +96,20 @@ struct transforms {
 	nnp_transform_2d_with_bias owt_f6x6_3x3s2_with_bias;
 	nnp_transform_2d_with_bias owt_f6x6_3x3_with_bias_with_relu;
 	nnp_transform_2d_with_bias owt_f6x6_3x3s2_with_bias_with_relu;
-#if NNP_BACKEND_ARM
+	nnp_transform_2d_with_offset iwt_f2x2_3x3_with_offset;
+	nnp_transform_2d_with_offset kwt_f2x2_3x3;
+	nnp_transform_2d_with_bias owt_f2x2_3x3_with_bias;
+	nnp_transform_2d_with_bias owt_f2x2_3x3_with_bias_with_relu;
+	nnp_transform_2d_with_offset iwt_f4x4_3x3_with_offset;
+	nnp_transform_2d_with_offset kwt_f4x4_3x3;
+	nnp_transform_2d_with_bias owt_f4x4_3x3_with_bias;
+	nnp_transform_2d_with_bias owt_f4x4_3x3_with_bias_with_relu;
+#if NNP_BACKEND_ARM || NNP_BACKEND_X86_64
 	nnp_transform_2d_with_offset iwt_f6x6_3x3_fp16_with_offset;
 	nnp_transform_2d_with_offset kwt_f6x6_3x3_fp16;
 	nnp_transform_2d_with_bias owt_f6x6_3x3_fp16_with_bias;
 	nnp_transform_2d_with_bias owt_f6x6_3x3_fp16_with_bias_with_relu;
-#endif /* NNP_BACKEND_ARM */
+#endif /* NNP_BACKEND_ARM || NNP_BACKEND_X86_64 */
 };
 
 #if !NNP_CONVOLUTION_ONLY
@@ -116,6 +129,13 @@ struct convolution {
 	uint32_t nr;
 };
 
+struct depthwise {
+	nnp_depthwise_function conv3x3;
+	nnp_depthwise_function conv3x3s2;
+	nnp_depthwise_function conv5x5;
+	nnp_depthwise_function conv5x5s2;
+};
+
 struct sgemm {
 	nnp_fast_sgemm_function only_mr_x_nr;
 	nnp_full_sgemm_function upto_mr_x_nr;
@@ -123,6 +143,13 @@ struct sgemm {
 	uint32_t nr;
 };
 
+struct q8gemm {
+	nnp_fast_q8gemm_function only_mr_x_nr;
+	nnp_full_q8gemm_function upto_mr_x_nr;
+	uint32_t mr;
+	uint32_t nr;
+};
+
 struct sxgemm {
 	nnp_fast_tuple_gemm_function only_mr_x_nr;
 	nnp_full_tuple_gemm_function upto_mr_x_nr;
@@ -130,14 +157,14 @@ struct sxgemm {
 	uint32_t nr;
 };
 
-#if NNP_BACKEND_ARM
+#if NNP_BACKEND_ARM || NNP_BACKEND_X86_64
 struct hxgemm {
 	nnp_fast_tuple_gemm_function only_mr_x_nr;
 	nnp_full_tuple_gemm_function upto_mr_x_nr;
 	uint32_t mr;
 	uint32_t nr;
 };
-#endif /* NNP_BACKEND_ARM */
+#endif /* NNP_BACKEND_ARM || NNP_BACKEND_X86_64 */
 
 struct cxgemm {
 #if !NNP_INFERENCE_ONLY
@@ -183,11 +210,13 @@ struct hardware_info {
 	struct activations activations;
 #endif
 	struct convolution conv1x1;
+	struct depthwise depthwise;
 	struct sgemm sgemm;
+	struct q8gemm q8gemm;
 	struct sxgemm sxgemm;
-#if NNP_BACKEND_ARM
+#if NNP_BACKEND_ARM || NNP_BACKEND_X86_64
 	struct hxgemm hxgemm;
-#endif /* NNP_BACKEND_ARM */
+#endif /* NNP_BACKEND_ARM || NNP_BACKEND_X86_64 */
 	struct cxgemm cxgemm;
 #if !NNP_CONVOLUTION_ONLY
 	struct sdotxf sdotxf;
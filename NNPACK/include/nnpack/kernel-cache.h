@@ -0,0 +1,73 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Identifies a kernel transform in the kernel cache: the kernel (by address and by a hash of its contents, so that
+ * kernels updated in place are transformed again), the layer shape, and the algorithm. The backend and the blocking
+ * parameters, which also determine the layout of transformed kernels, are fixed for the process.
+ * Keys must be built by nnp_kernel_cache_key, which zeroes the padding between fields.
+ */
+struct nnp_kernel_cache_key {
+	const float* kernel;
+	uint64_t kernel_hash;
+	size_t batch_size;
+	size_t groups;
+	size_t input_channels;
+	size_t output_channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	struct nnp_size kernel_dilation;
+	struct nnp_size output_subsampling;
+	enum nnp_convolution_algorithm algorithm;
+	enum nnp_activation activation;
+	bool channels_last;
+};
+
+void nnp_kernel_cache_key(
+	struct nnp_kernel_cache_key* key,
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	enum nnp_activation activation,
+	bool channels_last,
+	const float* kernel);
+
+/* Returns the memory budget of the kernel cache; 0 means that the cache is disabled */
+size_t nnp_kernel_cache_budget(void);
+
+/*
+ * Looks up a kernel transform and counts a hit or a miss. On a hit, the entry is marked as used, and is not evicted
+ * until it is released with nnp_kernel_cache_release. Returns NULL on a miss.
+ */
+const void* nnp_kernel_cache_acquire(const struct nnp_kernel_cache_key* key);
+
+/*
+ * Inserts a kernel transform allocated with allocate_memory, evicting least recently used entries to stay within the
+ * budget. On success, the cache owns the transform, and the entry is acquired as by nnp_kernel_cache_acquire.
+ * Returns false, and leaves the transform to the caller, if it can not fit into the budget.
+ */
+bool nnp_kernel_cache_insert(const struct nnp_kernel_cache_key* key, void* transformed_kernel, size_t transformed_kernel_size);
+
+/* Releases an entry returned by nnp_kernel_cache_acquire or inserted by nnp_kernel_cache_insert */
+void nnp_kernel_cache_release(const void* transformed_kernel);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
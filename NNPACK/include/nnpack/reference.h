@@ -22,6 +22,50 @@ void nnp_convolution_output__reference(
 	float output_pointer[],
 	pthreadpool_t threadpool);
 
+void nnp_grouped_convolution_output__reference(
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float input_pointer[],
+	const float kernel_pointer[],
+	const float bias[],
+	float output_pointer[],
+	pthreadpool_t threadpool);
+
+void nnp_dilated_convolution_output__reference(
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float input_pointer[],
+	const float kernel_pointer[],
+	const float bias[],
+	float output_pointer[],
+	pthreadpool_t threadpool);
+
+void nnp_depthwise_convolution_output__reference(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float input_pointer[],
+	const float kernel_pointer[],
+	const float bias[],
+	float output_pointer[],
+	pthreadpool_t threadpool);
+
 void nnp_convolution_input_gradient__reference(
 	size_t batch_size,
 	size_t input_channels,
@@ -10,6 +10,10 @@ static inline float maxf(float a, float b) {
 	return a > b ? a : b;
 }
 
+static inline float minf(float a, float b) {
+	return a > b ? b : a;
+}
+
 static inline size_t doz(size_t a, size_t b) {
 	return a > b ? a - b : 0;
 }
@@ -66,6 +66,24 @@ static inline enum nnp_status validate_convolution_arguments(
 				}
 			}
 			break;
+		case nnp_activation_relu6:
+			if (activation_parameters != NULL) {
+				return nnp_status_invalid_activation_parameters;
+			}
+			break;
+		case nnp_activation_clamp:
+		{
+			if (activation_parameters == NULL) {
+				return nnp_status_invalid_activation_parameters;
+			}
+			const struct nnp_clamp_parameters* clamp_parameters = (const struct nnp_clamp_parameters*) activation_parameters;
+			if (isnan(clamp_parameters->output_min) || isnan(clamp_parameters->output_max) ||
+				clamp_parameters->output_min > clamp_parameters->output_max)
+			{
+				return nnp_status_invalid_activation_parameters;
+			}
+			break;
+		}
 		default:
 			return nnp_status_invalid_activation;
 	}
@@ -73,6 +91,51 @@ static inline enum nnp_status validate_convolution_arguments(
 	return nnp_status_success;
 }
 
+static inline enum nnp_status validate_convolution_groups(
+	size_t groups, size_t input_channels, size_t output_channels)
+{
+	if (groups == 0) {
+		return nnp_status_invalid_groups;
+	}
+
+	if (input_channels % groups != 0 || output_channels % groups != 0) {
+		return nnp_status_invalid_groups;
+	}
+
+	return nnp_status_success;
+}
+
+static inline enum nnp_status validate_convolution_dilation(
+	struct nnp_size kernel_dilation)
+{
+	if (min(kernel_dilation.height, kernel_dilation.width) == 0) {
+		return nnp_status_invalid_kernel_dilation;
+	}
+
+	return nnp_status_success;
+}
+
+static inline enum nnp_status validate_q8_convolution_quantization(
+	size_t output_channels, const struct nnp_q8_convolution_parameters* quantization)
+{
+	if (quantization == NULL || quantization->requantization_scales == NULL) {
+		return nnp_status_invalid_quantization_parameters;
+	}
+
+	if (quantization->output_min > quantization->output_max) {
+		return nnp_status_invalid_quantization_parameters;
+	}
+
+	for (size_t output_channel = 0; output_channel < output_channels; output_channel++) {
+		const float scale = quantization->requantization_scales[output_channel];
+		if (!isfinite(scale) || !(scale > 0.0f)) {
+			return nnp_status_invalid_quantization_parameters;
+		}
+	}
+
+	return nnp_status_success;
+}
+
 static inline enum nnp_status validate_fully_connected_arguments(
 	size_t batch_size, size_t input_channels, size_t output_channels)
 {
@@ -161,6 +224,32 @@ static inline enum nnp_status validate_relu_arguments(
 	return nnp_status_success;
 }
 
+static inline enum nnp_status validate_nchwc_layout_arguments(
+	size_t batch_size, size_t channels, struct nnp_size image_size)
+{
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+
+	if (!nnp_hwinfo.supported) {
+		return nnp_status_unsupported_hardware;
+	}
+
+	if (batch_size == 0) {
+		return nnp_status_invalid_batch_size;
+	}
+
+	if (channels == 0) {
+		return nnp_status_invalid_channels;
+	}
+
+	if (min(image_size.height, image_size.width) == 0) {
+		return nnp_status_invalid_input_size;
+	}
+
+	return nnp_status_success;
+}
+
 static inline enum nnp_status validate_softmax_arguments(
 	size_t batch_size, size_t channels)
 {
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Library-owned scratch memory for calls which do not get a workspace buffer from the caller.
+ * The returned block is aligned on 64 bytes and must be returned with nnp_workspace_release_block
+ * with the same size once the computation finishes.
+ */
+void* nnp_workspace_acquire_block(size_t memory_size);
+void nnp_workspace_release_block(void* memory_block, size_t memory_size);
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
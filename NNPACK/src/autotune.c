@@ -0,0 +1,621 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/autotune.h>
+
+#include <nnpack/validation.h>
+
+/*
+ * Tuning cache.
+ *
+ * Maps a layer shape and thread count to the fastest algorithm and transform strategy measured on this machine.
+ * Networks have few distinct layer shapes, so the cache is a small array with linear search.
+ */
+
+/* Number of timed runs per candidate; the fastest run counts */
+#define NNP_AUTOTUNE_REPEATS 3
+
+/* Environment variable with the path of the tuning file to load at initialization and to update at deinitialization */
+#define NNP_AUTOTUNE_FILE_VARIABLE "NNPACK_TUNING_FILE"
+
+#define NNP_AUTOTUNE_FILE_HEADER "# NNPACK convolution tuning file"
+#define NNP_AUTOTUNE_FILE_COLUMNS \
+	"# batch input_channels output_channels input_height input_width " \
+	"padding_top padding_right padding_bottom padding_left kernel_height kernel_width " \
+	"subsampling_height subsampling_width activation threads algorithm transform_strategy"
+
+struct tuning_entry {
+	struct nnp_convolution_shape shape;
+	size_t threads_count;
+	enum nnp_convolution_algorithm algorithm;
+	enum nnp_convolution_transform_strategy transform_strategy;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	enum nnp_autotune_mode mode;
+	/* Set when entries were tuned since the cache was last loaded or saved */
+	bool modified;
+	size_t entries_count;
+	size_t entries_capacity;
+	struct tuning_entry* entries;
+} tuning_cache = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.mode = nnp_autotune_mode_cached,
+};
+
+static const enum nnp_convolution_algorithm candidate_algorithms[] = {
+	nnp_convolution_algorithm_wt8x8,
+#if NNP_BACKEND_ARM || NNP_BACKEND_X86_64
+	nnp_convolution_algorithm_wt8x8_fp16,
+#endif
+	nnp_convolution_algorithm_wt6x6,
+	nnp_convolution_algorithm_wt4x4,
+	nnp_convolution_algorithm_ft8x8,
+	nnp_convolution_algorithm_ft16x16,
+	nnp_convolution_algorithm_implicit_gemm,
+	nnp_convolution_algorithm_direct,
+};
+
+static const enum nnp_convolution_transform_strategy candidate_transform_strategies[] = {
+	nnp_convolution_transform_strategy_compute,
+	nnp_convolution_transform_strategy_reuse,
+};
+
+static inline bool equal_shapes(const struct nnp_convolution_shape a[restrict static 1], const struct nnp_convolution_shape b[restrict static 1]) {
+	return a->batch_size == b->batch_size &&
+		a->input_channels == b->input_channels &&
+		a->output_channels == b->output_channels &&
+		a->input_size.height == b->input_size.height && a->input_size.width == b->input_size.width &&
+		a->input_padding.top == b->input_padding.top && a->input_padding.right == b->input_padding.right &&
+		a->input_padding.bottom == b->input_padding.bottom && a->input_padding.left == b->input_padding.left &&
+		a->kernel_size.height == b->kernel_size.height && a->kernel_size.width == b->kernel_size.width &&
+		a->output_subsampling.height == b->output_subsampling.height &&
+		a->output_subsampling.width == b->output_subsampling.width &&
+		a->activation == b->activation;
+}
+
+/* Must be called with the cache mutex locked */
+static struct tuning_entry* find_entry(const struct nnp_convolution_shape shape[restrict static 1], size_t threads_count) {
+	for (size_t i = 0; i < tuning_cache.entries_count; i++) {
+		struct tuning_entry* entry = &tuning_cache.entries[i];
+		if (entry->threads_count == threads_count && equal_shapes(&entry->shape, shape)) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/* Must be called with the cache mutex locked */
+static enum nnp_status store_entry(const struct tuning_entry entry[restrict static 1]) {
+	struct tuning_entry* existing_entry = find_entry(&entry->shape, entry->threads_count);
+	if (existing_entry != NULL) {
+		*existing_entry = *entry;
+		return nnp_status_success;
+	}
+
+	if (tuning_cache.entries_count == tuning_cache.entries_capacity) {
+		const size_t entries_capacity = max(tuning_cache.entries_capacity * 2, 16);
+		struct tuning_entry* entries = realloc(tuning_cache.entries, entries_capacity * sizeof(struct tuning_entry));
+		if (entries == NULL) {
+			return nnp_status_out_of_memory;
+		}
+		tuning_cache.entries = entries;
+		tuning_cache.entries_capacity = entries_capacity;
+	}
+	tuning_cache.entries[tuning_cache.entries_count++] = *entry;
+	return nnp_status_success;
+}
+
+bool nnp_autotune_lookup(
+	const struct nnp_convolution_shape* shape,
+	size_t threads_count,
+	enum nnp_convolution_algorithm* algorithm,
+	enum nnp_convolution_transform_strategy* transform_strategy)
+{
+	bool found = false;
+	pthread_mutex_lock(&tuning_cache.mutex);
+	if (tuning_cache.mode != nnp_autotune_mode_disabled) {
+		const struct tuning_entry* entry = find_entry(shape, threads_count);
+		if (entry != NULL) {
+			*algorithm = entry->algorithm;
+			if (transform_strategy != NULL) {
+				*transform_strategy = entry->transform_strategy;
+			}
+			found = true;
+		}
+	}
+	pthread_mutex_unlock(&tuning_cache.mutex);
+	return found;
+}
+
+enum nnp_status nnp_autotune_select(
+	const struct nnp_convolution_shape* shape,
+	pthreadpool_t threadpool,
+	enum nnp_convolution_algorithm* algorithm,
+	enum nnp_convolution_transform_strategy* transform_strategy)
+{
+	if (nnp_autotune_lookup(shape, nnp_autotune_threads_count(threadpool), algorithm, transform_strategy)) {
+		return nnp_status_success;
+	}
+
+	pthread_mutex_lock(&tuning_cache.mutex);
+	const enum nnp_autotune_mode mode = tuning_cache.mode;
+	pthread_mutex_unlock(&tuning_cache.mutex);
+	if (mode != nnp_autotune_mode_measure) {
+		return nnp_status_success;
+	}
+
+	enum nnp_convolution_algorithm tuned_algorithm;
+	enum nnp_convolution_transform_strategy tuned_transform_strategy;
+	const enum nnp_status status = nnp_convolution_autotune(
+		shape->batch_size, shape->input_channels, shape->output_channels,
+		shape->input_size, shape->input_padding, shape->kernel_size, shape->output_subsampling,
+		shape->activation,
+		threadpool,
+		&tuned_algorithm, &tuned_transform_strategy);
+	switch (status) {
+		case nnp_status_success:
+			*algorithm = tuned_algorithm;
+			if (transform_strategy != NULL) {
+				*transform_strategy = tuned_transform_strategy;
+			}
+			return nnp_status_success;
+		case nnp_status_unsupported_algorithm:
+			/* No algorithm supports the shape: let the caller report the error */
+			return nnp_status_success;
+		default:
+			return status;
+	}
+}
+
+enum nnp_status nnp_autotune_set_mode(enum nnp_autotune_mode mode) {
+	switch (mode) {
+		case nnp_autotune_mode_disabled:
+		case nnp_autotune_mode_cached:
+		case nnp_autotune_mode_measure:
+			break;
+		default:
+			return nnp_status_invalid_algorithm;
+	}
+
+	pthread_mutex_lock(&tuning_cache.mutex);
+	tuning_cache.mode = mode;
+	pthread_mutex_unlock(&tuning_cache.mutex);
+	return nnp_status_success;
+}
+
+/*
+ * Activation parameters for measurements. The tuning cache is keyed by the kind of activation, as its cost in output
+ * transforms and epilogues does not depend on the parameters.
+ */
+static const void* measurement_activation_parameters(enum nnp_activation activation) {
+	static const struct nnp_clamp_parameters clamp_parameters = { .output_min = 0.0f, .output_max = 6.0f };
+	return activation == nnp_activation_clamp ? &clamp_parameters : NULL;
+}
+
+/*
+ * Measures the fastest of NNP_AUTOTUNE_REPEATS runs of a candidate, after a warm-up run.
+ * Returns an unsupported_* status if the candidate does not support the shape.
+ */
+static enum nnp_status measure_candidate(
+	const struct nnp_convolution_shape shape[restrict static 1],
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	pthreadpool_t threadpool,
+	double time[restrict static 1])
+{
+	void* transformed_kernel = NULL;
+	size_t transformed_kernel_size = 0;
+	enum nnp_status status = nnp_status_success;
+
+	if (transform_strategy == nnp_convolution_transform_strategy_reuse) {
+		/* The kernel transform is amortized over calls, and is not timed */
+		status = nnp_convolution_inference_batch(
+			algorithm, nnp_convolution_transform_strategy_precompute,
+			shape->batch_size, shape->input_channels, shape->output_channels,
+			shape->input_size, shape->input_padding, shape->kernel_size, shape->output_subsampling,
+			NULL, NULL, NULL, NULL, NULL, &transformed_kernel_size,
+			shape->activation, measurement_activation_parameters(shape->activation),
+			threadpool, NULL);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+
+		transformed_kernel = allocate_memory(transformed_kernel_size);
+		if (transformed_kernel == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+
+		status = nnp_convolution_inference_batch(
+			algorithm, nnp_convolution_transform_strategy_precompute,
+			shape->batch_size, shape->input_channels, shape->output_channels,
+			shape->input_size, shape->input_padding, shape->kernel_size, shape->output_subsampling,
+			NULL, kernel, NULL, NULL, transformed_kernel, &transformed_kernel_size,
+			shape->activation, measurement_activation_parameters(shape->activation),
+			threadpool, NULL);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+		kernel = transformed_kernel;
+	}
+
+	*time = 0.0;
+	for (size_t iteration = 0; iteration <= NNP_AUTOTUNE_REPEATS; iteration++) {
+		const double start = read_timer();
+		status = nnp_convolution_inference_batch(
+			algorithm, transform_strategy,
+			shape->batch_size, shape->input_channels, shape->output_channels,
+			shape->input_size, shape->input_padding, shape->kernel_size, shape->output_subsampling,
+			input, kernel, bias, output,
+			NULL, NULL,
+			shape->activation, measurement_activation_parameters(shape->activation),
+			threadpool, NULL);
+		const double elapsed = read_timer() - start;
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+
+		/* The first iteration warms up caches and the workspace arena */
+		if (iteration == 1 || (iteration > 1 && elapsed < *time)) {
+			*time = elapsed;
+		}
+	}
+
+cleanup:
+	release_memory(transformed_kernel, transformed_kernel_size);
+	return status;
+}
+
+enum nnp_status nnp_convolution_autotune(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	enum nnp_activation activation,
+	pthreadpool_t threadpool,
+	enum nnp_convolution_algorithm* algorithm_out,
+	enum nnp_convolution_transform_strategy* transform_strategy_out)
+{
+	void* memory_block = NULL;
+	size_t memory_size = 0;
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_convolution_arguments(
+		batch_size, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		activation, measurement_activation_parameters(activation));
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	const struct nnp_convolution_shape shape = {
+		.batch_size = batch_size,
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.kernel_size = kernel_size,
+		.output_subsampling = output_subsampling,
+		.activation = activation,
+	};
+	const struct nnp_size output_size = {
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
+	};
+
+	/* Synthetic tensors for measurements */
+	const size_t input_elements = batch_size * input_channels * input_size.height * input_size.width;
+	const size_t kernel_elements = output_channels * input_channels * kernel_size.height * kernel_size.width;
+	const size_t output_elements = batch_size * output_channels * output_size.height * output_size.width;
+	const size_t input_offset = 0;
+	const size_t kernel_offset = round_up(input_offset + input_elements, 16);
+	const size_t bias_offset = round_up(kernel_offset + kernel_elements, 16);
+	const size_t output_offset = round_up(bias_offset + output_channels, 16);
+	memory_size = (output_offset + output_elements) * sizeof(float);
+	memory_block = allocate_memory(memory_size);
+	if (memory_block == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+
+	float* input = (float*) memory_block + input_offset;
+	float* kernel = (float*) memory_block + kernel_offset;
+	float* bias = (float*) memory_block + bias_offset;
+	float* output = (float*) memory_block + output_offset;
+	/* Non-trivial normal values, so that no backend hits a denormal or zero fast path */
+	for (size_t i = 0; i < output_offset; i++) {
+		((float*) memory_block)[i] = (float) (int) (i % 17 + 1) * 0.0625f;
+	}
+
+	bool found = false;
+	struct tuning_entry best_entry = {
+		.shape = shape,
+		.threads_count = nnp_autotune_threads_count(threadpool),
+	};
+	double best_time = 0.0;
+	for (size_t i = 0; i < NNP_COUNT_OF(candidate_algorithms); i++) {
+		for (size_t j = 0; j < NNP_COUNT_OF(candidate_transform_strategies); j++) {
+			double time;
+			status = measure_candidate(&shape,
+				candidate_algorithms[i], candidate_transform_strategies[j],
+				input, kernel, bias, output,
+				threadpool, &time);
+			switch (status) {
+				case nnp_status_success:
+					break;
+				case nnp_status_unsupported_algorithm:
+				case nnp_status_unsupported_transform_strategy:
+					continue;
+				default:
+					goto cleanup;
+			}
+
+			if (!found || time < best_time) {
+				found = true;
+				best_time = time;
+				best_entry.algorithm = candidate_algorithms[i];
+				best_entry.transform_strategy = candidate_transform_strategies[j];
+			}
+		}
+	}
+	if (!found) {
+		status = nnp_status_unsupported_algorithm;
+		goto cleanup;
+	}
+
+	pthread_mutex_lock(&tuning_cache.mutex);
+	status = store_entry(&best_entry);
+	if (status == nnp_status_success) {
+		tuning_cache.modified = true;
+	}
+	pthread_mutex_unlock(&tuning_cache.mutex);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	if (algorithm_out != NULL) {
+		*algorithm_out = best_entry.algorithm;
+	}
+	if (transform_strategy_out != NULL) {
+		*transform_strategy_out = best_entry.transform_strategy;
+	}
+
+cleanup:
+	release_memory(memory_block, memory_size);
+	return status;
+}
+
+static const char* algorithm_name(enum nnp_convolution_algorithm algorithm) {
+	switch (algorithm) {
+		case nnp_convolution_algorithm_ft8x8:
+			return "ft8x8";
+		case nnp_convolution_algorithm_ft16x16:
+			return "ft16x16";
+		case nnp_convolution_algorithm_wt8x8:
+			return "wt8x8";
+		case nnp_convolution_algorithm_implicit_gemm:
+			return "implicit-gemm";
+		case nnp_convolution_algorithm_direct:
+			return "direct";
+		case nnp_convolution_algorithm_wt8x8_fp16:
+			return "wt8x8-fp16";
+		case nnp_convolution_algorithm_wt4x4:
+			return "wt4x4";
+		case nnp_convolution_algorithm_wt6x6:
+			return "wt6x6";
+		default:
+			return NULL;
+	}
+}
+
+static const char* transform_strategy_name(enum nnp_convolution_transform_strategy transform_strategy) {
+	switch (transform_strategy) {
+		case nnp_convolution_transform_strategy_compute:
+			return "compute";
+		case nnp_convolution_transform_strategy_reuse:
+			return "reuse";
+		default:
+			return NULL;
+	}
+}
+
+static const char* activation_name(enum nnp_activation activation) {
+	switch (activation) {
+		case nnp_activation_identity:
+			return "identity";
+		case nnp_activation_relu:
+			return "relu";
+		case nnp_activation_relu6:
+			return "relu6";
+		case nnp_activation_clamp:
+			return "clamp";
+		default:
+			return NULL;
+	}
+}
+
+static bool parse_algorithm(const char* name, enum nnp_convolution_algorithm algorithm[restrict static 1]) {
+	for (size_t i = 0; i < NNP_COUNT_OF(candidate_algorithms); i++) {
+		if (strcmp(name, algorithm_name(candidate_algorithms[i])) == 0) {
+			*algorithm = candidate_algorithms[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool parse_transform_strategy(const char* name, enum nnp_convolution_transform_strategy transform_strategy[restrict static 1]) {
+	for (size_t i = 0; i < NNP_COUNT_OF(candidate_transform_strategies); i++) {
+		if (strcmp(name, transform_strategy_name(candidate_transform_strategies[i])) == 0) {
+			*transform_strategy = candidate_transform_strategies[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool parse_activation(const char* name, enum nnp_activation activation[restrict static 1]) {
+	static const enum nnp_activation activations[] = {
+		nnp_activation_identity,
+		nnp_activation_relu,
+		nnp_activation_relu6,
+		nnp_activation_clamp,
+	};
+	for (size_t i = 0; i < NNP_COUNT_OF(activations); i++) {
+		if (strcmp(name, activation_name(activations[i])) == 0) {
+			*activation = activations[i];
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool parse_entry(const char* line, struct tuning_entry entry[restrict static 1]) {
+	char activation[16], algorithm[16], transform_strategy[16];
+	const int fields = sscanf(line,
+		"%zu %zu %zu %zu %zu %zu %zu %zu %zu %zu %zu %zu %zu %15s %zu %15s %15s",
+		&entry->shape.batch_size, &entry->shape.input_channels, &entry->shape.output_channels,
+		&entry->shape.input_size.height, &entry->shape.input_size.width,
+		&entry->shape.input_padding.top, &entry->shape.input_padding.right,
+		&entry->shape.input_padding.bottom, &entry->shape.input_padding.left,
+		&entry->shape.kernel_size.height, &entry->shape.kernel_size.width,
+		&entry->shape.output_subsampling.height, &entry->shape.output_subsampling.width,
+		activation, &entry->threads_count, algorithm, transform_strategy);
+	if (fields != 17) {
+		return false;
+	}
+
+	return parse_activation(activation, &entry->shape.activation) &&
+		parse_algorithm(algorithm, &entry->algorithm) &&
+		parse_transform_strategy(transform_strategy, &entry->transform_strategy) &&
+		validate_convolution_arguments(
+			entry->shape.batch_size, entry->shape.input_channels, entry->shape.output_channels,
+			entry->shape.input_size, entry->shape.input_padding, entry->shape.kernel_size,
+			entry->shape.output_subsampling,
+			entry->shape.activation, measurement_activation_parameters(entry->shape.activation)) == nnp_status_success;
+}
+
+enum nnp_status nnp_autotune_load(const char* path) {
+	if (path == NULL) {
+		return nnp_status_io_error;
+	}
+
+	FILE* file = fopen(path, "r");
+	if (file == NULL) {
+		return nnp_status_io_error;
+	}
+
+	enum nnp_status status = nnp_status_success;
+	char line[256];
+	pthread_mutex_lock(&tuning_cache.mutex);
+	while (fgets(line, sizeof(line), file) != NULL) {
+		const char* text = line;
+		while (*text == ' ' || *text == '\t') {
+			text++;
+		}
+		if (*text == '#' || *text == '\n' || *text == '\r' || *text == '\0') {
+			continue;
+		}
+
+		struct tuning_entry entry;
+		if (!parse_entry(text, &entry)) {
+			status = nnp_status_invalid_file_format;
+			break;
+		}
+		status = store_entry(&entry);
+		if (status != nnp_status_success) {
+			break;
+		}
+	}
+	if (status == nnp_status_success && ferror(file)) {
+		status = nnp_status_io_error;
+	}
+	pthread_mutex_unlock(&tuning_cache.mutex);
+
+	fclose(file);
+	return status;
+}
+
+enum nnp_status nnp_autotune_save(const char* path) {
+	if (path == NULL) {
+		return nnp_status_io_error;
+	}
+
+	FILE* file = fopen(path, "w");
+	if (file == NULL) {
+		return nnp_status_io_error;
+	}
+
+	bool failed = fprintf(file, "%s\n%s\n", NNP_AUTOTUNE_FILE_HEADER, NNP_AUTOTUNE_FILE_COLUMNS) < 0;
+	pthread_mutex_lock(&tuning_cache.mutex);
+	for (size_t i = 0; i < tuning_cache.entries_count && !failed; i++) {
+		const struct tuning_entry* entry = &tuning_cache.entries[i];
+		failed = fprintf(file, "%zu %zu %zu %zu %zu %zu %zu %zu %zu %zu %zu %zu %zu %s %zu %s %s\n",
+			entry->shape.batch_size, entry->shape.input_channels, entry->shape.output_channels,
+			entry->shape.input_size.height, entry->shape.input_size.width,
+			entry->shape.input_padding.top, entry->shape.input_padding.right,
+			entry->shape.input_padding.bottom, entry->shape.input_padding.left,
+			entry->shape.kernel_size.height, entry->shape.kernel_size.width,
+			entry->shape.output_subsampling.height, entry->shape.output_subsampling.width,
+			activation_name(entry->shape.activation), entry->threads_count,
+			algorithm_name(entry->algorithm), transform_strategy_name(entry->transform_strategy)) < 0;
+	}
+	if (!failed) {
+		tuning_cache.modified = false;
+	}
+	pthread_mutex_unlock(&tuning_cache.mutex);
+
+	if (fclose(file) != 0) {
+		failed = true;
+	}
+	return failed ? nnp_status_io_error : nnp_status_success;
+}
+
+enum nnp_status nnp_autotune_reset(void) {
+	pthread_mutex_lock(&tuning_cache.mutex);
+	free(tuning_cache.entries);
+	tuning_cache.entries = NULL;
+	tuning_cache.entries_count = 0;
+	tuning_cache.entries_capacity = 0;
+	tuning_cache.modified = false;
+	pthread_mutex_unlock(&tuning_cache.mutex);
+	return nnp_status_success;
+}
+
+void nnp_autotune_initialize(void) {
+	const char* path = getenv(NNP_AUTOTUNE_FILE_VARIABLE);
+	if (path != NULL) {
+		/* The file does not exist before the first tuning run, so failures are not reported */
+		nnp_autotune_load(path);
+	}
+}
+
+void nnp_autotune_deinitialize(void) {
+	const char* path = getenv(NNP_AUTOTUNE_FILE_VARIABLE);
+	pthread_mutex_lock(&tuning_cache.mutex);
+	const bool modified = tuning_cache.modified;
+	pthread_mutex_unlock(&tuning_cache.mutex);
+	if (path != NULL && modified) {
+		nnp_autotune_save(path);
+	}
+	nnp_autotune_reset();
+}
@@ -9,11 +9,21 @@
 #include <nnpack/macros.h>
 #include <nnpack/utils.h>
 #include <nnpack/system.h>
+#include <nnpack/workspace.h>
+#include <nnpack/autotune.h>
+#include <nnpack/kernel-cache.h>
 
 #include <nnpack/hwinfo.h>
+#include <nnpack/blocking.h>
 #include <nnpack/activations.h>
 #include <nnpack/validation.h>
 
+/*
+ * Channels-last tensors are staged on the stack one tile at a time. This bounds both the largest tile of the tiled
+ * algorithms (16x16 for FFT16x16) and the largest SGEMM micro-tile (mr x nr) of any backend.
+ */
+#define MAX_TILE_ELEMENTS (16 * 16)
+
 
 struct NNP_CACHE_ALIGN kernel_transform_context {
 	nnp_transform_2d_with_offset transform_function;
@@ -24,6 +34,8 @@ struct NNP_CACHE_ALIGN kernel_transform_context {
 	size_t input_channels;
 	size_t input_channels_block_size;
 	size_t output_channels;
+	size_t group_output_channels;
+	struct fxdiv_divisor_size_t output_channels_group_range;
 	struct nnp_size kernel_size;
 };
 
@@ -36,8 +48,15 @@ static void compute_kernel_transform(
 	const size_t input_channels             = context->input_channels;
 	const size_t input_channels_block_size  = context->input_channels_block_size;
 	const size_t output_channels            = context->output_channels;
+	const size_t group_output_channels      = context->group_output_channels;
 	const struct nnp_size kernel_size       = context->kernel_size;
 
+	/* Output channels of each group span a whole number of subblocks in the iteration space */
+	const struct fxdiv_result_size_t group_subblock =
+		fxdiv_divide_size_t(output_channels_subblock_start, context->output_channels_group_range);
+	output_channels_subblock_start = group_subblock.quotient * group_output_channels + group_subblock.remainder;
+	output_channels_subblock_size = min(output_channels_subblock_size, group_output_channels - group_subblock.remainder);
+
 	const float (*kernel)[input_channels][kernel_size.width * kernel_size.height] =
 		(const float(*)[input_channels][kernel_size.width * kernel_size.height]) context->kernel;
 	void* kernel_transform                          = context->kernel_transform;
@@ -62,10 +81,18 @@ struct NNP_CACHE_ALIGN input_transform_context {
 
 	const size_t tuple_size;
 	const size_t tiles_count;
+	/* Index of the first tile of the stream; input transforms are addressed relative to it */
+	const size_t tiles_start;
+	const struct fxdiv_divisor_size_t tiles_per_image;
 	const struct fxdiv_divisor_size_t tiles_x_count;
+	const size_t groups;
+	const size_t input_channels;
+	const size_t group_input_channels;
 	const size_t input_channels_block_start;
-	const size_t input_channels_block_size;
+	const struct fxdiv_divisor_size_t input_channels_block_size;
 	const struct nnp_size input_size;
+	const size_t input_channel_stride;
+	const size_t input_pixel_stride;
 	const size_t input_padding_left;
 	const size_t input_padding_top;
 	const struct nnp_size input_tile;
@@ -74,29 +101,44 @@ struct NNP_CACHE_ALIGN input_transform_context {
 
 static void compute_input_transform(
 	const struct input_transform_context context[restrict static 1],
-	size_t input_channels_block_offset, size_t tiles_subblock_start,
-	size_t input_channels_block_range,  size_t tiles_subblock_size)
+	size_t group_input_channels_block_offset, size_t tiles_subblock_start,
+	size_t group_input_channels_block_range,  size_t tiles_subblock_size)
 {
-	const size_t tuple_size                         = context->tuple_size;
-	const size_t tiles_count                        = context->tiles_count;
-	const struct fxdiv_divisor_size_t tiles_x_count = context->tiles_x_count;
-	const size_t input_channels_block_start         = context->input_channels_block_start;
-	const size_t input_channels_block_size          = context->input_channels_block_size;
-	const struct nnp_size input_size                = context->input_size;
-	const size_t input_padding_left                 = context->input_padding_left;
-	const size_t input_padding_top                  = context->input_padding_top;
-	const struct nnp_size input_tile                = context->input_tile;
-	const struct nnp_size input_tile_step           = context->input_tile_step;
-
-	const float (*input)[input_size.height][input_size.width] =
-		(const float(*)[input_size.height][input_size.width]) context->input;
+	const size_t tuple_size                           = context->tuple_size;
+	const size_t tiles_count                          = context->tiles_count;
+	const size_t tiles_start                          = context->tiles_start;
+	const struct fxdiv_divisor_size_t tiles_per_image = context->tiles_per_image;
+	const struct fxdiv_divisor_size_t tiles_x_count   = context->tiles_x_count;
+	const size_t groups                               = context->groups;
+	const size_t input_channels                       = context->input_channels;
+	const size_t group_input_channels                 = context->group_input_channels;
+	const size_t input_channels_block_start           = context->input_channels_block_start;
+	const size_t input_channels_block_size            = context->input_channels_block_size.value;
+	const struct nnp_size input_size                  = context->input_size;
+	const size_t input_channel_stride                 = context->input_channel_stride;
+	const size_t input_pixel_stride                   = context->input_pixel_stride;
+	const size_t input_padding_left                   = context->input_padding_left;
+	const size_t input_padding_top                    = context->input_padding_top;
+	const struct nnp_size input_tile                  = context->input_tile;
+	const struct nnp_size input_tile_step             = context->input_tile_step;
+
+	const float* input                              = context->input;
 	void* input_transform                           = context->input_transform;
 	nnp_transform_2d_with_offset transform_function = context->transform_function;
 
-	const size_t input_channel = input_channels_block_start + input_channels_block_offset;
+	/* Input transforms of each group are stored contiguously, and share the tuple stride of the whole block */
+	const struct fxdiv_result_size_t group_offset =
+		fxdiv_divide_size_t(group_input_channels_block_offset, context->input_channels_block_size);
+	const size_t group = group_offset.quotient;
+	const size_t input_channels_block_offset = group_offset.remainder;
+	input_transform += group * tiles_count * input_channels_block_size * tuple_size;
+
+	const size_t input_channel = group * group_input_channels + input_channels_block_start + input_channels_block_offset;
 	for (size_t tiles_subblock_offset = 0; tiles_subblock_offset < tiles_subblock_size; tiles_subblock_offset += 1) {
-		const size_t tile = tiles_subblock_start + tiles_subblock_offset;
-		const struct fxdiv_result_size_t tile_xy = fxdiv_divide_size_t(tile, tiles_x_count);
+		const size_t tile = tiles_start + tiles_subblock_start + tiles_subblock_offset;
+		const struct fxdiv_result_size_t sample_tile = fxdiv_divide_size_t(tile, tiles_per_image);
+		const size_t sample = sample_tile.quotient;
+		const struct fxdiv_result_size_t tile_xy = fxdiv_divide_size_t(sample_tile.remainder, tiles_x_count);
 		const size_t tile_x = tile_xy.remainder;
 		const size_t tile_y = tile_xy.quotient;
 
@@ -111,11 +153,27 @@ static void compute_input_transform(
 		const size_t column_offset = doz(input_padding_left, output_x);
 		const size_t column_count = min(input_size.width - input_x, input_tile.width - column_offset);
 
+		const float* input_data = input + sample * input_channels * input_size.height * input_size.width +
+			input_channel * input_channel_stride + (input_y * input_size.width + input_x) * input_pixel_stride;
+		size_t input_data_stride = input_size.width;
+		float input_data_tile[MAX_TILE_ELEMENTS];
+		if (input_pixel_stride != 1) {
+			/* Channels-last input: gather this channel of the tile, and transform it as a dense tile */
+			for (size_t row = 0; row < row_count; row++) {
+				for (size_t column = 0; column < column_count; column++) {
+					input_data_tile[row * column_count + column] =
+						input_data[(row * input_size.width + column) * input_pixel_stride];
+				}
+			}
+			input_data = input_data_tile;
+			input_data_stride = column_count;
+		}
+
 		transform_function(
-			&input[input_channel][input_y][input_x],
+			input_data,
 			input_transform + (tiles_subblock_start * input_channels_block_size + input_channels_block_offset * tiles_subblock_size + tiles_subblock_offset) * tuple_size,
-			input_size.width,
-			input_channels_block_size * tiles_count * tuple_size,
+			input_data_stride,
+			groups * input_channels_block_size * tiles_count * tuple_size,
 			row_count, column_count, row_offset, column_offset);
 	}
 }
@@ -125,14 +183,28 @@ struct NNP_CACHE_ALIGN output_transform_context {
 	float* output;
 	const void* output_transform;
 	const float* bias;
+	/* Optional tensor of the same shape as output, which is added to the output before the activation */
+	const float* residual;
 
 	size_t tuple_size;
 	size_t tiles_count;
+	/* Index of the first tile of the stream; output transforms are addressed relative to it */
+	size_t tiles_start;
+	struct fxdiv_divisor_size_t tiles_per_image;
 	struct fxdiv_divisor_size_t tiles_x_count;
 	struct fxdiv_divisor_size_t tiles_block_max;
 	size_t output_channels;
+	size_t group_output_channels;
+	struct fxdiv_divisor_size_t output_channels_group_range;
 	struct nnp_size output_size;
+	size_t output_channel_stride;
+	size_t output_pixel_stride;
 	struct nnp_size output_tile;
+	struct output_activation activation;
+	bool tile_activation;
+	/* Non-overlapping max-pooling window aligned to output tiles, or 0x0 if the output is not pooled */
+	struct nnp_size pooling;
+	struct nnp_size pooled_output_size;
 };
 
 static void compute_output_transform(
@@ -142,41 +214,115 @@ static void compute_output_transform(
 {
 	const size_t tuple_size                           = context->tuple_size;
 	const size_t tiles_count                          = context->tiles_count;
+	const size_t tiles_start                          = context->tiles_start;
+	const struct fxdiv_divisor_size_t tiles_per_image = context->tiles_per_image;
 	const struct fxdiv_divisor_size_t tiles_x_count   = context->tiles_x_count;
 	const struct fxdiv_divisor_size_t tiles_block_max = context->tiles_block_max;
 	const size_t output_channels                      = context->output_channels;
+	const size_t group_output_channels                = context->group_output_channels;
 	const struct nnp_size output_size                 = context->output_size;
+	const size_t output_channel_stride                = context->output_channel_stride;
+	const size_t output_pixel_stride                  = context->output_pixel_stride;
 	const struct nnp_size output_tile                 = context->output_tile;
+	const struct output_activation activation         = context->activation;
+	const bool tile_activation                        = context->tile_activation;
+	const float* residual                             = context->residual;
+	const struct nnp_size pooling                     = context->pooling;
+	const struct nnp_size pooled_output_size          = context->pooled_output_size;
+	const bool pooled = pooling.height != 0;
+	/*
+	 * Tiles go through a dense buffer for channels-last output, for residual connections, for activations without
+	 * a fused transform, and for pooling
+	 */
+	const bool buffered_tile = output_pixel_stride != 1 || residual != NULL || tile_activation || pooled;
+
+	const struct fxdiv_result_size_t group_subblock =
+		fxdiv_divide_size_t(output_channels_subblock_start, context->output_channels_group_range);
+	output_channels_subblock_start = group_subblock.quotient * group_output_channels + group_subblock.remainder;
+	output_channels_subblock_size = min(output_channels_subblock_size, group_output_channels - group_subblock.remainder);
 
 	const size_t tiles_block_start = fxdiv_round_down_size_t(tiles_subblock_start, tiles_block_max);
 	const size_t tiles_block_size = min(tiles_count - tiles_block_start, tiles_block_max.value);
 
-	float (*output)[output_size.height][output_size.width] =
-		(float(*)[output_size.height][output_size.width]) context->output;
+	float* output                                 = context->output;
 	const void* output_transform                  = context->output_transform;
 	const float* bias                             = context->bias;
 	nnp_transform_2d_with_bias transform_function = context->transform_function;
 
 	for (size_t tiles_subblock_offset = 0; tiles_subblock_offset < tiles_subblock_size; tiles_subblock_offset += 1) {
-		const size_t tile = tiles_subblock_start + tiles_subblock_offset;
-		const struct fxdiv_result_size_t tile_xy = fxdiv_divide_size_t(tile, tiles_x_count);
+		const size_t tile = tiles_start + tiles_subblock_start + tiles_subblock_offset;
+		const struct fxdiv_result_size_t sample_tile = fxdiv_divide_size_t(tile, tiles_per_image);
+		const size_t sample = sample_tile.quotient;
+		const struct fxdiv_result_size_t tile_xy = fxdiv_divide_size_t(sample_tile.remainder, tiles_x_count);
 		const size_t tile_x = tile_xy.remainder;
 		const size_t tile_y = tile_xy.quotient;
 
 		const size_t output_x = tile_x * output_tile.width;
 		const size_t output_y = tile_y * output_tile.height;
+		const size_t row_count = min(output_tile.height, output_size.height - output_y);
+		const size_t column_count = min(output_tile.width, output_size.width - output_x);
 
 		for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset += 1) {
 			const size_t output_channel = output_channels_subblock_start + output_channels_subblock_offset;
+			const size_t output_offset = sample * output_channels * output_size.height * output_size.width +
+				output_channel * output_channel_stride + (output_y * output_size.width + output_x) * output_pixel_stride;
+			float* output_data = output + output_offset;
+			float output_data_tile[MAX_TILE_ELEMENTS];
 			transform_function(
 				output_transform +
 					(tiles_block_start * output_channels + output_channels_subblock_start * tiles_block_size + ((tiles_subblock_start - tiles_block_start) + tiles_subblock_offset) * output_channels_subblock_size + output_channels_subblock_offset) * tuple_size,
-				&output[output_channel][output_y][output_x],
+				buffered_tile ? output_data_tile : output_data,
 				&bias[output_channel],
 				tiles_count * output_channels * tuple_size,
-				output_size.width,
-				min(output_tile.height, output_size.height - output_y),
-				min(output_tile.width, output_size.width - output_x));
+				buffered_tile ? column_count : output_size.width,
+				row_count, column_count);
+			if (buffered_tile) {
+				/*
+				 * Add the residual and activate the tile while it is in L1 cache, and store (or scatter, if channels-last)
+				 * it to the output. The residual is read before the output is written, so it may alias the output.
+				 */
+				if (residual != NULL) {
+					const float* residual_data = residual + output_offset;
+					for (size_t row = 0; row < row_count; row++) {
+						for (size_t column = 0; column < column_count; column++) {
+							output_data_tile[row * column_count + column] +=
+								residual_data[(row * output_size.width + column) * output_pixel_stride];
+						}
+					}
+				}
+				if (tile_activation) {
+					activate_block(output_data_tile, row_count * column_count, activation);
+				}
+				if (pooled) {
+					/*
+					 * Output tiles are multiples of the pooling window, so every window lies within a single tile, and
+					 * only pooled pixels are stored. Windows are clipped at the bottom and right edges of the output.
+					 */
+					float* pooled_data = output +
+						(sample * output_channels + output_channel) * pooled_output_size.height * pooled_output_size.width +
+						(output_y / pooling.height) * pooled_output_size.width + output_x / pooling.width;
+					for (size_t row = 0; row < row_count; row += pooling.height) {
+						const size_t window_row_count = min(pooling.height, row_count - row);
+						for (size_t column = 0; column < column_count; column += pooling.width) {
+							const size_t window_column_count = min(pooling.width, column_count - column);
+							float pooled_value = -__builtin_inff();
+							for (size_t y = row; y < row + window_row_count; y++) {
+								for (size_t x = column; x < column + window_column_count; x++) {
+									pooled_value = maxf(pooled_value, output_data_tile[y * column_count + x]);
+								}
+							}
+							pooled_data[(row / pooling.height) * pooled_output_size.width + column / pooling.width] = pooled_value;
+						}
+					}
+				} else {
+					for (size_t row = 0; row < row_count; row++) {
+						for (size_t column = 0; column < column_count; column++) {
+							output_data[(row * output_size.width + column) * output_pixel_stride] =
+								output_data_tile[row * column_count + column];
+						}
+					}
+				}
+			}
 		}
 	}
 }
@@ -184,12 +330,16 @@ static void compute_output_transform(
 struct NNP_CACHE_ALIGN tuple_multiplication_context {
 	size_t tuple_elements;
 	size_t tuple_size;
+	size_t tiles_count;
 	size_t tiles_subblock_max;
 	size_t input_channels_block_size;
 	size_t input_channels_block_start;
 	size_t output_channels;
+	size_t group_output_channels;
 	size_t output_channels_subblock_max;
 	size_t output_channels_block_start;
+	size_t output_channels_block_size;
+	struct fxdiv_divisor_size_t output_channels_group_range;
 
 	const void* input_transform;
 	const void* kernel_transform;
@@ -206,19 +356,32 @@ static void compute_tuple_multiplication(
 {
 	const size_t tuple_elements               = context->tuple_elements;
 	const size_t tuple_size                   = context->tuple_size;
+	const size_t tiles_count                  = context->tiles_count;
 	const size_t tiles_subblock_max           = context->tiles_subblock_max;
 	const size_t input_channels_block_size    = context->input_channels_block_size;
 	const size_t input_channels_block_start   = context->input_channels_block_start;
 	const size_t output_channels              = context->output_channels;
+	const size_t group_output_channels        = context->group_output_channels;
 	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
 	const size_t output_channels_block_start  = context->output_channels_block_start;
+	const size_t output_channels_block_size   = context->output_channels_block_size;
+
+	/*
+	 * The iteration space covers the output channels block of every group, so a single dispatch balances all groups
+	 * across threads. Each group multiplies its own input transform by its own diagonal block of the kernel transform.
+	 */
+	const struct fxdiv_result_size_t group_subblock =
+		fxdiv_divide_size_t(output_channels_subblock_start, context->output_channels_group_range);
+	const size_t group = group_subblock.quotient;
+	const size_t output_channel = group * group_output_channels + output_channels_block_start + group_subblock.remainder;
+	output_channels_subblock_size = min(output_channels_subblock_size, output_channels_block_size - group_subblock.remainder);
 
 	const void* input_transform  = context->input_transform +
-		tiles_block_start * input_channels_block_size * tuple_size;
+		(group * tiles_count + tiles_block_start) * input_channels_block_size * tuple_size;
 	const void* kernel_transform = context->kernel_transform +
-		(output_channels_block_start + output_channels_subblock_start) * input_channels_block_size * tuple_size;
+		output_channel * input_channels_block_size * tuple_size;
 	void* output_transform       = context->output_transform +
-		(tiles_block_start * output_channels + (output_channels_block_start + output_channels_subblock_start) * tiles_block_size) * tuple_size;
+		(tiles_block_start * output_channels + output_channel * tiles_block_size) * tuple_size;
 
 	if (output_channels_subblock_size == output_channels_subblock_max) {
 		const nnp_fast_tuple_gemm_function fast_gemm = context->fast_gemm;
@@ -258,6 +421,8 @@ struct NNP_CACHE_ALIGN kernel_packing_context {
 	size_t reduction_size;
 	size_t reduction_block_start;
 	size_t reduction_block_size;
+	size_t group_output_channels;
+	struct fxdiv_divisor_size_t output_channels_group_range;
 };
 
 static void compute_kernel_packing(
@@ -268,6 +433,13 @@ static void compute_kernel_packing(
 	const size_t reduction_size        = context->reduction_size;
 	const size_t reduction_block_start = context->reduction_block_start;
 	const size_t reduction_block_size  = context->reduction_block_size;
+	const size_t group_output_channels = context->group_output_channels;
+
+	/* Output channels of each group span a whole number of subblocks in the iteration space */
+	const struct fxdiv_result_size_t group_subblock =
+		fxdiv_divide_size_t(output_channels_subblock_start, context->output_channels_group_range);
+	output_channels_subblock_start = group_subblock.quotient * group_output_channels + group_subblock.remainder;
+	output_channels_subblock_size = min(output_channels_subblock_size, group_output_channels - group_subblock.remainder);
 
 	const float* kernel  = context->kernel +
 		output_channels_subblock_start * reduction_size + reduction_block_offset;
@@ -284,47 +456,63 @@ struct NNP_CACHE_ALIGN input_packing_context {
 	float* packed_input;
 
 	size_t simd_width;
+	size_t group_input_channels;
+	size_t packed_input_group_stride;
 	size_t reduction_block_start;
-	size_t reduction_block_size;
+	struct fxdiv_divisor_size_t reduction_block_size;
 	size_t output_image_block_start;
 	struct nnp_size input_size;
+	size_t input_channel_stride;
+	size_t input_pixel_stride;
 	size_t input_padding_top;
 	size_t input_padding_left;
 	struct fxdiv_divisor_size_t kernel_elements;
 	struct fxdiv_divisor_size_t kernel_width;
+	struct nnp_size kernel_dilation;
 	struct fxdiv_divisor_size_t output_width;
 	struct nnp_size output_subsampling;
 };
 
 static void compute_input_packing(
 	const struct input_packing_context context[restrict static 1],
-	size_t reduction_block_offset, size_t output_image_subblock_start,
-	size_t reduction_block_range,  size_t output_image_subblock_size)
+	size_t group_reduction_block_offset, size_t output_image_subblock_start,
+	size_t group_reduction_block_range,  size_t output_image_subblock_size)
 {
 	const size_t simd_width                           = context->simd_width;
+	const size_t group_input_channels                 = context->group_input_channels;
+	const size_t packed_input_group_stride            = context->packed_input_group_stride;
 	const size_t reduction_block_start                = context->reduction_block_start;
-	const size_t reduction_block_size                 = context->reduction_block_size;
+	const size_t reduction_block_size                 = context->reduction_block_size.value;
 	const size_t output_image_block_start             = context->output_image_block_start;
 	const struct nnp_size input_size                  = context->input_size;
+	const size_t input_channel_stride                 = context->input_channel_stride;
+	const size_t input_pixel_stride                   = context->input_pixel_stride;
 	const size_t input_padding_top                    = context->input_padding_top;
 	const size_t input_padding_left                   = context->input_padding_left;
 	const struct fxdiv_divisor_size_t kernel_elements = context->kernel_elements;
 	const struct fxdiv_divisor_size_t kernel_width    = context->kernel_width;
+	const struct nnp_size kernel_dilation             = context->kernel_dilation;
 	const struct fxdiv_divisor_size_t output_width    = context->output_width;
 	const struct nnp_size output_subsampling          = context->output_subsampling;
 
-	const float (*input)[input_size.height][input_size.width] =
-		(const float(*)[input_size.height][input_size.width]) context->input;
 	float* packed_input = context->packed_input;
 
 	const size_t output_image_subblock_stride = round_up_by_power_of_2(output_image_subblock_size, simd_width);
 
+	/* Inputs of all groups are packed in one pass, each group into its own part of the buffer */
+	const struct fxdiv_result_size_t group_offset =
+		fxdiv_divide_size_t(group_reduction_block_offset, context->reduction_block_size);
+	const size_t group = group_offset.quotient;
+	const size_t reduction_block_offset = group_offset.remainder;
+	packed_input += group * packed_input_group_stride;
+
 	const size_t reduction_index = reduction_block_start + reduction_block_offset;
 	const struct fxdiv_result_size_t reduction_index_divmod = fxdiv_divide_size_t(reduction_index, kernel_elements);
-	const size_t input_channel = reduction_index_divmod.quotient;
+	const size_t input_channel = group * group_input_channels + reduction_index_divmod.quotient;
 	const struct fxdiv_result_size_t kernel_xy = fxdiv_divide_size_t(reduction_index_divmod.remainder, kernel_width);
 	const size_t kernel_y = kernel_xy.quotient;
 	const size_t kernel_x = kernel_xy.remainder;
+	const float* input = context->input + input_channel * input_channel_stride;
 
 	for (size_t output_image_subblock_offset = 0; output_image_subblock_offset < output_image_subblock_size; output_image_subblock_offset += 1) {
 		const size_t output_image_index = output_image_block_start + output_image_subblock_start + output_image_subblock_offset;
@@ -332,30 +520,91 @@ static void compute_input_packing(
 		const size_t output_y = output_xy.quotient;
 		const size_t output_x = output_xy.remainder;
 
-		const size_t input_y = output_y * output_subsampling.height + kernel_y - input_padding_top;
-		const size_t input_x = output_x * output_subsampling.width  + kernel_x - input_padding_left;
+		/* Dilated kernels gather input pixels kernel_dilation apart; the dilated kernel is never materialized */
+		const size_t input_y = output_y * output_subsampling.height + kernel_y * kernel_dilation.height - input_padding_top;
+		const size_t input_x = output_x * output_subsampling.width  + kernel_x * kernel_dilation.width  - input_padding_left;
 
 		const size_t packed_index = output_image_subblock_start * reduction_block_size +
 			reduction_block_offset * output_image_subblock_stride + output_image_subblock_offset;
 		if ((input_x < input_size.width) && (input_y < input_size.height)) {
-			packed_input[packed_index] = input[input_channel][input_y][input_x];
+			packed_input[packed_index] = input[(input_y * input_size.width + input_x) * input_pixel_stride];
 		} else {
 			packed_input[packed_index] = 0.0f;
 		}
 	}
 }
 
+/*
+ * Input packing for 1x1 kernels: every reduction index is an input channel, and there is no padding,
+ * so a subblock of packed input is a copy (or, with subsampling or channels-last input, a strided gather) of one
+ * input channel.
+ */
+static void compute_pointwise_input_packing(
+	const struct input_packing_context context[restrict static 1],
+	size_t group_reduction_block_offset, size_t output_image_subblock_start,
+	size_t group_reduction_block_range,  size_t output_image_subblock_size)
+{
+	const size_t simd_width                           = context->simd_width;
+	const size_t group_input_channels                 = context->group_input_channels;
+	const size_t packed_input_group_stride            = context->packed_input_group_stride;
+	const size_t reduction_block_start                = context->reduction_block_start;
+	const size_t reduction_block_size                 = context->reduction_block_size.value;
+	const size_t output_image_block_start             = context->output_image_block_start;
+	const struct nnp_size input_size                  = context->input_size;
+	const size_t input_channel_stride                 = context->input_channel_stride;
+	const size_t input_pixel_stride                   = context->input_pixel_stride;
+	const struct fxdiv_divisor_size_t output_width    = context->output_width;
+	const struct nnp_size output_subsampling          = context->output_subsampling;
+
+	const size_t output_image_subblock_stride = round_up_by_power_of_2(output_image_subblock_size, simd_width);
+
+	const struct fxdiv_result_size_t group_offset =
+		fxdiv_divide_size_t(group_reduction_block_offset, context->reduction_block_size);
+	const size_t group = group_offset.quotient;
+	const size_t reduction_block_offset = group_offset.remainder;
+
+	const size_t input_channel = group * group_input_channels + reduction_block_start + reduction_block_offset;
+	const float* input = context->input + input_channel * input_channel_stride;
+	float* packed_input = context->packed_input + group * packed_input_group_stride +
+		output_image_subblock_start * reduction_block_size + reduction_block_offset * output_image_subblock_stride;
+
+	const size_t output_image_index = output_image_block_start + output_image_subblock_start;
+	if ((output_subsampling.height | output_subsampling.width | input_pixel_stride) == 1) {
+		memcpy(packed_input, &input[output_image_index], output_image_subblock_size * sizeof(float));
+	} else {
+		const struct fxdiv_result_size_t output_xy = fxdiv_divide_size_t(output_image_index, output_width);
+		size_t output_y = output_xy.quotient;
+		size_t output_x = output_xy.remainder;
+		for (size_t output_image_subblock_offset = 0; output_image_subblock_offset < output_image_subblock_size; output_image_subblock_offset += 1) {
+			packed_input[output_image_subblock_offset] = input[
+				(output_y * output_subsampling.height * input_size.width + output_x * output_subsampling.width) * input_pixel_stride];
+			if (++output_x == output_width.value) {
+				output_x = 0;
+				output_y += 1;
+			}
+		}
+	}
+}
+
 struct NNP_CACHE_ALIGN matrix_multiplication_context {
 	const float* packed_kernel;
 	const float* packed_input;
+	const float* bias;
+	const float* residual;
 	float* output;
+	struct output_activation activation;
 
+	size_t reduction_size;
 	size_t reduction_block_start;
 	size_t reduction_block_size;
 	size_t output_image_size;
+	size_t output_pixel_stride;
 	size_t output_image_block_start;
 	size_t output_image_subblock_max;
 	size_t output_channels_subblock_max;
+	size_t group_output_channels;
+	size_t packed_input_group_stride;
+	struct fxdiv_divisor_size_t output_channels_group_range;
 };
 
 static void compute_matrix_multiplication(
@@ -369,13 +618,43 @@ static void compute_matrix_multiplication(
 	const size_t output_image_block_start     = context->output_image_block_start;
 	const size_t output_image_subblock_max    = context->output_image_subblock_max;
 	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
+	const size_t group_output_channels        = context->group_output_channels;
+	const size_t packed_input_group_stride    = context->packed_input_group_stride;
+
+	/* Output channels of each group span a whole number of blocks, and each group multiplies its own packed input */
+	const struct fxdiv_result_size_t group_block =
+		fxdiv_divide_size_t(output_channels_block_start, context->output_channels_group_range);
+	const size_t group = group_block.quotient;
+	output_channels_block_start = group * group_output_channels + group_block.remainder;
+	output_channels_block_size = min(output_channels_block_size, group_output_channels - group_block.remainder);
 
 	const float* packed_kernel = context->packed_kernel +
 		output_channels_block_start * reduction_block_size;
-	const float* packed_input  = context->packed_input +
+	const float* packed_input  = context->packed_input + group * packed_input_group_stride +
 		output_image_subblock_start * reduction_block_size;
 	float* output              = context->output +
 		output_channels_block_start * output_image_size + output_image_block_start + output_image_subblock_start;
+	float* output_block        = output;
+	const size_t output_channels_count = output_channels_block_size;
+
+	/*
+	 * The first reduction block starts from the bias (and the residual), and the last one applies the activation, while
+	 * the output block is still in cache. Thus, the micro-kernels always accumulate into the output, and no serial pass
+	 * adds the bias.
+	 */
+	if (reduction_block_start == 0) {
+		const float* bias = context->bias + output_channels_block_start;
+		const float* residual = context->residual;
+		for (size_t output_channel = 0; output_channel < output_channels_count; output_channel += 1) {
+			const float bias_value = bias[output_channel];
+			const size_t row_offset = (output_block - context->output) + output_channel * output_image_size;
+			for (size_t index = 0; index < output_image_subblock_size; index += 1) {
+				/* The residual is read before the output is written, so it may alias the output */
+				output_block[output_channel * output_image_size + index] =
+					residual == NULL ? bias_value : bias_value + residual[row_offset + index];
+			}
+		}
+	}
 
 	if (output_image_subblock_size == output_image_subblock_max) {
 		const nnp_fast_sgemm_function fast_gemm = nnp_hwinfo.sgemm.only_mr_x_nr;
@@ -383,7 +662,7 @@ static void compute_matrix_multiplication(
 			output_channels_block_size -= output_channels_subblock_max;
 
 			fast_gemm(
-				reduction_block_size, reduction_block_start,
+				reduction_block_size, 1,
 				packed_kernel, packed_input, output,
 				output_image_size);
 
@@ -399,24 +678,124 @@ static void compute_matrix_multiplication(
 
 		full_gemm(
 			output_channels_subblock_size, output_image_subblock_size,
-			reduction_block_size, reduction_block_start,
+			reduction_block_size, 1,
 			packed_kernel, packed_input, output,
 			output_image_size);
 
 		packed_kernel += reduction_block_size * output_channels_subblock_max;
 		output        += output_image_size    * output_channels_subblock_max;
 	}
+
+	if (reduction_block_start + reduction_block_size == context->reduction_size && !is_identity_activation(context->activation)) {
+		for (size_t output_channel = 0; output_channel < output_channels_count; output_channel += 1) {
+			activate_block(output_block + output_channel * output_image_size, output_image_subblock_size, context->activation);
+		}
+	}
+}
+
+/*
+ * Matrix multiplication for a channels-last output, where the rows of output channels written by the micro-kernels are
+ * strided. Each micro-tile is accumulated in a dense buffer, loaded from the bias or the partial sums of previous
+ * reduction blocks, and scattered back to the output, with the activation on the last reduction block.
+ */
+static void compute_channels_last_matrix_multiplication(
+	const struct matrix_multiplication_context context[restrict static 1],
+	size_t output_channels_block_start, size_t output_image_subblock_start,
+	size_t output_channels_block_size,  size_t output_image_subblock_size)
+{
+	const size_t reduction_block_start        = context->reduction_block_start;
+	const size_t reduction_block_size         = context->reduction_block_size;
+	const size_t output_pixel_stride          = context->output_pixel_stride;
+	const size_t output_image_block_start     = context->output_image_block_start;
+	const size_t output_image_subblock_max    = context->output_image_subblock_max;
+	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
+	const size_t group_output_channels        = context->group_output_channels;
+	const size_t packed_input_group_stride    = context->packed_input_group_stride;
+	const bool first_reduction_block = reduction_block_start == 0;
+	const bool last_reduction_block = reduction_block_start + reduction_block_size == context->reduction_size;
+	const bool activate_output = last_reduction_block && !is_identity_activation(context->activation);
+	const struct output_activation activation = context->activation;
+
+	const struct fxdiv_result_size_t group_block =
+		fxdiv_divide_size_t(output_channels_block_start, context->output_channels_group_range);
+	const size_t group = group_block.quotient;
+	output_channels_block_start = group * group_output_channels + group_block.remainder;
+	output_channels_block_size = min(output_channels_block_size, group_output_channels - group_block.remainder);
+
+	const float* packed_kernel = context->packed_kernel +
+		output_channels_block_start * reduction_block_size;
+	const float* packed_input  = context->packed_input + group * packed_input_group_stride +
+		output_image_subblock_start * reduction_block_size;
+	const float* bias          = context->bias + output_channels_block_start;
+	float* output              = context->output +
+		(output_image_block_start + output_image_subblock_start) * output_pixel_stride + output_channels_block_start;
+	const float* residual      = context->residual == NULL ? NULL : context->residual + (output - context->output);
+
+	float output_tile[MAX_TILE_ELEMENTS];
+	while (output_channels_block_size != 0) {
+		const size_t output_channels_subblock_size = min(output_channels_block_size, output_channels_subblock_max);
+		output_channels_block_size -= output_channels_subblock_size;
+
+		for (size_t output_channel = 0; output_channel < output_channels_subblock_size; output_channel += 1) {
+			for (size_t index = 0; index < output_image_subblock_size; index += 1) {
+				float value;
+				if (first_reduction_block) {
+					value = bias[output_channel];
+					if (residual != NULL) {
+						value += residual[index * output_pixel_stride + output_channel];
+					}
+				} else {
+					value = output[index * output_pixel_stride + output_channel];
+				}
+				output_tile[output_channel * output_image_subblock_max + index] = value;
+			}
+		}
+
+		if (output_channels_subblock_size == output_channels_subblock_max && output_image_subblock_size == output_image_subblock_max) {
+			nnp_hwinfo.sgemm.only_mr_x_nr(
+				reduction_block_size, 1,
+				packed_kernel, packed_input, output_tile,
+				output_image_subblock_max);
+		} else {
+			nnp_hwinfo.sgemm.upto_mr_x_nr(
+				output_channels_subblock_size, output_image_subblock_size,
+				reduction_block_size, 1,
+				packed_kernel, packed_input, output_tile,
+				output_image_subblock_max);
+		}
+
+		for (size_t output_channel = 0; output_channel < output_channels_subblock_size; output_channel += 1) {
+			for (size_t index = 0; index < output_image_subblock_size; index += 1) {
+				const float value = output_tile[output_channel * output_image_subblock_max + index];
+				output[index * output_pixel_stride + output_channel] = activate_output ? activate(value, activation) : value;
+			}
+		}
+
+		packed_kernel += reduction_block_size * output_channels_subblock_max;
+		bias          += output_channels_subblock_max;
+		output        += output_channels_subblock_max;
+		if (residual != NULL) {
+			residual += output_channels_subblock_max;
+		}
+	}
 }
 
 struct NNP_CACHE_ALIGN direct_convolution_context {
 	const float* input;
 	const float* kernel;
+	const float* bias;
+	const float* residual;
 	float* output;
+	struct output_activation activation;
 
 	size_t image_elements;
 	size_t input_channels;
+	size_t group_input_channels;
 	size_t input_channels_block_max;
+	size_t output_channels;
+	size_t group_output_channels;
 	size_t output_channels_block_max;
+	struct fxdiv_divisor_size_t output_channels_group_range;
 
 	nnp_fast_conv_function fast_conv;
 	nnp_full_conv_function full_conv;
@@ -424,27 +803,54 @@ struct NNP_CACHE_ALIGN direct_convolution_context {
 
 static void compute_direct_convolution(
 	const struct direct_convolution_context context[restrict static 1],
-	size_t output_channels_block_start, size_t output_channels_block_size)
+	size_t sample,       size_t output_channels_block_start,
+	size_t sample_range, size_t output_channels_block_size)
 {
 	const size_t image_elements            = context->image_elements;
 	const size_t input_channels            = context->input_channels;
+	const size_t group_input_channels      = context->group_input_channels;
 	const size_t input_channels_block_max  = context->input_channels_block_max;
+	const size_t output_channels           = context->output_channels;
+	const size_t group_output_channels     = context->group_output_channels;
 	const size_t output_channels_block_max = context->output_channels_block_max;
 
-	const float* input  = context->input;
-	const float* kernel = context->kernel + output_channels_block_start * input_channels;
-	float* output       = context->output + output_channels_block_start * image_elements;
+	/* Output channels of each group span a whole number of blocks in the iteration space */
+	const struct fxdiv_result_size_t group_block =
+		fxdiv_divide_size_t(output_channels_block_start, context->output_channels_group_range);
+	const size_t group = group_block.quotient;
+	output_channels_block_start = group * group_output_channels + group_block.remainder;
+	output_channels_block_size = min(output_channels_block_size, group_output_channels - group_block.remainder);
+
+	const float* input  = context->input + (sample * input_channels + group * group_input_channels) * image_elements;
+	const float* kernel = context->kernel + output_channels_block_start * group_input_channels;
+	float* output       = context->output + (sample * output_channels + output_channels_block_start) * image_elements;
 
-	memset(output, 0, sizeof(float) * output_channels_block_size * image_elements);
+	/* Micro-kernels accumulate into the output: start from the bias and residual, so that no separate pass adds them */
+	const float* bias = context->bias + output_channels_block_start;
+	const float* residual = context->residual == NULL ? NULL : context->residual + (output - context->output);
+	for (size_t output_channel = 0; output_channel < output_channels_block_size; output_channel++) {
+		const float bias_value = bias[output_channel];
+		float* output_row = output + output_channel * image_elements;
+		if (residual != NULL) {
+			const float* residual_row = residual + output_channel * image_elements;
+			for (size_t index = 0; index < image_elements; index++) {
+				output_row[index] = bias_value + residual_row[index];
+			}
+		} else {
+			for (size_t index = 0; index < image_elements; index++) {
+				output_row[index] = bias_value;
+			}
+		}
+	}
 
-	size_t input_channels_unprocessed = input_channels;
+	size_t input_channels_unprocessed = group_input_channels;
 	if (output_channels_block_size == output_channels_block_max) {
 		const nnp_fast_conv_function fast_conv = context->fast_conv;
 		while (input_channels_unprocessed >= input_channels_block_max) {
 			input_channels_unprocessed -= input_channels_block_max;
 
 			fast_conv(
-				input_channels, image_elements,
+				group_input_channels, image_elements,
 				input, kernel, output);
 
 			input  += input_channels_block_max * image_elements;
@@ -459,50 +865,408 @@ static void compute_direct_convolution(
 
 		full_conv(
 			input_channels_block_size, output_channels_block_size,
-			input_channels, image_elements,
+			group_input_channels, image_elements,
 			input, kernel, output);
 
 		input  += input_channels_block_max * image_elements;
 		kernel += input_channels_block_max;
 	}
+
+	/* Apply activation while the output block is still in cache */
+	if (!is_identity_activation(context->activation)) {
+		activate_block(output, output_channels_block_size * image_elements, context->activation);
+	}
+}
+
+struct NNP_CACHE_ALIGN polyphase_input_context {
+	const float* input;
+	float* phase_input;
+
+	size_t phases;
+	struct fxdiv_divisor_size_t channels;
+	size_t phase_stride;
+	size_t channel_stride;
+	struct fxdiv_divisor_size_t phase_step_width;
+	size_t phase_step_height;
+	struct nnp_size input_size;
+	size_t input_padding_top;
+	size_t input_padding_left;
+	struct nnp_size phase_input_size;
+};
+
+/*
+ * Splits input images into phases: pixels phase_step apart starting at the same pixel. Depending on the strides,
+ * phases of an image become separate images (phase_stride = channels, channel_stride = 1) or separate channels
+ * (phase_stride = 1, channel_stride = phases) of the phase input.
+ */
+static void compute_polyphase_input(
+	const struct polyphase_input_context context[restrict static 1],
+	size_t image_channel, size_t phase)
+{
+	const size_t phases                          = context->phases;
+	const struct fxdiv_divisor_size_t channels   = context->channels;
+	const size_t phase_stride                    = context->phase_stride;
+	const size_t channel_stride                  = context->channel_stride;
+	const size_t phase_step_height               = context->phase_step_height;
+	const struct nnp_size input_size             = context->input_size;
+	const size_t input_padding_top               = context->input_padding_top;
+	const size_t input_padding_left              = context->input_padding_left;
+	const struct nnp_size phase_input_size       = context->phase_input_size;
+
+	const struct fxdiv_result_size_t sample_channel = fxdiv_divide_size_t(image_channel, channels);
+	const struct fxdiv_result_size_t phase_yx = fxdiv_divide_size_t(phase, context->phase_step_width);
+	const size_t phase_step_width = context->phase_step_width.value;
+
+	const float (*input)[input_size.width] =
+		(const float(*)[input_size.width]) (context->input + image_channel * input_size.height * input_size.width);
+	float (*phase_input)[phase_input_size.width] =
+		(float(*)[phase_input_size.width]) (context->phase_input +
+			(sample_channel.quotient * phases * channels.value +
+				phase * phase_stride + sample_channel.remainder * channel_stride) *
+					phase_input_size.height * phase_input_size.width);
+
+	for (size_t y = 0; y < phase_input_size.height; y++) {
+		const size_t input_y = phase_yx.quotient + y * phase_step_height - input_padding_top;
+		for (size_t x = 0; x < phase_input_size.width; x++) {
+			const size_t input_x = phase_yx.remainder + x * phase_step_width - input_padding_left;
+			if ((input_y < input_size.height) && (input_x < input_size.width)) {
+				phase_input[y][x] = input[input_y][input_x];
+			} else {
+				phase_input[y][x] = 0.0f;
+			}
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN polyphase_output_context {
+	const float* phase_output;
+	const float* residual;
+	float* output;
+	struct output_activation activation;
+
+	size_t phases;
+	struct fxdiv_divisor_size_t channels;
+	struct fxdiv_divisor_size_t phase_step_width;
+	size_t phase_step_height;
+	struct nnp_size output_size;
+	struct nnp_size phase_output_size;
+};
+
+static void compute_polyphase_output(
+	const struct polyphase_output_context context[restrict static 1],
+	size_t image_channel, size_t phase)
+{
+	const size_t phases                          = context->phases;
+	const struct fxdiv_divisor_size_t channels   = context->channels;
+	const size_t phase_step_height               = context->phase_step_height;
+	const struct nnp_size output_size            = context->output_size;
+	const struct nnp_size phase_output_size      = context->phase_output_size;
+
+	const struct fxdiv_result_size_t sample_channel = fxdiv_divide_size_t(image_channel, channels);
+	const struct fxdiv_result_size_t phase_yx = fxdiv_divide_size_t(phase, context->phase_step_width);
+	const size_t phase_step_width = context->phase_step_width.value;
+
+	const float (*phase_output)[phase_output_size.width] =
+		(const float(*)[phase_output_size.width]) (context->phase_output +
+			((sample_channel.quotient * phases + phase) * channels.value + sample_channel.remainder) *
+				phase_output_size.height * phase_output_size.width);
+	float (*output)[output_size.width] =
+		(float(*)[output_size.width]) (context->output + image_channel * output_size.height * output_size.width);
+
+	/* Phases are padded to the size of the largest phase: skip the padding */
+	const size_t rows = divide_round_up(doz(output_size.height, phase_yx.quotient), phase_step_height);
+	const size_t columns = divide_round_up(doz(output_size.width, phase_yx.remainder), phase_step_width);
+	if (context->residual == NULL) {
+		for (size_t y = 0; y < rows; y++) {
+			for (size_t x = 0; x < columns; x++) {
+				output[phase_yx.quotient + y * phase_step_height][phase_yx.remainder + x * phase_step_width] =
+					phase_output[y][x];
+			}
+		}
+	} else {
+		/* With a residual, phases are computed without the activation, which is applied after the residual here */
+		const struct output_activation activation = context->activation;
+		const float (*residual)[output_size.width] =
+			(const float(*)[output_size.width]) (context->residual + image_channel * output_size.height * output_size.width);
+		for (size_t y = 0; y < rows; y++) {
+			const size_t output_y = phase_yx.quotient + y * phase_step_height;
+			for (size_t x = 0; x < columns; x++) {
+				const size_t output_x = phase_yx.remainder + x * phase_step_width;
+				output[output_y][output_x] = activate(phase_output[y][x] + residual[output_y][output_x], activation);
+			}
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN polyphase_kernel_context {
+	const float* kernel;
+	float* phase_kernel;
+
+	size_t group_input_channels;
+	struct nnp_size kernel_size;
+	struct nnp_size phase_step;
+	struct nnp_size phase_kernel_size;
+};
+
+/*
+ * Splits each kernel into phase_step.height x phase_step.width phases: kernel elements phase_step apart starting at
+ * the same element. Phases are padded with zeros to phase_kernel_size and stored as consecutive input channels.
+ */
+static void compute_polyphase_kernel(
+	const struct polyphase_kernel_context context[restrict static 1],
+	size_t output_channel, size_t input_channel)
+{
+	const size_t group_input_channels         = context->group_input_channels;
+	const struct nnp_size kernel_size         = context->kernel_size;
+	const struct nnp_size phase_step          = context->phase_step;
+	const struct nnp_size phase_kernel_size   = context->phase_kernel_size;
+
+	const size_t kernel_index = output_channel * group_input_channels + input_channel;
+	const float (*kernel)[kernel_size.width] =
+		(const float(*)[kernel_size.width]) (context->kernel + kernel_index * kernel_size.height * kernel_size.width);
+	float (*phase_kernel)[phase_kernel_size.height][phase_kernel_size.width] =
+		(float(*)[phase_kernel_size.height][phase_kernel_size.width]) (context->phase_kernel +
+			kernel_index * phase_step.height * phase_step.width * phase_kernel_size.height * phase_kernel_size.width);
+
+	for (size_t phase_y = 0; phase_y < phase_step.height; phase_y++) {
+		for (size_t phase_x = 0; phase_x < phase_step.width; phase_x++) {
+			const size_t phase = phase_y * phase_step.width + phase_x;
+			for (size_t y = 0; y < phase_kernel_size.height; y++) {
+				const size_t kernel_y = y * phase_step.height + phase_y;
+				for (size_t x = 0; x < phase_kernel_size.width; x++) {
+					const size_t kernel_x = x * phase_step.width + phase_x;
+					if ((kernel_y < kernel_size.height) && (kernel_x < kernel_size.width)) {
+						phase_kernel[phase][y][x] = kernel[kernel_y][kernel_x];
+					} else {
+						phase_kernel[phase][y][x] = 0.0f;
+					}
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Algorithm choice, transform functions, and cache blocking parameters for a convolution. These depend only on the
+ * convolution shape and the hardware, and are shared by one-shot calls and by convolution plans.
+ */
+struct convolution_setup {
+	enum nnp_convolution_algorithm algorithm;
+	struct nnp_size output_size;
+	struct nnp_size kernel_dilation;
+	/* Input and output are stored as [batch][height][width][channels] rather than [batch][channels][height][width] */
+	bool channels_last;
+	struct output_activation activation;
+	/* The output transform function does not implement the activation, and output tiles are activated separately */
+	bool tile_activation;
+	/* Window (and stride) of max-pooling fused into the output transform of tiled algorithms, or 0x0 if none */
+	struct nnp_size output_pooling;
+
+	/* Parameters of tiled (Fourier or Winograd transform) algorithms */
+	bool fourier_transform;
+	size_t transform_element_size;
+	struct nnp_size tile_size;
+	nnp_transform_2d_with_offset input_transform_function;
+	nnp_transform_2d_with_offset kernel_transform_function;
+	nnp_transform_2d_with_bias output_transform_function;
+
+	/* Cache blocking parameters */
+	union {
+		struct {
+			size_t tiles_subblock_max;
+			size_t output_channels_subblock_max;
+			size_t input_channels_block_max;
+			size_t tiles_block_max;
+			size_t output_channels_block_max;
+		} fast;
+		struct gemm_blocking gemm;
+	} blocking;
+};
+
+struct nnp_convolution_plan {
+	struct convolution_setup setup;
+	enum nnp_convolution_transform_strategy transform_strategy;
+	size_t batch_size;
+	size_t groups;
+	size_t input_channels;
+	size_t output_channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	struct nnp_size output_subsampling;
+	/* Transformed or packed kernel, or a copy of the kernel for algorithms which use it as is */
+	void* kernel_buffer;
+	size_t kernel_buffer_size;
+	float* bias;
+	void* workspace_buffer;
+	size_t workspace_size;
+};
+
+/* Size of the kernel footprint on the input image, i.e. of the kernel with zeros inserted between its elements */
+static inline struct nnp_size dilated_kernel_size(struct nnp_size kernel_size, struct nnp_size kernel_dilation) {
+	return (struct nnp_size) {
+		.width = kernel_size.width == 0 ? 0 : (kernel_size.width - 1) * kernel_dilation.width + 1,
+		.height = kernel_size.height == 0 ? 0 : (kernel_size.height - 1) * kernel_dilation.height + 1
+	};
+}
+
+/*
+ * Dilated convolution with tiled algorithms is computed by polyphase decomposition: output pixels with the same
+ * coordinates modulo the dilation depend only on input pixels with the same coordinates modulo the dilation, so each
+ * of the dilation.height x dilation.width phases is a dense convolution with the original (undilated) kernel.
+ * All phases are padded to the same size, the size of the largest phase.
+ */
+static inline struct nnp_size polyphase_output_size(struct nnp_size output_size, struct nnp_size kernel_dilation) {
+	return (struct nnp_size) {
+		.width = divide_round_up(output_size.width, kernel_dilation.width),
+		.height = divide_round_up(output_size.height, kernel_dilation.height)
+	};
+}
+
+/*
+ * Strided convolution with Fourier transform algorithms is computed by polyphase decomposition too: input pixels and
+ * kernel elements with the same coordinates modulo the subsampling form subsampling.height x subsampling.width phases,
+ * and the strided convolution is the sum of dense convolutions of input phases with the matching kernel phases.
+ * Phases become extra input channels, so the sum is computed by the channel reduction of the dense convolution.
+ */
+static inline struct nnp_size polyphase_kernel_size(struct nnp_size kernel_size, struct nnp_size output_subsampling) {
+	return (struct nnp_size) {
+		.width = divide_round_up(kernel_size.width, output_subsampling.width),
+		.height = divide_round_up(kernel_size.height, output_subsampling.height)
+	};
+}
+
+/*
+ * Size of the output tile of a tiled algorithm. Strided Fourier transform algorithms compute a dense convolution of
+ * polyphase kernels.
+ */
+static inline struct nnp_size tiled_output_tile_size(
+	const struct convolution_setup setup[restrict static 1],
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling)
+{
+	if (setup->fourier_transform && max(output_subsampling.height, output_subsampling.width) > 1) {
+		kernel_size = polyphase_kernel_size(kernel_size, output_subsampling);
+		output_subsampling = (struct nnp_size) { .height = 1, .width = 1 };
+	}
+	return (struct nnp_size) {
+		.width = (setup->tile_size.width - kernel_size.width) / output_subsampling.width + 1,
+		.height = (setup->tile_size.height - kernel_size.height) / output_subsampling.height + 1
+	};
+}
+
+/* Output size of unpadded max-pooling with the window equal to the stride; windows are clipped at the edges */
+static inline struct nnp_size pooled_output_size(struct nnp_size output_size, struct nnp_size pooling) {
+	if (pooling.height == 0) {
+		return output_size;
+	}
+	return (struct nnp_size) {
+		.width = divide_round_up(output_size.width, pooling.width),
+		.height = divide_round_up(output_size.height, pooling.height)
+	};
+}
+
+/*
+ * Transforms one block of input channels of every group of the kernel. The transformed block holds
+ * output_channels x input_channels_block_size tuples for each tuple index.
+ */
+static void transform_kernel_block(
+	nnp_transform_2d_with_offset transform_function,
+	const float* kernel,
+	void* kernel_transform,
+	size_t tuple_size,
+	size_t groups,
+	size_t group_input_channels,
+	size_t input_channels_block_start,
+	size_t input_channels_block_size,
+	size_t output_channels,
+	size_t output_channels_subblock_max,
+	struct nnp_size kernel_size,
+	pthreadpool_t threadpool)
+{
+	const size_t group_output_channels = output_channels / groups;
+	const size_t output_channels_group_range = round_up(group_output_channels, output_channels_subblock_max);
+	struct kernel_transform_context kernel_transform_context = {
+		.transform_function = transform_function,
+		.kernel = kernel + input_channels_block_start * kernel_size.height * kernel_size.width,
+		.kernel_transform = kernel_transform,
+		.tuple_size = tuple_size,
+		.input_channels = group_input_channels,
+		.input_channels_block_size = input_channels_block_size,
+		.output_channels = output_channels,
+		.group_output_channels = group_output_channels,
+		.output_channels_group_range = fxdiv_init_size_t(output_channels_group_range),
+		.kernel_size = kernel_size,
+	};
+	pthreadpool_compute_2d_tiled(threadpool,
+		(pthreadpool_function_2d_tiled_t) compute_kernel_transform,
+		&kernel_transform_context,
+		groups * output_channels_group_range, input_channels_block_size,
+		output_channels_subblock_max,         1);
+}
+
+/*
+ * Tiled algorithms process tiles in streams: the input transform, tuple multiplication, and output transform of a stream
+ * complete before the next stream starts. Tiles of the whole minibatch form a single stream when their input and output
+ * transforms fit into the L3 cache blocking budget. Otherwise streams are limited to as many tiles as fit, so that
+ * transforms of a stream stay in cache between the passes, and the workspace does not grow with the image size.
+ * Streams span whole tile blocks of the tuple multiplication, so the kernel transform is not read more often than
+ * without streams.
+ * Multiple streams may need a larger kernel transform (stream_kernel_transform_size extra bytes), so tiles are streamed
+ * only when the input and output transforms they save outweigh it.
+ */
+static inline size_t tiles_stream_size_max(
+	size_t tiles_count, size_t tiles_block_max,
+	size_t tile_transforms_size, size_t stream_kernel_transform_size)
+{
+	const size_t tiles_stream_max = max(round_down(nnp_hwinfo.blocking.l3 / tile_transforms_size, tiles_block_max), tiles_block_max);
+	if (tiles_stream_max >= tiles_count) {
+		return tiles_count;
+	}
+	if ((tiles_count - tiles_stream_max) * tile_transforms_size <= stream_kernel_transform_size) {
+		return tiles_count;
+	}
+	return tiles_stream_max;
 }
 
 static enum nnp_status compute_fast_convolution_inference(
-	const bool fourier_transform,
+	const struct convolution_setup setup[restrict static 1],
 	const enum nnp_convolution_transform_strategy transform_strategy,
-	const size_t transform_element_size,
+	const size_t batch_size,
+	const size_t groups,
 	const size_t input_channels,
 	const size_t output_channels,
-	const struct nnp_size tile_size,
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
-	const struct nnp_size output_size,
 	const struct nnp_size output_subsampling,
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
 	void* workspace_buffer,
 	size_t* workspace_size,
-	const nnp_transform_2d_with_offset input_transform_function,
-	const nnp_transform_2d_with_offset kernel_transform_function,
-	const nnp_transform_2d_with_bias output_transform_function,
 	pthreadpool_t threadpool,
 	struct nnp_profile* profile)
 {
 	void* memory_block = NULL;
 	size_t memory_size = 0;
+	const bool fourier_transform = setup->fourier_transform;
+	const size_t transform_element_size = setup->transform_element_size;
+	const struct nnp_size tile_size = setup->tile_size;
+	const struct nnp_size output_size = setup->output_size;
+	const nnp_transform_2d_with_offset input_transform_function = setup->input_transform_function;
+	const nnp_transform_2d_with_offset kernel_transform_function = setup->kernel_transform_function;
+	const nnp_transform_2d_with_bias output_transform_function = setup->output_transform_function;
 	const size_t simd_width = nnp_hwinfo.simd_width;
 	const size_t tuple_elements = (fourier_transform ? simd_width * 2 : simd_width);
 	const size_t tuple_size = tuple_elements * transform_element_size;
 	const size_t tile_elements = tile_size.height * tile_size.width;
-	const size_t tuple_count = tile_elements / tuple_elements;
+	/* Tiles with a number of elements not divisible by tuple size (e.g. 6x6) are padded to whole tuples */
+	const size_t tuple_count = divide_round_up(tile_elements, tuple_elements);
 
-	const struct nnp_size output_tile_size = {
-		.width = (tile_size.width - kernel_size.width) / output_subsampling.width + 1,
-		.height = (tile_size.height - kernel_size.height) / output_subsampling.height + 1
-	};
+	const struct nnp_size output_tile_size = tiled_output_tile_size(setup, kernel_size, output_subsampling);
 	const struct nnp_size tile_step = {
 		.width = tile_size.width - kernel_size.width + 1,
 		.height = tile_size.height - kernel_size.height + 1
@@ -510,38 +1274,55 @@ static enum nnp_status compute_fast_convolution_inference(
 
 	const size_t tiles_y_count = divide_round_up(output_size.height, output_tile_size.height);
 	const size_t tiles_x_count = divide_round_up(output_size.width, output_tile_size.width);
-	const size_t tiles_count = tiles_x_count * tiles_y_count;
+	const size_t tiles_per_image = tiles_x_count * tiles_y_count;
+	/*
+	 * Tiles of all images in the minibatch form a single tiles dimension, so that the kernel transform and
+	 * the blocked tuple multiplication are shared by the whole minibatch.
+	 */
+	const size_t tiles_count = batch_size * tiles_per_image;
 
-	/* Calculate cache blocking parameters */
-	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / tuple_size;
-	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / tuple_size;
-	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / tuple_size;
-
-	const size_t tiles_subblock_max = (fourier_transform ? nnp_hwinfo.cxgemm.mr : nnp_hwinfo.sxgemm.mr);
-	const size_t output_channels_subblock_max = (fourier_transform ? nnp_hwinfo.cxgemm.nr : nnp_hwinfo.sxgemm.nr);
-
-	const size_t input_channels_block_max =
-		round_down(cache_elements_l1 / (tiles_subblock_max + output_channels_subblock_max), 2);
-	const size_t tiles_block_max =
-		round_down(cache_elements_l2 / input_channels_block_max, tiles_subblock_max);
-	const size_t output_channels_block_max =
-		round_down(cache_elements_l3 / input_channels_block_max, output_channels_subblock_max);
-
-	const size_t transform_tile_size = tile_elements * transform_element_size;
-	const size_t input_transform_size = tiles_count * min(input_channels, input_channels_block_max) * transform_tile_size;
-	const size_t output_transform_size = tiles_count * output_channels * transform_tile_size;
+	const size_t tiles_subblock_max = setup->blocking.fast.tiles_subblock_max;
+	const size_t output_channels_subblock_max = setup->blocking.fast.output_channels_subblock_max;
+	const size_t input_channels_block_max = setup->blocking.fast.input_channels_block_max;
+	const size_t tiles_block_max = setup->blocking.fast.tiles_block_max;
+	const size_t output_channels_block_max = setup->blocking.fast.output_channels_block_max;
+
+	/*
+	 * Grouped convolution has a block-diagonal kernel: input channels are blocked within a group, and the kernel
+	 * transform holds only the diagonal blocks. Output channels of each group are padded to whole subblocks in the
+	 * iteration space, so that subblocks never straddle groups.
+	 */
+	const size_t group_input_channels = input_channels / groups;
+	const size_t group_output_channels = output_channels / groups;
+	const size_t output_channels_group_range = round_up(group_output_channels, output_channels_subblock_max);
+
+	/*
+	 * A single stream transforms the kernel one input channels block at a time. Multiple streams revisit every
+	 * input channels block, so they keep the transformed kernel for all blocks, which are transformed by the first stream.
+	 */
+	const size_t transform_tile_size = tuple_count * tuple_size;
+	const size_t input_channels_block_range = min(group_input_channels, input_channels_block_max);
+	const size_t stream_kernel_transform_size = transform_strategy == nnp_convolution_transform_strategy_compute ?
+		output_channels * (group_input_channels - input_channels_block_range) * transform_tile_size : 0;
+	const size_t tiles_stream_max = tiles_stream_size_max(tiles_count, tiles_block_max,
+		(groups * input_channels_block_range + output_channels) * transform_tile_size, stream_kernel_transform_size);
+	const bool streamed = tiles_stream_max < tiles_count;
+	const size_t input_transform_size = tiles_stream_max * groups * input_channels_block_range * transform_tile_size;
+	const size_t output_transform_size = tiles_stream_max * output_channels * transform_tile_size;
 	switch (transform_strategy) {
 		case nnp_convolution_transform_strategy_compute:
 		case nnp_convolution_transform_strategy_reuse:
 		{
 			memory_size = input_transform_size + output_transform_size;
-			const size_t kernel_transform_size = output_channels * min(input_channels, input_channels_block_max) * transform_tile_size;
 			if (transform_strategy == nnp_convolution_transform_strategy_compute) {
-				memory_size += kernel_transform_size;
+				memory_size += output_channels * input_channels_block_range * transform_tile_size;
+				if (streamed) {
+					memory_size += stream_kernel_transform_size;
+				}
 			}
 			if (workspace_buffer == NULL) {
 				if (workspace_size == NULL) {
-					memory_block = allocate_memory(memory_size);
+					memory_block = nnp_workspace_acquire_block(memory_size);
 					if (memory_block == NULL) {
 						return nnp_status_out_of_memory;
 					}
@@ -560,131 +1341,158 @@ static enum nnp_status compute_fast_convolution_inference(
 			void* output_transform = memory_block + input_transform_size;
 			void* kernel_transform = memory_block + input_transform_size + output_transform_size;
 
-			for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max) {
-				const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
+			for (size_t tiles_stream_start = 0; tiles_stream_start < tiles_count; tiles_stream_start += tiles_stream_max) {
+				const size_t tiles_stream_size = min(tiles_count - tiles_stream_start, tiles_stream_max);
 
-				if (transform_strategy == nnp_convolution_transform_strategy_compute) {
-					NNP_KERNEL_TRANSFORM_START(profile)
-					struct kernel_transform_context kernel_transform_context = {
-						.transform_function = kernel_transform_function,
-						.kernel = kernel + input_channels_block_start * kernel_size.height * kernel_size.width,
-						.kernel_transform = kernel_transform,
+				for (size_t input_channels_block_start = 0; input_channels_block_start < group_input_channels; input_channels_block_start += input_channels_block_max) {
+					const size_t input_channels_block_size = min(group_input_channels - input_channels_block_start, input_channels_block_max);
+
+					const void* kernel_transform_block;
+					if (transform_strategy == nnp_convolution_transform_strategy_compute) {
+						void* kernel_transform_buffer = kernel_transform;
+						if (streamed) {
+							kernel_transform_buffer += input_channels_block_start * output_channels * transform_tile_size;
+						}
+						if (!streamed || tiles_stream_start == 0) {
+							NNP_KERNEL_TRANSFORM_START(profile)
+							transform_kernel_block(kernel_transform_function,
+								kernel, kernel_transform_buffer,
+								tuple_size, groups, group_input_channels, input_channels_block_start, input_channels_block_size,
+								output_channels, output_channels_subblock_max, kernel_size, threadpool);
+							NNP_KERNEL_TRANSFORM_END(profile)
+						}
+						kernel_transform_block = kernel_transform_buffer;
+					} else {
+						kernel_transform_block = (const void*) kernel + input_channels_block_start * output_channels * transform_tile_size;
+					}
+
+					NNP_INPUT_TRANSFORM_START(profile)
+					struct input_transform_context input_transform_context = {
+						.input = input,
+						.input_transform = input_transform,
+						.transform_function = input_transform_function,
 						.tuple_size = tuple_size,
+						.tiles_count = tiles_stream_size,
+						.tiles_start = tiles_stream_start,
+						.tiles_per_image = fxdiv_init_size_t(tiles_per_image),
+						.tiles_x_count = fxdiv_init_size_t(tiles_x_count),
+						.groups = groups,
 						.input_channels = input_channels,
-						.input_channels_block_size = input_channels_block_size,
-						.output_channels = output_channels,
-						.kernel_size = kernel_size,
+						.group_input_channels = group_input_channels,
+						.input_channels_block_start = input_channels_block_start,
+						.input_channels_block_size = fxdiv_init_size_t(input_channels_block_size),
+						.input_size = input_size,
+						.input_channel_stride = setup->channels_last ? 1 : input_size.height * input_size.width,
+						.input_pixel_stride = setup->channels_last ? input_channels : 1,
+						.input_padding_left = input_padding.left,
+						.input_padding_top = input_padding.top,
+						.input_tile = tile_size,
+						.input_tile_step = tile_step,
 					};
 					pthreadpool_compute_2d_tiled(threadpool,
-						(pthreadpool_function_2d_tiled_t) compute_kernel_transform,
-						&kernel_transform_context,
-						output_channels,              input_channels_block_size,
-						output_channels_subblock_max, 1);
-					NNP_KERNEL_TRANSFORM_END(profile)
-				} else {
-					kernel_transform = (void*) kernel + input_channels_block_start * output_channels * transform_tile_size;
-				}
+						(pthreadpool_function_2d_tiled_t) compute_input_transform,
+						&input_transform_context,
+						groups * input_channels_block_size, tiles_stream_size,
+						1,                                  tiles_subblock_max);
+					NNP_INPUT_TRANSFORM_END(profile)
 
-				NNP_INPUT_TRANSFORM_START(profile)
-				struct input_transform_context input_transform_context = {
-					.input = input,
-					.input_transform = input_transform,
-					.transform_function = input_transform_function,
-					.tuple_size = tuple_size,
-					.tiles_count = tiles_count,
-					.tiles_x_count = fxdiv_init_size_t(tiles_x_count),
-					.input_channels_block_start = input_channels_block_start,
-					.input_channels_block_size = input_channels_block_size,
-					.input_size = input_size,
-					.input_padding_left = input_padding.left,
-					.input_padding_top = input_padding.top,
-					.input_tile = tile_size,
-					.input_tile_step = tile_step,
-				};
-				pthreadpool_compute_2d_tiled(threadpool,
-					(pthreadpool_function_2d_tiled_t) compute_input_transform,
-					&input_transform_context,
-					input_channels_block_size, tiles_count,
-					1,                         tiles_subblock_max);
-				NNP_INPUT_TRANSFORM_END(profile)
-
-				NNP_BLOCK_MULTIPLICATION_START(profile)
-				for (size_t tuple_index = 0; tuple_index < tuple_count; tuple_index += 1) {
-					nnp_full_tuple_gemm_function full_gemm_function;
-					nnp_fast_tuple_gemm_function fast_gemm_function;
-					if (fourier_transform) {
-						if (tuple_index < NNP_COMPLEX_TUPLE_INDEX) {
-							fast_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_only_mr_x_nr;
-							full_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_upto_mr_x_nr;
+					NNP_BLOCK_MULTIPLICATION_START(profile)
+					for (size_t tuple_index = 0; tuple_index < tuple_count; tuple_index += 1) {
+						nnp_full_tuple_gemm_function full_gemm_function;
+						nnp_fast_tuple_gemm_function fast_gemm_function;
+						if (fourier_transform) {
+							if (tuple_index < NNP_COMPLEX_TUPLE_INDEX) {
+								fast_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_only_mr_x_nr;
+								full_gemm_function = nnp_hwinfo.cxgemm.s4cX_conjb_upto_mr_x_nr;
+							} else {
+								fast_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_only_mr_x_nr;
+								full_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_upto_mr_x_nr;
+							}
 						} else {
-							fast_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_only_mr_x_nr;
-							full_gemm_function = nnp_hwinfo.cxgemm.cX_conjb_upto_mr_x_nr;
+							if NNP_LIKELY(transform_element_size == sizeof(float)) {
+								fast_gemm_function = nnp_hwinfo.sxgemm.only_mr_x_nr;
+								full_gemm_function = nnp_hwinfo.sxgemm.upto_mr_x_nr;
+							} else {
+								#if NNP_BACKEND_ARM || NNP_BACKEND_X86_64
+									fast_gemm_function = nnp_hwinfo.hxgemm.only_mr_x_nr;
+									full_gemm_function = nnp_hwinfo.hxgemm.upto_mr_x_nr;
+								#else
+									/* Setup never selects fp16 transforms on backends without hxgemm */
+									NNP_UNREACHABLE;
+								#endif /* NNP_BACKEND_ARM || NNP_BACKEND_X86_64 */
+							}
 						}
-					} else {
-						if NNP_LIKELY(transform_element_size == sizeof(float)) {
-							fast_gemm_function = nnp_hwinfo.sxgemm.only_mr_x_nr;
-							full_gemm_function = nnp_hwinfo.sxgemm.upto_mr_x_nr;
-						} else {
-							#if NNP_BACKEND_ARM
-								fast_gemm_function = nnp_hwinfo.hxgemm.only_mr_x_nr;
-								full_gemm_function = nnp_hwinfo.hxgemm.upto_mr_x_nr;
-							#endif /* NNP_BACKEND_ARM */
+						for (size_t output_channels_block_start = 0; output_channels_block_start < group_output_channels; output_channels_block_start += output_channels_block_max) {
+							const size_t output_channels_block_size = min(group_output_channels - output_channels_block_start, output_channels_block_max);
+							const size_t output_channels_block_range = round_up(output_channels_block_size, output_channels_subblock_max);
+							struct tuple_multiplication_context tuple_multiplication_context = {
+								.tuple_elements = tuple_elements,
+								.tuple_size = tuple_size,
+								.tiles_count = tiles_stream_size,
+								.tiles_subblock_max = tiles_subblock_max,
+								.input_channels_block_start = input_channels_block_start,
+								.input_channels_block_size = input_channels_block_size,
+								.output_channels = output_channels,
+								.group_output_channels = group_output_channels,
+								.output_channels_subblock_max = output_channels_subblock_max,
+								.output_channels_block_start = output_channels_block_start,
+								.output_channels_block_size = output_channels_block_size,
+								.output_channels_group_range = fxdiv_init_size_t(output_channels_block_range),
+								.input_transform = input_transform +
+									tuple_index * groups * tiles_stream_size * input_channels_block_size * tuple_size,
+								.kernel_transform = kernel_transform_block +
+									tuple_index * output_channels * input_channels_block_size * tuple_size,
+								.output_transform = output_transform +
+									tuple_index * tiles_stream_size * output_channels * tuple_size,
+								.fast_gemm = fast_gemm_function,
+								.full_gemm = full_gemm_function,
+							};
+							pthreadpool_compute_2d_tiled(threadpool,
+								(pthreadpool_function_2d_tiled_t) compute_tuple_multiplication,
+								&tuple_multiplication_context,
+								tiles_stream_size, groups * output_channels_block_range,
+								tiles_block_max,   output_channels_subblock_max);
 						}
 					}
-					for (size_t output_channels_block_start = 0; output_channels_block_start < output_channels; output_channels_block_start += output_channels_block_max) {
-						const size_t output_channels_block_size = min(output_channels - output_channels_block_start, output_channels_block_max);
-						struct tuple_multiplication_context tuple_multiplication_context = {
-							.tuple_elements = tuple_elements,
-							.tuple_size = tuple_size,
-							.tiles_subblock_max = tiles_subblock_max,
-							.input_channels_block_start = input_channels_block_start,
-							.input_channels_block_size = input_channels_block_size,
-							.output_channels = output_channels,
-							.output_channels_subblock_max = output_channels_subblock_max,
-							.output_channels_block_start = output_channels_block_start,
-							.input_transform = input_transform +
-								tuple_index * tiles_count * input_channels_block_size * tuple_size,
-							.kernel_transform = kernel_transform +
-								tuple_index * output_channels * input_channels_block_size * tuple_size,
-							.output_transform = output_transform +
-								tuple_index * tiles_count * output_channels * tuple_size,
-							.fast_gemm = fast_gemm_function,
-							.full_gemm = full_gemm_function,
-						};
-						pthreadpool_compute_2d_tiled(threadpool,
-							(pthreadpool_function_2d_tiled_t) compute_tuple_multiplication,
-							&tuple_multiplication_context,
-							tiles_count,     output_channels_block_size,
-							tiles_block_max, output_channels_subblock_max);
-					}
+					NNP_BLOCK_MULTIPLICATION_END(profile)
 				}
-				NNP_BLOCK_MULTIPLICATION_END(profile)
+				NNP_OUTPUT_TRANSFORM_START(profile)
+				struct output_transform_context output_transform_context = {
+					.transform_function = output_transform_function,
+					.output = output,
+					.output_transform = output_transform,
+					.bias = bias,
+					.residual = residual,
+					.tuple_size = tuple_size,
+					.tiles_count = tiles_stream_size,
+					.tiles_start = tiles_stream_start,
+					.tiles_per_image = fxdiv_init_size_t(tiles_per_image),
+					.tiles_x_count = fxdiv_init_size_t(tiles_x_count),
+					.tiles_block_max = fxdiv_init_size_t(tiles_block_max),
+					.output_channels = output_channels,
+					.group_output_channels = group_output_channels,
+					.output_channels_group_range = fxdiv_init_size_t(output_channels_group_range),
+					.output_size = output_size,
+					.output_channel_stride = setup->channels_last ? 1 : output_size.height * output_size.width,
+					.output_pixel_stride = setup->channels_last ? output_channels : 1,
+					.output_tile = output_tile_size,
+					.activation = setup->activation,
+					.tile_activation = setup->tile_activation,
+					.pooling = setup->output_pooling,
+					.pooled_output_size = pooled_output_size(output_size, setup->output_pooling),
+				};
+				pthreadpool_compute_2d_tiled(threadpool,
+					(pthreadpool_function_2d_tiled_t) compute_output_transform,
+					&output_transform_context,
+					groups * output_channels_group_range, tiles_stream_size,
+					output_channels_subblock_max,         tiles_subblock_max);
+				NNP_OUTPUT_TRANSFORM_END(profile)
 			}
-			NNP_OUTPUT_TRANSFORM_START(profile)
-			struct output_transform_context output_transform_context = {
-				.transform_function = output_transform_function,
-				.output = output,
-				.output_transform = output_transform,
-				.bias = bias,
-				.tuple_size = tuple_size,
-				.tiles_count = tiles_count,
-				.tiles_x_count = fxdiv_init_size_t(tiles_x_count),
-				.tiles_block_max = fxdiv_init_size_t(tiles_block_max),
-				.output_channels = output_channels,
-				.output_size = output_size,
-				.output_tile = output_tile_size,
-			};
-			pthreadpool_compute_2d_tiled(threadpool,
-				(pthreadpool_function_2d_tiled_t) compute_output_transform,
-				&output_transform_context,
-				output_channels,              tiles_count,
-				output_channels_subblock_max, tiles_subblock_max);
-			NNP_OUTPUT_TRANSFORM_END(profile)
 			break;
 		}
 		case nnp_convolution_transform_strategy_precompute:
 		{
-			const size_t kernel_transform_size = output_channels * input_channels * transform_tile_size;
+			const size_t kernel_transform_size = output_channels * group_input_channels * transform_tile_size;
 			if (workspace_buffer == NULL) {
 				*workspace_size = kernel_transform_size;
 				return nnp_status_success;
@@ -695,25 +1503,14 @@ static enum nnp_status compute_fast_convolution_inference(
 				memory_block = workspace_buffer;
 			}
 
-			for (size_t input_channels_block_start = 0; input_channels_block_start < input_channels; input_channels_block_start += input_channels_block_max) {
-				const size_t input_channels_block_size = min(input_channels - input_channels_block_start, input_channels_block_max);
+			for (size_t input_channels_block_start = 0; input_channels_block_start < group_input_channels; input_channels_block_start += input_channels_block_max) {
+				const size_t input_channels_block_size = min(group_input_channels - input_channels_block_start, input_channels_block_max);
 
 				NNP_KERNEL_TRANSFORM_START(profile)
-				struct kernel_transform_context kernel_transform_context = {
-					.transform_function = kernel_transform_function,
-					.kernel = kernel + input_channels_block_start * kernel_size.height * kernel_size.width,
-					.kernel_transform = (void*) workspace_buffer + input_channels_block_start * output_channels * transform_tile_size,
-					.tuple_size = tuple_size,
-					.input_channels = input_channels,
-					.input_channels_block_size = input_channels_block_size,
-					.output_channels = output_channels,
-					.kernel_size = kernel_size,
-				};
-				pthreadpool_compute_2d_tiled(threadpool,
-					(pthreadpool_function_2d_tiled_t) compute_kernel_transform,
-					&kernel_transform_context,
-					output_channels,              input_channels_block_size,
-					output_channels_subblock_max, 1);
+				transform_kernel_block(kernel_transform_function,
+					kernel, (void*) workspace_buffer + input_channels_block_start * output_channels * transform_tile_size,
+					tuple_size, groups, group_input_channels, input_channels_block_start, input_channels_block_size,
+					output_channels, output_channels_subblock_max, kernel_size, threadpool);
 				NNP_KERNEL_TRANSFORM_END(profile)
 			}
 			break;
@@ -723,51 +1520,366 @@ static enum nnp_status compute_fast_convolution_inference(
 	}
 
 	if (memory_block != workspace_buffer) {
-		release_memory(memory_block, memory_size);
+		nnp_workspace_release_block(memory_block, memory_size);
 	}
 	return nnp_status_success;
 }
 
-static enum nnp_status compute_gemm_convolution_inference(
+static enum nnp_status compute_dilated_convolution_inference(
+	const struct convolution_setup setup[restrict static 1],
 	const enum nnp_convolution_transform_strategy transform_strategy,
+	const size_t batch_size,
+	const size_t groups,
 	const size_t input_channels,
 	const size_t output_channels,
 	const struct nnp_size input_size,
 	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
-	const struct nnp_size output_size,
-	const struct nnp_size output_subsampling,
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
 	void* workspace_buffer,
 	size_t* workspace_size,
-	enum nnp_activation activation,
 	pthreadpool_t threadpool,
 	struct nnp_profile* profile)
 {
-	enum nnp_status status = nnp_status_success;
 	void* memory_block = NULL;
 	size_t memory_size = 0;
-	const size_t simd_width = nnp_hwinfo.simd_width;
+	const struct nnp_size kernel_dilation = setup->kernel_dilation;
+	const struct nnp_size output_size = setup->output_size;
+	const size_t phases = kernel_dilation.height * kernel_dilation.width;
 
-	/* Calculate cache blocking parameters */
-	const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / sizeof(float);
-	const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / sizeof(float);
-	const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / sizeof(float);
+	/* Every phase is a dense, unpadded convolution, and all phases form one minibatch */
+	struct convolution_setup phase_setup = *setup;
+	phase_setup.output_size = polyphase_output_size(output_size, kernel_dilation);
+	phase_setup.kernel_dilation = (struct nnp_size) { .height = 1, .width = 1 };
+	if (residual != NULL) {
+		/* Setup chose the identity output transform: the residual and activation are applied to the gathered phases */
+		phase_setup.tile_activation = false;
+	}
+	const struct nnp_size phase_input_size = {
+		.width = phase_setup.output_size.width + kernel_size.width - 1,
+		.height = phase_setup.output_size.height + kernel_size.height - 1
+	};
+	const struct nnp_padding phase_input_padding = { 0 };
+	const struct nnp_size phase_output_subsampling = { .height = 1, .width = 1 };
 
-	const size_t output_channels_subblock_max = nnp_hwinfo.sgemm.mr;
-	const size_t output_image_subblock_max = nnp_hwinfo.sgemm.nr;
+	if (transform_strategy == nnp_convolution_transform_strategy_precompute) {
+		/* Kernel transform does not depend on dilation */
+		return compute_fast_convolution_inference(
+			&phase_setup, transform_strategy,
+			batch_size, groups, input_channels, output_channels,
+			phase_input_size, phase_input_padding, kernel_size, phase_output_subsampling,
+			input, kernel, bias, NULL, output, workspace_buffer, workspace_size,
+			threadpool, profile);
+	}
 
-	const size_t reduction_size = input_channels * kernel_size.height * kernel_size.width;
-	const size_t output_image_size = output_size.height * output_size.width;
-	const size_t reduction_block_max =
-		round_down(cache_elements_l1 / (output_channels_subblock_max + output_image_subblock_max), 2);
-	const size_t output_channels_block_max =
-		round_down(cache_elements_l2 / reduction_block_max, output_channels_subblock_max);
-	const size_t output_image_block_max =
-		round_down(cache_elements_l3 / reduction_block_max, output_image_subblock_max);
+	size_t phase_workspace_size = 0;
+	enum nnp_status status = compute_fast_convolution_inference(
+		&phase_setup, transform_strategy,
+		batch_size * phases, groups, input_channels, output_channels,
+		phase_input_size, phase_input_padding, kernel_size, phase_output_subsampling,
+		NULL, NULL, NULL, NULL, NULL, NULL, &phase_workspace_size,
+		threadpool, NULL);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	const size_t phase_input_offset = round_up(phase_workspace_size, 64);
+	const size_t phase_input_size_bytes = batch_size * phases * input_channels *
+		phase_input_size.height * phase_input_size.width * sizeof(float);
+	const size_t phase_output_offset = phase_input_offset + round_up(phase_input_size_bytes, 64);
+	memory_size = phase_output_offset + batch_size * phases * output_channels *
+		phase_setup.output_size.height * phase_setup.output_size.width * sizeof(float);
+	if (workspace_buffer == NULL) {
+		if (workspace_size == NULL) {
+			memory_block = nnp_workspace_acquire_block(memory_size);
+			if (memory_block == NULL) {
+				return nnp_status_out_of_memory;
+			}
+		} else {
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	} else {
+		if (*workspace_size < memory_size) {
+			return nnp_status_insufficient_buffer;
+		}
+		memory_block = workspace_buffer;
+	}
+
+	float* phase_input = memory_block + phase_input_offset;
+	float* phase_output = memory_block + phase_output_offset;
+
+	NNP_INPUT_TRANSFORM_START(profile)
+	struct polyphase_input_context polyphase_input_context = {
+		.input = input,
+		.phase_input = phase_input,
+		.phases = phases,
+		.channels = fxdiv_init_size_t(input_channels),
+		.phase_stride = input_channels,
+		.channel_stride = 1,
+		.phase_step_width = fxdiv_init_size_t(kernel_dilation.width),
+		.phase_step_height = kernel_dilation.height,
+		.input_size = input_size,
+		.input_padding_top = input_padding.top,
+		.input_padding_left = input_padding.left,
+		.phase_input_size = phase_input_size,
+	};
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_polyphase_input,
+		&polyphase_input_context,
+		batch_size * input_channels, phases);
+	NNP_INPUT_TRANSFORM_END(profile)
+
+	status = compute_fast_convolution_inference(
+		&phase_setup, transform_strategy,
+		batch_size * phases, groups, input_channels, output_channels,
+		phase_input_size, phase_input_padding, kernel_size, phase_output_subsampling,
+		phase_input, kernel, bias, NULL, phase_output, memory_block, &phase_workspace_size,
+		threadpool, profile);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	NNP_OUTPUT_TRANSFORM_START(profile)
+	struct polyphase_output_context polyphase_output_context = {
+		.phase_output = phase_output,
+		.residual = residual,
+		.output = output,
+		.activation = setup->activation,
+		.phases = phases,
+		.channels = fxdiv_init_size_t(output_channels),
+		.phase_step_width = fxdiv_init_size_t(kernel_dilation.width),
+		.phase_step_height = kernel_dilation.height,
+		.output_size = output_size,
+		.phase_output_size = phase_setup.output_size,
+	};
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_polyphase_output,
+		&polyphase_output_context,
+		batch_size * output_channels, phases);
+	NNP_OUTPUT_TRANSFORM_END(profile)
+
+cleanup:
+	if (memory_block != workspace_buffer) {
+		nnp_workspace_release_block(memory_block, memory_size);
+	}
+	return status;
+}
+
+static enum nnp_status compute_strided_convolution_inference(
+	const struct convolution_setup setup[restrict static 1],
+	const enum nnp_convolution_transform_strategy transform_strategy,
+	const size_t batch_size,
+	const size_t groups,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	void* memory_block = NULL;
+	size_t memory_size = 0;
+	const struct nnp_size output_size = setup->output_size;
+	const size_t phases = output_subsampling.height * output_subsampling.width;
+	const size_t group_input_channels = input_channels / groups;
+
+	/* Phases of every input channel form a dense, unpadded, unstrided convolution with phases of its kernels */
+	const size_t phase_input_channels = input_channels * phases;
+	const struct nnp_size phase_kernel_size = polyphase_kernel_size(kernel_size, output_subsampling);
+	const struct nnp_size phase_input_size = {
+		.width = output_size.width + phase_kernel_size.width - 1,
+		.height = output_size.height + phase_kernel_size.height - 1
+	};
+	const struct nnp_padding phase_input_padding = { 0 };
+	const struct nnp_size phase_output_subsampling = { .height = 1, .width = 1 };
+	const size_t phase_kernel_size_bytes = output_channels * group_input_channels * phases *
+		phase_kernel_size.height * phase_kernel_size.width * sizeof(float);
+	struct polyphase_kernel_context polyphase_kernel_context = {
+		.kernel = kernel,
+		.group_input_channels = group_input_channels,
+		.kernel_size = kernel_size,
+		.phase_step = output_subsampling,
+		.phase_kernel_size = phase_kernel_size,
+	};
+
+	enum nnp_status status = nnp_status_success;
+	if (transform_strategy == nnp_convolution_transform_strategy_precompute) {
+		if (workspace_buffer == NULL && workspace_size != NULL) {
+			return compute_fast_convolution_inference(
+				setup, transform_strategy,
+				batch_size, groups, phase_input_channels, output_channels,
+				phase_input_size, phase_input_padding, phase_kernel_size, phase_output_subsampling,
+				NULL, NULL, NULL, NULL, NULL, NULL, workspace_size,
+				threadpool, NULL);
+		}
+
+		/* Kernel phases are needed only until they are transformed */
+		memory_size = phase_kernel_size_bytes;
+		memory_block = nnp_workspace_acquire_block(memory_size);
+		if (memory_block == NULL) {
+			return nnp_status_out_of_memory;
+		}
+
+		NNP_KERNEL_TRANSFORM_START(profile)
+		polyphase_kernel_context.phase_kernel = memory_block;
+		pthreadpool_compute_2d(threadpool,
+			(pthreadpool_function_2d_t) compute_polyphase_kernel,
+			&polyphase_kernel_context,
+			output_channels, group_input_channels);
+		NNP_KERNEL_TRANSFORM_END(profile)
+
+		status = compute_fast_convolution_inference(
+			setup, transform_strategy,
+			batch_size, groups, phase_input_channels, output_channels,
+			phase_input_size, phase_input_padding, phase_kernel_size, phase_output_subsampling,
+			NULL, memory_block, NULL, NULL, NULL, workspace_buffer, workspace_size,
+			threadpool, profile);
+		nnp_workspace_release_block(memory_block, memory_size);
+		return status;
+	}
+
+	size_t phase_workspace_size = 0;
+	status = compute_fast_convolution_inference(
+		setup, transform_strategy,
+		batch_size, groups, phase_input_channels, output_channels,
+		phase_input_size, phase_input_padding, phase_kernel_size, phase_output_subsampling,
+		NULL, NULL, NULL, NULL, NULL, NULL, &phase_workspace_size,
+		threadpool, NULL);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	/* With the reuse strategy, the kernel is already split into phases and transformed */
+	const bool split_kernel = transform_strategy == nnp_convolution_transform_strategy_compute;
+	const size_t phase_input_offset = round_up(phase_workspace_size, 64);
+	const size_t phase_input_size_bytes = batch_size * phase_input_channels *
+		phase_input_size.height * phase_input_size.width * sizeof(float);
+	const size_t phase_kernel_offset = phase_input_offset + round_up(phase_input_size_bytes, 64);
+	memory_size = phase_kernel_offset + (split_kernel ? phase_kernel_size_bytes : 0);
+	if (workspace_buffer == NULL) {
+		if (workspace_size == NULL) {
+			memory_block = nnp_workspace_acquire_block(memory_size);
+			if (memory_block == NULL) {
+				return nnp_status_out_of_memory;
+			}
+		} else {
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	} else {
+		if (*workspace_size < memory_size) {
+			return nnp_status_insufficient_buffer;
+		}
+		memory_block = workspace_buffer;
+	}
+
+	float* phase_input = memory_block + phase_input_offset;
+	const float* phase_kernel = kernel;
+	if (split_kernel) {
+		NNP_KERNEL_TRANSFORM_START(profile)
+		polyphase_kernel_context.phase_kernel = memory_block + phase_kernel_offset;
+		pthreadpool_compute_2d(threadpool,
+			(pthreadpool_function_2d_t) compute_polyphase_kernel,
+			&polyphase_kernel_context,
+			output_channels, group_input_channels);
+		NNP_KERNEL_TRANSFORM_END(profile)
+		phase_kernel = polyphase_kernel_context.phase_kernel;
+	}
+
+	NNP_INPUT_TRANSFORM_START(profile)
+	struct polyphase_input_context polyphase_input_context = {
+		.input = input,
+		.phase_input = phase_input,
+		.phases = phases,
+		.channels = fxdiv_init_size_t(input_channels),
+		.phase_stride = 1,
+		.channel_stride = phases,
+		.phase_step_width = fxdiv_init_size_t(output_subsampling.width),
+		.phase_step_height = output_subsampling.height,
+		.input_size = input_size,
+		.input_padding_top = input_padding.top,
+		.input_padding_left = input_padding.left,
+		.phase_input_size = phase_input_size,
+	};
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_polyphase_input,
+		&polyphase_input_context,
+		batch_size * input_channels, phases);
+	NNP_INPUT_TRANSFORM_END(profile)
+
+	/* Output of the phase convolution is the output of the strided convolution */
+	status = compute_fast_convolution_inference(
+		setup, transform_strategy,
+		batch_size, groups, phase_input_channels, output_channels,
+		phase_input_size, phase_input_padding, phase_kernel_size, phase_output_subsampling,
+		phase_input, phase_kernel, bias, residual, output, memory_block, &phase_workspace_size,
+		threadpool, profile);
+
+	if (memory_block != workspace_buffer) {
+		nnp_workspace_release_block(memory_block, memory_size);
+	}
+	return status;
+}
+
+static enum nnp_status compute_gemm_convolution_inference(
+	const struct convolution_setup setup[restrict static 1],
+	const enum nnp_convolution_transform_strategy transform_strategy,
+	const size_t batch_size,
+	const size_t groups,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	enum nnp_status status = nnp_status_success;
+	void* memory_block = NULL;
+	size_t memory_size = 0;
+	const size_t simd_width = nnp_hwinfo.simd_width;
+	const struct nnp_size output_size = setup->output_size;
+
+	const size_t output_channels_subblock_max = setup->blocking.gemm.output_channels_subblock_max;
+	const size_t output_image_subblock_max = setup->blocking.gemm.output_image_subblock_max;
+	const size_t reduction_block_max = setup->blocking.gemm.reduction_block_max;
+	const size_t output_channels_block_max = setup->blocking.gemm.output_channels_block_max;
+	const size_t output_image_block_max = setup->blocking.gemm.output_image_block_max;
+
+	/*
+	 * With grouped convolution every group is a separate GEMM over its own input channels. Output channels of each
+	 * group are padded to whole blocks in the iteration space, so that all groups are multiplied in one dispatch.
+	 */
+	const size_t group_input_channels = input_channels / groups;
+	const size_t group_output_channels = output_channels / groups;
+	const size_t output_channels_subblock_group_range = round_up(group_output_channels, output_channels_subblock_max);
+	const size_t output_channels_block_group_range = round_up(group_output_channels, output_channels_block_max);
+
+	const size_t reduction_size = group_input_channels * kernel_size.height * kernel_size.width;
+	const size_t input_image_size = input_size.height * input_size.width;
+	const size_t output_image_size = output_size.height * output_size.width;
 
 	switch (transform_strategy) {
 		case nnp_convolution_transform_strategy_compute:
@@ -775,12 +1887,12 @@ static enum nnp_status compute_gemm_convolution_inference(
 		{
 			const size_t packed_kernel_size = output_channels *
 				min(reduction_block_max, reduction_size) * sizeof(float);
-			const size_t packed_input_size = min(output_image_block_max, round_up(output_image_size, simd_width)) *
+			const size_t packed_input_size = groups * min(output_image_block_max, round_up(output_image_size, simd_width)) *
 				min(reduction_block_max, reduction_size) * sizeof(float);
 			memory_size = packed_kernel_size + packed_input_size;
 			if (workspace_buffer == NULL) {
 				if (workspace_size == NULL) {
-					memory_block = allocate_memory(memory_size);
+					memory_block = nnp_workspace_acquire_block(memory_size);
 					if (memory_block == NULL) {
 						return nnp_status_out_of_memory;
 					}
@@ -810,91 +1922,89 @@ static enum nnp_status compute_gemm_convolution_inference(
 						.reduction_size = reduction_size,
 						.reduction_block_start = reduction_block_start,
 						.reduction_block_size = reduction_block_size,
+						.group_output_channels = group_output_channels,
+						.output_channels_group_range = fxdiv_init_size_t(output_channels_subblock_group_range),
 					};
 					pthreadpool_compute_2d_tiled(threadpool,
 						(pthreadpool_function_2d_tiled_t) compute_kernel_packing,
 						&kernel_packing_context,
-						output_channels,              reduction_block_size,
-						output_channels_subblock_max, 1);
+						groups * output_channels_subblock_group_range, reduction_block_size,
+						output_channels_subblock_max,                  1);
 					NNP_KERNEL_TRANSFORM_END(profile)
 				} else {
 					packed_kernel = (void*) kernel + output_channels * reduction_block_start * sizeof(float);
 				}
 
+				const bool pointwise = kernel_size.height * kernel_size.width == 1;
 				const struct fxdiv_divisor_size_t kernel_elements_divisor = fxdiv_init_size_t(kernel_size.height * kernel_size.width);
 				const struct fxdiv_divisor_size_t kernel_width_divisor = fxdiv_init_size_t(kernel_size.width);
 				const struct fxdiv_divisor_size_t output_width_divisor = fxdiv_init_size_t(output_size.width);
-				for (size_t output_image_block_start = 0; output_image_block_start < output_image_size; output_image_block_start += output_image_block_max) {
-					const size_t output_image_block_size = min(output_image_size - output_image_block_start, output_image_block_max);
+				/* Reuse the packed kernel block for every image in the minibatch */
+				for (size_t sample = 0; sample < batch_size; sample += 1) {
+					for (size_t output_image_block_start = 0; output_image_block_start < output_image_size; output_image_block_start += output_image_block_max) {
+						const size_t output_image_block_size = min(output_image_size - output_image_block_start, output_image_block_max);
+						const size_t packed_input_group_stride = round_up(output_image_block_size, simd_width) * reduction_block_size;
 
-					/* Pack image into L3 block */
-					NNP_INPUT_TRANSFORM_START(profile)
-					struct input_packing_context input_packing_context = {
-						.input = input,
-						.packed_input = packed_input,
-						.simd_width = simd_width,
-						.reduction_block_start = reduction_block_start,
-						.reduction_block_size = reduction_block_size,
-						.output_image_block_start = output_image_block_start,
-						.input_size = input_size,
-						.input_padding_top = input_padding.top,
-						.input_padding_left = input_padding.left,
-						.kernel_elements = kernel_elements_divisor,
-						.kernel_width = kernel_width_divisor,
-						.output_width = output_width_divisor,
-						.output_subsampling = output_subsampling,
-					};
-					pthreadpool_compute_2d_tiled(threadpool,
-						(pthreadpool_function_2d_tiled_t) compute_input_packing,
-						&input_packing_context,
-						reduction_block_size, output_image_block_size,
-						1,                    output_image_subblock_max);
-					NNP_INPUT_TRANSFORM_END(profile)
+						/* Pack image into L3 block */
+						NNP_INPUT_TRANSFORM_START(profile)
+						struct input_packing_context input_packing_context = {
+							.input = input + sample * input_channels * input_image_size,
+							.packed_input = packed_input,
+							.simd_width = simd_width,
+							.group_input_channels = group_input_channels,
+							.packed_input_group_stride = packed_input_group_stride,
+							.reduction_block_start = reduction_block_start,
+							.reduction_block_size = fxdiv_init_size_t(reduction_block_size),
+							.output_image_block_start = output_image_block_start,
+							.input_size = input_size,
+							.input_channel_stride = setup->channels_last ? 1 : input_image_size,
+							.input_pixel_stride = setup->channels_last ? input_channels : 1,
+							.input_padding_top = input_padding.top,
+							.input_padding_left = input_padding.left,
+							.kernel_elements = kernel_elements_divisor,
+							.kernel_width = kernel_width_divisor,
+							.kernel_dilation = setup->kernel_dilation,
+							.output_width = output_width_divisor,
+							.output_subsampling = output_subsampling,
+						};
+						pthreadpool_compute_2d_tiled(threadpool,
+							(pthreadpool_function_2d_tiled_t)
+								(pointwise ? compute_pointwise_input_packing : compute_input_packing),
+							&input_packing_context,
+							groups * reduction_block_size, output_image_block_size,
+							1,                             output_image_subblock_max);
+						NNP_INPUT_TRANSFORM_END(profile)
 
-					NNP_BLOCK_MULTIPLICATION_START(profile)
-					struct matrix_multiplication_context matrix_multiplication_context = {
-						.packed_kernel = packed_kernel,
-						.packed_input = packed_input,
-						.output = output,
-						.reduction_block_start = reduction_block_start,
-						.reduction_block_size = reduction_block_size,
-						.output_image_size = output_image_size,
-						.output_image_block_start = output_image_block_start,
-						.output_image_subblock_max = output_image_subblock_max,
-						.output_channels_subblock_max = output_channels_subblock_max,
-					};
-					pthreadpool_compute_2d_tiled(threadpool,
-						(pthreadpool_function_2d_tiled_t) compute_matrix_multiplication,
-						&matrix_multiplication_context,
-						output_channels,           output_image_block_size,
-						output_channels_block_max, output_image_subblock_max);
-					NNP_BLOCK_MULTIPLICATION_END(profile)
-				}
-			}
-			/* Add bias */
-			NNP_OUTPUT_TRANSFORM_START(profile)
-			switch (activation) {
-				case nnp_activation_identity:
-					for (size_t output_channel = 0; output_channel < output_channels; output_channel += 1) {
-						const float bias_value = bias[output_channel];
-						for (size_t index = 0; index < output_image_size; index += 1) {
-							output[output_channel * output_image_size + index] += bias_value;
-						}
-					}
-					break;
-				case nnp_activation_relu:
-					for (size_t output_channel = 0; output_channel < output_channels; output_channel += 1) {
-						const float bias_value = bias[output_channel];
-						for (size_t index = 0; index < output_image_size; index += 1) {
-							output[output_channel * output_image_size + index] =
-								relu(output[output_channel * output_image_size + index] + bias_value, 0.0f);
-						}
+						NNP_BLOCK_MULTIPLICATION_START(profile)
+						struct matrix_multiplication_context matrix_multiplication_context = {
+							.packed_kernel = packed_kernel,
+							.packed_input = packed_input,
+							.bias = bias,
+							.residual = residual == NULL ? NULL : residual + sample * output_channels * output_image_size,
+							.output = output + sample * output_channels * output_image_size,
+							.activation = setup->activation,
+							.reduction_size = reduction_size,
+							.reduction_block_start = reduction_block_start,
+							.reduction_block_size = reduction_block_size,
+							.output_image_size = output_image_size,
+							.output_pixel_stride = setup->channels_last ? output_channels : 1,
+							.output_image_block_start = output_image_block_start,
+							.output_image_subblock_max = output_image_subblock_max,
+							.output_channels_subblock_max = output_channels_subblock_max,
+							.group_output_channels = group_output_channels,
+							.packed_input_group_stride = packed_input_group_stride,
+							.output_channels_group_range = fxdiv_init_size_t(output_channels_block_group_range),
+						};
+						pthreadpool_compute_2d_tiled(threadpool,
+							(pthreadpool_function_2d_tiled_t) (setup->channels_last ?
+								compute_channels_last_matrix_multiplication : compute_matrix_multiplication),
+							&matrix_multiplication_context,
+							groups * output_channels_block_group_range, output_image_block_size,
+							output_channels_block_max,                  output_image_subblock_max);
+						NNP_BLOCK_MULTIPLICATION_END(profile)
 					}
-					break;
-				default:
-					NNP_UNREACHABLE;
+				}
 			}
-			NNP_OUTPUT_TRANSFORM_END(profile)
 			break;
 		}
 		case nnp_convolution_transform_strategy_precompute:
@@ -921,12 +2031,14 @@ static enum nnp_status compute_gemm_convolution_inference(
 					.reduction_size = reduction_size,
 					.reduction_block_start = reduction_block_start,
 					.reduction_block_size = reduction_block_size,
+					.group_output_channels = group_output_channels,
+					.output_channels_group_range = fxdiv_init_size_t(output_channels_subblock_group_range),
 				};
 				pthreadpool_compute_2d_tiled(threadpool,
 					(pthreadpool_function_2d_tiled_t) compute_kernel_packing,
 					&kernel_packing_context,
-					output_channels,              reduction_block_size,
-					output_channels_subblock_max, 1);
+					groups * output_channels_subblock_group_range, reduction_block_size,
+					output_channels_subblock_max,                  1);
 				NNP_KERNEL_TRANSFORM_END(profile)
 			}
 			break;
@@ -936,77 +2048,132 @@ static enum nnp_status compute_gemm_convolution_inference(
 	}
 
 	if (memory_block != workspace_buffer) {
-		release_memory(memory_block, memory_size);
+		nnp_workspace_release_block(memory_block, memory_size);
 	}
 	return status;
 }
 
 static enum nnp_status compute_direct_convolution_inference(
+	const struct convolution_setup setup[restrict static 1],
+	const size_t batch_size,
+	const size_t groups,
 	const size_t input_channels,
 	const size_t output_channels,
 	const struct nnp_size image_size,
+	const struct nnp_padding input_padding,
 	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
 	const float* input,
 	const float* kernel,
 	const float* bias,
+	const float* residual,
 	float* output,
 	void* workspace_buffer,
 	size_t* workspace_size,
-	enum nnp_activation activation,
 	pthreadpool_t threadpool,
 	struct nnp_profile* profile)
 {
 	const size_t image_elements = image_size.height * image_size.width;
 
+	/*
+	 * The 1x1 micro-kernels stream the whole input image of a group for every block of output channels. When the image
+	 * does not fit into L2 cache, it would be re-read from memory, so use the packed and cache-blocked GEMM engine.
+	 * The GEMM engine also handles subsampling and channels-last tensors.
+	 */
+	if (setup->channels_last || max(output_subsampling.height, output_subsampling.width) > 1 ||
+		(input_channels / groups) * image_elements * sizeof(float) > nnp_hwinfo.blocking.l2)
+	{
+		return compute_gemm_convolution_inference(
+			setup, nnp_convolution_transform_strategy_compute,
+			batch_size, groups, input_channels, output_channels,
+			image_size, input_padding, kernel_size, output_subsampling,
+			input, kernel, bias, residual, output, workspace_buffer, workspace_size,
+			threadpool, profile);
+	}
+
 	if (workspace_buffer == NULL && workspace_size != NULL) {
 		*workspace_size = 0;
 		return nnp_status_success;
 	}
 
+	const size_t group_output_channels = output_channels / groups;
+	const size_t output_channels_group_range = round_up(group_output_channels, nnp_hwinfo.conv1x1.nr);
+
+	/* Bias and activation are applied by the parallel tasks, so the output is not traversed again */
 	NNP_BLOCK_MULTIPLICATION_START(profile)
 	struct direct_convolution_context direct_convolution_context = {
 		.input = input,
 		.kernel = kernel,
+		.bias = bias,
+		.residual = residual,
 		.output = output,
+		.activation = setup->activation,
 		.image_elements = image_elements,
 		.input_channels = input_channels,
+		.group_input_channels = input_channels / groups,
 		.input_channels_block_max = nnp_hwinfo.conv1x1.mr,
+		.output_channels = output_channels,
+		.group_output_channels = group_output_channels,
 		.output_channels_block_max = nnp_hwinfo.conv1x1.nr,
+		.output_channels_group_range = fxdiv_init_size_t(output_channels_group_range),
 		.fast_conv = nnp_hwinfo.conv1x1.only_mr_x_nr,
 		.full_conv = nnp_hwinfo.conv1x1.upto_mr_x_nr,
 	};
-	pthreadpool_compute_1d_tiled(threadpool,
-		(pthreadpool_function_1d_tiled_t) compute_direct_convolution,
+	pthreadpool_compute_2d_tiled(threadpool,
+		(pthreadpool_function_2d_tiled_t) compute_direct_convolution,
 		&direct_convolution_context,
-		output_channels, nnp_hwinfo.conv1x1.nr);
+		batch_size, groups * output_channels_group_range,
+		1,          nnp_hwinfo.conv1x1.nr);
 	NNP_BLOCK_MULTIPLICATION_END(profile)
 
-	/* Add bias */
-	NNP_OUTPUT_TRANSFORM_START(profile)
-	switch (activation) {
-		case nnp_activation_identity:
-			for (size_t output_channel = 0; output_channel < output_channels; output_channel += 1) {
-				const float bias_value = bias[output_channel];
-				for (size_t index = 0; index < image_elements; index += 1) {
-					output[output_channel * image_elements + index] += bias_value;
-				}
-			}
-			break;
-		case nnp_activation_relu:
-			for (size_t output_channel = 0; output_channel < output_channels; output_channel += 1) {
-				const float bias_value = bias[output_channel];
-				for (size_t index = 0; index < image_elements; index += 1) {
-					output[output_channel * image_elements + index] =
-						relu(output[output_channel * image_elements + index] + bias_value, 0.0f);
-				}
-			}
-			break;
-		default:
-			NNP_UNREACHABLE;
+	return nnp_status_success;
+}
+
+/*
+ * Chooses the Winograd tile size for a 3x3 stride-1 convolution. Small feature maps waste most of an 8x8 tile on
+ * padding, so smaller tiles are used when they need fewer transformed elements in total.
+ * The 4x4 tiles have higher per-output cost, so they are only chosen for outputs of at most 2 pixels.
+ */
+static inline enum nnp_convolution_algorithm select_winograd_algorithm(struct nnp_size output_size) {
+	const size_t elements_8x8 = 8 * 8 *
+		divide_round_up(output_size.height, 6) * divide_round_up(output_size.width, 6);
+	const size_t elements_6x6 = 6 * 6 *
+		divide_round_up(output_size.height, 4) * divide_round_up(output_size.width, 4);
+	if (max(output_size.height, output_size.width) <= 2) {
+		return nnp_convolution_algorithm_wt4x4;
+	} else if (elements_6x6 < elements_8x8) {
+		return nnp_convolution_algorithm_wt6x6;
+	} else {
+		return nnp_convolution_algorithm_wt8x8;
 	}
-	NNP_OUTPUT_TRANSFORM_END(profile)
+}
 
-	return nnp_status_success;
+/*
+ * Chooses the FFT tile size for a stride-1 convolution with a kernel of at most 16x16, or returns
+ * nnp_convolution_algorithm_auto if the kernel does not fit into a tile.
+ */
+static inline enum nnp_convolution_algorithm select_fft_algorithm(
+	struct nnp_size kernel_size,
+	struct nnp_size output_size)
+{
+	if (max(kernel_size.height, kernel_size.width) <= 8) {
+		/* Decide between FFT 8x8 and FFT 16x16 */
+		const size_t tile_count_8x8 =
+			divide_round_up(output_size.height, 8 - kernel_size.height + 1) *
+			divide_round_up(output_size.width, 8 - kernel_size.width + 1);
+		const size_t tile_count_16x16 =
+			divide_round_up(output_size.height, 16 - kernel_size.height + 1) *
+			divide_round_up(output_size.width, 16 - kernel_size.width + 1);
+		if (tile_count_8x8 <= 4 * tile_count_16x16) {
+			/* 8x8 tiles are more efficient */
+			return nnp_convolution_algorithm_ft8x8;
+		} else {
+			return nnp_convolution_algorithm_ft16x16;
+		}
+	} else if (max(kernel_size.height, kernel_size.width) <= 16) {
+		return nnp_convolution_algorithm_ft16x16;
+	}
+	return nnp_convolution_algorithm_auto;
 }
 
 static inline enum nnp_convolution_algorithm select_algorithm(
@@ -1014,202 +2181,294 @@ static inline enum nnp_convolution_algorithm select_algorithm(
 	struct nnp_size output_subsampling,
 	struct nnp_size output_size)
 {
-	if (max(output_subsampling.height, output_subsampling.width) == 1) {
-		/* Stride-1 convolution: consider fast convolution algorithm and direct 1x1 */
-		if (max(kernel_size.height, kernel_size.width) == 1) {
-			return nnp_convolution_algorithm_direct;
-		} else if (kernel_size.height == 3 && kernel_size.width == 3) {
-			return nnp_convolution_algorithm_wt8x8;
+	enum nnp_convolution_algorithm algorithm = nnp_convolution_algorithm_auto;
+	if (max(kernel_size.height, kernel_size.width) == 1) {
+		/* 1x1 convolution, possibly strided (e.g. ResNet downsampling) */
+		return nnp_convolution_algorithm_direct;
+	} else if (max(output_subsampling.height, output_subsampling.width) == 1) {
+		/* Stride-1 convolution: consider fast convolution algorithm */
+		if (kernel_size.height == 3 && kernel_size.width == 3) {
+			return select_winograd_algorithm(output_size);
 		} else if (min(kernel_size.height, kernel_size.width) >= 2) {
 			/* Consider FFT-based fast convolution */
-			if (max(kernel_size.height, kernel_size.width) <= 8) {
-				/* Decide between FFT 8x8 and FFT 16x16 */
-				const size_t tile_count_8x8 =
-					divide_round_up(output_size.height, 8 - kernel_size.height + 1) *
-					divide_round_up(output_size.width, 8 - kernel_size.width + 1);
-				const size_t tile_count_16x16 =
-					divide_round_up(output_size.height, 16 - kernel_size.height + 1) *
-					divide_round_up(output_size.width, 16 - kernel_size.width + 1);
-				if (tile_count_8x8 <= 4 * tile_count_16x16) {
-					/* 8x8 tiles are more efficient */
-					return nnp_convolution_algorithm_ft8x8;
-				} else {
-					return nnp_convolution_algorithm_ft16x16;
-				}
-			} else if (max(kernel_size.height, kernel_size.width) <= 16) {
-				return nnp_convolution_algorithm_ft16x16;
-			}
+			algorithm = select_fft_algorithm(kernel_size, output_size);
+		}
+	} else if (min(kernel_size.height, kernel_size.width) >= 5) {
+		/*
+		 * Strided large-kernel convolution (e.g. 5x5 or 7x7 stride-2 stems, AlexNet 11x11 stride-4 conv1):
+		 * consider FFT-based fast convolution of the polyphase decomposition.
+		 */
+		const struct nnp_size phase_kernel = polyphase_kernel_size(kernel_size, output_subsampling);
+		if (min(phase_kernel.height, phase_kernel.width) >= 2) {
+			algorithm = select_fft_algorithm(phase_kernel, output_size);
 		}
 	}
 
+	if (algorithm != nnp_convolution_algorithm_auto) {
+		return algorithm;
+	}
+
 	/* Fall-back algorithm */
 	return nnp_convolution_algorithm_implicit_gemm;
 }
 
-enum nnp_status nnp_convolution_inference(
-	enum nnp_convolution_algorithm algorithm,
-	enum nnp_convolution_transform_strategy transform_strategy,
-	size_t input_channels,
-	size_t output_channels,
+enum nnp_convolution_algorithm nnp_convolution_heuristic_algorithm(
 	struct nnp_size input_size,
 	struct nnp_padding input_padding,
 	struct nnp_size kernel_size,
-	struct nnp_size output_subsampling,
-	const float* input,
-	const float* kernel,
-	const float* bias,
-	float* output,
-	void* workspace_buffer,
-	size_t* workspace_size,
-	enum nnp_activation activation,
-	const void* activation_parameters,
-	pthreadpool_t threadpool,
-	struct nnp_profile* profile)
+	struct nnp_size output_subsampling)
 {
-	NNP_TOTAL_START(profile)
+	const struct nnp_size output_size = {
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
+	};
+	return select_algorithm(kernel_size, output_subsampling, output_size);
+}
 
-	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
-	enum nnp_status status = validate_convolution_arguments(
-		1, input_channels, output_channels,
-		input_size, input_padding, kernel_size, output_subsampling,
-		activation, activation_parameters);
-	if (status != nnp_status_success) {
-		goto cleanup;
+/* Selects the fp32 Winograd F(6x6, 3x3) transforms; these also serve as the fallback for wt8x8_fp16 */
+static enum nnp_status setup_winograd_f6x6_3x3(
+	struct convolution_setup setup[restrict static 1],
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const enum nnp_activation transform_activation)
+{
+	if (kernel_size.height != 3 || kernel_size.width != 3) {
+		return nnp_status_unsupported_algorithm;
 	}
+	setup->tile_size = (struct nnp_size) { .height = 8, .width = 8 };
+	setup->transform_element_size = sizeof(float);
+	setup->fourier_transform = false;
 
-	if (activation_parameters != NULL) {
-		status = nnp_status_unsupported_activation_parameters;
-		goto cleanup;
+	setup->input_transform_function = nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream;
+	setup->kernel_transform_function = nnp_hwinfo.transforms.kwt_f6x6_3x3;
+	setup->output_transform_function = NULL;
+	switch (transform_activation) {
+		case nnp_activation_identity:
+			if (output_subsampling.height == 1 && output_subsampling.width == 1) {
+				setup->output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias;
+			} else if (output_subsampling.height == 2 && output_subsampling.width == 2) {
+				setup->output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3s2_with_bias;
+			}
+			break;
+		case nnp_activation_relu:
+			if (output_subsampling.height == 1 && output_subsampling.width == 1) {
+				setup->output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias_with_relu;
+			} else if (output_subsampling.height == 2 && output_subsampling.width == 2) {
+				setup->output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3s2_with_bias_with_relu;
+			}
+			break;
+		default:
+			NNP_UNREACHABLE;
 	}
+	return nnp_status_success;
+}
 
+static enum nnp_status setup_convolution_inference(
+	enum nnp_convolution_algorithm algorithm,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size kernel_dilation,
+	const struct nnp_size output_subsampling,
+	const struct output_activation activation,
+	const bool channels_last,
+	const bool residual,
+	struct convolution_setup setup[restrict static 1])
+{
+	const struct nnp_size dilated_kernel = dilated_kernel_size(kernel_size, kernel_dilation);
 	const struct nnp_size output_size = {
-		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
-		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
+		.width = (input_padding.left + input_size.width + input_padding.right - dilated_kernel.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - dilated_kernel.height) / output_subsampling.height + 1
 	};
+	const bool dilated = max(kernel_dilation.height, kernel_dilation.width) > 1;
+	const bool subsampled = max(output_subsampling.height, output_subsampling.width) > 1;
+	const struct nnp_size phase_kernel = polyphase_kernel_size(kernel_size, output_subsampling);
 
 	if (algorithm == nnp_convolution_algorithm_auto) {
-		algorithm = select_algorithm(kernel_size, output_subsampling, output_size);
+		/* Tiled algorithms see the undilated kernel and the output size of a single phase */
+		algorithm = select_algorithm(kernel_size, output_subsampling,
+			dilated ? polyphase_output_size(output_size, kernel_dilation) : output_size);
+		if (channels_last && algorithm != nnp_convolution_algorithm_direct && (dilated ||
+			(subsampled && (algorithm == nnp_convolution_algorithm_ft8x8 || algorithm == nnp_convolution_algorithm_ft16x16))))
+		{
+			/* Polyphase decompositions work on planar tensors; implicit GEMM gathers channels-last input directly */
+			algorithm = nnp_convolution_algorithm_implicit_gemm;
+		}
+	}
+
+	/*
+	 * Tiled algorithms have output transforms with fused ReLU. Other activations, and any activation after a residual
+	 * connection, are applied by the output transform task to each tile, right after the identity output transform,
+	 * while the tile is in L1 cache.
+	 */
+	const enum nnp_activation transform_activation =
+		is_relu_activation(activation) && !residual ? nnp_activation_relu : nnp_activation_identity;
+	*setup = (struct convolution_setup) {
+		.algorithm = algorithm,
+		.output_size = output_size,
+		.kernel_dilation = kernel_dilation,
+		.channels_last = channels_last,
+		.activation = activation,
+		.tile_activation = !is_identity_activation(activation) && transform_activation == nnp_activation_identity,
+	};
+	switch (algorithm) {
+		case nnp_convolution_algorithm_wt8x8:
+		case nnp_convolution_algorithm_wt8x8_fp16:
+		case nnp_convolution_algorithm_wt4x4:
+		case nnp_convolution_algorithm_wt6x6:
+			/* Phases of a strided dilated convolution are not dense, and phases are only extracted from planar tensors */
+			if (dilated && (subsampled || channels_last)) {
+				return nnp_status_unsupported_algorithm;
+			}
+			break;
+		case nnp_convolution_algorithm_ft8x8:
+		case nnp_convolution_algorithm_ft16x16:
+			if (dilated && subsampled) {
+				return nnp_status_unsupported_algorithm;
+			}
+			/* Dilated and strided convolutions are decomposed into phases, which supports only planar tensors */
+			if (channels_last && (dilated || subsampled)) {
+				return nnp_status_unsupported_algorithm;
+			}
+			break;
+		default:
+			break;
 	}
 
-	struct nnp_size tile_size;
-	size_t transform_element_size;
-	bool fourier_transform;
-	nnp_transform_2d_with_offset input_transform_function = NULL;
-	nnp_transform_2d_with_offset kernel_transform_function = NULL;
-	nnp_transform_2d_with_bias output_transform_function = NULL;
 	switch (algorithm) {
 		case nnp_convolution_algorithm_wt8x8_fp16:
-			#if NNP_BACKEND_ARM
+			#if NNP_BACKEND_ARM || NNP_BACKEND_X86_64
 				if (kernel_size.height != 3 || kernel_size.width != 3) {
-					status = nnp_status_unsupported_algorithm;
-					goto cleanup;
+					return nnp_status_unsupported_algorithm;
 				}
 				if (max(output_subsampling.height, output_subsampling.width) > 1) {
-					status = nnp_status_unsupported_algorithm;
-					goto cleanup;
+					return nnp_status_unsupported_algorithm;
 				}
-				tile_size = (struct nnp_size) { .height = 8, .width = 8 };
-				transform_element_size = sizeof(uint16_t);
-				fourier_transform = false;
+				setup->tile_size = (struct nnp_size) { .height = 8, .width = 8 };
+				setup->transform_element_size = sizeof(uint16_t);
+				setup->fourier_transform = false;
 
-				input_transform_function = nnp_hwinfo.transforms.iwt_f6x6_3x3_fp16_with_offset;
-				kernel_transform_function = nnp_hwinfo.transforms.kwt_f6x6_3x3_fp16;
-				switch (activation) {
+				setup->input_transform_function = nnp_hwinfo.transforms.iwt_f6x6_3x3_fp16_with_offset;
+				setup->kernel_transform_function = nnp_hwinfo.transforms.kwt_f6x6_3x3_fp16;
+				switch (transform_activation) {
 					case nnp_activation_identity:
-						output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias;
+						setup->output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias;
 						break;
 					case nnp_activation_relu:
-						output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias_with_relu;
+						setup->output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias_with_relu;
 						break;
 					default:
 						NNP_UNREACHABLE;
 				}
-				if (input_transform_function != NULL && kernel_transform_function != NULL && output_transform_function != NULL) {
+				if (setup->input_transform_function != NULL &&
+					setup->kernel_transform_function != NULL &&
+					setup->output_transform_function != NULL)
+				{
 					break;
 				}
 			#endif
+		{
 			/*
-			 * Fallthrough otherwise. The rationale here is that only some backends have fp16 storage natively implemented
-			 * (e.g. ARM NEON + VFP_FP16 currently), while configuration is (currently) fairly platform-independent.
+			 * Use fp32 transforms otherwise. The rationale here is that only some backends have fp16 storage natively
+			 * implemented (ARM NEON + VFP_FP16 and x86-64 AVX2 + F16C currently), while configuration is (currently)
+			 * fairly platform-independent.
 			 * Thus silently falling back to the baseline Winograd implementation is reasonable.
 			 */
+			const enum nnp_status status =
+				setup_winograd_f6x6_3x3(setup, kernel_size, output_subsampling, transform_activation);
+			if (status != nnp_status_success) {
+				return status;
+			}
+			break;
+		}
 		case nnp_convolution_algorithm_wt8x8:
+		{
+			const enum nnp_status status =
+				setup_winograd_f6x6_3x3(setup, kernel_size, output_subsampling, transform_activation);
+			if (status != nnp_status_success) {
+				return status;
+			}
+			break;
+		}
+		case nnp_convolution_algorithm_wt4x4:
+		case nnp_convolution_algorithm_wt6x6:
 			if (kernel_size.height != 3 || kernel_size.width != 3) {
-				status = nnp_status_unsupported_algorithm;
-				goto cleanup;
+				return nnp_status_unsupported_algorithm;
 			}
-			tile_size = (struct nnp_size) { .height = 8, .width = 8 };
-			transform_element_size = sizeof(float);
-			fourier_transform = false;
-
-			input_transform_function = nnp_hwinfo.transforms.iwt_f6x6_3x3_with_offset_and_stream;
-			kernel_transform_function = nnp_hwinfo.transforms.kwt_f6x6_3x3;
-			switch (activation) {
-				case nnp_activation_identity:
-					if (output_subsampling.height == 1 && output_subsampling.width == 1) {
-						output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias;
-					} else if (output_subsampling.height == 2 && output_subsampling.width == 2) {
-						output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3s2_with_bias;
-					}
-					break;
-				case nnp_activation_relu:
-					if (output_subsampling.height == 1 && output_subsampling.width == 1) {
-						output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias_with_relu;
-					} else if (output_subsampling.height == 2 && output_subsampling.width == 2) {
-						output_transform_function = nnp_hwinfo.transforms.owt_f6x6_3x3s2_with_bias_with_relu;
-					}
-					break;
-				default:
-					NNP_UNREACHABLE;
+			if (max(output_subsampling.height, output_subsampling.width) > 1) {
+				return nnp_status_unsupported_algorithm;
+			}
+			setup->transform_element_size = sizeof(float);
+			setup->fourier_transform = false;
+			if (algorithm == nnp_convolution_algorithm_wt4x4) {
+				setup->tile_size = (struct nnp_size) { .height = 4, .width = 4 };
+				setup->input_transform_function = nnp_hwinfo.transforms.iwt_f2x2_3x3_with_offset;
+				setup->kernel_transform_function = nnp_hwinfo.transforms.kwt_f2x2_3x3;
+				switch (transform_activation) {
+					case nnp_activation_identity:
+						setup->output_transform_function = nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias;
+						break;
+					case nnp_activation_relu:
+						setup->output_transform_function = nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias_with_relu;
+						break;
+					default:
+						NNP_UNREACHABLE;
+				}
+			} else {
+				setup->tile_size = (struct nnp_size) { .height = 6, .width = 6 };
+				setup->input_transform_function = nnp_hwinfo.transforms.iwt_f4x4_3x3_with_offset;
+				setup->kernel_transform_function = nnp_hwinfo.transforms.kwt_f4x4_3x3;
+				switch (transform_activation) {
+					case nnp_activation_identity:
+						setup->output_transform_function = nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias;
+						break;
+					case nnp_activation_relu:
+						setup->output_transform_function = nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias_with_relu;
+						break;
+					default:
+						NNP_UNREACHABLE;
+				}
 			}
 			break;
 		case nnp_convolution_algorithm_ft8x8:
-			if (max(kernel_size.height, kernel_size.width) > 8) {
-				status = nnp_status_unsupported_algorithm;
-				goto cleanup;
+			/* Strided convolutions are decomposed into dense convolutions with phases of the kernel */
+			if (max(phase_kernel.height, phase_kernel.width) > 8) {
+				return nnp_status_unsupported_algorithm;
 			}
-			if (max(output_subsampling.height, output_subsampling.width) > 1) {
-				status = nnp_status_unsupported_algorithm;
-				goto cleanup;
-			}
-			tile_size = (struct nnp_size) { .height = 8, .width = 8 };
-			transform_element_size = sizeof(float);
-			fourier_transform = true;
+			setup->tile_size = (struct nnp_size) { .height = 8, .width = 8 };
+			setup->transform_element_size = sizeof(float);
+			setup->fourier_transform = true;
 
-			input_transform_function = nnp_hwinfo.transforms.fft8x8_with_offset_and_stream;
-			kernel_transform_function = nnp_hwinfo.transforms.fft8x8_with_offset_and_stream;
-			switch (activation) {
+			setup->input_transform_function = nnp_hwinfo.transforms.fft8x8_with_offset_and_stream;
+			setup->kernel_transform_function = nnp_hwinfo.transforms.fft8x8_with_offset_and_stream;
+			switch (transform_activation) {
 				case nnp_activation_identity:
-					output_transform_function = nnp_hwinfo.transforms.ifft8x8_with_bias;
+					setup->output_transform_function = nnp_hwinfo.transforms.ifft8x8_with_bias;
 					break;
 				case nnp_activation_relu:
-					output_transform_function = nnp_hwinfo.transforms.ifft8x8_with_bias_with_relu;
+					setup->output_transform_function = nnp_hwinfo.transforms.ifft8x8_with_bias_with_relu;
 					break;
 				default:
 					NNP_UNREACHABLE;
 			}
 			break;
 		case nnp_convolution_algorithm_ft16x16:
-			if (max(kernel_size.height, kernel_size.width) > 16) {
-				status = nnp_status_unsupported_algorithm;
-				goto cleanup;
+			/* Strided convolutions are decomposed into dense convolutions with phases of the kernel */
+			if (max(phase_kernel.height, phase_kernel.width) > 16) {
+				return nnp_status_unsupported_algorithm;
 			}
-			if (max(output_subsampling.height, output_subsampling.width) > 1) {
-				status = nnp_status_unsupported_algorithm;
-				goto cleanup;
-			}
-			tile_size = (struct nnp_size) { .height = 16, .width = 16 };
-			transform_element_size = sizeof(float);
-			fourier_transform = true;
+			setup->tile_size = (struct nnp_size) { .height = 16, .width = 16 };
+			setup->transform_element_size = sizeof(float);
+			setup->fourier_transform = true;
 
-			input_transform_function = nnp_hwinfo.transforms.fft16x16_with_offset_and_stream;
-			kernel_transform_function = nnp_hwinfo.transforms.fft16x16_with_offset_and_stream;
-			switch (activation) {
+			setup->input_transform_function = nnp_hwinfo.transforms.fft16x16_with_offset_and_stream;
+			setup->kernel_transform_function = nnp_hwinfo.transforms.fft16x16_with_offset_and_stream;
+			switch (transform_activation) {
 				case nnp_activation_identity:
-					output_transform_function = nnp_hwinfo.transforms.ifft16x16_with_bias;
+					setup->output_transform_function = nnp_hwinfo.transforms.ifft16x16_with_bias;
 					break;
 				case nnp_activation_relu:
-					output_transform_function = nnp_hwinfo.transforms.ifft16x16_with_bias_with_relu;
+					setup->output_transform_function = nnp_hwinfo.transforms.ifft16x16_with_bias_with_relu;
 					break;
 				default:
 					NNP_UNREACHABLE;
@@ -1219,63 +2478,1688 @@ enum nnp_status nnp_convolution_inference(
 			break;
 		case nnp_convolution_algorithm_direct:
 			if (max(kernel_size.height, kernel_size.width) > 1) {
-				status = nnp_status_unsupported_algorithm;
-				goto cleanup;
-			}
-			if (max(output_subsampling.height, output_subsampling.width) > 1) {
-				status = nnp_status_unsupported_algorithm;
-				goto cleanup;
+				return nnp_status_unsupported_algorithm;
 			}
 			break;
 		case nnp_convolution_algorithm_auto:
 			NNP_UNREACHABLE;
 		default:
-			status = nnp_status_invalid_algorithm;
-			goto cleanup;
+			return nnp_status_invalid_algorithm;
 	}
 
+	/* Calculate cache blocking parameters */
 	switch (algorithm) {
 		case nnp_convolution_algorithm_wt8x8:
 		case nnp_convolution_algorithm_wt8x8_fp16:
+		case nnp_convolution_algorithm_wt4x4:
+		case nnp_convolution_algorithm_wt6x6:
 		case nnp_convolution_algorithm_ft8x8:
 		case nnp_convolution_algorithm_ft16x16:
-			if (input_transform_function == NULL || kernel_transform_function == NULL || output_transform_function == NULL) {
-				status = nnp_status_unsupported_algorithm;
-				goto cleanup;
+		{
+			if (setup->input_transform_function == NULL ||
+				setup->kernel_transform_function == NULL ||
+				setup->output_transform_function == NULL)
+			{
+				return nnp_status_unsupported_algorithm;
 			}
-			status = compute_fast_convolution_inference(
-				fourier_transform, transform_strategy, transform_element_size,
-				input_channels, output_channels,
-				tile_size, input_size, input_padding, kernel_size, output_size, output_subsampling,
-				input, kernel, bias, output, workspace_buffer, workspace_size,
-				input_transform_function, kernel_transform_function, output_transform_function,
-				threadpool, profile);
+
+			const size_t simd_width = nnp_hwinfo.simd_width;
+			const size_t tuple_elements = (setup->fourier_transform ? simd_width * 2 : simd_width);
+			const size_t tuple_size = tuple_elements * setup->transform_element_size;
+
+			const size_t cache_elements_l1 = nnp_hwinfo.blocking.l1 / tuple_size;
+			const size_t cache_elements_l2 = nnp_hwinfo.blocking.l2 / tuple_size;
+			const size_t cache_elements_l3 = nnp_hwinfo.blocking.l3 / tuple_size;
+
+			const size_t tiles_subblock_max = (setup->fourier_transform ? nnp_hwinfo.cxgemm.mr : nnp_hwinfo.sxgemm.mr);
+			const size_t output_channels_subblock_max = (setup->fourier_transform ? nnp_hwinfo.cxgemm.nr : nnp_hwinfo.sxgemm.nr);
+
+			const size_t input_channels_block_max =
+				round_down(cache_elements_l1 / (tiles_subblock_max + output_channels_subblock_max), 2);
+			setup->blocking.fast.tiles_subblock_max = tiles_subblock_max;
+			setup->blocking.fast.output_channels_subblock_max = output_channels_subblock_max;
+			setup->blocking.fast.input_channels_block_max = input_channels_block_max;
+			setup->blocking.fast.tiles_block_max =
+				round_down(cache_elements_l2 / input_channels_block_max, tiles_subblock_max);
+			setup->blocking.fast.output_channels_block_max =
+				round_down(cache_elements_l3 / input_channels_block_max, output_channels_subblock_max);
 			break;
+		}
 		case nnp_convolution_algorithm_implicit_gemm:
-			status = compute_gemm_convolution_inference(
-				transform_strategy,
-				input_channels, output_channels,
-				input_size, input_padding, kernel_size, output_size, output_subsampling,
-				input, kernel, bias, output, workspace_buffer, workspace_size,
-				activation,
-				threadpool, profile);
+		case nnp_convolution_algorithm_direct:
+		{
+			/* Direct 1x1 convolution uses the GEMM engine for large and strided layers */
+			setup->blocking.gemm = gemm_blocking(nnp_hwinfo.sgemm.mr, nnp_hwinfo.sgemm.nr, sizeof(float));
 			break;
+		}
+		default:
+			break;
+	}
+
+	return nnp_status_success;
+}
+
+static enum nnp_status compute_convolution_inference(
+	const struct convolution_setup setup[restrict static 1],
+	const enum nnp_convolution_transform_strategy transform_strategy,
+	const size_t batch_size,
+	const size_t groups,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	switch (setup->algorithm) {
+		case nnp_convolution_algorithm_wt8x8:
+		case nnp_convolution_algorithm_wt8x8_fp16:
+		case nnp_convolution_algorithm_wt4x4:
+		case nnp_convolution_algorithm_wt6x6:
+		case nnp_convolution_algorithm_ft8x8:
+		case nnp_convolution_algorithm_ft16x16:
+			if (max(setup->kernel_dilation.height, setup->kernel_dilation.width) > 1) {
+				return compute_dilated_convolution_inference(
+					setup, transform_strategy,
+					batch_size, groups, input_channels, output_channels,
+					input_size, input_padding, kernel_size,
+					input, kernel, bias, residual, output, workspace_buffer, workspace_size,
+					threadpool, profile);
+			}
+			if (max(output_subsampling.height, output_subsampling.width) > 1 && setup->fourier_transform) {
+				return compute_strided_convolution_inference(
+					setup, transform_strategy,
+					batch_size, groups, input_channels, output_channels,
+					input_size, input_padding, kernel_size, output_subsampling,
+					input, kernel, bias, residual, output, workspace_buffer, workspace_size,
+					threadpool, profile);
+			}
+			return compute_fast_convolution_inference(
+				setup, transform_strategy,
+				batch_size, groups, input_channels, output_channels,
+				input_size, input_padding, kernel_size, output_subsampling,
+				input, kernel, bias, residual, output, workspace_buffer, workspace_size,
+				threadpool, profile);
+		case nnp_convolution_algorithm_implicit_gemm:
+			return compute_gemm_convolution_inference(
+				setup, transform_strategy,
+				batch_size, groups, input_channels, output_channels,
+				input_size, input_padding, kernel_size, output_subsampling,
+				input, kernel, bias, residual, output, workspace_buffer, workspace_size,
+				threadpool, profile);
 		case nnp_convolution_algorithm_direct:
 			if (transform_strategy != nnp_convolution_transform_strategy_compute) {
-				status = nnp_status_unsupported_transform_strategy;
-				goto cleanup;
+				return nnp_status_unsupported_transform_strategy;
 			}
-			status = compute_direct_convolution_inference(
-				input_channels, output_channels, input_size, kernel_size,
-				input, kernel, bias, output, workspace_buffer, workspace_size,
-				activation,
+			return compute_direct_convolution_inference(
+				setup,
+				batch_size, groups, input_channels, output_channels,
+				input_size, input_padding, kernel_size, output_subsampling,
+				input, kernel, bias, residual, output, workspace_buffer, workspace_size,
 				threadpool, profile);
-			break;
-		case nnp_convolution_algorithm_auto:
+		default:
 			NNP_UNREACHABLE;
 	}
+}
+
+/*
+ * Max-pooling is fused into the output transform of tiled algorithms when pooling windows do not overlap and
+ * output tiles are multiples of the pooling window, so that no window straddles tiles.
+ */
+static bool fused_pooling_supported(
+	const struct convolution_setup setup[restrict static 1],
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const struct nnp_size pooling_size,
+	const struct nnp_size pooling_stride)
+{
+	switch (setup->algorithm) {
+		case nnp_convolution_algorithm_wt8x8:
+		case nnp_convolution_algorithm_wt8x8_fp16:
+		case nnp_convolution_algorithm_wt4x4:
+		case nnp_convolution_algorithm_wt6x6:
+		case nnp_convolution_algorithm_ft8x8:
+		case nnp_convolution_algorithm_ft16x16:
+			break;
+		default:
+			return false;
+	}
+	if (setup->channels_last || max(setup->kernel_dilation.height, setup->kernel_dilation.width) > 1) {
+		return false;
+	}
+	if (pooling_size.height != pooling_stride.height || pooling_size.width != pooling_stride.width) {
+		return false;
+	}
+	const struct nnp_size output_tile = tiled_output_tile_size(setup, kernel_size, output_subsampling);
+	return output_tile.height % pooling_size.height == 0 && output_tile.width % pooling_size.width == 0;
+}
+
+/*
+ * Convolution followed by max-pooling which can not be fused into the output transform: the full-resolution output
+ * (with the residual, if any) is computed into the workspace and pooled from there, in the layout of the output.
+ */
+static enum nnp_status compute_unfused_pooling_convolution_inference(
+	const struct convolution_setup setup[restrict static 1],
+	const enum nnp_convolution_transform_strategy transform_strategy,
+	const size_t batch_size,
+	const size_t groups,
+	const size_t input_channels,
+	const size_t output_channels,
+	const struct nnp_size input_size,
+	const struct nnp_padding input_padding,
+	const struct nnp_size kernel_size,
+	const struct nnp_size output_subsampling,
+	const struct nnp_size pooling_size,
+	const struct nnp_size pooling_stride,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	void* memory_block = NULL;
+	size_t memory_size = 0;
+	const struct nnp_size output_size = setup->output_size;
+
+	size_t convolution_workspace_size = 0;
+	enum nnp_status status = compute_convolution_inference(
+		setup, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		NULL, NULL, NULL, NULL, NULL, NULL, &convolution_workspace_size,
+		threadpool, NULL);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	const size_t convolution_output_offset = round_up(convolution_workspace_size, 64);
+	memory_size = convolution_output_offset +
+		batch_size * output_channels * output_size.height * output_size.width * sizeof(float);
+	if (workspace_buffer == NULL) {
+		if (workspace_size == NULL) {
+			memory_block = nnp_workspace_acquire_block(memory_size);
+			if (memory_block == NULL) {
+				return nnp_status_out_of_memory;
+			}
+		} else {
+			*workspace_size = memory_size;
+			return nnp_status_success;
+		}
+	} else {
+		if (*workspace_size < memory_size) {
+			return nnp_status_insufficient_buffer;
+		}
+		memory_block = workspace_buffer;
+	}
+
+	float* convolution_output = memory_block + convolution_output_offset;
+	status = compute_convolution_inference(
+		setup, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		input, kernel, bias, residual, convolution_output, memory_block, &convolution_workspace_size,
+		threadpool, profile);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	NNP_OUTPUT_TRANSFORM_START(profile)
+	const struct nnp_padding pooling_padding = { 0 };
+	if (setup->channels_last) {
+		status = nnp_max_pooling_output_nhwc(
+			batch_size, output_channels,
+			output_size, pooling_padding, pooling_size, pooling_stride,
+			convolution_output, output,
+			threadpool);
+	} else {
+		status = nnp_max_pooling_output(
+			batch_size, output_channels,
+			output_size, pooling_padding, pooling_size, pooling_stride,
+			convolution_output, output,
+			threadpool);
+	}
+	NNP_OUTPUT_TRANSFORM_END(profile)
+
+cleanup:
+	if (memory_block != workspace_buffer) {
+		nnp_workspace_release_block(memory_block, memory_size);
+	}
+	return status;
+}
+
+/*
+ * Prefers the algorithm tuned for this shape on this machine; otherwise, setup falls back to the heuristic.
+ * The tuning cache is keyed by dense convolution shapes on planar tensors: grouped, dilated, and channels-last
+ * convolutions use the heuristic.
+ */
+static enum nnp_convolution_algorithm tuned_convolution_algorithm(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	enum nnp_activation activation,
+	bool channels_last,
+	pthreadpool_t threadpool)
+{
+	const bool dilated = max(kernel_dilation.height, kernel_dilation.width) > 1;
+	if (algorithm == nnp_convolution_algorithm_auto && groups == 1 && !dilated && !channels_last) {
+		const struct nnp_convolution_shape shape = {
+			.batch_size = batch_size,
+			.input_channels = input_channels,
+			.output_channels = output_channels,
+			.input_size = input_size,
+			.input_padding = input_padding,
+			.kernel_size = kernel_size,
+			.output_subsampling = output_subsampling,
+			.activation = activation,
+		};
+		nnp_autotune_lookup(&shape, nnp_autotune_threads_count(threadpool), &algorithm, NULL);
+	}
+	return algorithm;
+}
+
+/*
+ * Takes the kernel transform for the call from the kernel cache, or transforms the kernel and inserts the transform.
+ * Sets transformed_kernel to NULL if the algorithm consumes the kernel as is, or if the transform does not fit into the
+ * cache; then the call transforms the kernel in its workspace as usual. The transform must be released with
+ * nnp_kernel_cache_release.
+ */
+static enum nnp_status acquire_cached_kernel_transform(
+	const struct convolution_setup setup[restrict static 1],
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	enum nnp_activation activation,
+	const float* kernel,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile,
+	const void** transformed_kernel_out)
+{
+	*transformed_kernel_out = NULL;
+
+	struct nnp_kernel_cache_key key;
+	nnp_kernel_cache_key(&key, setup->algorithm,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, setup->kernel_dilation, output_subsampling,
+		activation, setup->channels_last, kernel);
+	const void* cached_kernel = nnp_kernel_cache_acquire(&key);
+	if (cached_kernel != NULL) {
+		*transformed_kernel_out = cached_kernel;
+		return nnp_status_success;
+	}
+
+	size_t transformed_kernel_size = 0;
+	enum nnp_status status = compute_convolution_inference(
+		setup, nnp_convolution_transform_strategy_precompute,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		NULL, kernel, NULL, NULL, NULL, NULL, &transformed_kernel_size,
+		threadpool, NULL);
+	if (status != nnp_status_success || transformed_kernel_size > nnp_kernel_cache_budget()) {
+		/* The kernel has no transform to precompute (e.g. direct convolution), or the transform can never be cached */
+		return nnp_status_success;
+	}
+
+	void* transformed_kernel = allocate_memory(transformed_kernel_size);
+	if (transformed_kernel == NULL) {
+		return nnp_status_success;
+	}
+	status = compute_convolution_inference(
+		setup, nnp_convolution_transform_strategy_precompute,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		NULL, kernel, NULL, NULL, NULL, transformed_kernel, &transformed_kernel_size,
+		threadpool, profile);
+	if (status != nnp_status_success || !nnp_kernel_cache_insert(&key, transformed_kernel, transformed_kernel_size)) {
+		release_memory(transformed_kernel, transformed_kernel_size);
+		return status;
+	}
+
+	*transformed_kernel_out = transformed_kernel;
+	return nnp_status_success;
+}
+
+static enum nnp_status convolution_inference(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	bool channels_last,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	bool kernel_cache,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	const void* cached_kernel = NULL;
+	enum nnp_status status = validate_convolution_dilation(kernel_dilation);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	/*
+	 * Basic validation of parameters. This check detects invalid, but not unsupported parameters.
+	 * Padding is validated against the dilated kernel, which determines the output size.
+	 */
+	status = validate_convolution_arguments(
+		batch_size, input_channels, output_channels,
+		input_size, input_padding, dilated_kernel_size(kernel_size, kernel_dilation), output_subsampling,
+		activation, activation_parameters);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	status = validate_convolution_groups(groups, input_channels, output_channels);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	algorithm = tuned_convolution_algorithm(
+		algorithm,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		activation, channels_last, threadpool);
+
+	struct convolution_setup setup;
+	status = setup_convolution_inference(
+		algorithm,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		resolve_output_activation(activation, activation_parameters), channels_last, residual != NULL, &setup);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	/* Calls which would transform the kernel reuse its transform from the kernel cache, if the cache is enabled */
+	const bool workspace_query = workspace_buffer == NULL && workspace_size != NULL;
+	if (kernel_cache && transform_strategy == nnp_convolution_transform_strategy_compute && !workspace_query &&
+		nnp_kernel_cache_budget() != 0)
+	{
+		status = acquire_cached_kernel_transform(&setup,
+			batch_size, groups, input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling,
+			activation, kernel, threadpool, profile, &cached_kernel);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+		if (cached_kernel != NULL) {
+			transform_strategy = nnp_convolution_transform_strategy_reuse;
+			kernel = cached_kernel;
+		}
+	}
+
+	/* 1x1 pooling with 1x1 stride is the identity; kernel precomputation does not produce the output */
+	const bool pooled = max(pooling_size.height, pooling_size.width) > 1 &&
+		transform_strategy != nnp_convolution_transform_strategy_precompute;
+	if (pooled) {
+		const struct nnp_padding pooling_padding = { 0 };
+		status = validate_pooling_arguments(
+			batch_size, output_channels,
+			setup.output_size, pooling_padding,
+			pooling_size, pooling_stride);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+
+		if (!fused_pooling_supported(&setup, kernel_size, output_subsampling, pooling_size, pooling_stride)) {
+			status = compute_unfused_pooling_convolution_inference(
+				&setup, transform_strategy,
+				batch_size, groups, input_channels, output_channels,
+				input_size, input_padding, kernel_size, output_subsampling,
+				pooling_size, pooling_stride,
+				input, kernel, bias, residual, output, workspace_buffer, workspace_size,
+				threadpool, profile);
+			goto cleanup;
+		}
+		setup.output_pooling = pooling_size;
+	}
+
+	status = compute_convolution_inference(
+		&setup, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		input, kernel, bias, residual, output, workspace_buffer, workspace_size,
+		threadpool, profile);
 
 cleanup:
+	if (cached_kernel != NULL) {
+		nnp_kernel_cache_release(cached_kernel);
+	}
 	NNP_TOTAL_END(profile)
 	return status;
 }
+
+/* Horizontal band of the output (after max-pooling, if any) of a block of images, and the input rows it depends on */
+struct convolution_band {
+	size_t batch_start;
+	size_t batch_size;
+	size_t output_row_start;
+	size_t output_row_count;
+	size_t input_row_start;
+	size_t input_row_count;
+	struct nnp_padding input_padding;
+};
+
+/* Convolutional layer which is computed in bands to fit into a workspace budget */
+struct banded_convolution {
+	size_t batch_size;
+	size_t groups;
+	size_t input_channels;
+	size_t output_channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	struct nnp_size kernel_dilation;
+	struct nnp_size output_subsampling;
+	struct nnp_size pooling_size;
+	struct nnp_size pooling_stride;
+	enum nnp_activation activation;
+	const void* activation_parameters;
+	bool channels_last;
+	bool pooled;
+	/* Rows of the convolution output, and of the layer output (after max-pooling, if any) */
+	size_t convolution_rows;
+	size_t output_rows;
+	/* Image planes are channels of planar images, or whole channels-last images */
+	size_t input_planes;
+	size_t output_planes;
+	size_t input_row_elements;
+	size_t output_row_elements;
+};
+
+struct band_schedule {
+	enum nnp_convolution_algorithm algorithm;
+	enum nnp_convolution_transform_strategy transform_strategy;
+	/* Size of the kernel transform computed once and reused by all bands, or 0 if every band transforms the kernel */
+	size_t kernel_transform_size;
+	size_t batch_block;
+	size_t row_block;
+	/* Workspace of the largest band, including copies of its input and output rows */
+	size_t band_workspace_size;
+};
+
+struct NNP_CACHE_ALIGN band_copy_context {
+	const float* source;
+	float* destination;
+	size_t source_plane_stride;
+	size_t destination_plane_stride;
+	size_t plane_elements;
+};
+
+static void compute_band_copy(
+	const struct band_copy_context context[restrict static 1],
+	size_t plane)
+{
+	memcpy(
+		context->destination + plane * context->destination_plane_stride,
+		context->source + plane * context->source_plane_stride,
+		context->plane_elements * sizeof(float));
+}
+
+static void copy_band_rows(
+	const float* source,
+	float* destination,
+	size_t planes,
+	size_t rows,
+	size_t source_rows,
+	size_t destination_rows,
+	size_t row_elements,
+	pthreadpool_t threadpool)
+{
+	struct band_copy_context band_copy_context = {
+		.source = source,
+		.destination = destination,
+		.source_plane_stride = source_rows * row_elements,
+		.destination_plane_stride = destination_rows * row_elements,
+		.plane_elements = rows * row_elements,
+	};
+	pthreadpool_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_band_copy,
+		&band_copy_context,
+		planes);
+}
+
+/* Bands which cover whole planes, or only one plane, are contiguous in the tensor and need no copy */
+static inline size_t band_copy_size(size_t planes, size_t rows, size_t plane_rows, size_t row_elements) {
+	if (planes == 1 || rows == plane_rows) {
+		return 0;
+	}
+	return round_up(planes * rows * row_elements * sizeof(float), 64);
+}
+
+static struct convolution_band convolution_band(
+	const struct banded_convolution layer[restrict static 1],
+	size_t batch_start, size_t batch_size,
+	size_t output_row_start, size_t output_row_count)
+{
+	size_t convolution_row_start = output_row_start;
+	size_t convolution_row_end = output_row_start + output_row_count;
+	if (layer->pooled) {
+		/* Pooling windows are clipped at the bottom edge of the convolution output */
+		convolution_row_start = output_row_start * layer->pooling_stride.height;
+		convolution_row_end = min((convolution_row_end - 1) * layer->pooling_stride.height + layer->pooling_size.height,
+			layer->convolution_rows);
+	}
+
+	/* Rows of the padded input under the kernel windows of the band; only bands at the image edges are padded */
+	const size_t kernel_height = dilated_kernel_size(layer->kernel_size, layer->kernel_dilation).height;
+	const size_t padded_row_start = convolution_row_start * layer->output_subsampling.height;
+	const size_t padded_row_end = (convolution_row_end - 1) * layer->output_subsampling.height + kernel_height;
+	const size_t input_row_start = doz(padded_row_start, layer->input_padding.top);
+	const size_t input_row_end = min(doz(padded_row_end, layer->input_padding.top), layer->input_size.height);
+	return (struct convolution_band) {
+		.batch_start = batch_start,
+		.batch_size = batch_size,
+		.output_row_start = output_row_start,
+		.output_row_count = output_row_count,
+		.input_row_start = input_row_start,
+		.input_row_count = input_row_end - input_row_start,
+		.input_padding = {
+			.top = doz(layer->input_padding.top, padded_row_start),
+			.right = layer->input_padding.right,
+			.bottom = doz(padded_row_end, layer->input_padding.top + layer->input_size.height),
+			.left = layer->input_padding.left,
+		},
+	};
+}
+
+/*
+ * Computes a band as a separate convolution of its input rows. Bands which are not contiguous in the input or output
+ * tensors are copied through the start of the band workspace, and the rest of it is the workspace of the convolution.
+ * If input, kernel, and output are NULL, only queries the workspace of the band.
+ */
+static enum nnp_status compute_convolution_band(
+	const struct banded_convolution layer[restrict static 1],
+	const struct band_schedule schedule[restrict static 1],
+	const struct convolution_band band[restrict static 1],
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool)
+{
+	const size_t input_planes = band->batch_size * layer->input_planes;
+	const size_t output_planes = band->batch_size * layer->output_planes;
+	const size_t input_copy_size =
+		band_copy_size(input_planes, band->input_row_count, layer->input_size.height, layer->input_row_elements);
+	const size_t output_copy_size =
+		band_copy_size(output_planes, band->output_row_count, layer->output_rows, layer->output_row_elements);
+	const struct nnp_size band_input_size = {
+		.width = layer->input_size.width,
+		.height = band->input_row_count,
+	};
+
+	if (input == NULL) {
+		size_t convolution_workspace_size = 0;
+		const enum nnp_status status = convolution_inference(
+			schedule->algorithm, schedule->transform_strategy,
+			band->batch_size, layer->groups, layer->input_channels, layer->output_channels,
+			band_input_size, band->input_padding, layer->kernel_size, layer->kernel_dilation, layer->output_subsampling,
+			NULL, NULL, NULL, NULL, NULL, NULL, &convolution_workspace_size,
+			layer->activation, layer->activation_parameters, layer->channels_last,
+			layer->pooling_size, layer->pooling_stride,
+			false, threadpool, NULL);
+		*workspace_size = input_copy_size + output_copy_size + round_up(convolution_workspace_size, 64);
+		return status;
+	}
+
+	const size_t input_image_elements = layer->input_planes * layer->input_size.height * layer->input_row_elements;
+	const size_t output_image_elements = layer->output_planes * layer->output_rows * layer->output_row_elements;
+	input += band->batch_start * input_image_elements + band->input_row_start * layer->input_row_elements;
+	output += band->batch_start * output_image_elements + band->output_row_start * layer->output_row_elements;
+	if (residual != NULL) {
+		residual += band->batch_start * output_image_elements + band->output_row_start * layer->output_row_elements;
+	}
+
+	const float* band_input = input;
+	if (input_copy_size != 0) {
+		band_input = workspace_buffer;
+		copy_band_rows(input, workspace_buffer, input_planes,
+			band->input_row_count, layer->input_size.height, band->input_row_count, layer->input_row_elements,
+			threadpool);
+	}
+	float* band_output = output;
+	const float* band_residual = residual;
+	if (output_copy_size != 0) {
+		band_output = workspace_buffer + input_copy_size;
+		if (residual != NULL) {
+			/* The output transforms accumulate into the residual in place */
+			band_residual = band_output;
+			copy_band_rows(residual, band_output, output_planes,
+				band->output_row_count, layer->output_rows, band->output_row_count, layer->output_row_elements,
+				threadpool);
+		}
+	}
+
+	size_t convolution_workspace_size = *workspace_size - input_copy_size - output_copy_size;
+	void* convolution_workspace = workspace_buffer + input_copy_size + output_copy_size;
+	const enum nnp_status status = convolution_inference(
+		schedule->algorithm, schedule->transform_strategy,
+		band->batch_size, layer->groups, layer->input_channels, layer->output_channels,
+		band_input_size, band->input_padding, layer->kernel_size, layer->kernel_dilation, layer->output_subsampling,
+		band_input, kernel, bias, band_residual, band_output,
+		convolution_workspace_size == 0 ? NULL : convolution_workspace,
+		convolution_workspace_size == 0 ? NULL : &convolution_workspace_size,
+		layer->activation, layer->activation_parameters, layer->channels_last,
+		layer->pooling_size, layer->pooling_stride,
+		false, threadpool, NULL);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	if (output_copy_size != 0) {
+		copy_band_rows(band_output, output, output_planes,
+			band->output_row_count, band->output_row_count, layer->output_rows, layer->output_row_elements,
+			threadpool);
+	}
+	return nnp_status_success;
+}
+
+/* Workspace of the largest band when the layer is split into blocks of batch_block images and row_block output rows */
+static enum nnp_status band_workspace_size(
+	const struct banded_convolution layer[restrict static 1],
+	const struct band_schedule schedule[restrict static 1],
+	size_t batch_block,
+	size_t row_block,
+	size_t workspace_size[restrict static 1],
+	pthreadpool_t threadpool)
+{
+	*workspace_size = 0;
+	for (size_t row_start = 0; row_start < layer->output_rows; row_start += row_block) {
+		const struct convolution_band band = convolution_band(layer,
+			0, min(batch_block, layer->batch_size),
+			row_start, min(row_block, layer->output_rows - row_start));
+		size_t band_size = 0;
+		const enum nnp_status status = compute_convolution_band(layer, schedule, &band,
+			NULL, NULL, NULL, NULL, NULL, NULL, &band_size,
+			threadpool);
+		if (status != nnp_status_success) {
+			return status;
+		}
+		*workspace_size = max(*workspace_size, band_size);
+	}
+	return nnp_status_success;
+}
+
+/*
+ * Chooses the largest bands within the workspace budget. Blocks of whole images need neither halos nor copies, so the
+ * minibatch is split first, and rows of an image are split only if a single image does not fit. Rows are split in
+ * multiples of row_granularity, and bands are balanced, i.e. the same number of bands is made as small as possible.
+ */
+static enum nnp_status schedule_bands(
+	const struct banded_convolution layer[restrict static 1],
+	size_t row_granularity,
+	size_t max_workspace_size,
+	struct band_schedule schedule[restrict static 1],
+	pthreadpool_t threadpool)
+{
+	size_t workspace_size = 0;
+	enum nnp_status status = band_workspace_size(layer, schedule, 1, layer->output_rows, &workspace_size, threadpool);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	if (workspace_size <= max_workspace_size) {
+		size_t batch_block_fits = 1, batch_block_exceeds = layer->batch_size + 1;
+		while (batch_block_exceeds - batch_block_fits > 1) {
+			const size_t batch_block = (batch_block_fits + batch_block_exceeds) / 2;
+			status = band_workspace_size(layer, schedule, batch_block, layer->output_rows, &workspace_size, threadpool);
+			if (status != nnp_status_success) {
+				return status;
+			}
+			if (workspace_size <= max_workspace_size) {
+				batch_block_fits = batch_block;
+			} else {
+				batch_block_exceeds = batch_block;
+			}
+		}
+		const size_t batch_blocks = divide_round_up(layer->batch_size, batch_block_fits);
+		schedule->batch_block = divide_round_up(layer->batch_size, batch_blocks);
+		schedule->row_block = layer->output_rows;
+	} else {
+		const size_t row_granules = divide_round_up(layer->output_rows, row_granularity);
+		size_t row_granules_fit = 0, row_granules_exceed = row_granules;
+		while (row_granules_exceed - row_granules_fit > 1) {
+			const size_t band_granules = (row_granules_fit + row_granules_exceed) / 2;
+			status = band_workspace_size(layer, schedule, 1, band_granules * row_granularity, &workspace_size, threadpool);
+			if (status != nnp_status_success) {
+				return status;
+			}
+			if (workspace_size <= max_workspace_size) {
+				row_granules_fit = band_granules;
+			} else {
+				row_granules_exceed = band_granules;
+			}
+		}
+		if (row_granules_fit == 0) {
+			if (row_granularity != 1) {
+				/* Bands which end inside output tiles waste parts of the tiles, but may still fit */
+				return schedule_bands(layer, 1, max_workspace_size, schedule, threadpool);
+			}
+			return nnp_status_insufficient_buffer;
+		}
+		const size_t bands = divide_round_up(row_granules, row_granules_fit);
+		schedule->batch_block = 1;
+		schedule->row_block = min(divide_round_up(row_granules, bands) * row_granularity, layer->output_rows);
+	}
+
+	status = band_workspace_size(layer, schedule,
+		schedule->batch_block, schedule->row_block, &schedule->band_workspace_size, threadpool);
+	if (status != nnp_status_success) {
+		return status;
+	}
+	if (schedule->band_workspace_size > max_workspace_size) {
+		return nnp_status_insufficient_buffer;
+	}
+	return nnp_status_success;
+}
+
+static inline size_t band_count(
+	const struct banded_convolution layer[restrict static 1],
+	const struct band_schedule schedule[restrict static 1])
+{
+	return divide_round_up(layer->batch_size, schedule->batch_block) * divide_round_up(layer->output_rows, schedule->row_block);
+}
+
+/*
+ * Convolution within a workspace budget. Layers which fit are computed in one pass. Otherwise, the layer is split
+ * into bands (see schedule_bands), which are computed with the selected algorithm, or, for automatic algorithm
+ * selection, with implicit GEMM, whose workspace does not grow with the image. If the kernel transform fits into the
+ * budget next to a band, the kernel is transformed once and reused by all bands, unless that takes more bands than
+ * transforming the kernel in every band. Without a workspace buffer, the workspace is allocated at its exact size
+ * rather than from the workspace arena, whose slabs are rounded up, so that the layer never takes more memory than
+ * the budget.
+ */
+static enum nnp_status bounded_convolution_inference(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t max_workspace_size,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	bool channels_last,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	void* memory_block = workspace_buffer;
+	size_t memory_size = 0;
+	const bool workspace_query = workspace_buffer == NULL && workspace_size != NULL;
+
+	/* Validates the layer, and queries the workspace to compute it in one pass */
+	size_t layer_workspace_size = 0;
+	enum nnp_status status = convolution_inference(
+		algorithm, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		NULL, NULL, NULL, NULL, NULL, NULL, &layer_workspace_size,
+		activation, activation_parameters, channels_last, pooling_size, pooling_stride,
+		false, threadpool, NULL);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	const bool pooled = max(pooling_size.height, pooling_size.width) > 1 &&
+		transform_strategy != nnp_convolution_transform_strategy_precompute;
+	/* Kernel precomputation does not depend on the image, and pooled outputs do not match the residual rows */
+	const bool splittable = transform_strategy != nnp_convolution_transform_strategy_precompute &&
+		!(pooled && residual != NULL);
+	if (layer_workspace_size <= max_workspace_size || !splittable) {
+		if (layer_workspace_size > max_workspace_size) {
+			status = nnp_status_insufficient_buffer;
+			goto cleanup;
+		}
+
+		memory_size = layer_workspace_size;
+		if (workspace_query) {
+			*workspace_size = memory_size;
+			goto cleanup;
+		}
+		if (memory_block == NULL && memory_size != 0) {
+			memory_block = allocate_memory(memory_size);
+			if (memory_block == NULL) {
+				status = nnp_status_out_of_memory;
+				goto cleanup;
+			}
+		}
+
+		size_t convolution_workspace_size = memory_size;
+		status = convolution_inference(
+			algorithm, transform_strategy,
+			batch_size, groups, input_channels, output_channels,
+			input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+			input, kernel, bias, residual, output,
+			memory_size == 0 ? NULL : memory_block, memory_size == 0 ? NULL : &convolution_workspace_size,
+			activation, activation_parameters, channels_last, pooling_size, pooling_stride,
+			false, threadpool, NULL);
+		goto cleanup;
+	}
+
+	const bool automatic = algorithm == nnp_convolution_algorithm_auto;
+	algorithm = tuned_convolution_algorithm(
+		algorithm,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		activation, channels_last, threadpool);
+
+	const struct output_activation output_activation = resolve_output_activation(activation, activation_parameters);
+	struct convolution_setup setup;
+	status = setup_convolution_inference(
+		algorithm,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		output_activation, channels_last, residual != NULL, &setup);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	const struct nnp_size output_size = setup.output_size;
+	const struct nnp_size layer_output_size = !pooled ? output_size : (struct nnp_size) {
+		.width = divide_round_up(doz(output_size.width, pooling_size.width), pooling_stride.width) + 1,
+		.height = divide_round_up(doz(output_size.height, pooling_size.height), pooling_stride.height) + 1,
+	};
+	const struct banded_convolution layer = {
+		.batch_size = batch_size,
+		.groups = groups,
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.kernel_size = kernel_size,
+		.kernel_dilation = kernel_dilation,
+		.output_subsampling = output_subsampling,
+		.pooling_size = pooling_size,
+		.pooling_stride = pooling_stride,
+		.activation = activation,
+		.activation_parameters = activation_parameters,
+		.channels_last = channels_last,
+		.pooled = pooled,
+		.convolution_rows = output_size.height,
+		.output_rows = layer_output_size.height,
+		.input_planes = channels_last ? 1 : input_channels,
+		.output_planes = channels_last ? 1 : output_channels,
+		.input_row_elements = channels_last ? input_size.width * input_channels : input_size.width,
+		.output_row_elements = channels_last ? layer_output_size.width * output_channels : layer_output_size.width,
+	};
+
+	/* A precomputed kernel is specific to its algorithm: only the kernel of an automatic selection may be swapped */
+	const enum nnp_convolution_algorithm candidate_algorithms[2] = {
+		setup.algorithm,
+		nnp_convolution_algorithm_implicit_gemm,
+	};
+	const size_t candidate_algorithms_count =
+		automatic && transform_strategy == nnp_convolution_transform_strategy_compute &&
+		setup.algorithm != nnp_convolution_algorithm_implicit_gemm ? 2 : 1;
+
+	struct band_schedule schedule = { .band_workspace_size = SIZE_MAX };
+	for (size_t i = 0; i < candidate_algorithms_count; i++) {
+		const enum nnp_convolution_algorithm candidate_algorithm = candidate_algorithms[i];
+		struct convolution_setup candidate_setup;
+		if (setup_convolution_inference(
+			candidate_algorithm,
+			input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+			output_activation, channels_last, residual != NULL, &candidate_setup) != nnp_status_success)
+		{
+			continue;
+		}
+
+		/* Bands of tiled algorithms start at output tile boundaries (of all phases, for dilated convolutions) */
+		size_t row_granularity = 1;
+		if (candidate_setup.tile_size.height != 0) {
+			const struct nnp_size output_tile = tiled_output_tile_size(&candidate_setup, kernel_size, output_subsampling);
+			row_granularity = output_tile.height * kernel_dilation.height;
+			if (pooled) {
+				row_granularity = fused_pooling_supported(&candidate_setup, kernel_size, output_subsampling, pooling_size, pooling_stride) ?
+					output_tile.height / pooling_size.height : 1;
+			}
+		}
+
+		struct band_schedule compute_schedule = {
+			.algorithm = candidate_algorithm,
+			.transform_strategy = transform_strategy,
+		};
+		const bool compute_fits =
+			schedule_bands(&layer, row_granularity, max_workspace_size, &compute_schedule, threadpool) == nnp_status_success;
+
+		struct band_schedule reuse_schedule = {
+			.algorithm = candidate_algorithm,
+			.transform_strategy = nnp_convolution_transform_strategy_reuse,
+		};
+		bool reuse_fits = false;
+		if (transform_strategy == nnp_convolution_transform_strategy_compute &&
+			candidate_algorithm != nnp_convolution_algorithm_direct)
+		{
+			size_t kernel_transform_size = 0;
+			if (convolution_inference(
+				candidate_algorithm, nnp_convolution_transform_strategy_precompute,
+				batch_size, groups, input_channels, output_channels,
+				input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+				NULL, NULL, NULL, NULL, NULL, NULL, &kernel_transform_size,
+				activation, activation_parameters, channels_last, pooling_size, pooling_stride,
+				false, threadpool, NULL) == nnp_status_success &&
+				round_up(kernel_transform_size, 64) < max_workspace_size)
+			{
+				reuse_schedule.kernel_transform_size = round_up(kernel_transform_size, 64);
+				reuse_fits = schedule_bands(&layer, row_granularity,
+					max_workspace_size - reuse_schedule.kernel_transform_size, &reuse_schedule, threadpool) == nnp_status_success;
+			}
+		}
+
+		if (reuse_fits && (!compute_fits || band_count(&layer, &reuse_schedule) <= band_count(&layer, &compute_schedule))) {
+			schedule = reuse_schedule;
+			break;
+		} else if (compute_fits) {
+			schedule = compute_schedule;
+			break;
+		}
+	}
+	if (schedule.band_workspace_size == SIZE_MAX) {
+		status = nnp_status_insufficient_buffer;
+		goto cleanup;
+	}
+
+	memory_size = schedule.kernel_transform_size + schedule.band_workspace_size;
+	if (workspace_query) {
+		*workspace_size = memory_size;
+		goto cleanup;
+	}
+	if (memory_block == NULL && memory_size != 0) {
+		memory_block = allocate_memory(memory_size);
+		if (memory_block == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+	}
+
+	if (schedule.kernel_transform_size != 0) {
+		size_t kernel_transform_size = schedule.kernel_transform_size;
+		status = convolution_inference(
+			schedule.algorithm, nnp_convolution_transform_strategy_precompute,
+			batch_size, groups, input_channels, output_channels,
+			input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+			NULL, kernel, NULL, NULL, NULL, memory_block, &kernel_transform_size,
+			activation, activation_parameters, channels_last, pooling_size, pooling_stride,
+			false, threadpool, NULL);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+		kernel = memory_block;
+	}
+
+	void* band_workspace = memory_block + schedule.kernel_transform_size;
+	for (size_t batch_start = 0; batch_start < batch_size; batch_start += schedule.batch_block) {
+		for (size_t row_start = 0; row_start < layer.output_rows; row_start += schedule.row_block) {
+			const struct convolution_band band = convolution_band(&layer,
+				batch_start, min(schedule.batch_block, batch_size - batch_start),
+				row_start, min(schedule.row_block, layer.output_rows - row_start));
+			size_t band_workspace_size = schedule.band_workspace_size;
+			status = compute_convolution_band(&layer, &schedule, &band,
+				input, kernel, bias, residual, output, band_workspace, &band_workspace_size,
+				threadpool);
+			if (status != nnp_status_success) {
+				goto cleanup;
+			}
+		}
+	}
+
+cleanup:
+	if (memory_block != workspace_buffer) {
+		release_memory(memory_block, memory_size);
+	}
+	NNP_TOTAL_END(profile)
+	return status;
+}
+
+enum nnp_status nnp_convolution_inference_dilated(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return nnp_convolution_inference_with_options(
+		algorithm, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		input, kernel, bias, output, workspace_buffer, workspace_size,
+		activation, activation_parameters, NULL,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_nhwc(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	const struct nnp_convolution_options options = {
+		.channels_last = true,
+	};
+	return nnp_convolution_inference_with_options(
+		algorithm, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		input, kernel, bias, output, workspace_buffer, workspace_size,
+		activation, activation_parameters, &options,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_residual(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	const float* residual,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	const struct nnp_convolution_options options = {
+		.residual = residual,
+	};
+	return nnp_convolution_inference_with_options(
+		algorithm, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		input, kernel, bias, output, workspace_buffer, workspace_size,
+		activation, activation_parameters, &options,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_max_pooling(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	const struct nnp_convolution_options options = {
+		.pooling_size = pooling_size,
+		.pooling_stride = pooling_stride,
+	};
+	return nnp_convolution_inference_with_options(
+		algorithm, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		input, kernel, bias, output, workspace_buffer, workspace_size,
+		activation, activation_parameters, &options,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_bounded(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	const struct nnp_size pooling = { .height = 1, .width = 1 };
+	return bounded_convolution_inference(
+		algorithm, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		input, kernel, bias, NULL, output, workspace_buffer, workspace_size, NULL,
+		activation, activation_parameters, false, pooling, pooling,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_with_options(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	const struct nnp_convolution_options* options,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	const struct nnp_convolution_options default_options = { 0 };
+	if (options == NULL) {
+		options = &default_options;
+	}
+
+	/* Zero-initialized options mean no pooling, and non-overlapping pooling windows */
+	struct nnp_size pooling_size = options->pooling_size;
+	if (pooling_size.height == 0 && pooling_size.width == 0) {
+		pooling_size = (struct nnp_size) { .height = 1, .width = 1 };
+	}
+	struct nnp_size pooling_stride = options->pooling_stride;
+	if (pooling_stride.height == 0 && pooling_stride.width == 0) {
+		pooling_stride = pooling_size;
+	}
+
+	if (options->workspace_limit != 0) {
+		return bounded_convolution_inference(
+			algorithm, transform_strategy,
+			batch_size, groups, input_channels, output_channels,
+			input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+			input, kernel, bias, options->residual, output,
+			workspace_buffer, options->workspace_limit, workspace_size,
+			activation, activation_parameters, options->channels_last, pooling_size, pooling_stride,
+			threadpool, profile);
+	}
+
+	return convolution_inference(
+		algorithm, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		input, kernel, bias, options->residual, output, workspace_buffer, workspace_size,
+		activation, activation_parameters, options->channels_last, pooling_size, pooling_stride,
+		true, threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_grouped(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	const struct nnp_size kernel_dilation = { .height = 1, .width = 1 };
+	return nnp_convolution_inference_dilated(
+		algorithm, transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		input, kernel, bias, output,
+		workspace_buffer, workspace_size,
+		activation, activation_parameters,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference_batch(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return nnp_convolution_inference_grouped(
+		algorithm, transform_strategy,
+		batch_size, 1, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		input, kernel, bias, output,
+		workspace_buffer, workspace_size,
+		activation, activation_parameters,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_inference(
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	return nnp_convolution_inference_batch(
+		algorithm, transform_strategy,
+		1, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		input, kernel, bias, output,
+		workspace_buffer, workspace_size,
+		activation, activation_parameters,
+		threadpool, profile);
+}
+
+enum nnp_status nnp_convolution_plan_create_dilated(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	nnp_convolution_plan_t* plan_out)
+{
+	struct nnp_convolution_plan* plan = NULL;
+
+	if (plan_out == NULL) {
+		return nnp_status_invalid_plan;
+	}
+	*plan_out = NULL;
+
+	enum nnp_status status = validate_convolution_dilation(kernel_dilation);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	status = validate_convolution_arguments(
+		batch_size, input_channels, output_channels,
+		input_size, input_padding, dilated_kernel_size(kernel_size, kernel_dilation), output_subsampling,
+		activation, activation_parameters);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	status = validate_convolution_groups(groups, input_channels, output_channels);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	enum nnp_convolution_transform_strategy transform_strategy = nnp_convolution_transform_strategy_reuse;
+	const bool dilated = max(kernel_dilation.height, kernel_dilation.width) > 1;
+	if (algorithm == nnp_convolution_algorithm_auto && groups == 1 && !dilated) {
+		const struct nnp_convolution_shape shape = {
+			.batch_size = batch_size,
+			.input_channels = input_channels,
+			.output_channels = output_channels,
+			.input_size = input_size,
+			.input_padding = input_padding,
+			.kernel_size = kernel_size,
+			.output_subsampling = output_subsampling,
+			.activation = activation,
+		};
+		status = nnp_autotune_select(&shape, threadpool, &algorithm, &transform_strategy);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+	}
+
+	plan = calloc(1, sizeof(struct nnp_convolution_plan));
+	if (plan == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+	plan->batch_size = batch_size;
+	plan->groups = groups;
+	plan->input_channels = input_channels;
+	plan->output_channels = output_channels;
+	plan->input_size = input_size;
+	plan->input_padding = input_padding;
+	plan->kernel_size = kernel_size;
+	plan->output_subsampling = output_subsampling;
+
+	status = setup_convolution_inference(
+		algorithm,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		resolve_output_activation(activation, activation_parameters), false, false, &plan->setup);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	plan->bias = malloc(output_channels * sizeof(float));
+	if (plan->bias == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+	memcpy(plan->bias, bias, output_channels * sizeof(float));
+
+	if (plan->setup.algorithm == nnp_convolution_algorithm_direct) {
+		transform_strategy = nnp_convolution_transform_strategy_compute;
+	}
+	plan->transform_strategy = transform_strategy;
+	if (transform_strategy == nnp_convolution_transform_strategy_compute) {
+		/* The kernel is transformed on every execution (or consumed as is): keep a private copy of it */
+		plan->kernel_buffer_size = output_channels * (input_channels / groups) * kernel_size.height * kernel_size.width * sizeof(float);
+		plan->kernel_buffer = allocate_memory(plan->kernel_buffer_size);
+		if (plan->kernel_buffer == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+		memcpy(plan->kernel_buffer, kernel, plan->kernel_buffer_size);
+	} else {
+		/* Transform (or pack) the kernel once, and reuse it in every execution of the plan */
+		status = compute_convolution_inference(
+			&plan->setup, nnp_convolution_transform_strategy_precompute,
+			batch_size, groups, input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling,
+			NULL, kernel, NULL, NULL, NULL, NULL, &plan->kernel_buffer_size,
+			threadpool, NULL);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+
+		plan->kernel_buffer = allocate_memory(plan->kernel_buffer_size);
+		if (plan->kernel_buffer == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+
+		status = compute_convolution_inference(
+			&plan->setup, nnp_convolution_transform_strategy_precompute,
+			batch_size, groups, input_channels, output_channels,
+			input_size, input_padding, kernel_size, output_subsampling,
+			NULL, kernel, NULL, NULL, NULL, plan->kernel_buffer, &plan->kernel_buffer_size,
+			threadpool, NULL);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+	}
+
+	/* Query and allocate the workspace for the plan's batch size */
+	status = compute_convolution_inference(
+		&plan->setup, plan->transform_strategy,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		NULL, plan->kernel_buffer, plan->bias, NULL, NULL, NULL, &plan->workspace_size,
+		threadpool, NULL);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+	if (plan->workspace_size != 0) {
+		plan->workspace_buffer = allocate_memory(plan->workspace_size);
+		if (plan->workspace_buffer == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+	}
+
+	*plan_out = plan;
+	plan = NULL;
+
+cleanup:
+	nnp_convolution_plan_destroy(plan);
+	return status;
+}
+
+enum nnp_status nnp_convolution_plan_create_grouped(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	nnp_convolution_plan_t* plan_out)
+{
+	const struct nnp_size kernel_dilation = { .height = 1, .width = 1 };
+	return nnp_convolution_plan_create_dilated(
+		algorithm,
+		batch_size, groups, input_channels, output_channels,
+		input_size, input_padding, kernel_size, kernel_dilation, output_subsampling,
+		kernel, bias,
+		activation, activation_parameters,
+		threadpool, plan_out);
+}
+
+enum nnp_status nnp_convolution_plan_create(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	nnp_convolution_plan_t* plan_out)
+{
+	return nnp_convolution_plan_create_grouped(
+		algorithm,
+		batch_size, 1, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		kernel, bias,
+		activation, activation_parameters,
+		threadpool, plan_out);
+}
+
+enum nnp_status nnp_convolution_plan_execute(
+	nnp_convolution_plan_t plan,
+	const float* input,
+	float* output,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	enum nnp_status status = nnp_status_success;
+	if (plan == NULL) {
+		status = nnp_status_invalid_plan;
+		goto cleanup;
+	}
+
+	/*
+	 * Algorithm, blocking, and workspace were fixed when the plan was created, so no validation or workspace
+	 * query is done here. Plans without workspace (direct convolution) must not pass a workspace size, as it would
+	 * be interpreted as a workspace size query.
+	 */
+	size_t workspace_size = plan->workspace_size;
+	status = compute_convolution_inference(
+		&plan->setup, plan->transform_strategy,
+		plan->batch_size, plan->groups, plan->input_channels, plan->output_channels,
+		plan->input_size, plan->input_padding, plan->kernel_size, plan->output_subsampling,
+		input, plan->kernel_buffer, plan->bias, NULL, output,
+		plan->workspace_buffer, plan->workspace_buffer == NULL ? NULL : &workspace_size,
+		threadpool, profile);
+
+cleanup:
+	NNP_TOTAL_END(profile)
+	return status;
+}
+
+enum nnp_convolution_algorithm nnp_convolution_plan_get_algorithm(nnp_convolution_plan_t plan) {
+	if (plan == NULL) {
+		return nnp_convolution_algorithm_auto;
+	}
+	return plan->setup.algorithm;
+}
+
+void nnp_convolution_plan_destroy(nnp_convolution_plan_t plan) {
+	if (plan != NULL) {
+		if (plan->workspace_buffer != NULL) {
+			release_memory(plan->workspace_buffer, plan->workspace_size);
+		}
+		if (plan->kernel_buffer != NULL) {
+			release_memory(plan->kernel_buffer, plan->kernel_buffer_size);
+		}
+		free(plan->bias);
+		free(plan);
+	}
+}
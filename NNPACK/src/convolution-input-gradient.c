@@ -6,6 +6,7 @@
 #include <nnpack/macros.h>
 #include <nnpack/utils.h>
 #include <nnpack/system.h>
+#include <nnpack/workspace.h>
 
 #include <nnpack/hwinfo.h>
 #include <nnpack/validation.h>
@@ -290,7 +291,7 @@ static enum nnp_status compute_fast_convolution_input_gradient(
 
 	if (workspace_buffer == NULL) {
 		if (workspace_size == NULL) {
-			memory_block = allocate_memory(memory_size);
+			memory_block = nnp_workspace_acquire_block(memory_size);
 			if (memory_block == NULL) {
 				return nnp_status_out_of_memory;
 			}
@@ -423,7 +424,7 @@ static enum nnp_status compute_fast_convolution_input_gradient(
 	}
 
 	if (memory_block != workspace_buffer) {
-		release_memory(memory_block, memory_size);
+		nnp_workspace_release_block(memory_block, memory_size);
 	}
 	return nnp_status_success;
 }
@@ -559,6 +560,8 @@ enum nnp_status nnp_convolution_input_gradient(
 			break;
 		case nnp_convolution_algorithm_implicit_gemm:
 		case nnp_convolution_algorithm_direct:
+		case nnp_convolution_algorithm_wt4x4:
+		case nnp_convolution_algorithm_wt6x6:
 		case nnp_convolution_algorithm_auto:
 			NNP_UNREACHABLE;
 	}
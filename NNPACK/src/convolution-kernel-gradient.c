@@ -6,6 +6,7 @@
 #include <nnpack/macros.h>
 #include <nnpack/utils.h>
 #include <nnpack/system.h>
+#include <nnpack/workspace.h>
 
 #include <nnpack/hwinfo.h>
 #include <nnpack/validation.h>
@@ -273,7 +274,7 @@ static enum nnp_status compute_fast_convolution_kernel_gradient(
 
 	if (workspace_buffer == NULL) {
 		if (workspace_size == NULL) {
-			memory_block = allocate_memory(memory_size);
+			memory_block = nnp_workspace_acquire_block(memory_size);
 			if (memory_block == NULL) {
 				return nnp_status_out_of_memory;
 			}
@@ -409,7 +410,7 @@ static enum nnp_status compute_fast_convolution_kernel_gradient(
 	NNP_KERNEL_TRANSFORM_END(profile)
 
 	if (memory_block != workspace_buffer) {
-		release_memory(memory_block, memory_size);
+		nnp_workspace_release_block(memory_block, memory_size);
 	}
 	return nnp_status_success;
 }
@@ -533,6 +534,8 @@ enum nnp_status nnp_convolution_kernel_gradient(
 		case nnp_convolution_algorithm_wt8x8_fp16:
 		case nnp_convolution_algorithm_implicit_gemm:
 		case nnp_convolution_algorithm_direct:
+		case nnp_convolution_algorithm_wt4x4:
+		case nnp_convolution_algorithm_wt6x6:
 		case nnp_convolution_algorithm_auto:
 			NNP_UNREACHABLE;
 	}
@@ -0,0 +1,152 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+
+#include <nnpack/hwinfo.h>
+#include <nnpack/activations.h>
+#include <nnpack/validation.h>
+
+
+struct NNP_CACHE_ALIGN depthwise_convolution_context {
+	nnp_depthwise_function depthwise_function;
+	const float* input;
+	const float* kernel;
+	const float* bias;
+	float* output;
+
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	size_t output_subsampling;
+	struct nnp_size output_size;
+	float output_min;
+	float output_max;
+};
+
+static void compute_depthwise_convolution(
+	const struct depthwise_convolution_context context[restrict static 1],
+	size_t channel, size_t output_y,
+	size_t channel_range, size_t output_y_range)
+{
+	const nnp_depthwise_function depthwise_function = context->depthwise_function;
+	const struct nnp_size input_size       = context->input_size;
+	const struct nnp_padding input_padding = context->input_padding;
+	const struct nnp_size kernel_size      = context->kernel_size;
+	const size_t output_subsampling        = context->output_subsampling;
+	const struct nnp_size output_size      = context->output_size;
+	const float bias                       = context->bias[channel];
+	const float output_min                 = context->output_min;
+	const float output_max                 = context->output_max;
+
+	const float* input = context->input + channel * input_size.height * input_size.width;
+	const float* kernel = context->kernel + channel * kernel_size.height * kernel_size.width;
+	float* output = context->output + channel * output_size.height * output_size.width;
+
+	for (size_t y = output_y; y < output_y + output_y_range; y++) {
+		/* Skip kernel rows which fall into implicit top and bottom padding */
+		const size_t row_start = y * output_subsampling;
+		const size_t kernel_row_start = doz(input_padding.top, row_start);
+		const size_t kernel_row_end = min(kernel_size.height, input_size.height + input_padding.top - row_start);
+		const size_t input_row = row_start + kernel_row_start - input_padding.top;
+
+		depthwise_function(
+			input + input_row * input_size.width,
+			kernel + kernel_row_start * kernel_size.width,
+			output + y * output_size.width,
+			input_size.width, input_padding.left, output_size.width,
+			(uint32_t) doz(kernel_row_end, kernel_row_start),
+			bias, output_min, output_max);
+	}
+}
+
+enum nnp_status nnp_depthwise_convolution_inference(
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_convolution_arguments(
+		1, channels, channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		activation, activation_parameters);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	/* Micro-kernels clamp the output, which expresses every activation except leaky ReLU */
+	const struct output_activation output_activation = resolve_output_activation(activation, activation_parameters);
+	if (output_activation.negative_slope != 0.0f && output_activation.negative_slope != 1.0f) {
+		status = nnp_status_unsupported_activation_parameters;
+		goto cleanup;
+	}
+
+	if (output_subsampling.height != output_subsampling.width || output_subsampling.height > 2) {
+		status = nnp_status_unsupported_algorithm;
+		goto cleanup;
+	}
+	const bool subsampled = output_subsampling.height == 2;
+
+	nnp_depthwise_function depthwise_function = NULL;
+	if (kernel_size.height == 3 && kernel_size.width == 3) {
+		depthwise_function = subsampled ? nnp_hwinfo.depthwise.conv3x3s2 : nnp_hwinfo.depthwise.conv3x3;
+	} else if (kernel_size.height == 5 && kernel_size.width == 5) {
+		depthwise_function = subsampled ? nnp_hwinfo.depthwise.conv5x5s2 : nnp_hwinfo.depthwise.conv5x5;
+	} else {
+		status = nnp_status_unsupported_kernel_size;
+		goto cleanup;
+	}
+
+	const struct nnp_size output_size = {
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
+	};
+
+	struct depthwise_convolution_context depthwise_convolution_context = {
+		.depthwise_function = depthwise_function,
+		.input = input,
+		.kernel = kernel,
+		.bias = bias,
+		.output = output,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.kernel_size = kernel_size,
+		.output_subsampling = output_subsampling.height,
+		.output_size = output_size,
+		.output_min = output_activation.negative_slope == 0.0f ?
+			maxf(output_activation.output_min, 0.0f) : output_activation.output_min,
+		.output_max = output_activation.output_max,
+	};
+
+	/* Give each task enough rows to amortize the dispatch overhead on narrow feature maps */
+	const size_t output_rows_per_tile = min(divide_round_up(256, output_size.width), output_size.height);
+
+	NNP_BLOCK_MULTIPLICATION_START(profile)
+	pthreadpool_compute_2d_tiled(threadpool,
+		(pthreadpool_function_2d_tiled_t) compute_depthwise_convolution,
+		&depthwise_convolution_context,
+		channels, output_size.height,
+		1, output_rows_per_tile);
+	NNP_BLOCK_MULTIPLICATION_END(profile)
+
+cleanup:
+	NNP_TOTAL_END(profile)
+	return status;
+}
@@ -4,6 +4,7 @@
 #include <nnpack/macros.h>
 #include <nnpack/utils.h>
 #include <nnpack/system.h>
+#include <nnpack/workspace.h>
 
 #include <nnpack/hwinfo.h>
 #include <nnpack/validation.h>
@@ -226,6 +227,7 @@ enum nnp_status nnp_fully_connected_output(
 	struct nnp_profile* profile)
 {
 	void* memory_block = NULL;
+	size_t memory_size = 0;
 	NNP_TOTAL_START(profile)
 
 	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
@@ -251,9 +253,9 @@ enum nnp_status nnp_fully_connected_output(
 	/* Extra alignment on 64 is needed to ensure that packed_kernel is always SIMD-aligned */
 	const size_t packed_kernel_offset = round_up(packed_input_size, 64);
 	const size_t packed_kernel_size = round_up(output_channels, output_channels_subblock_max) * input_channels_block_max * sizeof(float);
-	const size_t memory_size = packed_kernel_offset + packed_kernel_size;
+	memory_size = packed_kernel_offset + packed_kernel_size;
 
-	memory_block = allocate_memory(memory_size);
+	memory_block = nnp_workspace_acquire_block(memory_size);
 	if (memory_block == NULL) {
 		status = nnp_status_out_of_memory;
 		goto cleanup;
@@ -274,7 +276,7 @@ enum nnp_status nnp_fully_connected_output(
 		profile);
 
 cleanup:
-	release_memory(memory_block, memory_size);
+	nnp_workspace_release_block(memory_block, memory_size);
 	NNP_TOTAL_END(profile)
 	return status;
 }
@@ -11,7 +11,9 @@
 #include <nnpack/blas.h>
 #include <nnpack/transform.h>
 #include <nnpack/relu.h>
+#include <nnpack/depthwise.h>
 #include <nnpack/softmax.h>
+#include <nnpack/autotune.h>
 
 struct hardware_info nnp_hwinfo = { };
 // static pthread_once_t hwinfo_init_control = PTHREAD_ONCE_INIT;
@@ -457,6 +459,20 @@ static void init_hwinfo(void) {
 #endif /* !NNP_INFERENCE_ONLY */
 				nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_with_bias__avx2;
 				nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_with_bias_with_relu__avx2;
+				nnp_hwinfo.transforms.iwt_f2x2_3x3_with_offset = (nnp_transform_2d_with_offset) nnp_iwt4x4_3x3_with_offset__avx2;
+				nnp_hwinfo.transforms.kwt_f2x2_3x3 = (nnp_transform_2d_with_offset) nnp_kwt4x4_3x3__avx2;
+				nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt4x4_3x3_with_bias__avx2;
+				nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt4x4_3x3_with_bias_with_relu__avx2;
+				nnp_hwinfo.transforms.iwt_f4x4_3x3_with_offset = (nnp_transform_2d_with_offset) nnp_iwt6x6_3x3_with_offset__avx2;
+				nnp_hwinfo.transforms.kwt_f4x4_3x3 = (nnp_transform_2d_with_offset) nnp_kwt6x6_3x3__avx2;
+				nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt6x6_3x3_with_bias__avx2;
+				nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt6x6_3x3_with_bias_with_relu__avx2;
+				if (cpuinfo_has_x86_f16c()) {
+					nnp_hwinfo.transforms.iwt_f6x6_3x3_fp16_with_offset = (nnp_transform_2d_with_offset) nnp_iwt8x8_3x3_fp16_with_offset__avx2;
+					nnp_hwinfo.transforms.kwt_f6x6_3x3_fp16 = (nnp_transform_2d_with_offset) nnp_kwt8x8_3x3_fp16__avx2;
+					nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_fp16_with_bias__avx2;
+					nnp_hwinfo.transforms.owt_f6x6_3x3_fp16_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_fp16_with_bias_with_relu__avx2;
+				}
 #if !NNP_CONVOLUTION_ONLY
 				nnp_hwinfo.activations.relu = nnp_relu__avx2;
 				nnp_hwinfo.activations.inplace_relu = nnp_inplace_relu__avx2;
@@ -478,18 +494,38 @@ static void init_hwinfo(void) {
 					.only_mr_x_nr = nnp_conv1x1_only_2x4__fma3,
 					.upto_mr_x_nr = nnp_conv1x1_upto_2x4__fma3,
 				};
+				nnp_hwinfo.depthwise = (struct depthwise) {
+					.conv3x3 = nnp_dwconv3x3__avx2,
+					.conv3x3s2 = nnp_dwconv3x3s2__avx2,
+					.conv5x5 = nnp_dwconv5x5__avx2,
+					.conv5x5s2 = nnp_dwconv5x5s2__avx2,
+				};
 				nnp_hwinfo.sgemm = (struct sgemm) {
 					.mr = 4,
 					.nr = 24,
 					.only_mr_x_nr = nnp_sgemm_only_4x24__fma3,
 					.upto_mr_x_nr = nnp_sgemm_upto_4x24__fma3,
 				};
+				nnp_hwinfo.q8gemm = (struct q8gemm) {
+					.mr = 4,
+					.nr = 8,
+					.only_mr_x_nr = nnp_q8gemm_only_4x8__avx2,
+					.upto_mr_x_nr = nnp_q8gemm_upto_4x8__avx2,
+				};
 				nnp_hwinfo.sxgemm = (struct sxgemm) {
 					.mr = 3,
 					.nr = 4,
 					.only_mr_x_nr = (nnp_fast_tuple_gemm_function) nnp_s8gemm_only_3x4__fma3,
 					.upto_mr_x_nr = (nnp_full_tuple_gemm_function) nnp_s8gemm_upto_3x4__fma3,
 				};
+				if (cpuinfo_has_x86_f16c()) {
+					nnp_hwinfo.hxgemm = (struct hxgemm) {
+						.mr = 3,
+						.nr = 4,
+						.only_mr_x_nr = (nnp_fast_tuple_gemm_function) nnp_h8gemm_only_3x4__avx2,
+						.upto_mr_x_nr = (nnp_full_tuple_gemm_function) nnp_h8gemm_upto_3x4__avx2,
+					};
+				}
 				nnp_hwinfo.cxgemm = (struct cxgemm) {
 					.mr = 2,
 					.nr = 2,
@@ -537,6 +573,14 @@ static void init_hwinfo(void) {
 #endif /* !NNP_INFERENCE_ONLY */
 			nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_with_bias__psimd;
 			nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_with_bias_with_relu__psimd;
+			nnp_hwinfo.transforms.iwt_f2x2_3x3_with_offset = (nnp_transform_2d_with_offset) nnp_iwt4x4_3x3_with_offset__psimd;
+			nnp_hwinfo.transforms.kwt_f2x2_3x3 = (nnp_transform_2d_with_offset) nnp_kwt4x4_3x3__psimd;
+			nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt4x4_3x3_with_bias__psimd;
+			nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt4x4_3x3_with_bias_with_relu__psimd;
+			nnp_hwinfo.transforms.iwt_f4x4_3x3_with_offset = (nnp_transform_2d_with_offset) nnp_iwt6x6_3x3_with_offset__psimd;
+			nnp_hwinfo.transforms.kwt_f4x4_3x3 = (nnp_transform_2d_with_offset) nnp_kwt6x6_3x3__psimd;
+			nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt6x6_3x3_with_bias__psimd;
+			nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt6x6_3x3_with_bias_with_relu__psimd;
 #if !NNP_CONVOLUTION_ONLY
 			nnp_hwinfo.activations.relu = nnp_relu__psimd;
 			nnp_hwinfo.activations.inplace_relu = nnp_inplace_relu__psimd;
@@ -558,12 +602,24 @@ static void init_hwinfo(void) {
 				.only_mr_x_nr = nnp_conv1x1_only_2x4__psimd,
 				.upto_mr_x_nr = nnp_conv1x1_upto_2x4__psimd,
 			};
+			nnp_hwinfo.depthwise = (struct depthwise) {
+				.conv3x3 = nnp_dwconv3x3__psimd,
+				.conv3x3s2 = nnp_dwconv3x3s2__psimd,
+				.conv5x5 = nnp_dwconv5x5__psimd,
+				.conv5x5s2 = nnp_dwconv5x5s2__psimd,
+			};
 			nnp_hwinfo.sgemm = (struct sgemm) {
 				.mr = 4,
 				.nr = 8,
 				.only_mr_x_nr = nnp_sgemm_only_4x8__psimd,
 				.upto_mr_x_nr = nnp_sgemm_upto_4x8__psimd,
 			};
+			nnp_hwinfo.q8gemm = (struct q8gemm) {
+				.mr = 4,
+				.nr = 4,
+				.only_mr_x_nr = nnp_q8gemm_only_4x4__scalar,
+				.upto_mr_x_nr = nnp_q8gemm_upto_4x4__scalar,
+			};
 			nnp_hwinfo.sxgemm = (struct sxgemm) {
 				.mr = 3,
 				.nr = 4,
@@ -616,6 +672,14 @@ static void init_hwinfo(void) {
 #endif /* !NNP_INFERENCE_ONLY */
 			nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_with_bias__neon;
 			nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_with_bias_with_relu__neon;
+			nnp_hwinfo.transforms.iwt_f2x2_3x3_with_offset = (nnp_transform_2d_with_offset) nnp_iwt4x4_3x3_with_offset__psimd;
+			nnp_hwinfo.transforms.kwt_f2x2_3x3 = (nnp_transform_2d_with_offset) nnp_kwt4x4_3x3__psimd;
+			nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt4x4_3x3_with_bias__psimd;
+			nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt4x4_3x3_with_bias_with_relu__psimd;
+			nnp_hwinfo.transforms.iwt_f4x4_3x3_with_offset = (nnp_transform_2d_with_offset) nnp_iwt6x6_3x3_with_offset__psimd;
+			nnp_hwinfo.transforms.kwt_f4x4_3x3 = (nnp_transform_2d_with_offset) nnp_kwt6x6_3x3__psimd;
+			nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt6x6_3x3_with_bias__psimd;
+			nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt6x6_3x3_with_bias_with_relu__psimd;
 			nnp_hwinfo.transforms.owt_f6x6_3x3s2_with_bias = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3s2_with_bias__neon;
 			nnp_hwinfo.transforms.owt_f6x6_3x3s2_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3s2_with_bias_with_relu__neon;
 			if (cpuinfo_has_arm_neon_fp16()) {
@@ -645,6 +709,12 @@ static void init_hwinfo(void) {
 				.only_mr_x_nr = nnp_conv1x1_only_4x4__neon,
 				.upto_mr_x_nr = nnp_conv1x1_upto_4x4__neon,
 			};
+			nnp_hwinfo.depthwise = (struct depthwise) {
+				.conv3x3 = nnp_dwconv3x3__psimd,
+				.conv3x3s2 = nnp_dwconv3x3s2__psimd,
+				.conv5x5 = nnp_dwconv5x5__psimd,
+				.conv5x5s2 = nnp_dwconv5x5s2__psimd,
+			};
 			nnp_hwinfo.sgemm = (struct sgemm) {
 				.mr = 6,
 				.nr = 8,
@@ -655,6 +725,12 @@ static void init_hwinfo(void) {
 				#endif
 				.upto_mr_x_nr = nnp_sgemm_upto_6x8__neon,
 			};
+			nnp_hwinfo.q8gemm = (struct q8gemm) {
+				.mr = 4,
+				.nr = 4,
+				.only_mr_x_nr = nnp_q8gemm_only_4x4__scalar,
+				.upto_mr_x_nr = nnp_q8gemm_upto_4x4__scalar,
+			};
 			nnp_hwinfo.sxgemm = (struct sxgemm) {
 				.mr = 3,
 				.nr = 3,
@@ -741,6 +817,14 @@ static void init_hwinfo(void) {
 #endif /* !NNP_INFERENCE_ONLY */
 			nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_with_bias__scalar;
 			nnp_hwinfo.transforms.owt_f6x6_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt8x8_3x3_with_bias_with_relu__scalar;
+			nnp_hwinfo.transforms.iwt_f2x2_3x3_with_offset = (nnp_transform_2d_with_offset) nnp_iwt4x4_3x3_with_offset__scalar;
+			nnp_hwinfo.transforms.kwt_f2x2_3x3 = (nnp_transform_2d_with_offset) nnp_kwt4x4_3x3__scalar;
+			nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt4x4_3x3_with_bias__scalar;
+			nnp_hwinfo.transforms.owt_f2x2_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt4x4_3x3_with_bias_with_relu__scalar;
+			nnp_hwinfo.transforms.iwt_f4x4_3x3_with_offset = (nnp_transform_2d_with_offset) nnp_iwt6x6_3x3_with_offset__scalar;
+			nnp_hwinfo.transforms.kwt_f4x4_3x3 = (nnp_transform_2d_with_offset) nnp_kwt6x6_3x3__scalar;
+			nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias = (nnp_transform_2d_with_bias) nnp_owt6x6_3x3_with_bias__scalar;
+			nnp_hwinfo.transforms.owt_f4x4_3x3_with_bias_with_relu = (nnp_transform_2d_with_bias) nnp_owt6x6_3x3_with_bias_with_relu__scalar;
 #if !NNP_CONVOLUTION_ONLY
 			nnp_hwinfo.activations.relu = nnp_relu__scalar;
 			nnp_hwinfo.activations.inplace_relu = nnp_inplace_relu__scalar;
@@ -762,12 +846,24 @@ static void init_hwinfo(void) {
 				.only_mr_x_nr = nnp_conv1x1_only_2x4__scalar,
 				.upto_mr_x_nr = nnp_conv1x1_upto_2x4__scalar,
 			};
+			nnp_hwinfo.depthwise = (struct depthwise) {
+				.conv3x3 = nnp_dwconv3x3__scalar,
+				.conv3x3s2 = nnp_dwconv3x3s2__scalar,
+				.conv5x5 = nnp_dwconv5x5__scalar,
+				.conv5x5s2 = nnp_dwconv5x5s2__scalar,
+			};
 			nnp_hwinfo.sgemm = (struct sgemm) {
 				.mr = 4,
 				.nr = 3,
 				.only_mr_x_nr = nnp_sgemm_only_4x3__scalar,
 				.upto_mr_x_nr = nnp_sgemm_upto_4x3__scalar,
 			};
+			nnp_hwinfo.q8gemm = (struct q8gemm) {
+				.mr = 4,
+				.nr = 4,
+				.only_mr_x_nr = nnp_q8gemm_only_4x4__scalar,
+				.upto_mr_x_nr = nnp_q8gemm_upto_4x4__scalar,
+			};
 			nnp_hwinfo.sxgemm = (struct sxgemm) {
 				.mr = 4,
 				.nr = 3,
@@ -810,6 +906,7 @@ enum nnp_status nnp_initialize(void) {
 	pthread_once(&hwinfo_init_control, &init_hwinfo);*/
 	init_hwinfo();
 	if (nnp_hwinfo.supported) {
+		nnp_autotune_initialize();
 		return nnp_status_success;
 	} else {
 		return nnp_status_unsupported_hardware;
@@ -817,6 +914,9 @@ enum nnp_status nnp_initialize(void) {
 }
 
 enum nnp_status nnp_deinitialize(void) {
+	nnp_workspace_release();
+	nnp_kernel_cache_reset();
+	nnp_autotune_deinitialize();
 	// cpuinfo_deinitialize();
 	return nnp_status_success;
 }
@@ -0,0 +1,266 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <pthread.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/kernel-cache.h>
+
+/*
+ * Kernel cache.
+ *
+ * Keeps kernel transforms of one-shot convolution calls with nnp_convolution_transform_strategy_compute, so that
+ * repeated calls with the same kernel skip the kernel transform, as if the caller precomputed it. The cache holds at
+ * most budget bytes of transforms, and evicts the least recently used ones to make room. Transforms which running
+ * calls use are never evicted. Networks have few layers, so the cache is a small array with linear search.
+ */
+
+struct kernel_cache_entry {
+	struct nnp_kernel_cache_key key;
+	void* transformed_kernel;
+	size_t transformed_kernel_size;
+	/* Number of running calls which use the transform */
+	size_t users;
+	/* Value of the use counter when the entry was last acquired */
+	uint64_t last_use;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	/* Memory budget for kernel transforms, in bytes; 0 disables the cache */
+	size_t budget;
+	/* Total size of cached kernel transforms, in bytes */
+	size_t size;
+	uint64_t use_counter;
+	size_t hits;
+	size_t misses;
+	size_t evictions;
+	size_t entries_count;
+	size_t entries_capacity;
+	struct kernel_cache_entry* entries;
+} kernel_cache = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/*
+ * FNV-1a over 32-bit words in four interleaved lanes: kernels are hashed on every call, so hashing must not be limited
+ * by the latency of multiplication.
+ */
+static uint64_t hash_kernel(const float* kernel, size_t elements) {
+	const uint64_t prime = UINT64_C(0x100000001B3);
+	uint64_t lanes[4] = {
+		UINT64_C(0xCBF29CE484222325), UINT64_C(0x84222325CBF29CE4),
+		UINT64_C(0xE484222325CBF29C), UINT64_C(0x25CBF29CE4842223),
+	};
+	size_t i = 0;
+	for (; i + 4 <= elements; i += 4) {
+		for (size_t lane = 0; lane < 4; lane++) {
+			uint32_t word;
+			memcpy(&word, &kernel[i + lane], sizeof(word));
+			lanes[lane] = (lanes[lane] ^ word) * prime;
+		}
+	}
+	for (; i < elements; i++) {
+		uint32_t word;
+		memcpy(&word, &kernel[i], sizeof(word));
+		lanes[0] = (lanes[0] ^ word) * prime;
+	}
+
+	uint64_t hash = lanes[0];
+	for (size_t lane = 1; lane < 4; lane++) {
+		hash = (hash ^ lanes[lane]) * prime;
+	}
+	return hash;
+}
+
+void nnp_kernel_cache_key(
+	struct nnp_kernel_cache_key* key,
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t groups,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size kernel_dilation,
+	struct nnp_size output_subsampling,
+	enum nnp_activation activation,
+	bool channels_last,
+	const float* kernel)
+{
+	/* Keys are compared with memcmp, so padding between fields must be zero */
+	memset(key, 0, sizeof(struct nnp_kernel_cache_key));
+	key->kernel = kernel;
+	key->kernel_hash = hash_kernel(kernel, output_channels * (input_channels / groups) * kernel_size.height * kernel_size.width);
+	key->batch_size = batch_size;
+	key->groups = groups;
+	key->input_channels = input_channels;
+	key->output_channels = output_channels;
+	key->input_size = input_size;
+	key->input_padding = input_padding;
+	key->kernel_size = kernel_size;
+	key->kernel_dilation = kernel_dilation;
+	key->output_subsampling = output_subsampling;
+	key->algorithm = algorithm;
+	key->activation = activation;
+	key->channels_last = channels_last;
+}
+
+/* Must be called with the cache mutex locked */
+static struct kernel_cache_entry* find_entry(const struct nnp_kernel_cache_key* key) {
+	for (size_t i = 0; i < kernel_cache.entries_count; i++) {
+		struct kernel_cache_entry* entry = &kernel_cache.entries[i];
+		if (memcmp(&entry->key, key, sizeof(struct nnp_kernel_cache_key)) == 0) {
+			return entry;
+		}
+	}
+	return NULL;
+}
+
+/* Must be called with the cache mutex locked */
+static void remove_entry(struct kernel_cache_entry* entry) {
+	release_memory(entry->transformed_kernel, entry->transformed_kernel_size);
+	kernel_cache.size -= entry->transformed_kernel_size;
+	*entry = kernel_cache.entries[--kernel_cache.entries_count];
+}
+
+/*
+ * Evicts least recently used entries until another size bytes fit into the budget.
+ * Returns false if entries in use do not leave enough room. Must be called with the cache mutex locked.
+ */
+static bool make_room(size_t size) {
+	while (kernel_cache.size + size > kernel_cache.budget) {
+		struct kernel_cache_entry* victim = NULL;
+		for (size_t i = 0; i < kernel_cache.entries_count; i++) {
+			struct kernel_cache_entry* entry = &kernel_cache.entries[i];
+			if (entry->users == 0 && (victim == NULL || entry->last_use < victim->last_use)) {
+				victim = entry;
+			}
+		}
+		if (victim == NULL) {
+			return false;
+		}
+		remove_entry(victim);
+		kernel_cache.evictions += 1;
+	}
+	return true;
+}
+
+size_t nnp_kernel_cache_budget(void) {
+	pthread_mutex_lock(&kernel_cache.mutex);
+	const size_t budget = kernel_cache.budget;
+	pthread_mutex_unlock(&kernel_cache.mutex);
+	return budget;
+}
+
+const void* nnp_kernel_cache_acquire(const struct nnp_kernel_cache_key* key) {
+	const void* transformed_kernel = NULL;
+
+	pthread_mutex_lock(&kernel_cache.mutex);
+	struct kernel_cache_entry* entry = find_entry(key);
+	if (entry != NULL) {
+		entry->users += 1;
+		entry->last_use = ++kernel_cache.use_counter;
+		transformed_kernel = entry->transformed_kernel;
+		kernel_cache.hits += 1;
+	} else {
+		kernel_cache.misses += 1;
+	}
+	pthread_mutex_unlock(&kernel_cache.mutex);
+
+	return transformed_kernel;
+}
+
+bool nnp_kernel_cache_insert(const struct nnp_kernel_cache_key* key, void* transformed_kernel, size_t transformed_kernel_size) {
+	bool inserted = false;
+
+	pthread_mutex_lock(&kernel_cache.mutex);
+	/* Concurrent calls which missed the same kernel insert it only once */
+	if (transformed_kernel_size > kernel_cache.budget || find_entry(key) != NULL || !make_room(transformed_kernel_size)) {
+		goto cleanup;
+	}
+
+	if (kernel_cache.entries_count == kernel_cache.entries_capacity) {
+		const size_t entries_capacity = max(kernel_cache.entries_capacity * 2, 16);
+		struct kernel_cache_entry* entries =
+			realloc(kernel_cache.entries, entries_capacity * sizeof(struct kernel_cache_entry));
+		if (entries == NULL) {
+			goto cleanup;
+		}
+		kernel_cache.entries = entries;
+		kernel_cache.entries_capacity = entries_capacity;
+	}
+
+	kernel_cache.entries[kernel_cache.entries_count++] = (struct kernel_cache_entry) {
+		.key = *key,
+		.transformed_kernel = transformed_kernel,
+		.transformed_kernel_size = transformed_kernel_size,
+		.users = 1,
+		.last_use = ++kernel_cache.use_counter,
+	};
+	kernel_cache.size += transformed_kernel_size;
+	inserted = true;
+
+cleanup:
+	pthread_mutex_unlock(&kernel_cache.mutex);
+	return inserted;
+}
+
+void nnp_kernel_cache_release(const void* transformed_kernel) {
+	pthread_mutex_lock(&kernel_cache.mutex);
+	for (size_t i = 0; i < kernel_cache.entries_count; i++) {
+		struct kernel_cache_entry* entry = &kernel_cache.entries[i];
+		if (entry->transformed_kernel == transformed_kernel) {
+			entry->users -= 1;
+			break;
+		}
+	}
+	/* The budget may have been lowered while the entry was in use */
+	make_room(0);
+	pthread_mutex_unlock(&kernel_cache.mutex);
+}
+
+enum nnp_status nnp_kernel_cache_set_budget(size_t budget) {
+	pthread_mutex_lock(&kernel_cache.mutex);
+	kernel_cache.budget = budget;
+	make_room(0);
+	pthread_mutex_unlock(&kernel_cache.mutex);
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_kernel_cache_get_stats(struct nnp_kernel_cache_stats* stats) {
+	pthread_mutex_lock(&kernel_cache.mutex);
+	*stats = (struct nnp_kernel_cache_stats) {
+		.hits = kernel_cache.hits,
+		.misses = kernel_cache.misses,
+		.evictions = kernel_cache.evictions,
+		.entries = kernel_cache.entries_count,
+		.size = kernel_cache.size,
+		.budget = kernel_cache.budget,
+	};
+	pthread_mutex_unlock(&kernel_cache.mutex);
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_kernel_cache_reset(void) {
+	pthread_mutex_lock(&kernel_cache.mutex);
+	for (size_t i = kernel_cache.entries_count; i != 0; i--) {
+		struct kernel_cache_entry* entry = &kernel_cache.entries[i - 1];
+		/* Transforms used by concurrently running calls stay in the cache */
+		if (entry->users == 0) {
+			remove_entry(entry);
+		}
+	}
+	kernel_cache.hits = 0;
+	kernel_cache.misses = 0;
+	kernel_cache.evictions = 0;
+	pthread_mutex_unlock(&kernel_cache.mutex);
+	return nnp_status_success;
+}
@@ -0,0 +1,353 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/workspace.h>
+
+#include <nnpack/hwinfo.h>
+#include <nnpack/activations.h>
+#include <nnpack/validation.h>
+
+
+/* Number of adjacent output pixels which share each loaded kernel vector */
+#define NCHWC_PIXEL_TILE 4
+/* Largest channel block the accumulator tile is sized for */
+#define NCHWC_MAX_CHANNEL_BLOCK 16
+
+
+struct NNP_CACHE_ALIGN nchwc_kernel_packing_context {
+	const float* kernel;
+	const float* bias;
+	float* packed_kernel;
+	float* packed_bias;
+
+	size_t input_channels;
+	size_t output_channels;
+	size_t input_channel_blocks;
+	size_t channel_block;
+	size_t kernel_elements;
+};
+
+/*
+ * Packs kernel[output_channels][input_channels][kernel_size.height][kernel_size.width] for one block of output
+ * channels as packed_kernel[input_channel_block][kernel_size.height][kernel_size.width][input lane][output lane],
+ * with zeros in place of channels past the end. The output lanes are contiguous, so the inner loop of the
+ * convolution is a broadcast of one input value times one vector of kernel values.
+ */
+static void compute_nchwc_kernel_packing(
+	const struct nchwc_kernel_packing_context context[restrict static 1],
+	size_t output_channel_block)
+{
+	const size_t input_channels       = context->input_channels;
+	const size_t output_channels      = context->output_channels;
+	const size_t input_channel_blocks = context->input_channel_blocks;
+	const size_t channel_block        = context->channel_block;
+	const size_t kernel_elements      = context->kernel_elements;
+
+	const size_t output_channel_start = output_channel_block * channel_block;
+	float* packed_kernel = context->packed_kernel +
+		output_channel_block * input_channel_blocks * kernel_elements * channel_block * channel_block;
+	float* packed_bias = context->packed_bias + output_channel_start;
+
+	for (size_t input_channel_block = 0; input_channel_block < input_channel_blocks; input_channel_block++) {
+		const size_t input_channel_start = input_channel_block * channel_block;
+		for (size_t kernel_element = 0; kernel_element < kernel_elements; kernel_element++) {
+			for (size_t input_lane = 0; input_lane < channel_block; input_lane++) {
+				const size_t input_channel = input_channel_start + input_lane;
+				for (size_t output_lane = 0; output_lane < channel_block; output_lane++) {
+					const size_t output_channel = output_channel_start + output_lane;
+					float value = 0.0f;
+					if (input_channel < input_channels && output_channel < output_channels) {
+						value = context->kernel[(output_channel * input_channels + input_channel) * kernel_elements + kernel_element];
+					}
+					*packed_kernel++ = value;
+				}
+			}
+		}
+	}
+
+	for (size_t output_lane = 0; output_lane < channel_block; output_lane++) {
+		const size_t output_channel = output_channel_start + output_lane;
+		packed_bias[output_lane] = output_channel < output_channels ? context->bias[output_channel] : 0.0f;
+	}
+}
+
+struct NNP_CACHE_ALIGN nchwc_convolution_context {
+	const float* input;
+	const float* packed_kernel;
+	const float* packed_bias;
+	float* output;
+
+	size_t output_channels;
+	size_t input_channel_blocks;
+	size_t output_channel_blocks;
+	size_t channel_block;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size kernel_size;
+	struct nnp_size output_subsampling;
+	struct nnp_size output_size;
+	struct output_activation activation;
+};
+
+/*
+ * Computes rows [output_y, output_y + output_y_range) of one block of output channels of one image.
+ * The caller passes channel_block as a compile-time constant, so that the lane loops unroll into SIMD
+ * multiply-adds across channels. Kernel rows and columns which fall into implicit padding are skipped.
+ */
+static inline void nchwc_convolution_rows(
+	const struct nchwc_convolution_context context[restrict static 1],
+	size_t image_block, size_t output_y, size_t output_y_range,
+	const size_t channel_block)
+{
+	const size_t input_channel_blocks      = context->input_channel_blocks;
+	const size_t output_channel_blocks     = context->output_channel_blocks;
+	const struct nnp_size input_size       = context->input_size;
+	const struct nnp_padding input_padding = context->input_padding;
+	const struct nnp_size kernel_size      = context->kernel_size;
+	const struct nnp_size output_subsampling = context->output_subsampling;
+	const struct nnp_size output_size      = context->output_size;
+	const struct output_activation activation = context->activation;
+
+	const size_t sample = image_block / output_channel_blocks;
+	const size_t output_channel_block = image_block % output_channel_blocks;
+	const size_t input_block_stride = input_size.height * input_size.width * channel_block;
+	const size_t kernel_block_stride = kernel_size.height * kernel_size.width * channel_block * channel_block;
+
+	const float* input = context->input + sample * input_channel_blocks * input_block_stride;
+	const float* kernel = context->packed_kernel + output_channel_block * input_channel_blocks * kernel_block_stride;
+	const float* bias = context->packed_bias + output_channel_block * channel_block;
+	float* output = context->output + image_block * output_size.height * output_size.width * channel_block;
+	/* Activation can map zero to a non-zero value, while output padding lanes must stay zero */
+	const size_t output_lanes = min(channel_block, context->output_channels - output_channel_block * channel_block);
+
+	for (size_t y = output_y; y < output_y + output_y_range; y++) {
+		const size_t row_start = y * output_subsampling.height;
+		const size_t kernel_row_start = doz(input_padding.top, row_start);
+		const size_t kernel_row_end = min(kernel_size.height, input_size.height + input_padding.top - row_start);
+
+		for (size_t x = 0; x < output_size.width; x += NCHWC_PIXEL_TILE) {
+			const size_t pixels = min(NCHWC_PIXEL_TILE, output_size.width - x);
+
+			float acc[NCHWC_PIXEL_TILE][NCHWC_MAX_CHANNEL_BLOCK];
+			for (size_t pixel = 0; pixel < NCHWC_PIXEL_TILE; pixel++) {
+				for (size_t lane = 0; lane < channel_block; lane++) {
+					acc[pixel][lane] = bias[lane];
+				}
+			}
+
+			for (size_t input_channel_block = 0; input_channel_block < input_channel_blocks; input_channel_block++) {
+				const float* input_block = input + input_channel_block * input_block_stride;
+				const float* kernel_block = kernel + input_channel_block * kernel_block_stride;
+				for (size_t ky = kernel_row_start; ky < kernel_row_end; ky++) {
+					const float* input_row = input_block + (row_start + ky - input_padding.top) * input_size.width * channel_block;
+					for (size_t kx = 0; kx < kernel_size.width; kx++) {
+						const float* kernel_vectors = kernel_block + (ky * kernel_size.width + kx) * channel_block * channel_block;
+						for (size_t pixel = 0; pixel < pixels; pixel++) {
+							/* Columns left of the input row wrap around to large values */
+							const size_t input_x = (x + pixel) * output_subsampling.width + kx - input_padding.left;
+							if (input_x >= input_size.width) {
+								continue;
+							}
+							const float* input_pixel = input_row + input_x * channel_block;
+							for (size_t input_lane = 0; input_lane < channel_block; input_lane++) {
+								const float input_value = input_pixel[input_lane];
+								const float* kernel_vector = kernel_vectors + input_lane * channel_block;
+								for (size_t output_lane = 0; output_lane < channel_block; output_lane++) {
+									acc[pixel][output_lane] += input_value * kernel_vector[output_lane];
+								}
+							}
+						}
+					}
+				}
+			}
+
+			float* output_pixels = output + (y * output_size.width + x) * channel_block;
+			for (size_t pixel = 0; pixel < pixels; pixel++) {
+				for (size_t lane = 0; lane < channel_block; lane++) {
+					output_pixels[pixel * channel_block + lane] = activate(acc[pixel][lane], activation);
+				}
+				for (size_t lane = output_lanes; lane < channel_block; lane++) {
+					output_pixels[pixel * channel_block + lane] = 0.0f;
+				}
+			}
+		}
+	}
+}
+
+static void compute_nchwc_convolution(
+	const struct nchwc_convolution_context context[restrict static 1],
+	size_t image_block, size_t output_y,
+	size_t image_block_range, size_t output_y_range)
+{
+	nchwc_convolution_rows(context, image_block, output_y, output_y_range, context->channel_block);
+}
+
+static void compute_nchwc_convolution_c4(
+	const struct nchwc_convolution_context context[restrict static 1],
+	size_t image_block, size_t output_y,
+	size_t image_block_range, size_t output_y_range)
+{
+	nchwc_convolution_rows(context, image_block, output_y, output_y_range, 4);
+}
+
+static void compute_nchwc_convolution_c8(
+	const struct nchwc_convolution_context context[restrict static 1],
+	size_t image_block, size_t output_y,
+	size_t image_block_range, size_t output_y_range)
+{
+	nchwc_convolution_rows(context, image_block, output_y, output_y_range, 8);
+}
+
+static void compute_nchwc_convolution_c16(
+	const struct nchwc_convolution_context context[restrict static 1],
+	size_t image_block, size_t output_y,
+	size_t image_block_range, size_t output_y_range)
+{
+	nchwc_convolution_rows(context, image_block, output_y, output_y_range, 16);
+}
+
+enum nnp_status nnp_convolution_inference_nchwc(
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* input,
+	const float* kernel,
+	const float* bias,
+	float* output,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	enum nnp_activation activation,
+	const void* activation_parameters,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	void* memory_block = NULL;
+	size_t memory_size = 0;
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_convolution_arguments(
+		batch_size, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		activation, activation_parameters);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	const size_t channel_block = nnp_hwinfo.simd_width;
+	if (channel_block > NCHWC_MAX_CHANNEL_BLOCK) {
+		status = nnp_status_unsupported_hardware;
+		goto cleanup;
+	}
+
+	const size_t input_channel_blocks = divide_round_up(input_channels, channel_block);
+	const size_t output_channel_blocks = divide_round_up(output_channels, channel_block);
+	const size_t kernel_elements = kernel_size.height * kernel_size.width;
+	const struct nnp_size output_size = {
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
+	};
+
+	const size_t packed_kernel_size = round_up(
+		output_channel_blocks * input_channel_blocks * kernel_elements * channel_block * channel_block * sizeof(float), 64);
+	const size_t packed_bias_size = output_channel_blocks * channel_block * sizeof(float);
+	memory_size = packed_kernel_size + packed_bias_size;
+
+	if (workspace_buffer == NULL) {
+		if (workspace_size == NULL) {
+			memory_block = nnp_workspace_acquire_block(memory_size);
+			if (memory_block == NULL) {
+				status = nnp_status_out_of_memory;
+				goto cleanup;
+			}
+		} else {
+			*workspace_size = memory_size;
+			goto cleanup;
+		}
+	} else {
+		if (*workspace_size < memory_size) {
+			status = nnp_status_insufficient_buffer;
+			goto cleanup;
+		}
+		memory_block = workspace_buffer;
+	}
+
+	float* packed_kernel = memory_block;
+	float* packed_bias = memory_block + packed_kernel_size;
+
+	struct nchwc_kernel_packing_context kernel_packing_context = {
+		.kernel = kernel,
+		.bias = bias,
+		.packed_kernel = packed_kernel,
+		.packed_bias = packed_bias,
+		.input_channels = input_channels,
+		.output_channels = output_channels,
+		.input_channel_blocks = input_channel_blocks,
+		.channel_block = channel_block,
+		.kernel_elements = kernel_elements,
+	};
+	NNP_KERNEL_TRANSFORM_START(profile)
+	pthreadpool_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_nchwc_kernel_packing,
+		&kernel_packing_context,
+		output_channel_blocks);
+	NNP_KERNEL_TRANSFORM_END(profile)
+
+	pthreadpool_function_2d_tiled_t convolution_function = (pthreadpool_function_2d_tiled_t) compute_nchwc_convolution;
+	switch (channel_block) {
+		case 4:
+			convolution_function = (pthreadpool_function_2d_tiled_t) compute_nchwc_convolution_c4;
+			break;
+		case 8:
+			convolution_function = (pthreadpool_function_2d_tiled_t) compute_nchwc_convolution_c8;
+			break;
+		case 16:
+			convolution_function = (pthreadpool_function_2d_tiled_t) compute_nchwc_convolution_c16;
+			break;
+	}
+
+	struct nchwc_convolution_context convolution_context = {
+		.input = input,
+		.packed_kernel = packed_kernel,
+		.packed_bias = packed_bias,
+		.output = output,
+		.output_channels = output_channels,
+		.input_channel_blocks = input_channel_blocks,
+		.output_channel_blocks = output_channel_blocks,
+		.channel_block = channel_block,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.kernel_size = kernel_size,
+		.output_subsampling = output_subsampling,
+		.output_size = output_size,
+		.activation = resolve_output_activation(activation, activation_parameters),
+	};
+
+	/* Give each task enough rows to amortize the dispatch overhead on narrow feature maps */
+	const size_t output_rows_per_tile = min(divide_round_up(256, output_size.width), output_size.height);
+
+	NNP_BLOCK_MULTIPLICATION_START(profile)
+	pthreadpool_compute_2d_tiled(threadpool,
+		convolution_function,
+		&convolution_context,
+		batch_size * output_channel_blocks, output_size.height,
+		1, output_rows_per_tile);
+	NNP_BLOCK_MULTIPLICATION_END(profile)
+
+cleanup:
+	if (memory_block != workspace_buffer) {
+		nnp_workspace_release_block(memory_block, memory_size);
+	}
+	NNP_TOTAL_END(profile)
+	return status;
+}
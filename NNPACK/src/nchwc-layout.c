@@ -0,0 +1,129 @@
+#include <stddef.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+
+#include <nnpack/hwinfo.h>
+#include <nnpack/validation.h>
+
+
+size_t nnp_nchwc_channel_block_size(void) {
+	return nnp_hwinfo.initialized ? nnp_hwinfo.simd_width : 0;
+}
+
+struct NNP_CACHE_ALIGN nchwc_layout_context {
+	const float* input;
+	float* output;
+	size_t channels;
+	size_t channel_blocks;
+	size_t channel_block;
+	size_t image_elements;
+};
+
+static void compute_nchw_to_nchwc(
+	const struct nchwc_layout_context context[restrict static 1],
+	size_t image_block)
+{
+	const size_t channels       = context->channels;
+	const size_t channel_blocks = context->channel_blocks;
+	const size_t channel_block  = context->channel_block;
+	const size_t image_elements = context->image_elements;
+
+	const size_t sample = image_block / channel_blocks;
+	const size_t channel_start = (image_block % channel_blocks) * channel_block;
+	const size_t channel_count = min(channel_block, channels - channel_start);
+
+	const float* input = context->input + (sample * channels + channel_start) * image_elements;
+	float* output = context->output + image_block * image_elements * channel_block;
+
+	for (size_t pixel = 0; pixel < image_elements; pixel++) {
+		size_t lane = 0;
+		for (; lane < channel_count; lane++) {
+			output[lane] = input[lane * image_elements + pixel];
+		}
+		/* Lanes past the last channel are zero, so that blocked consumers can ignore the channel count */
+		for (; lane < channel_block; lane++) {
+			output[lane] = 0.0f;
+		}
+		output += channel_block;
+	}
+}
+
+static void compute_nchwc_to_nchw(
+	const struct nchwc_layout_context context[restrict static 1],
+	size_t image_block)
+{
+	const size_t channels       = context->channels;
+	const size_t channel_blocks = context->channel_blocks;
+	const size_t channel_block  = context->channel_block;
+	const size_t image_elements = context->image_elements;
+
+	const size_t sample = image_block / channel_blocks;
+	const size_t channel_start = (image_block % channel_blocks) * channel_block;
+	const size_t channel_count = min(channel_block, channels - channel_start);
+
+	const float* input = context->input + image_block * image_elements * channel_block;
+	float* output = context->output + (sample * channels + channel_start) * image_elements;
+
+	for (size_t pixel = 0; pixel < image_elements; pixel++) {
+		for (size_t lane = 0; lane < channel_count; lane++) {
+			output[lane * image_elements + pixel] = input[lane];
+		}
+		input += channel_block;
+	}
+}
+
+static enum nnp_status convert_layout(
+	pthreadpool_function_1d_t function,
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	const float* input,
+	float* output,
+	pthreadpool_t threadpool)
+{
+	const enum nnp_status status = validate_nchwc_layout_arguments(batch_size, channels, image_size);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	const size_t channel_block = nnp_hwinfo.simd_width;
+	const size_t channel_blocks = divide_round_up(channels, channel_block);
+	struct nchwc_layout_context nchwc_layout_context = {
+		.input = input,
+		.output = output,
+		.channels = channels,
+		.channel_blocks = channel_blocks,
+		.channel_block = channel_block,
+		.image_elements = image_size.height * image_size.width,
+	};
+	pthreadpool_compute_1d(threadpool, function, &nchwc_layout_context, batch_size * channel_blocks);
+
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_convert_nchw_to_nchwc(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	const float* input,
+	float* output,
+	pthreadpool_t threadpool)
+{
+	return convert_layout((pthreadpool_function_1d_t) compute_nchw_to_nchwc,
+		batch_size, channels, image_size, input, output, threadpool);
+}
+
+enum nnp_status nnp_convert_nchwc_to_nchw(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size image_size,
+	const float* input,
+	float* output,
+	pthreadpool_t threadpool)
+{
+	return convert_layout((pthreadpool_function_1d_t) compute_nchwc_to_nchw,
+		batch_size, channels, image_size, input, output, threadpool);
+}
@@ -0,0 +1,1879 @@
+#include <errno.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/autotune.h>
+
+#include <nnpack/hwinfo.h>
+#include <nnpack/validation.h>
+
+/* Alignment of every buffer in the network arena */
+#define NETWORK_BUFFER_ALIGNMENT 64
+
+/* Buffer indices of layer inputs, outputs, and workspaces which do not live in the arena */
+#define NETWORK_NO_BUFFER SIZE_MAX
+#define NETWORK_EXTERNAL_INPUT (SIZE_MAX - 1)
+#define NETWORK_EXTERNAL_OUTPUT (SIZE_MAX - 2)
+
+/* Model files: magic, format version, and alignment of sections with kernels and biases */
+#define NETWORK_MODEL_MAGIC "NNPMODEL"
+#define NETWORK_MODEL_VERSION 1
+#define NETWORK_MODEL_BYTE_ORDER_MARK UINT32_C(0x01020304)
+#define NETWORK_MODEL_SECTION_ALIGNMENT 64
+
+#if NNP_BACKEND_X86_64
+	#define NETWORK_MODEL_BACKEND 1
+#elif NNP_BACKEND_ARM
+	#define NETWORK_MODEL_BACKEND 2
+#elif NNP_BACKEND_PSIMD
+	#define NETWORK_MODEL_BACKEND 3
+#elif NNP_BACKEND_SCALAR
+	#define NETWORK_MODEL_BACKEND 4
+#endif
+
+
+enum network_layer_type {
+	network_layer_convolution,
+	network_layer_max_pooling,
+	network_layer_relu,
+	network_layer_fully_connected,
+	network_layer_softmax,
+};
+
+struct network_layer {
+	enum network_layer_type type;
+	size_t input_channels;
+	size_t output_channels;
+	struct nnp_size input_size;
+	struct nnp_size output_size;
+	union {
+		struct {
+			enum nnp_convolution_algorithm algorithm;
+			enum nnp_convolution_transform_strategy transform_strategy;
+			struct nnp_padding input_padding;
+			struct nnp_size kernel_size;
+			struct nnp_size output_subsampling;
+			const float* kernel;
+			const float* bias;
+			enum nnp_activation activation;
+			/* Copy of the activation parameters, if the layer has them */
+			bool has_activation_parameters;
+			union {
+				float negative_slope;
+				struct nnp_clamp_parameters clamp;
+			} activation_parameters;
+			/*
+			 * Kernel transformed by nnp_network_plan, if the layer uses nnp_convolution_transform_strategy_precompute,
+			 * or the caller's transformed kernel, if the layer uses nnp_convolution_transform_strategy_reuse
+			 */
+			void* transformed_kernel;
+			size_t transformed_kernel_size;
+			size_t workspace_size;
+		} convolution;
+		struct {
+			struct nnp_padding input_padding;
+			struct nnp_size pooling_size;
+			struct nnp_size pooling_stride;
+		} pooling;
+		struct {
+			float negative_slope;
+		} relu;
+		struct {
+			const float* kernel;
+		} fully_connected;
+	};
+	/* Indices of planned buffers, or one of the NETWORK_* special values */
+	size_t input_buffer;
+	size_t output_buffer;
+	size_t workspace_buffer;
+	/*
+	 * For networks loaded by nnp_network_load_streaming: location of the (transformed) kernel and the bias in the model
+	 * file. Before the layer runs, the kernel is read to the start of a stream buffer, and the bias after it.
+	 */
+	struct {
+		bool enabled;
+		/* Index of the layer among layers with streamed parameters */
+		size_t index;
+		uint64_t kernel_offset;
+		size_t kernel_size;
+		uint64_t bias_offset;
+		size_t bias_size;
+	} stream;
+};
+
+/* An intermediate activation tensor or a layer workspace, live from first_layer to last_layer inclusive */
+struct network_buffer {
+	size_t size;
+	size_t first_layer;
+	size_t last_layer;
+	size_t offset;
+	/* For activation tensors: whether the tensor is placed at the end of the arena rather than at its start */
+	bool top_of_arena;
+};
+
+struct nnp_network {
+	size_t batch_size;
+	size_t input_channels;
+	struct nnp_size input_size;
+	/* Set when nnp_network_plan is called: no layers can be added after that, even if planning fails */
+	bool sealed;
+	/* Set when nnp_network_plan succeeds */
+	bool planned;
+
+	struct network_layer* layers;
+	size_t layers_count;
+	size_t layers_capacity;
+
+	struct network_buffer* buffers;
+	size_t buffers_count;
+
+	void* arena;
+	struct nnp_network_memory memory;
+
+	/* Mapping of the model file, if the network was loaded by nnp_network_load */
+	void* model;
+	size_t model_size;
+
+	/* Double buffering of layer parameters, if the network was loaded by nnp_network_load_streaming */
+	struct network_stream* stream;
+};
+
+/*
+ * Layer parameters of a streamed network live in two buffers. While a layer computes with the parameters in one buffer,
+ * a helper thread reads the parameters of the next streamed layer into the other one. Streamed layers with even indices
+ * use the first buffer, and layers with odd indices use the second, so each buffer is only as large as the largest
+ * layer which uses it.
+ */
+struct network_stream {
+	/* Model file, or block device with a model file at its start */
+	int fd;
+	/* Layers with streamed parameters, in the order of execution */
+	const struct network_layer** layers;
+	size_t layers_count;
+
+	void* buffers[2];
+	size_t buffer_size[2];
+	/* Index of the streamed layer which the buffer holds or is being read into, or NETWORK_NO_BUFFER */
+	size_t buffer_layer[2];
+	/* Set when the read into the buffer was requested, but the helper thread did not start it yet */
+	bool buffer_requested[2];
+	/* Set when no read into the buffer is in progress. buffer_status is the result of the last read */
+	bool buffer_ready[2];
+	enum nnp_status buffer_status[2];
+
+	/* Guards all fields above which change after loading, and the profile */
+	pthread_mutex_t mutex;
+	/* Signalled when a read is requested, when a read completes, and when the helper thread must exit */
+	pthread_cond_t cond;
+	pthread_t thread;
+	bool thread_started;
+	bool exiting;
+
+	struct nnp_network_stream_profile profile;
+};
+
+/*
+ * Hardware parameters which determine the layout of transformed kernels: the backend, SIMD width, cache blocking, and
+ * register blocking of the GEMM micro-kernels. Transformed kernels in a model file are only valid on the same key.
+ */
+struct network_model_key {
+	uint32_t backend;
+	uint32_t simd_width;
+	uint64_t blocking_l1;
+	uint64_t blocking_l2;
+	uint64_t blocking_l3;
+	uint32_t sgemm_mr;
+	uint32_t sgemm_nr;
+	uint32_t sxgemm_mr;
+	uint32_t sxgemm_nr;
+	uint32_t cxgemm_mr;
+	uint32_t cxgemm_nr;
+	uint32_t conv1x1_mr;
+	uint32_t conv1x1_nr;
+};
+
+struct network_model_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order_mark;
+	struct network_model_key key;
+	uint64_t input_channels;
+	uint64_t input_height;
+	uint64_t input_width;
+	uint64_t layers_count;
+	uint64_t file_size;
+};
+
+/* Location of kernel or bias data in a model file, with offset aligned to NETWORK_MODEL_SECTION_ALIGNMENT */
+struct network_model_section {
+	uint64_t offset;
+	uint64_t size;
+};
+
+/* Layer record in a model file. Records of all layers follow the header */
+struct network_model_layer {
+	uint32_t type;
+	uint32_t algorithm;
+	uint32_t transform_strategy;
+	uint32_t activation;
+	uint64_t output_channels;
+	/* Top, right, bottom, and left padding */
+	uint32_t input_padding[4];
+	/* Height and width of the convolution kernel or pooling window */
+	uint32_t kernel_size[2];
+	/* Height and width of the convolution subsampling or pooling stride */
+	uint32_t stride[2];
+	/* Height and width of the transform tile of the transformed kernel */
+	uint32_t transform_tile[2];
+	/* Negative slope of (leaky) ReLU, or bounds of clamp activation */
+	float activation_parameters[2];
+	uint32_t has_activation_parameters;
+	uint32_t reserved;
+	struct network_model_section kernel;
+	struct network_model_section bias;
+	struct network_model_section transformed_kernel;
+};
+
+/* Layers are stored in a growing array, so pointers to activation parameters are only taken when they are used */
+static inline const void* convolution_activation_parameters(const struct network_layer* layer) {
+	return layer->convolution.has_activation_parameters ? &layer->convolution.activation_parameters : NULL;
+}
+
+static inline size_t layer_output_elements(const struct nnp_network* network) {
+	if (network->layers_count == 0) {
+		return network->input_channels * network->input_size.height * network->input_size.width;
+	} else {
+		const struct network_layer* last_layer = &network->layers[network->layers_count - 1];
+		return last_layer->output_channels * last_layer->output_size.height * last_layer->output_size.width;
+	}
+}
+
+/* Appends a layer which consumes the output of the last layer (or the network input) and returns it */
+static enum nnp_status append_layer(
+	struct nnp_network* network,
+	enum network_layer_type type,
+	struct network_layer** layer_out)
+{
+	if (network == NULL || network->sealed) {
+		return nnp_status_invalid_network;
+	}
+
+	if (network->layers_count == network->layers_capacity) {
+		const size_t layers_capacity = max(network->layers_capacity * 2, 8);
+		struct network_layer* layers = realloc(network->layers, layers_capacity * sizeof(struct network_layer));
+		if (layers == NULL) {
+			return nnp_status_out_of_memory;
+		}
+		network->layers = layers;
+		network->layers_capacity = layers_capacity;
+	}
+
+	struct network_layer* layer = &network->layers[network->layers_count];
+	*layer = (struct network_layer) {
+		.type = type,
+		.input_channels = network->input_channels,
+		.output_channels = network->input_channels,
+		.input_size = network->input_size,
+		.output_size = network->input_size,
+	};
+	if (network->layers_count != 0) {
+		const struct network_layer* previous_layer = &network->layers[network->layers_count - 1];
+		layer->input_channels = previous_layer->output_channels;
+		layer->input_size = previous_layer->output_size;
+		layer->output_channels = previous_layer->output_channels;
+		layer->output_size = previous_layer->output_size;
+	}
+	*layer_out = layer;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_create(
+	size_t batch_size,
+	size_t input_channels,
+	struct nnp_size input_size,
+	nnp_network_t* network_out)
+{
+	if (network_out == NULL) {
+		return nnp_status_invalid_network;
+	}
+	*network_out = NULL;
+
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+	if (batch_size == 0) {
+		return nnp_status_invalid_batch_size;
+	}
+	if (input_channels == 0) {
+		return nnp_status_invalid_channels;
+	}
+	if (min(input_size.height, input_size.width) == 0) {
+		return nnp_status_invalid_input_size;
+	}
+
+	struct nnp_network* network = calloc(1, sizeof(struct nnp_network));
+	if (network == NULL) {
+		return nnp_status_out_of_memory;
+	}
+	network->batch_size = batch_size;
+	network->input_channels = input_channels;
+	network->input_size = input_size;
+
+	*network_out = network;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_add_convolution(
+	nnp_network_t network,
+	enum nnp_convolution_algorithm algorithm,
+	enum nnp_convolution_transform_strategy transform_strategy,
+	size_t output_channels,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const float* kernel,
+	const float* bias,
+	enum nnp_activation activation,
+	const void* activation_parameters)
+{
+	struct network_layer* layer = NULL;
+	enum nnp_status status = append_layer(network, network_layer_convolution, &layer);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	status = validate_convolution_arguments(
+		network->batch_size, layer->input_channels, output_channels,
+		layer->input_size, input_padding, kernel_size, output_subsampling,
+		activation, activation_parameters);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	switch (transform_strategy) {
+		case nnp_convolution_transform_strategy_compute:
+		case nnp_convolution_transform_strategy_precompute:
+			break;
+		case nnp_convolution_transform_strategy_reuse:
+			/* A transformed kernel is only valid for the algorithm it was transformed for */
+			if (algorithm == nnp_convolution_algorithm_auto) {
+				return nnp_status_invalid_algorithm;
+			}
+			break;
+		default:
+			return nnp_status_invalid_transform_strategy;
+	}
+
+	layer->output_channels = output_channels;
+	layer->output_size = (struct nnp_size) {
+		.height = (input_padding.top + layer->input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1,
+		.width = (input_padding.left + layer->input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+	};
+	layer->convolution.algorithm = algorithm;
+	layer->convolution.transform_strategy = transform_strategy;
+	layer->convolution.input_padding = input_padding;
+	layer->convolution.kernel_size = kernel_size;
+	layer->convolution.output_subsampling = output_subsampling;
+	if (transform_strategy == nnp_convolution_transform_strategy_reuse) {
+		layer->convolution.transformed_kernel = (void*) kernel;
+	} else {
+		layer->convolution.kernel = kernel;
+	}
+	layer->convolution.bias = bias;
+	layer->convolution.activation = activation;
+	if (activation_parameters != NULL) {
+		switch (activation) {
+			case nnp_activation_relu:
+				layer->convolution.activation_parameters.negative_slope = *((const float*) activation_parameters);
+				break;
+			case nnp_activation_clamp:
+				layer->convolution.activation_parameters.clamp = *((const struct nnp_clamp_parameters*) activation_parameters);
+				break;
+			default:
+				break;
+		}
+		layer->convolution.has_activation_parameters = true;
+	}
+
+	network->layers_count += 1;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_add_max_pooling(
+	nnp_network_t network,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride)
+{
+	struct network_layer* layer = NULL;
+	enum nnp_status status = append_layer(network, network_layer_max_pooling, &layer);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	status = validate_pooling_arguments(
+		network->batch_size, layer->input_channels,
+		layer->input_size, input_padding,
+		pooling_size, pooling_stride);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	/* Same output size as in nnp_max_pooling_output */
+	layer->output_size = (struct nnp_size) {
+		.height = divide_round_up(doz(input_padding.top + layer->input_size.height + input_padding.bottom, pooling_size.height), pooling_stride.height) + 1,
+		.width = divide_round_up(doz(input_padding.left + layer->input_size.width + input_padding.right, pooling_size.width), pooling_stride.width) + 1,
+	};
+	layer->pooling.input_padding = input_padding;
+	layer->pooling.pooling_size = pooling_size;
+	layer->pooling.pooling_stride = pooling_stride;
+
+	network->layers_count += 1;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_add_relu(
+	nnp_network_t network,
+	float negative_slope)
+{
+	if (network == NULL || network->sealed) {
+		return nnp_status_invalid_network;
+	}
+
+	if (!isfinite(negative_slope) || negative_slope < 0.0f) {
+		return nnp_status_invalid_activation_parameters;
+	}
+
+	/* ReLU right after a convolution without activation is fused into the output transform of the convolution */
+	if (network->layers_count != 0) {
+		struct network_layer* previous_layer = &network->layers[network->layers_count - 1];
+		if (previous_layer->type == network_layer_convolution &&
+			previous_layer->convolution.activation == nnp_activation_identity)
+		{
+			previous_layer->convolution.activation = nnp_activation_relu;
+			if (negative_slope != 0.0f) {
+				previous_layer->convolution.activation_parameters.negative_slope = negative_slope;
+				previous_layer->convolution.has_activation_parameters = true;
+			}
+			return nnp_status_success;
+		}
+	}
+
+	struct network_layer* layer = NULL;
+	enum nnp_status status = append_layer(network, network_layer_relu, &layer);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	layer->relu.negative_slope = negative_slope;
+
+	network->layers_count += 1;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_add_fully_connected(
+	nnp_network_t network,
+	size_t output_channels,
+	const float* kernel)
+{
+	struct network_layer* layer = NULL;
+	enum nnp_status status = append_layer(network, network_layer_fully_connected, &layer);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	/* The layer consumes each image of the batch as a vector of channels x height x width elements */
+	layer->input_channels = layer_output_elements(network);
+	layer->input_size = (struct nnp_size) { .height = 1, .width = 1 };
+	status = validate_fully_connected_arguments(network->batch_size, layer->input_channels, output_channels);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	layer->output_channels = output_channels;
+	layer->output_size = (struct nnp_size) { .height = 1, .width = 1 };
+	layer->fully_connected.kernel = kernel;
+
+	network->layers_count += 1;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_add_softmax(
+	nnp_network_t network)
+{
+	struct network_layer* layer = NULL;
+	enum nnp_status status = append_layer(network, network_layer_softmax, &layer);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	/* Softmax is computed over all channels x height x width elements of each image */
+	status = validate_softmax_arguments(network->batch_size, layer_output_elements(network));
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	network->layers_count += 1;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_get_output_shape(
+	nnp_network_t network,
+	size_t* channels,
+	struct nnp_size* output_size)
+{
+	if (network == NULL || network->layers_count == 0) {
+		return nnp_status_invalid_network;
+	}
+
+	const struct network_layer* last_layer = &network->layers[network->layers_count - 1];
+	if (channels != NULL) {
+		*channels = last_layer->output_channels;
+	}
+	if (output_size != NULL) {
+		*output_size = last_layer->output_size;
+	}
+	return nnp_status_success;
+}
+
+static size_t append_buffer(struct nnp_network* network, size_t size, size_t layer) {
+	network->buffers[network->buffers_count] = (struct network_buffer) {
+		.size = round_up(size, NETWORK_BUFFER_ALIGNMENT),
+		.first_layer = layer,
+		.last_layer = layer,
+	};
+	return network->buffers_count++;
+}
+
+/*
+ * Assigns arena offsets to all buffers. Layers form a chain, so in every layer at most two tensors are live, the layer
+ * input and the layer output, together with the layer workspace. Consecutive tensors are placed at the opposite ends
+ * of the arena and workspaces in the gap between them, so an arena as large as the largest total size of buffers
+ * live in the same layer holds all of them.
+ */
+static void place_buffers(struct nnp_network* network, size_t arena_size) {
+	bool top_of_arena = false;
+	for (size_t i = 0; i < network->layers_count; i++) {
+		const struct network_layer* layer = &network->layers[i];
+
+		size_t bottom_size = 0;
+		const size_t tensors[2] = { layer->input_buffer, layer->output_buffer };
+		for (size_t t = 0; t < 2; t++) {
+			if (tensors[t] >= network->buffers_count) {
+				continue;
+			}
+
+			struct network_buffer* tensor = &network->buffers[tensors[t]];
+			if (tensor->first_layer == i) {
+				tensor->top_of_arena = top_of_arena;
+				tensor->offset = top_of_arena ? arena_size - tensor->size : 0;
+				top_of_arena = !top_of_arena;
+			}
+			if (!tensor->top_of_arena) {
+				bottom_size = tensor->size;
+			}
+		}
+
+		if (layer->workspace_buffer != NETWORK_NO_BUFFER) {
+			network->buffers[layer->workspace_buffer].offset = bottom_size;
+		}
+	}
+}
+
+static enum nnp_status query_transformed_kernel_size(
+	const struct nnp_network* network,
+	const struct network_layer* layer,
+	const void* kernel,
+	pthreadpool_t threadpool,
+	size_t* transformed_kernel_size)
+{
+	return nnp_convolution_inference_batch(
+		layer->convolution.algorithm, nnp_convolution_transform_strategy_precompute,
+		network->batch_size, layer->input_channels, layer->output_channels,
+		layer->input_size, layer->convolution.input_padding,
+		layer->convolution.kernel_size, layer->convolution.output_subsampling,
+		NULL, kernel, NULL, NULL,
+		NULL, transformed_kernel_size,
+		layer->convolution.activation, convolution_activation_parameters(layer),
+		threadpool, NULL);
+}
+
+static enum nnp_status plan_convolution(
+	struct nnp_network* network,
+	struct network_layer* layer,
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = nnp_status_success;
+
+	if (layer->convolution.transform_strategy == nnp_convolution_transform_strategy_precompute) {
+		/*
+		 * The transformed kernel is only valid for the algorithm it was transformed for, so automatic algorithm
+		 * selection is resolved here once, in the same way as for convolution plans. Without a tuned choice, the layer
+		 * records the heuristic choice, so that the transformed kernel in a model file names its algorithm.
+		 */
+		const bool automatic = layer->convolution.algorithm == nnp_convolution_algorithm_auto;
+		if (automatic) {
+			const struct nnp_convolution_shape shape = {
+				.batch_size = network->batch_size,
+				.input_channels = layer->input_channels,
+				.output_channels = layer->output_channels,
+				.input_size = layer->input_size,
+				.input_padding = layer->convolution.input_padding,
+				.kernel_size = layer->convolution.kernel_size,
+				.output_subsampling = layer->convolution.output_subsampling,
+				.activation = layer->convolution.activation,
+			};
+			status = nnp_autotune_select(&shape, threadpool, &layer->convolution.algorithm, NULL);
+			if (status != nnp_status_success) {
+				return status;
+			}
+			if (layer->convolution.algorithm == nnp_convolution_algorithm_auto) {
+				layer->convolution.algorithm = nnp_convolution_heuristic_algorithm(
+					layer->input_size, layer->convolution.input_padding,
+					layer->convolution.kernel_size, layer->convolution.output_subsampling);
+			}
+		}
+
+		status = query_transformed_kernel_size(network, layer, layer->convolution.kernel, threadpool,
+			&layer->convolution.transformed_kernel_size);
+		if (status == nnp_status_unsupported_transform_strategy && automatic) {
+			/* Algorithms which consume the kernel as is (e.g. direct 1x1 convolution) have nothing to precompute */
+			layer->convolution.transform_strategy = nnp_convolution_transform_strategy_compute;
+			layer->convolution.transformed_kernel_size = 0;
+		} else if (status != nnp_status_success) {
+			return status;
+		} else {
+			layer->convolution.transformed_kernel = allocate_memory(layer->convolution.transformed_kernel_size);
+			if (layer->convolution.transformed_kernel == NULL) {
+				return nnp_status_out_of_memory;
+			}
+
+			status = nnp_convolution_inference_batch(
+				layer->convolution.algorithm, nnp_convolution_transform_strategy_precompute,
+				network->batch_size, layer->input_channels, layer->output_channels,
+				layer->input_size, layer->convolution.input_padding,
+				layer->convolution.kernel_size, layer->convolution.output_subsampling,
+				NULL, layer->convolution.kernel, NULL, NULL,
+				layer->convolution.transformed_kernel, &layer->convolution.transformed_kernel_size,
+				layer->convolution.activation, convolution_activation_parameters(layer),
+				threadpool, NULL);
+			if (status != nnp_status_success) {
+				return status;
+			}
+			network->memory.parameters_size += layer->convolution.transformed_kernel_size;
+		}
+	} else if (layer->convolution.transform_strategy == nnp_convolution_transform_strategy_reuse) {
+		/* The caller's transformed kernel is not owned by the network: its size is only recorded for nnp_network_save */
+		status = query_transformed_kernel_size(network, layer, layer->convolution.transformed_kernel, threadpool,
+			&layer->convolution.transformed_kernel_size);
+		if (status != nnp_status_success) {
+			return status;
+		}
+	}
+
+	const bool reuse = layer->convolution.transformed_kernel != NULL;
+	return nnp_convolution_inference_batch(
+		layer->convolution.algorithm,
+		reuse ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute,
+		network->batch_size, layer->input_channels, layer->output_channels,
+		layer->input_size, layer->convolution.input_padding,
+		layer->convolution.kernel_size, layer->convolution.output_subsampling,
+		NULL, reuse ? layer->convolution.transformed_kernel : layer->convolution.kernel, layer->convolution.bias, NULL,
+		NULL, &layer->convolution.workspace_size,
+		layer->convolution.activation, convolution_activation_parameters(layer),
+		threadpool, NULL);
+}
+
+enum nnp_status nnp_network_plan(
+	nnp_network_t network,
+	pthreadpool_t threadpool)
+{
+	if (network == NULL || network->sealed || network->layers_count == 0) {
+		return nnp_status_invalid_network;
+	}
+	network->sealed = true;
+
+	/* Every layer adds at most an output tensor and a workspace */
+	network->buffers = calloc(2 * network->layers_count, sizeof(struct network_buffer));
+	if (network->buffers == NULL) {
+		return nnp_status_out_of_memory;
+	}
+
+	enum nnp_status status = nnp_status_success;
+	size_t current_buffer = NETWORK_EXTERNAL_INPUT;
+	for (size_t i = 0; i < network->layers_count; i++) {
+		struct network_layer* layer = &network->layers[i];
+
+		layer->input_buffer = current_buffer;
+		if (current_buffer != NETWORK_EXTERNAL_INPUT) {
+			network->buffers[current_buffer].last_layer = i;
+		}
+
+		/* Element-wise layers overwrite their input, unless it is the caller's input */
+		const bool in_place = (layer->type == network_layer_relu || layer->type == network_layer_softmax) &&
+			current_buffer != NETWORK_EXTERNAL_INPUT;
+		if (!in_place) {
+			current_buffer = append_buffer(network,
+				network->batch_size * layer->output_channels * layer->output_size.height * layer->output_size.width * sizeof(float),
+				i);
+		}
+		layer->output_buffer = current_buffer;
+
+		layer->workspace_buffer = NETWORK_NO_BUFFER;
+		if (layer->type == network_layer_convolution) {
+			status = plan_convolution(network, layer, threadpool);
+			if (status != nnp_status_success) {
+				goto cleanup;
+			}
+			if (layer->convolution.workspace_size != 0) {
+				layer->workspace_buffer = append_buffer(network, layer->convolution.workspace_size, i);
+			}
+		}
+	}
+
+	/* The tensor produced last is the caller's output buffer: it does not take space in the arena */
+	const size_t output_buffer = current_buffer;
+	for (size_t i = 0; i < network->layers_count; i++) {
+		struct network_layer* layer = &network->layers[i];
+		if (layer->input_buffer == output_buffer) {
+			layer->input_buffer = NETWORK_EXTERNAL_OUTPUT;
+		}
+		if (layer->output_buffer == output_buffer) {
+			layer->output_buffer = NETWORK_EXTERNAL_OUTPUT;
+		}
+	}
+	network->buffers[output_buffer].size = 0;
+
+	/* Memory statistics: the sum of all buffers, and the largest sum of buffers live in the same layer */
+	for (size_t i = 0; i < network->buffers_count; i++) {
+		network->memory.unplanned_size += network->buffers[i].size;
+	}
+	for (size_t i = 0; i < network->layers_count; i++) {
+		size_t live_size = 0;
+		for (size_t j = 0; j < network->buffers_count; j++) {
+			const struct network_buffer* buffer = &network->buffers[j];
+			if (buffer->first_layer <= i && i <= buffer->last_layer) {
+				live_size += buffer->size;
+			}
+		}
+		network->memory.peak_live_size = max(network->memory.peak_live_size, live_size);
+	}
+
+	network->memory.arena_size = network->memory.peak_live_size;
+	place_buffers(network, network->memory.arena_size);
+
+	if (network->memory.arena_size != 0) {
+		network->arena = allocate_memory(network->memory.arena_size);
+		if (network->arena == NULL) {
+			status = nnp_status_out_of_memory;
+			goto cleanup;
+		}
+	}
+	network->planned = true;
+
+cleanup:
+	return status;
+}
+
+enum nnp_status nnp_network_get_memory(
+	nnp_network_t network,
+	struct nnp_network_memory* memory)
+{
+	if (network == NULL || !network->planned) {
+		return nnp_status_invalid_network;
+	}
+
+	*memory = network->memory;
+	return nnp_status_success;
+}
+
+static inline void* buffer_pointer(
+	const struct nnp_network* network,
+	size_t buffer,
+	const float* input,
+	float* output)
+{
+	switch (buffer) {
+		case NETWORK_NO_BUFFER:
+			return NULL;
+		case NETWORK_EXTERNAL_INPUT:
+			return (void*) input;
+		case NETWORK_EXTERNAL_OUTPUT:
+			return output;
+		default:
+			return network->arena + network->buffers[buffer].offset;
+	}
+}
+
+static enum nnp_status run_layer(
+	const struct nnp_network* network,
+	const struct network_layer* layer,
+	const float* layer_input,
+	float* layer_output,
+	void* workspace,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	const size_t batch_size = network->batch_size;
+	switch (layer->type) {
+		case network_layer_convolution:
+		{
+			const bool reuse = layer->convolution.transformed_kernel != NULL;
+			size_t workspace_size = layer->convolution.workspace_size;
+			return nnp_convolution_inference_batch(
+				layer->convolution.algorithm,
+				reuse ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute,
+				batch_size, layer->input_channels, layer->output_channels,
+				layer->input_size, layer->convolution.input_padding,
+				layer->convolution.kernel_size, layer->convolution.output_subsampling,
+				layer_input, reuse ? layer->convolution.transformed_kernel : layer->convolution.kernel,
+				layer->convolution.bias, layer_output,
+				workspace, workspace == NULL ? NULL : &workspace_size,
+				layer->convolution.activation, convolution_activation_parameters(layer),
+				threadpool, profile);
+		}
+		case network_layer_max_pooling:
+			return nnp_max_pooling_output(
+				batch_size, layer->input_channels,
+				layer->input_size, layer->pooling.input_padding,
+				layer->pooling.pooling_size, layer->pooling.pooling_stride,
+				layer_input, layer_output,
+				threadpool);
+		case network_layer_relu:
+			return nnp_relu_output(
+				batch_size, layer->input_channels * layer->input_size.height * layer->input_size.width,
+				layer_input, layer_output,
+				layer->relu.negative_slope,
+				threadpool);
+		case network_layer_fully_connected:
+			for (size_t sample = 0; sample < batch_size; sample++) {
+				const enum nnp_status status = nnp_fully_connected_inference(
+					layer->input_channels, layer->output_channels,
+					layer_input + sample * layer->input_channels,
+					layer->fully_connected.kernel,
+					layer_output + sample * layer->output_channels,
+					threadpool);
+				if (status != nnp_status_success) {
+					return status;
+				}
+			}
+			return nnp_status_success;
+		case network_layer_softmax:
+			return nnp_softmax_output(
+				batch_size, layer->input_channels * layer->input_size.height * layer->input_size.width,
+				layer_input, layer_output,
+				threadpool);
+	}
+	NNP_UNREACHABLE;
+}
+
+/* Reads a section of the model file, retrying short reads, which are normal for block devices */
+static bool read_stream_section(int fd, uint64_t offset, size_t size, void* data) {
+	size_t bytes_done = 0;
+	while (bytes_done < size) {
+		const ssize_t bytes_read = pread(fd, data + bytes_done, size - bytes_done, (off_t) (offset + bytes_done));
+		if (bytes_read < 0 && errno == EINTR) {
+			continue;
+		}
+		if (bytes_read <= 0) {
+			return false;
+		}
+		bytes_done += (size_t) bytes_read;
+	}
+	return true;
+}
+
+/* Helper thread of a streamed network: reads layer parameters into stream buffers on request */
+static void* stream_thread_function(void* argument) {
+	struct network_stream* stream = argument;
+
+	pthread_mutex_lock(&stream->mutex);
+	for (;;) {
+		size_t buffer = NETWORK_NO_BUFFER;
+		if (stream->buffer_requested[0]) {
+			buffer = 0;
+		} else if (stream->buffer_requested[1]) {
+			buffer = 1;
+		}
+		if (buffer == NETWORK_NO_BUFFER) {
+			if (stream->exiting) {
+				break;
+			}
+			pthread_cond_wait(&stream->cond, &stream->mutex);
+			continue;
+		}
+		stream->buffer_requested[buffer] = false;
+		const struct network_layer* layer = stream->layers[stream->buffer_layer[buffer]];
+		void* data = stream->buffers[buffer];
+		pthread_mutex_unlock(&stream->mutex);
+
+		const double read_start = read_timer();
+		const bool success =
+			read_stream_section(stream->fd, layer->stream.kernel_offset, layer->stream.kernel_size, data) &&
+			read_stream_section(stream->fd, layer->stream.bias_offset, layer->stream.bias_size,
+				data + round_up(layer->stream.kernel_size, NETWORK_BUFFER_ALIGNMENT));
+		const double read_time = read_timer() - read_start;
+
+		pthread_mutex_lock(&stream->mutex);
+		stream->profile.io_time += read_time;
+		stream->profile.reads += 1;
+		if (success) {
+			stream->profile.bytes_read += layer->stream.kernel_size + layer->stream.bias_size;
+		}
+		stream->buffer_status[buffer] = success ? nnp_status_success : nnp_status_io_error;
+		stream->buffer_ready[buffer] = true;
+		pthread_cond_broadcast(&stream->cond);
+	}
+	pthread_mutex_unlock(&stream->mutex);
+	return NULL;
+}
+
+/* Asks the helper thread to read parameters of a streamed layer into an idle buffer. The mutex must be held */
+static void request_stream_read(struct network_stream* stream, size_t buffer, size_t index) {
+	stream->buffer_layer[buffer] = index;
+	stream->buffer_requested[buffer] = true;
+	stream->buffer_ready[buffer] = false;
+	pthread_cond_broadcast(&stream->cond);
+}
+
+/*
+ * Waits until parameters of a streamed layer are in its buffer, then starts reading parameters of the next streamed
+ * layer into the other buffer, which held the previous streamed layer. After the last streamed layer, the first one is
+ * read ahead for the next run, unless both use the same buffer.
+ */
+static enum nnp_status acquire_stream_buffer(
+	struct network_stream* stream,
+	size_t index,
+	void** data)
+{
+	const size_t buffer = index % 2;
+
+	pthread_mutex_lock(&stream->mutex);
+	const double wait_start = read_timer();
+	/* The buffer may still be read into after a failed run, possibly for another layer */
+	while (!stream->buffer_ready[buffer]) {
+		pthread_cond_wait(&stream->cond, &stream->mutex);
+	}
+	if (stream->buffer_layer[buffer] != index || stream->buffer_status[buffer] != nnp_status_success) {
+		request_stream_read(stream, buffer, index);
+		while (!stream->buffer_ready[buffer]) {
+			pthread_cond_wait(&stream->cond, &stream->mutex);
+		}
+	}
+	stream->profile.wait_time += read_timer() - wait_start;
+
+	const enum nnp_status status = stream->buffer_status[buffer];
+	if (status == nnp_status_success) {
+		const size_t next_index = index + 1 == stream->layers_count ? 0 : index + 1;
+		const size_t next_buffer = next_index % 2;
+		if (next_buffer != buffer && stream->buffer_ready[next_buffer] && stream->buffer_layer[next_buffer] != next_index) {
+			request_stream_read(stream, next_buffer, next_index);
+		}
+		*data = stream->buffers[buffer];
+	}
+	pthread_mutex_unlock(&stream->mutex);
+	return status;
+}
+
+static void destroy_stream(struct network_stream* stream) {
+	if (stream->thread_started) {
+		pthread_mutex_lock(&stream->mutex);
+		stream->exiting = true;
+		pthread_cond_broadcast(&stream->cond);
+		pthread_mutex_unlock(&stream->mutex);
+		pthread_join(stream->thread, NULL);
+	}
+	pthread_cond_destroy(&stream->cond);
+	pthread_mutex_destroy(&stream->mutex);
+	for (size_t buffer = 0; buffer < 2; buffer++) {
+		if (stream->buffers[buffer] != NULL) {
+			release_memory(stream->buffers[buffer], stream->buffer_size[buffer]);
+		}
+	}
+	if (stream->fd != -1) {
+		close(stream->fd);
+	}
+	free(stream->layers);
+	free(stream);
+}
+
+enum nnp_status nnp_network_run(
+	nnp_network_t network,
+	const float* input,
+	float* output,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	enum nnp_status status = nnp_status_success;
+	if (network == NULL || !network->planned) {
+		status = nnp_status_invalid_network;
+		goto cleanup;
+	}
+
+	for (size_t i = 0; i < network->layers_count; i++) {
+		const struct network_layer* layer = &network->layers[i];
+
+		/* Streamed layers run on a copy which points to the parameters in the stream buffer */
+		struct network_layer streamed_layer;
+		if (layer->stream.enabled) {
+			void* data = NULL;
+			status = acquire_stream_buffer(network->stream, layer->stream.index, &data);
+			if (status != nnp_status_success) {
+				goto cleanup;
+			}
+
+			streamed_layer = *layer;
+			const float* bias = layer->stream.bias_size == 0 ? NULL :
+				data + round_up(layer->stream.kernel_size, NETWORK_BUFFER_ALIGNMENT);
+			if (layer->type == network_layer_fully_connected) {
+				streamed_layer.fully_connected.kernel = data;
+			} else if (layer->convolution.transformed_kernel != NULL) {
+				streamed_layer.convolution.transformed_kernel = data;
+				streamed_layer.convolution.bias = bias;
+			} else {
+				streamed_layer.convolution.kernel = data;
+				streamed_layer.convolution.bias = bias;
+			}
+			layer = &streamed_layer;
+		}
+
+		struct nnp_profile layer_profile = { 0 };
+		status = run_layer(network, layer,
+			buffer_pointer(network, layer->input_buffer, input, output),
+			buffer_pointer(network, layer->output_buffer, input, output),
+			buffer_pointer(network, layer->workspace_buffer, input, output),
+			threadpool, profile == NULL ? NULL : &layer_profile);
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+
+		if (profile != NULL) {
+			profile->input_transform += layer_profile.input_transform;
+			profile->kernel_transform += layer_profile.kernel_transform;
+			profile->output_transform += layer_profile.output_transform;
+			profile->block_multiplication += layer_profile.block_multiplication;
+		}
+	}
+
+cleanup:
+	NNP_TOTAL_END(profile)
+	return status;
+}
+
+void nnp_network_destroy(nnp_network_t network) {
+	if (network != NULL) {
+		if (network->arena != NULL) {
+			release_memory(network->arena, network->memory.arena_size);
+		}
+		for (size_t i = 0; i < network->layers_count; i++) {
+			const struct network_layer* layer = &network->layers[i];
+			if (layer->type == network_layer_convolution &&
+				layer->convolution.transform_strategy == nnp_convolution_transform_strategy_precompute &&
+				layer->convolution.transformed_kernel != NULL)
+			{
+				release_memory(layer->convolution.transformed_kernel, layer->convolution.transformed_kernel_size);
+			}
+		}
+		if (network->model != NULL) {
+			munmap(network->model, network->model_size);
+		}
+		if (network->stream != NULL) {
+			destroy_stream(network->stream);
+		}
+		free(network->buffers);
+		free(network->layers);
+		free(network);
+	}
+}
+
+static struct network_model_key model_key(void) {
+	return (struct network_model_key) {
+		.backend = NETWORK_MODEL_BACKEND,
+		.simd_width = nnp_hwinfo.simd_width,
+		.blocking_l1 = nnp_hwinfo.blocking.l1,
+		.blocking_l2 = nnp_hwinfo.blocking.l2,
+		.blocking_l3 = nnp_hwinfo.blocking.l3,
+		.sgemm_mr = nnp_hwinfo.sgemm.mr,
+		.sgemm_nr = nnp_hwinfo.sgemm.nr,
+		.sxgemm_mr = nnp_hwinfo.sxgemm.mr,
+		.sxgemm_nr = nnp_hwinfo.sxgemm.nr,
+		.cxgemm_mr = nnp_hwinfo.cxgemm.mr,
+		.cxgemm_nr = nnp_hwinfo.cxgemm.nr,
+		.conv1x1_mr = nnp_hwinfo.conv1x1.mr,
+		.conv1x1_nr = nnp_hwinfo.conv1x1.nr,
+	};
+}
+
+/* Size of the tiles of kernels transformed by the algorithm, or 0x0 if the algorithm only packs kernels */
+static struct nnp_size transform_tile_size(enum nnp_convolution_algorithm algorithm) {
+	switch (algorithm) {
+		case nnp_convolution_algorithm_ft8x8:
+		case nnp_convolution_algorithm_wt8x8:
+		case nnp_convolution_algorithm_wt8x8_fp16:
+			return (struct nnp_size) { .height = 8, .width = 8 };
+		case nnp_convolution_algorithm_ft16x16:
+			return (struct nnp_size) { .height = 16, .width = 16 };
+		case nnp_convolution_algorithm_wt4x4:
+			return (struct nnp_size) { .height = 4, .width = 4 };
+		case nnp_convolution_algorithm_wt6x6:
+			return (struct nnp_size) { .height = 6, .width = 6 };
+		default:
+			return (struct nnp_size) { .height = 0, .width = 0 };
+	}
+}
+
+/* Assigns an aligned offset after the end of the file to a section of the given size, and extends the file */
+static struct network_model_section append_section(size_t* file_size, size_t size) {
+	struct network_model_section section = { 0 };
+	if (size != 0) {
+		section.offset = round_up(*file_size, NETWORK_MODEL_SECTION_ALIGNMENT);
+		section.size = size;
+		*file_size = section.offset + size;
+	}
+	return section;
+}
+
+static bool write_section(FILE* file, size_t* file_offset, const struct network_model_section* section, const void* data) {
+	static const char padding[NETWORK_MODEL_SECTION_ALIGNMENT] = { 0 };
+
+	if (section->size == 0) {
+		return true;
+	}
+
+	const size_t padding_size = section->offset - *file_offset;
+	if (fwrite(padding, 1, padding_size, file) != padding_size || fwrite(data, 1, section->size, file) != section->size) {
+		return false;
+	}
+	*file_offset = section->offset + section->size;
+	return true;
+}
+
+enum nnp_status nnp_network_save(
+	nnp_network_t network,
+	const char* path)
+{
+	/* Parameters of streamed networks are not in memory */
+	if (network == NULL || !network->planned || network->stream != NULL) {
+		return nnp_status_invalid_network;
+	}
+	if (path == NULL) {
+		return nnp_status_io_error;
+	}
+
+	enum nnp_status status = nnp_status_success;
+	FILE* file = NULL;
+	struct network_model_layer* records = calloc(network->layers_count, sizeof(struct network_model_layer));
+	if (records == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+
+	size_t file_size = sizeof(struct network_model_header) + network->layers_count * sizeof(struct network_model_layer);
+	for (size_t i = 0; i < network->layers_count; i++) {
+		const struct network_layer* layer = &network->layers[i];
+		struct network_model_layer* record = &records[i];
+		record->type = layer->type;
+		record->output_channels = layer->output_channels;
+		switch (layer->type) {
+			case network_layer_convolution:
+			{
+				record->algorithm = layer->convolution.algorithm;
+				record->transform_strategy = layer->convolution.transform_strategy;
+				record->activation = layer->convolution.activation;
+				record->input_padding[0] = layer->convolution.input_padding.top;
+				record->input_padding[1] = layer->convolution.input_padding.right;
+				record->input_padding[2] = layer->convolution.input_padding.bottom;
+				record->input_padding[3] = layer->convolution.input_padding.left;
+				record->kernel_size[0] = layer->convolution.kernel_size.height;
+				record->kernel_size[1] = layer->convolution.kernel_size.width;
+				record->stride[0] = layer->convolution.output_subsampling.height;
+				record->stride[1] = layer->convolution.output_subsampling.width;
+				if (layer->convolution.has_activation_parameters) {
+					record->has_activation_parameters = 1;
+					if (layer->convolution.activation == nnp_activation_clamp) {
+						record->activation_parameters[0] = layer->convolution.activation_parameters.clamp.output_min;
+						record->activation_parameters[1] = layer->convolution.activation_parameters.clamp.output_max;
+					} else {
+						record->activation_parameters[0] = layer->convolution.activation_parameters.negative_slope;
+					}
+				}
+
+				if (layer->convolution.kernel != NULL) {
+					record->kernel = append_section(&file_size, layer->output_channels * layer->input_channels *
+						layer->convolution.kernel_size.height * layer->convolution.kernel_size.width * sizeof(float));
+				}
+				if (layer->convolution.bias != NULL) {
+					record->bias = append_section(&file_size, layer->output_channels * sizeof(float));
+				}
+				if (layer->convolution.transformed_kernel != NULL) {
+					const struct nnp_size transform_tile = transform_tile_size(layer->convolution.algorithm);
+					record->transform_tile[0] = transform_tile.height;
+					record->transform_tile[1] = transform_tile.width;
+					record->transformed_kernel = append_section(&file_size, layer->convolution.transformed_kernel_size);
+				}
+				break;
+			}
+			case network_layer_max_pooling:
+				record->input_padding[0] = layer->pooling.input_padding.top;
+				record->input_padding[1] = layer->pooling.input_padding.right;
+				record->input_padding[2] = layer->pooling.input_padding.bottom;
+				record->input_padding[3] = layer->pooling.input_padding.left;
+				record->kernel_size[0] = layer->pooling.pooling_size.height;
+				record->kernel_size[1] = layer->pooling.pooling_size.width;
+				record->stride[0] = layer->pooling.pooling_stride.height;
+				record->stride[1] = layer->pooling.pooling_stride.width;
+				break;
+			case network_layer_relu:
+				record->activation_parameters[0] = layer->relu.negative_slope;
+				record->has_activation_parameters = 1;
+				break;
+			case network_layer_fully_connected:
+				if (layer->fully_connected.kernel != NULL) {
+					record->kernel = append_section(&file_size, layer->output_channels * layer->input_channels * sizeof(float));
+				}
+				break;
+			case network_layer_softmax:
+				break;
+		}
+	}
+
+	struct network_model_header header = {
+		.version = NETWORK_MODEL_VERSION,
+		.byte_order_mark = NETWORK_MODEL_BYTE_ORDER_MARK,
+		.key = model_key(),
+		.input_channels = network->input_channels,
+		.input_height = network->input_size.height,
+		.input_width = network->input_size.width,
+		.layers_count = network->layers_count,
+		.file_size = file_size,
+	};
+	memcpy(header.magic, NETWORK_MODEL_MAGIC, sizeof(header.magic));
+
+	file = fopen(path, "wb");
+	if (file == NULL) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+
+	bool failed = fwrite(&header, sizeof(header), 1, file) != 1 ||
+		fwrite(records, sizeof(struct network_model_layer), network->layers_count, file) != network->layers_count;
+	size_t file_offset = sizeof(struct network_model_header) + network->layers_count * sizeof(struct network_model_layer);
+	for (size_t i = 0; i < network->layers_count && !failed; i++) {
+		const struct network_layer* layer = &network->layers[i];
+		const struct network_model_layer* record = &records[i];
+		switch (layer->type) {
+			case network_layer_convolution:
+				failed = !write_section(file, &file_offset, &record->kernel, layer->convolution.kernel) ||
+					!write_section(file, &file_offset, &record->bias, layer->convolution.bias) ||
+					!write_section(file, &file_offset, &record->transformed_kernel, layer->convolution.transformed_kernel);
+				break;
+			case network_layer_fully_connected:
+				failed = !write_section(file, &file_offset, &record->kernel, layer->fully_connected.kernel);
+				break;
+			default:
+				break;
+		}
+	}
+	if (fclose(file) != 0) {
+		failed = true;
+	}
+	if (failed) {
+		status = nnp_status_io_error;
+	}
+
+cleanup:
+	free(records);
+	return status;
+}
+
+/* Checks that a section lies within the model file, and has the expected size (SIZE_MAX for any size) unless empty */
+static bool validate_section(const struct network_model_section* section, size_t model_size, size_t expected_size) {
+	if (section->size == 0) {
+		return true;
+	}
+
+	return section->offset % NETWORK_MODEL_SECTION_ALIGNMENT == 0 &&
+		section->offset <= model_size && section->size <= model_size - section->offset &&
+		(expected_size == SIZE_MAX || section->size == expected_size);
+}
+
+/* Stand-in for parameters of streamed layers, which are only in memory while the layer runs */
+static const float streamed_section_placeholder[1];
+
+/* Returns parameters in a model file in memory, or a placeholder for a streamed model (NULL model) */
+static inline const void* section_data(const void* model, const struct network_model_section* section) {
+	if (section->size == 0) {
+		return NULL;
+	}
+	return model == NULL ? streamed_section_placeholder : model + section->offset;
+}
+
+static enum nnp_status load_convolution(
+	struct nnp_network* network,
+	const void* model,
+	size_t model_size,
+	const struct network_model_layer* record,
+	bool same_hardware,
+	pthreadpool_t threadpool)
+{
+	const size_t input_channels = network->layers_count == 0 ?
+		network->input_channels : network->layers[network->layers_count - 1].output_channels;
+	const size_t output_channels = record->output_channels;
+	const struct nnp_padding input_padding = {
+		.top = record->input_padding[0],
+		.right = record->input_padding[1],
+		.bottom = record->input_padding[2],
+		.left = record->input_padding[3],
+	};
+	const struct nnp_size kernel_size = { .height = record->kernel_size[0], .width = record->kernel_size[1] };
+	const struct nnp_size output_subsampling = { .height = record->stride[0], .width = record->stride[1] };
+	if (!validate_section(&record->kernel, model_size, output_channels * input_channels * kernel_size.height * kernel_size.width * sizeof(float)) ||
+		!validate_section(&record->bias, model_size, output_channels * sizeof(float)) ||
+		!validate_section(&record->transformed_kernel, model_size, SIZE_MAX))
+	{
+		return nnp_status_invalid_file_format;
+	}
+
+	const enum nnp_activation activation = record->activation;
+	union {
+		float negative_slope;
+		struct nnp_clamp_parameters clamp;
+	} activation_parameters;
+	const void* activation_parameters_pointer = NULL;
+	if (record->has_activation_parameters) {
+		if (activation == nnp_activation_clamp) {
+			activation_parameters.clamp.output_min = record->activation_parameters[0];
+			activation_parameters.clamp.output_max = record->activation_parameters[1];
+		} else {
+			activation_parameters.negative_slope = record->activation_parameters[0];
+		}
+		activation_parameters_pointer = &activation_parameters;
+	}
+
+	const float* bias = section_data(model, &record->bias);
+	const struct nnp_size transform_tile = transform_tile_size(record->algorithm);
+	bool reuse = record->transformed_kernel.size != 0 && same_hardware &&
+		transform_tile.height == record->transform_tile[0] && transform_tile.width == record->transform_tile[1];
+	if (reuse) {
+		const void* transformed_kernel = section_data(model, &record->transformed_kernel);
+		enum nnp_status status = nnp_network_add_convolution(network,
+			record->algorithm, nnp_convolution_transform_strategy_reuse,
+			output_channels, input_padding, kernel_size, output_subsampling,
+			transformed_kernel, bias, activation, activation_parameters_pointer);
+		if (status != nnp_status_success) {
+			return status;
+		}
+
+		/*
+		 * Same hardware parameters do not guarantee the same transformed kernel layout, e.g. fp16 storage needs
+		 * processor support. If the layout differs, the layer is replaced with one which transforms the raw kernel.
+		 */
+		size_t transformed_kernel_size = 0;
+		status = query_transformed_kernel_size(network, &network->layers[network->layers_count - 1],
+			transformed_kernel, threadpool, &transformed_kernel_size);
+		if (status != nnp_status_success || transformed_kernel_size != record->transformed_kernel.size) {
+			network->layers_count -= 1;
+			reuse = false;
+		}
+	}
+
+	if (!reuse) {
+		if (record->kernel.size == 0) {
+			return record->transformed_kernel.size != 0 ? nnp_status_unsupported_hardware : nnp_status_invalid_file_format;
+		}
+
+		/* Streamed layers transform the kernel in every run: a precomputed kernel would stay in memory */
+		return nnp_network_add_convolution(network,
+			record->algorithm,
+			record->transform_strategy == nnp_convolution_transform_strategy_compute || model == NULL ?
+				nnp_convolution_transform_strategy_compute : nnp_convolution_transform_strategy_precompute,
+			output_channels, input_padding, kernel_size, output_subsampling,
+			section_data(model, &record->kernel), bias, activation, activation_parameters_pointer);
+	}
+	return nnp_status_success;
+}
+
+/* Checks the header of a model file, and that the layer records lie within the file */
+static bool validate_model_header(const void* model, size_t model_size) {
+	if (model_size < sizeof(struct network_model_header)) {
+		return false;
+	}
+
+	const struct network_model_header* header = model;
+	return memcmp(header->magic, NETWORK_MODEL_MAGIC, sizeof(header->magic)) == 0 &&
+		header->version == NETWORK_MODEL_VERSION &&
+		header->byte_order_mark == NETWORK_MODEL_BYTE_ORDER_MARK &&
+		header->file_size == model_size &&
+		header->layers_count != 0 &&
+		header->layers_count <= (model_size - sizeof(struct network_model_header)) / sizeof(struct network_model_layer);
+}
+
+/* Whether transformed kernels of a model file with a valid header were transformed for this hardware */
+static bool is_model_for_this_hardware(const void* model) {
+	const struct network_model_header* header = model;
+	const struct network_model_key key = model_key();
+	return memcmp(&header->key, &key, sizeof(key)) == 0;
+}
+
+/*
+ * Creates and plans a network which reads kernels and biases from the model file in memory. If streamed is set, only
+ * the header and layer records are in memory, and convolutional and fully connected layers record where to read their
+ * parameters from.
+ */
+static enum nnp_status load_model(
+	const void* model,
+	size_t model_size,
+	bool streamed,
+	size_t batch_size,
+	pthreadpool_t threadpool,
+	nnp_network_t* network_out)
+{
+	if (!validate_model_header(model, model_size)) {
+		return nnp_status_invalid_file_format;
+	}
+
+	const struct network_model_header* header = model;
+	const bool same_hardware = is_model_for_this_hardware(model);
+
+	nnp_network_t network = NULL;
+	const struct nnp_size input_size = { .height = header->input_height, .width = header->input_width };
+	enum nnp_status status = nnp_network_create(batch_size, header->input_channels, input_size, &network);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	const void* sections = streamed ? NULL : model;
+	const struct network_model_layer* records = (const struct network_model_layer*) (header + 1);
+	for (size_t i = 0; i < header->layers_count; i++) {
+		const struct network_model_layer* record = &records[i];
+		switch (record->type) {
+			case network_layer_convolution:
+				status = load_convolution(network, sections, model_size, record, same_hardware, threadpool);
+				break;
+			case network_layer_max_pooling:
+			{
+				const struct nnp_padding input_padding = {
+					.top = record->input_padding[0],
+					.right = record->input_padding[1],
+					.bottom = record->input_padding[2],
+					.left = record->input_padding[3],
+				};
+				const struct nnp_size pooling_size = { .height = record->kernel_size[0], .width = record->kernel_size[1] };
+				const struct nnp_size pooling_stride = { .height = record->stride[0], .width = record->stride[1] };
+				status = nnp_network_add_max_pooling(network, input_padding, pooling_size, pooling_stride);
+				break;
+			}
+			case network_layer_relu:
+				status = nnp_network_add_relu(network, record->activation_parameters[0]);
+				break;
+			case network_layer_fully_connected:
+				if (record->kernel.size == 0 ||
+					!validate_section(&record->kernel, model_size, record->output_channels * layer_output_elements(network) * sizeof(float)))
+				{
+					status = nnp_status_invalid_file_format;
+					break;
+				}
+				status = nnp_network_add_fully_connected(network, record->output_channels, section_data(sections, &record->kernel));
+				break;
+			case network_layer_softmax:
+				status = nnp_network_add_softmax(network);
+				break;
+			default:
+				status = nnp_status_invalid_file_format;
+				break;
+		}
+		if (status != nnp_status_success) {
+			goto cleanup;
+		}
+
+		if (streamed && (record->type == network_layer_convolution || record->type == network_layer_fully_connected)) {
+			struct network_layer* layer = &network->layers[network->layers_count - 1];
+			const struct network_model_section* kernel = &record->kernel;
+			if (layer->type == network_layer_convolution &&
+				layer->convolution.transform_strategy == nnp_convolution_transform_strategy_reuse)
+			{
+				kernel = &record->transformed_kernel;
+			}
+			layer->stream.enabled = true;
+			layer->stream.kernel_offset = kernel->offset;
+			layer->stream.kernel_size = kernel->size;
+			if (layer->type == network_layer_convolution) {
+				layer->stream.bias_offset = record->bias.offset;
+				layer->stream.bias_size = record->bias.size;
+			}
+		}
+	}
+
+	status = nnp_network_plan(network, threadpool);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	*network_out = network;
+	return nnp_status_success;
+
+cleanup:
+	nnp_network_destroy(network);
+	return status;
+}
+
+enum nnp_status nnp_network_load(
+	const char* path,
+	size_t batch_size,
+	pthreadpool_t threadpool,
+	nnp_network_t* network_out)
+{
+	if (network_out == NULL) {
+		return nnp_status_invalid_network;
+	}
+	*network_out = NULL;
+
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+	if (path == NULL) {
+		return nnp_status_io_error;
+	}
+
+	const int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		return nnp_status_io_error;
+	}
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0) {
+		close(fd);
+		return nnp_status_io_error;
+	}
+	const size_t model_size = (size_t) file_stat.st_size;
+	if (model_size < sizeof(struct network_model_header)) {
+		close(fd);
+		return nnp_status_invalid_file_format;
+	}
+
+	/* Read-only private mapping: kernels are paged in from the file when first used, and never copied */
+	void* model = mmap(NULL, model_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (model == MAP_FAILED) {
+		return nnp_status_io_error;
+	}
+
+	nnp_network_t network = NULL;
+	const enum nnp_status status = load_model(model, model_size, false, batch_size, threadpool, &network);
+	if (status != nnp_status_success) {
+		munmap(model, model_size);
+		return status;
+	}
+
+	network->model = model;
+	network->model_size = model_size;
+	*network_out = network;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_load_memory(
+	const void* model,
+	size_t model_size,
+	size_t batch_size,
+	pthreadpool_t threadpool,
+	nnp_network_t* network_out)
+{
+	if (network_out == NULL) {
+		return nnp_status_invalid_network;
+	}
+	*network_out = NULL;
+
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+	if (model == NULL) {
+		return nnp_status_invalid_file_format;
+	}
+	/* Sections are aligned relative to the start of the model */
+	if ((uintptr_t) model % NETWORK_MODEL_SECTION_ALIGNMENT != 0) {
+		return nnp_status_misaligned_buffer;
+	}
+
+	return load_model(model, model_size, false, batch_size, threadpool, network_out);
+}
+
+/*
+ * Assigns indices to streamed layers, allocates the stream buffers, and starts the helper thread. The stream takes
+ * ownership of the file descriptor, and the network of the stream, even on failure.
+ */
+static enum nnp_status create_stream(struct nnp_network* network, int fd) {
+	struct network_stream* stream = calloc(1, sizeof(struct network_stream));
+	if (stream == NULL) {
+		close(fd);
+		return nnp_status_out_of_memory;
+	}
+	stream->fd = fd;
+	if (pthread_mutex_init(&stream->mutex, NULL) != 0) {
+		close(fd);
+		free(stream);
+		return nnp_status_out_of_memory;
+	}
+	if (pthread_cond_init(&stream->cond, NULL) != 0) {
+		pthread_mutex_destroy(&stream->mutex);
+		close(fd);
+		free(stream);
+		return nnp_status_out_of_memory;
+	}
+	for (size_t buffer = 0; buffer < 2; buffer++) {
+		stream->buffer_layer[buffer] = NETWORK_NO_BUFFER;
+		stream->buffer_ready[buffer] = true;
+	}
+	network->stream = stream;
+
+	for (size_t i = 0; i < network->layers_count; i++) {
+		stream->layers_count += network->layers[i].stream.enabled;
+	}
+	if (stream->layers_count == 0) {
+		return nnp_status_success;
+	}
+
+	stream->layers = calloc(stream->layers_count, sizeof(const struct network_layer*));
+	if (stream->layers == NULL) {
+		return nnp_status_out_of_memory;
+	}
+	size_t index = 0;
+	for (size_t i = 0; i < network->layers_count; i++) {
+		struct network_layer* layer = &network->layers[i];
+		if (layer->stream.enabled) {
+			layer->stream.index = index;
+			stream->layers[index] = layer;
+			stream->buffer_size[index % 2] = max(stream->buffer_size[index % 2],
+				round_up(layer->stream.kernel_size, NETWORK_BUFFER_ALIGNMENT) + layer->stream.bias_size);
+			index += 1;
+		}
+	}
+
+	for (size_t buffer = 0; buffer < 2; buffer++) {
+		if (stream->buffer_size[buffer] != 0) {
+			stream->buffers[buffer] = allocate_memory(stream->buffer_size[buffer]);
+			if (stream->buffers[buffer] == NULL) {
+				return nnp_status_out_of_memory;
+			}
+			network->memory.parameters_size += stream->buffer_size[buffer];
+		}
+	}
+
+	if (pthread_create(&stream->thread, NULL, stream_thread_function, stream) != 0) {
+		return nnp_status_out_of_memory;
+	}
+	stream->thread_started = true;
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_network_load_streaming(
+	const char* path,
+	size_t batch_size,
+	pthreadpool_t threadpool,
+	nnp_network_t* network_out)
+{
+	if (network_out == NULL) {
+		return nnp_status_invalid_network;
+	}
+	*network_out = NULL;
+
+	if (!nnp_hwinfo.initialized) {
+		return nnp_status_uninitialized;
+	}
+	if (path == NULL) {
+		return nnp_status_io_error;
+	}
+
+	int fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		return nnp_status_io_error;
+	}
+
+	enum nnp_status status = nnp_status_success;
+	void* records = NULL;
+	nnp_network_t network = NULL;
+
+	/* Block devices report no size: the model file only has to fit in them */
+	struct stat file_stat;
+	if (fstat(fd, &file_stat) != 0) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+	const bool regular_file = S_ISREG(file_stat.st_mode);
+	if (regular_file && (size_t) file_stat.st_size < sizeof(struct network_model_header)) {
+		status = nnp_status_invalid_file_format;
+		goto cleanup;
+	}
+
+	struct network_model_header header;
+	if (!read_stream_section(fd, 0, sizeof(header), &header)) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+	if (!validate_model_header(&header, header.file_size) ||
+		(regular_file && (uint64_t) file_stat.st_size != header.file_size))
+	{
+		status = nnp_status_invalid_file_format;
+		goto cleanup;
+	}
+
+	/* Only the header and layer records are read now; kernels and biases are read in every run */
+	const size_t records_size = sizeof(header) + header.layers_count * sizeof(struct network_model_layer);
+	records = malloc(records_size);
+	if (records == NULL) {
+		status = nnp_status_out_of_memory;
+		goto cleanup;
+	}
+	if (!read_stream_section(fd, 0, records_size, records)) {
+		status = nnp_status_io_error;
+		goto cleanup;
+	}
+
+	status = load_model(records, header.file_size, true, batch_size, threadpool, &network);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	status = create_stream(network, fd);
+	fd = -1;
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	*network_out = network;
+	network = NULL;
+
+cleanup:
+	nnp_network_destroy(network);
+	free(records);
+	if (fd != -1) {
+		close(fd);
+	}
+	return status;
+}
+
+enum nnp_status nnp_network_get_stream_profile(
+	nnp_network_t network,
+	struct nnp_network_stream_profile* profile)
+{
+	if (network == NULL || network->stream == NULL) {
+		return nnp_status_invalid_network;
+	}
+
+	pthread_mutex_lock(&network->stream->mutex);
+	*profile = network->stream->profile;
+	pthread_mutex_unlock(&network->stream->mutex);
+	return nnp_status_success;
+}
+
+enum nnp_status nnp_model_get_layer(
+	const void* model,
+	size_t model_size,
+	size_t index,
+	struct nnp_model_layer* layer)
+{
+	if (model == NULL || !validate_model_header(model, model_size)) {
+		return nnp_status_invalid_file_format;
+	}
+	if ((uintptr_t) model % NETWORK_MODEL_SECTION_ALIGNMENT != 0) {
+		return nnp_status_misaligned_buffer;
+	}
+
+	const struct network_model_header* header = model;
+	if (index >= header->layers_count) {
+		return nnp_status_invalid_network;
+	}
+
+	const struct network_model_layer* record = &((const struct network_model_layer*) (header + 1))[index];
+	if (!validate_section(&record->kernel, model_size, SIZE_MAX) ||
+		!validate_section(&record->bias, model_size, record->output_channels * sizeof(float)) ||
+		!validate_section(&record->transformed_kernel, model_size, SIZE_MAX))
+	{
+		return nnp_status_invalid_file_format;
+	}
+
+	*layer = (struct nnp_model_layer) {
+		.algorithm = record->algorithm,
+		.output_channels = record->output_channels,
+		.input_padding = {
+			.top = record->input_padding[0],
+			.right = record->input_padding[1],
+			.bottom = record->input_padding[2],
+			.left = record->input_padding[3],
+		},
+		.kernel_size = { .height = record->kernel_size[0], .width = record->kernel_size[1] },
+		.stride = { .height = record->stride[0], .width = record->stride[1] },
+		.activation = record->activation,
+		.activation_parameters = record->has_activation_parameters ? record->activation_parameters : NULL,
+		.kernel = section_data(model, &record->kernel),
+		.bias = section_data(model, &record->bias),
+	};
+	switch (record->type) {
+		case network_layer_convolution:
+		{
+			layer->type = nnp_model_layer_convolution;
+			const struct nnp_size transform_tile = transform_tile_size(record->algorithm);
+			if (is_model_for_this_hardware(model) &&
+				transform_tile.height == record->transform_tile[0] && transform_tile.width == record->transform_tile[1])
+			{
+				layer->transformed_kernel = section_data(model, &record->transformed_kernel);
+				layer->transformed_kernel_size = record->transformed_kernel.size;
+			}
+			break;
+		}
+		case network_layer_max_pooling:
+			layer->type = nnp_model_layer_max_pooling;
+			break;
+		case network_layer_relu:
+			layer->type = nnp_model_layer_relu;
+			break;
+		case network_layer_fully_connected:
+			layer->type = nnp_model_layer_fully_connected;
+			break;
+		case network_layer_softmax:
+			layer->type = nnp_model_layer_softmax;
+			break;
+		default:
+			return nnp_status_invalid_file_format;
+	}
+	return nnp_status_success;
+}
+
+#if defined(__ELF__)
+/*
+ * Descriptors of model images linked into the program by src/model-image.S. The linker defines the bounds of the
+ * section only if some object file provides it, so the symbols are weak.
+ */
+extern const struct nnp_model_image __start_nnp_model_images[] __attribute__((__weak__));
+extern const struct nnp_model_image __stop_nnp_model_images[] __attribute__((__weak__));
+#endif
+
+const struct nnp_model_image* nnp_model_image_find(const char* name) {
+#if defined(__ELF__)
+	if (name == NULL || __start_nnp_model_images == NULL) {
+		return NULL;
+	}
+
+	for (const struct nnp_model_image* image = __start_nnp_model_images; image != __stop_nnp_model_images; image++) {
+		if (strcmp(image->name, name) == 0) {
+			return image;
+		}
+	}
+#endif
+	return NULL;
+}
@@ -138,6 +138,54 @@ static void compute_pooling_output(
 		pooling_size.height, pooling_size.width);
 }
 
+struct NNP_CACHE_ALIGN nhwc_pooling_context {
+	const float* input;
+	float* output;
+
+	size_t channels;
+	struct nnp_size input_size;
+	struct nnp_padding input_padding;
+	struct nnp_size output_size;
+	struct nnp_size pooling_size;
+	struct nnp_size pooling_stride;
+};
+
+static void compute_nhwc_max_pooling_output(
+	const struct nhwc_pooling_context context[restrict static 1],
+	size_t sample, size_t y)
+{
+	const size_t channels                  = context->channels;
+	const struct nnp_size input_size       = context->input_size;
+	const struct nnp_padding input_padding = context->input_padding;
+	const struct nnp_size output_size      = context->output_size;
+	const struct nnp_size pooling_size     = context->pooling_size;
+	const struct nnp_size pooling_stride   = context->pooling_stride;
+
+	const float* input = context->input + sample * input_size.height * input_size.width * channels;
+	float* output = context->output + (sample * output_size.height + y) * output_size.width * channels;
+
+	for (size_t x = 0; x < output_size.width; x++) {
+		float* output_pixel = output + x * channels;
+		for (size_t c = 0; c < channels; c++) {
+			output_pixel[c] = -__builtin_inff();
+		}
+		for (size_t i = 0; i < pooling_size.height; i++) {
+			const size_t s = y * pooling_stride.height + i - input_padding.top;
+			if (s < input_size.height) {
+				for (size_t j = 0; j < pooling_size.width; j++) {
+					const size_t t = x * pooling_stride.width + j - input_padding.left;
+					if (t < input_size.width) {
+						const float* input_pixel = input + (s * input_size.width + t) * channels;
+						for (size_t c = 0; c < channels; c++) {
+							output_pixel[c] = maxf(input_pixel[c], output_pixel[c]);
+						}
+					}
+				}
+			}
+		}
+	}
+}
+
 enum nnp_status nnp_max_pooling_output(
 	size_t batch_size,
 	size_t channels,
@@ -187,3 +235,45 @@ enum nnp_status nnp_max_pooling_output(
 
 	return nnp_status_success;
 }
+
+enum nnp_status nnp_max_pooling_output_nhwc(
+	size_t batch_size,
+	size_t channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size pooling_size,
+	struct nnp_size pooling_stride,
+	const float input[],
+	float output[],
+	pthreadpool_t threadpool)
+{
+	enum nnp_status status = validate_pooling_arguments(
+		batch_size, channels,
+		input_size, input_padding,
+		pooling_size, pooling_stride);
+	if (status != nnp_status_success) {
+		return status;
+	}
+
+	const struct nnp_size output_size = {
+		.height = divide_round_up(doz(input_padding.top + input_size.height + input_padding.bottom, pooling_size.height), pooling_stride.height) + 1,
+		.width = divide_round_up(doz(input_padding.left + input_size.width + input_padding.right, pooling_size.width), pooling_stride.width) + 1,
+	};
+
+	struct nhwc_pooling_context nhwc_pooling_context = {
+		.input = input,
+		.output = output,
+		.channels = channels,
+		.input_size = input_size,
+		.input_padding = input_padding,
+		.output_size = output_size,
+		.pooling_size = pooling_size,
+		.pooling_stride = pooling_stride,
+	};
+	pthreadpool_compute_2d(threadpool,
+		(pthreadpool_function_2d_t) compute_nhwc_max_pooling_output,
+		&nhwc_pooling_context,
+		batch_size, output_size.height);
+
+	return nnp_status_success;
+}
@@ -0,0 +1,155 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <psimd.h>
+
+#include <nnpack/activations.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+
+#include <psimd/winograd/f2x2k3x3.h>
+#include <psimd/transpose.h>
+
+
+void nnp_iwt4x4_3x3_with_offset__psimd(
+	const float data[restrict static 1],
+	float transform[restrict static 1],
+	size_t data_stride, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	transform_stride /= sizeof(float);
+
+	NNP_SIMD_ALIGN float block[4][4] = { 0 };
+	for (size_t i = 0; i < row_count; i++) {
+		for (size_t j = 0; j < column_count; j++) {
+			block[row_offset + i][column_offset + j] = data[i * data_stride + j];
+		}
+	}
+
+	psimd_f32 wd[4];
+	winograd_f2k3_input_transform(
+		psimd_load_f32(&block[0][0]),
+		psimd_load_f32(&block[1][0]),
+		psimd_load_f32(&block[2][0]),
+		psimd_load_f32(&block[3][0]),
+		&wd[0], &wd[1], &wd[2], &wd[3]);
+	psimd_transpose4x4_f32(
+		wd[0], wd[1], wd[2], wd[3],
+		&wd[0], &wd[1], &wd[2], &wd[3]);
+	winograd_f2k3_input_transform(
+		wd[0], wd[1], wd[2], wd[3],
+		&wd[0], &wd[1], &wd[2], &wd[3]);
+
+	for (size_t row = 0; row < 4; row++) {
+		psimd_store_f32(transform, wd[row]);
+		transform += transform_stride;
+	}
+}
+
+void nnp_kwt4x4_3x3__psimd(
+	const float g[restrict static 9],
+	float transform[restrict static 1],
+	size_t stride_g, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	transform_stride /= sizeof(float);
+
+	const psimd_f32 g0 = psimd_load_f32(g);
+	const psimd_f32 g1 = psimd_load_f32(g + 3);
+	const psimd_f32 g5678 = psimd_load_f32(g + 5);
+	#ifdef __clang__
+		const psimd_f32 g2 = __builtin_shufflevector(g5678, g5678, 1, 2, 3, -1);
+	#else
+		const psimd_f32 g2 = __builtin_shuffle(g5678, g5678, (psimd_s32) { 1, 2, 3, -1 });
+	#endif
+
+	psimd_f32 w[4];
+	winograd_f2k3_kernel_transform(g0, g1, g2,
+		&w[0], &w[1], &w[2], &w[3]);
+	psimd_transpose4x4_f32(
+		w[0], w[1], w[2], w[3],
+		&w[0], &w[1], &w[2], &w[3]);
+
+	psimd_f32 wg[4];
+	winograd_f2k3_kernel_transform(w[0], w[1], w[2],
+		&wg[0], &wg[1], &wg[2], &wg[3]);
+
+	for (size_t row = 0; row < 4; row++) {
+		psimd_store_f32(transform, wg[row]);
+		transform += transform_stride;
+	}
+}
+
+void nnp_owt4x4_3x3_with_bias__psimd(
+	const float transform[restrict static 1],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	transform_stride /= sizeof(float);
+
+	const psimd_f32 m0 = psimd_load_f32(transform);
+	transform += transform_stride;
+	const psimd_f32 m1 = psimd_load_f32(transform) + (psimd_f32) { 0, *bias, 0, 0 };
+	transform += transform_stride;
+	const psimd_f32 m2 = psimd_load_f32(transform);
+	transform += transform_stride;
+	const psimd_f32 m3 = psimd_load_f32(transform);
+
+	psimd_f32 s[4];
+	winograd_f2k3_output_transform(m0, m1, m2, m3, &s[0], &s[1]);
+	psimd_transpose4x4_f32(
+		s[0], s[1], psimd_zero_f32(), psimd_zero_f32(),
+		&s[0], &s[1], &s[2], &s[3]);
+
+	NNP_SIMD_ALIGN float block[2][4];
+	psimd_f32 t0, t1;
+	winograd_f2k3_output_transform(s[0], s[1], s[2], s[3], &t0, &t1);
+	psimd_store_f32(&block[0][0], t0);
+	psimd_store_f32(&block[1][0], t1);
+
+	for (size_t i = 0; i < row_count; i++) {
+		for (size_t j = 0; j < column_count; j++) {
+			output[i * output_stride + j] = block[i][j];
+		}
+	}
+}
+
+void nnp_owt4x4_3x3_with_bias_with_relu__psimd(
+	const float transform[restrict static 1],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	transform_stride /= sizeof(float);
+
+	const psimd_f32 m0 = psimd_load_f32(transform);
+	transform += transform_stride;
+	const psimd_f32 m1 = psimd_load_f32(transform) + (psimd_f32) { 0, *bias, 0, 0 };
+	transform += transform_stride;
+	const psimd_f32 m2 = psimd_load_f32(transform);
+	transform += transform_stride;
+	const psimd_f32 m3 = psimd_load_f32(transform);
+
+	psimd_f32 s[4];
+	winograd_f2k3_output_transform(m0, m1, m2, m3, &s[0], &s[1]);
+	psimd_transpose4x4_f32(
+		s[0], s[1], psimd_zero_f32(), psimd_zero_f32(),
+		&s[0], &s[1], &s[2], &s[3]);
+
+	NNP_SIMD_ALIGN float block[2][4];
+	psimd_f32 t0, t1;
+	winograd_f2k3_output_transform(s[0], s[1], s[2], s[3], &t0, &t1);
+	psimd_store_f32(&block[0][0], psimd_relu_f32(t0, psimd_zero_f32()));
+	psimd_store_f32(&block[1][0], psimd_relu_f32(t1, psimd_zero_f32()));
+
+	for (size_t i = 0; i < row_count; i++) {
+		for (size_t j = 0; j < column_count; j++) {
+			output[i * output_stride + j] = block[i][j];
+		}
+	}
+}
@@ -0,0 +1,216 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <psimd.h>
+
+#include <nnpack/activations.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+
+#include <psimd/winograd/f4x4k3x3.h>
+#include <psimd/transpose.h>
+
+
+/*
+ * 6x6 transform tiles are stored as 9 tuples of 4 elements:
+ * tuples 0-5 hold columns 0-3 of the 6 rows, and tuples 6-8 hold columns 4-5 of pairs of adjacent rows.
+ */
+
+static inline void store_transform6x6(
+	float transform[restrict static 1],
+	size_t transform_stride,
+	psimd_f32 w[restrict static 6][2])
+{
+	for (size_t row = 0; row < 6; row++) {
+		psimd_store_f32(transform, w[row][0]);
+		transform += transform_stride;
+	}
+	for (size_t row = 0; row < 6; row += 2) {
+		psimd_store_f32(transform, psimd_concat_lo_f32(w[row][1], w[row + 1][1]));
+		transform += transform_stride;
+	}
+}
+
+static inline void load_transform6x6(
+	const float transform[restrict static 1],
+	size_t transform_stride,
+	psimd_f32 m[restrict static 6][2])
+{
+	for (size_t row = 0; row < 6; row++) {
+		m[row][0] = psimd_load_f32(transform);
+		transform += transform_stride;
+	}
+	for (size_t row = 0; row < 6; row += 2) {
+		const psimd_f32 m_pair = psimd_load_f32(transform);
+		m[row][1] = m_pair;
+		m[row + 1][1] = psimd_concat_hi_f32(m_pair, m_pair);
+		transform += transform_stride;
+	}
+}
+
+void nnp_iwt6x6_3x3_with_offset__psimd(
+	const float data[restrict static 1],
+	float transform[restrict static 1],
+	size_t data_stride, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	transform_stride /= sizeof(float);
+
+	NNP_SIMD_ALIGN float block[6][8] = { 0 };
+	for (size_t i = 0; i < row_count; i++) {
+		for (size_t j = 0; j < column_count; j++) {
+			block[row_offset + i][column_offset + j] = data[i * data_stride + j];
+		}
+	}
+
+	psimd_f32 wd[8][2];
+	for (size_t col = 0; col < 2; col++) {
+		winograd_f4k3_input_transform(
+			psimd_load_f32(&block[0][col * 4]),
+			psimd_load_f32(&block[1][col * 4]),
+			psimd_load_f32(&block[2][col * 4]),
+			psimd_load_f32(&block[3][col * 4]),
+			psimd_load_f32(&block[4][col * 4]),
+			psimd_load_f32(&block[5][col * 4]),
+			&wd[0][col], &wd[1][col], &wd[2][col], &wd[3][col], &wd[4][col], &wd[5][col]);
+	}
+
+	/* Transpose: row r of wt holds column r of wd, with rows 0-3 of wd in wt[r][0] and rows 4-5 in wt[r][1] */
+	psimd_f32 wt[8][2];
+	for (size_t col = 0; col < 2; col++) {
+		psimd_transpose4x4_f32(
+			wd[0][col], wd[1][col], wd[2][col], wd[3][col],
+			&wt[col * 4 + 0][0], &wt[col * 4 + 1][0], &wt[col * 4 + 2][0], &wt[col * 4 + 3][0]);
+		psimd_transpose4x4_f32(
+			wd[4][col], wd[5][col], psimd_zero_f32(), psimd_zero_f32(),
+			&wt[col * 4 + 0][1], &wt[col * 4 + 1][1], &wt[col * 4 + 2][1], &wt[col * 4 + 3][1]);
+	}
+
+	for (size_t col = 0; col < 2; col++) {
+		winograd_f4k3_input_transform(
+			wt[0][col], wt[1][col], wt[2][col], wt[3][col], wt[4][col], wt[5][col],
+			&wd[0][col], &wd[1][col], &wd[2][col], &wd[3][col], &wd[4][col], &wd[5][col]);
+	}
+	store_transform6x6(transform, transform_stride, wd);
+}
+
+void nnp_kwt6x6_3x3__psimd(
+	const float g[restrict static 9],
+	float transform[restrict static 1],
+	size_t stride_g, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	transform_stride /= sizeof(float);
+
+	const psimd_f32 g0 = psimd_load_f32(g);
+	const psimd_f32 g1 = psimd_load_f32(g + 3);
+	const psimd_f32 g5678 = psimd_load_f32(g + 5);
+	#ifdef __clang__
+		const psimd_f32 g2 = __builtin_shufflevector(g5678, g5678, 1, 2, 3, -1);
+	#else
+		const psimd_f32 g2 = __builtin_shuffle(g5678, g5678, (psimd_s32) { 1, 2, 3, -1 });
+	#endif
+
+	psimd_f32 w[6];
+	winograd_f4k3_kernel_transform(g0, g1, g2,
+		&w[0], &w[1], &w[2], &w[3], &w[4], &w[5]);
+
+	psimd_f32 wt[4][2];
+	psimd_transpose4x4_f32(
+		w[0], w[1], w[2], w[3],
+		&wt[0][0], &wt[1][0], &wt[2][0], &wt[3][0]);
+	psimd_transpose4x4_f32(
+		w[4], w[5], psimd_zero_f32(), psimd_zero_f32(),
+		&wt[0][1], &wt[1][1], &wt[2][1], &wt[3][1]);
+
+	psimd_f32 wg[6][2];
+	for (size_t col = 0; col < 2; col++) {
+		winograd_f4k3_kernel_transform(wt[0][col], wt[1][col], wt[2][col],
+			&wg[0][col], &wg[1][col], &wg[2][col], &wg[3][col], &wg[4][col], &wg[5][col]);
+	}
+	store_transform6x6(transform, transform_stride, wg);
+}
+
+void nnp_owt6x6_3x3_with_bias__psimd(
+	const float transform[restrict static 1],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	transform_stride /= sizeof(float);
+
+	psimd_f32 m[6][2];
+	load_transform6x6(transform, transform_stride, m);
+	m[1][0] += (psimd_f32) { 0, *bias, 0, 0 };
+
+	psimd_f32 s[4][2];
+	for (size_t col = 0; col < 2; col++) {
+		winograd_f4k3_output_transform(m[0][col], m[1][col], m[2][col], m[3][col], m[4][col], m[5][col],
+			&s[0][col], &s[1][col], &s[2][col], &s[3][col]);
+	}
+
+	psimd_f32 st[8];
+	for (size_t col = 0; col < 2; col++) {
+		psimd_transpose4x4_f32(
+			s[0][col], s[1][col], s[2][col], s[3][col],
+			&st[col * 4 + 0], &st[col * 4 + 1], &st[col * 4 + 2], &st[col * 4 + 3]);
+	}
+
+	NNP_SIMD_ALIGN float block[4][4];
+	psimd_f32 t0, t1, t2, t3;
+	winograd_f4k3_output_transform(st[0], st[1], st[2], st[3], st[4], st[5], &t0, &t1, &t2, &t3);
+	psimd_store_f32(&block[0][0], t0);
+	psimd_store_f32(&block[1][0], t1);
+	psimd_store_f32(&block[2][0], t2);
+	psimd_store_f32(&block[3][0], t3);
+
+	for (size_t i = 0; i < row_count; i++) {
+		for (size_t j = 0; j < column_count; j++) {
+			output[i * output_stride + j] = block[i][j];
+		}
+	}
+}
+
+void nnp_owt6x6_3x3_with_bias_with_relu__psimd(
+	const float transform[restrict static 1],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	transform_stride /= sizeof(float);
+
+	psimd_f32 m[6][2];
+	load_transform6x6(transform, transform_stride, m);
+	m[1][0] += (psimd_f32) { 0, *bias, 0, 0 };
+
+	psimd_f32 s[4][2];
+	for (size_t col = 0; col < 2; col++) {
+		winograd_f4k3_output_transform(m[0][col], m[1][col], m[2][col], m[3][col], m[4][col], m[5][col],
+			&s[0][col], &s[1][col], &s[2][col], &s[3][col]);
+	}
+
+	psimd_f32 st[8];
+	for (size_t col = 0; col < 2; col++) {
+		psimd_transpose4x4_f32(
+			s[0][col], s[1][col], s[2][col], s[3][col],
+			&st[col * 4 + 0], &st[col * 4 + 1], &st[col * 4 + 2], &st[col * 4 + 3]);
+	}
+
+	NNP_SIMD_ALIGN float block[4][4];
+	psimd_f32 t0, t1, t2, t3;
+	winograd_f4k3_output_transform(st[0], st[1], st[2], st[3], st[4], st[5], &t0, &t1, &t2, &t3);
+	psimd_store_f32(&block[0][0], psimd_relu_f32(t0, psimd_zero_f32()));
+	psimd_store_f32(&block[1][0], psimd_relu_f32(t1, psimd_zero_f32()));
+	psimd_store_f32(&block[2][0], psimd_relu_f32(t2, psimd_zero_f32()));
+	psimd_store_f32(&block[3][0], psimd_relu_f32(t3, psimd_zero_f32()));
+
+	for (size_t i = 0; i < row_count; i++) {
+		for (size_t j = 0; j < column_count; j++) {
+			output[i * output_stride + j] = block[i][j];
+		}
+	}
+}
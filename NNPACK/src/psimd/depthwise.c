@@ -0,0 +1,120 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <psimd.h>
+
+#include <nnpack/utils.h>
+#include <nnpack/depthwise.h>
+
+
+static inline float dwconv_pixel_with_padding(
+	const float* input, const float* kernel,
+	size_t input_width, size_t input_x, uint32_t kernel_rows,
+	float bias, const uint32_t kernel_width)
+{
+	float acc = bias;
+	for (uint32_t i = 0; i < kernel_rows; i++) {
+		for (uint32_t j = 0; j < kernel_width; j++) {
+			/* Columns left of the input row wrap around to large values */
+			const size_t t = input_x + j;
+			if (t < input_width) {
+				acc += input[t] * kernel[j];
+			}
+		}
+		input += input_width;
+		kernel += kernel_width;
+	}
+	return acc;
+}
+
+static inline void dwconv_row(
+	const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max,
+	const uint32_t kernel_width, const uint32_t stride)
+{
+	const size_t interior_start = min(divide_round_up(padding_left, stride), output_width);
+	const size_t interior_end = depthwise_interior_end(input_width, padding_left, output_width, kernel_width, stride);
+	/* Strided loads read stride - 1 columns past the footprint of the last output in a vector */
+	const size_t vector_end = depthwise_interior_end(input_width, padding_left, output_width, kernel_width + stride - 1, stride);
+
+	size_t x = 0;
+	for (; x < interior_start; x++) {
+		const float acc = dwconv_pixel_with_padding(input, kernel,
+			input_width, x * stride - padding_left, kernel_rows, bias, kernel_width);
+		output[x] = minf(maxf(acc, output_min), output_max);
+	}
+
+	const psimd_f32 vmin = psimd_splat_f32(output_min);
+	const psimd_f32 vmax = psimd_splat_f32(output_max);
+	for (; x + 4 <= vector_end; x += 4) {
+		const float* input_row = input + (x * stride - padding_left);
+		const float* kernel_row = kernel;
+		psimd_f32 vacc = psimd_splat_f32(bias);
+		for (uint32_t i = 0; i < kernel_rows; i++) {
+			for (uint32_t j = 0; j < kernel_width; j++) {
+				psimd_f32 vi;
+				if (stride == 1) {
+					vi = psimd_load_f32(input_row + j);
+				} else {
+					vi = psimd_concat_even_f32(psimd_load_f32(input_row + j), psimd_load_f32(input_row + j + 4));
+				}
+				vacc += vi * psimd_load_splat_f32(kernel_row + j);
+			}
+			input_row += input_width;
+			kernel_row += kernel_width;
+		}
+		psimd_store_f32(output + x, psimd_min_f32(psimd_max_f32(vacc, vmin), vmax));
+	}
+
+	for (; x < interior_end; x++) {
+		const float* input_row = input + (x * stride - padding_left);
+		const float* kernel_row = kernel;
+		float acc = bias;
+		for (uint32_t i = 0; i < kernel_rows; i++) {
+			for (uint32_t j = 0; j < kernel_width; j++) {
+				acc += input_row[j] * kernel_row[j];
+			}
+			input_row += input_width;
+			kernel_row += kernel_width;
+		}
+		output[x] = minf(maxf(acc, output_min), output_max);
+	}
+	for (; x < output_width; x++) {
+		const float acc = dwconv_pixel_with_padding(input, kernel,
+			input_width, x * stride - padding_left, kernel_rows, bias, kernel_width);
+		output[x] = minf(maxf(acc, output_min), output_max);
+	}
+}
+
+void nnp_dwconv3x3__psimd(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 3, 1);
+}
+
+void nnp_dwconv3x3s2__psimd(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 3, 2);
+}
+
+void nnp_dwconv5x5__psimd(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 5, 1);
+}
+
+void nnp_dwconv5x5s2__psimd(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 5, 2);
+}
@@ -84,7 +84,8 @@ static float sum_exp_minus_c__psimd(size_t n, const float v[restrict static n],
 		n -= 4;
 	}
 	if (n != 0) {
-		sum0 += psimd_exp_f32(psimd_andmask_f32(psimd_load_s32(&mask[4 * (n - 1)]), psimd_load_f32(v + n - 4)) - c);
+		/* Mask after exponentiation: masked lanes would add exp(0 - c) to the sum otherwise */
+		sum0 += psimd_andmask_f32(psimd_load_s32(&mask[4 * (n - 1)]), psimd_exp_f32(psimd_load_f32(v + n - 4) - c));
 	}
 	return psimd_reduce_sum_f32(sum0);
 }
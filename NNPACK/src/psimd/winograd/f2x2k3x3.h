@@ -0,0 +1,56 @@
+#pragma once
+
+#include <psimd.h>
+
+#include <nnpack/macros.h>
+
+
+static NNP_INLINE void winograd_f2k3_input_transform(
+	const psimd_f32 d0, const psimd_f32 d1, const psimd_f32 d2, const psimd_f32 d3,
+	psimd_f32 transform0[restrict static 1],
+	psimd_f32 transform1[restrict static 1],
+	psimd_f32 transform2[restrict static 1],
+	psimd_f32 transform3[restrict static 1])
+{
+	// Compute wd0 := d0 - d2
+	*transform0 = d0 - d2;
+	// Compute wd1 := d1 + d2
+	*transform1 = d1 + d2;
+	// Compute wd2 := d2 - d1
+	*transform2 = d2 - d1;
+	// Compute wd3 := d1 - d3
+	*transform3 = d1 - d3;
+}
+
+static NNP_INLINE void winograd_f2k3_kernel_transform(
+	const psimd_f32 g0, const psimd_f32 g1, const psimd_f32 g2,
+	psimd_f32 transform0[restrict static 1],
+	psimd_f32 transform1[restrict static 1],
+	psimd_f32 transform2[restrict static 1],
+	psimd_f32 transform3[restrict static 1])
+{
+	const psimd_f32 const_half = psimd_splat_f32(0.5f);
+
+	// Compute
+	//   w1 := 0.5 * (g0 + g1 + g2)
+	//   w2 := 0.5 * (g0 - g1 + g2)
+	const psimd_f32 half_g0_add_g2 = const_half * (g0 + g2);
+	const psimd_f32 half_g1 = const_half * g1;
+
+	*transform0 = g0;
+	*transform1 = half_g0_add_g2 + half_g1;
+	*transform2 = half_g0_add_g2 - half_g1;
+	*transform3 = g2;
+}
+
+static NNP_INLINE void winograd_f2k3_output_transform(
+	const psimd_f32 m0, const psimd_f32 m1, const psimd_f32 m2, const psimd_f32 m3,
+	psimd_f32 output0[restrict static 1],
+	psimd_f32 output1[restrict static 1])
+{
+	// Compute
+	//   s0 := m0 + m1 + m2
+	//   s1 := m1 - m2 - m3
+	*output0 = m0 + m1 + m2;
+	*output1 = (m1 - m2) - m3;
+}
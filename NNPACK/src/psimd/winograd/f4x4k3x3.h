@@ -0,0 +1,101 @@
+#pragma once
+
+#include <psimd.h>
+
+#include <nnpack/macros.h>
+
+
+static NNP_INLINE void winograd_f4k3_input_transform(
+	const psimd_f32 d0, const psimd_f32 d1, const psimd_f32 d2, const psimd_f32 d3, const psimd_f32 d4, const psimd_f32 d5,
+	psimd_f32 transform0[restrict static 1],
+	psimd_f32 transform1[restrict static 1],
+	psimd_f32 transform2[restrict static 1],
+	psimd_f32 transform3[restrict static 1],
+	psimd_f32 transform4[restrict static 1],
+	psimd_f32 transform5[restrict static 1])
+{
+	const psimd_f32 const_2 = psimd_splat_f32(2.0f);
+	const psimd_f32 const_4 = psimd_splat_f32(4.0f);
+
+	const psimd_f32 d4_sub_d2 = d4 - d2;
+	const psimd_f32 d3_sub_d1 = d3 - d1;
+
+	// Compute
+	//   wd0 := 4 * d0 - 5 * d2 + d4
+	//   wd5 := 4 * d1 - 5 * d3 + d5
+	const psimd_f32 wd0 = const_4 * (d0 - d2) + d4_sub_d2;
+	const psimd_f32 wd5 = const_4 * (d1 - d3) + (d5 - d3);
+
+	// Compute
+	//   wd1 := (d4 - 4 * d2) + (d3 - 4 * d1)
+	//   wd2 := (d4 - 4 * d2) - (d3 - 4 * d1)
+	const psimd_f32 d4_sub_4d2 = d4 - const_4 * d2;
+	const psimd_f32 d3_sub_4d1 = d3 - const_4 * d1;
+
+	// Compute
+	//   wd3 := (d4 - d2) + 2 * (d3 - d1)
+	//   wd4 := (d4 - d2) - 2 * (d3 - d1)
+	const psimd_f32 d3_sub_d1_times_2 = const_2 * d3_sub_d1;
+
+	*transform0 = wd0;
+	*transform1 = d4_sub_4d2 + d3_sub_4d1;
+	*transform2 = d4_sub_4d2 - d3_sub_4d1;
+	*transform3 = d4_sub_d2 + d3_sub_d1_times_2;
+	*transform4 = d4_sub_d2 - d3_sub_d1_times_2;
+	*transform5 = wd5;
+}
+
+static NNP_INLINE void winograd_f4k3_kernel_transform(
+	const psimd_f32 g0, const psimd_f32 g1, const psimd_f32 g2,
+	psimd_f32 transform0[restrict static 1],
+	psimd_f32 transform1[restrict static 1],
+	psimd_f32 transform2[restrict static 1],
+	psimd_f32 transform3[restrict static 1],
+	psimd_f32 transform4[restrict static 1],
+	psimd_f32 transform5[restrict static 1])
+{
+	const psimd_f32 const_1_6 = psimd_splat_f32(0x1.555556p-3f);
+
+	// Compute
+	//   w1 := -(g0 + g1 + g2) / 6
+	//   w2 := -(g0 - g1 + g2) / 6
+	const psimd_f32 g0_add_g2 = g0 + g2;
+	const psimd_f32 w1 = (g0_add_g2 + g1) * -const_1_6;
+	const psimd_f32 w2 = (g0_add_g2 - g1) * -const_1_6;
+
+	// Compute
+	//   w3 := g0 / 24 + g1 / 12 + g2 / 6
+	//   w4 := g0 / 24 - g1 / 12 + g2 / 6
+	const psimd_f32 g0_div_24_add_g2_div_6 = psimd_splat_f32(0x1.555556p-5f) * g0 + const_1_6 * g2;
+	const psimd_f32 g1_div_12 = psimd_splat_f32(0x1.555556p-4f) * g1;
+
+	*transform0 = psimd_splat_f32(0.25f) * g0;
+	*transform1 = w1;
+	*transform2 = w2;
+	*transform3 = g0_div_24_add_g2_div_6 + g1_div_12;
+	*transform4 = g0_div_24_add_g2_div_6 - g1_div_12;
+	*transform5 = g2;
+}
+
+static NNP_INLINE void winograd_f4k3_output_transform(
+	const psimd_f32 m0, const psimd_f32 m1, const psimd_f32 m2, const psimd_f32 m3, const psimd_f32 m4, const psimd_f32 m5,
+	psimd_f32 output0[restrict static 1],
+	psimd_f32 output1[restrict static 1],
+	psimd_f32 output2[restrict static 1],
+	psimd_f32 output3[restrict static 1])
+{
+	const psimd_f32 m1_add_m2 = m1 + m2;
+	const psimd_f32 m1_sub_m2 = m1 - m2;
+	const psimd_f32 m3_add_m4 = m3 + m4;
+	const psimd_f32 m3_sub_m4 = m3 - m4;
+
+	// Compute
+	//   s0 := m0 + (m1 + m2) + (m3 + m4)
+	//   s1 := (m1 - m2) + 2 * (m3 - m4)
+	//   s2 := (m1 + m2) + 4 * (m3 + m4)
+	//   s3 := (m1 - m2) + 8 * (m3 - m4) + m5
+	*output0 = m0 + m1_add_m2 + m3_add_m4;
+	*output1 = m1_sub_m2 + psimd_splat_f32(2.0f) * m3_sub_m4;
+	*output2 = m1_add_m2 + psimd_splat_f32(4.0f) * m3_add_m4;
+	*output3 = m1_sub_m2 + psimd_splat_f32(8.0f) * m3_sub_m4 + m5;
+}
@@ -0,0 +1,518 @@
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <math.h>
+
+#include <fxdiv.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/workspace.h>
+
+#include <nnpack/hwinfo.h>
+#include <nnpack/blocking.h>
+#include <nnpack/validation.h>
+
+/*
+ * Quantized convolution is an implicit GEMM of int8 kernel rows and uint8 input columns, with the cache blocking of the
+ * FP32 GEMM engine. The q8gemm micro-kernels consume the reduction in pairs, so every reduction block of the packed
+ * kernel and input is padded to an even size, and the kernel is padded with zeros.
+ *
+ * With input zero point z, the convolution of the real input is sum((x - z) * w) = sum(x * w) - z * sum(w), and
+ * implicit padding is packed as z. The micro-kernels accumulate sum(x * w) in int32, and z * sum(w) is folded into
+ * the bias when the kernel is packed.
+ */
+
+struct NNP_CACHE_ALIGN q8_kernel_packing_context {
+	const int8_t* kernel;
+	const int32_t* bias;
+	int8_t* packed_kernel;
+	int32_t* packed_bias;
+
+	int32_t input_zero_point;
+	size_t output_channels;
+	size_t output_channels_range;
+	size_t output_channels_subblock_max;
+	size_t reduction_size;
+	size_t reduction_block_max;
+};
+
+static void compute_q8_kernel_packing(
+	const struct q8_kernel_packing_context context[restrict static 1],
+	size_t output_channels_subblock)
+{
+	const size_t output_channels              = context->output_channels;
+	const size_t output_channels_range        = context->output_channels_range;
+	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
+	const size_t reduction_size               = context->reduction_size;
+	const size_t reduction_block_max          = context->reduction_block_max;
+
+	const size_t output_channels_subblock_start = output_channels_subblock * output_channels_subblock_max;
+	const size_t output_channels_subblock_size =
+		min(output_channels - output_channels_subblock_start, output_channels_subblock_max);
+	const int8_t* kernel = context->kernel + output_channels_subblock_start * reduction_size;
+
+	/* Each reduction block is a [reduction pairs][output channels][2] panel of all output channels */
+	for (size_t reduction_block_start = 0; reduction_block_start < reduction_size; reduction_block_start += reduction_block_max) {
+		const size_t reduction_block_size = min(reduction_size - reduction_block_start, reduction_block_max);
+		const size_t reduction_block_stride = round_up(reduction_block_size, 2);
+		int8_t* packed_kernel = context->packed_kernel + reduction_block_start * output_channels_range +
+			output_channels_subblock_start * reduction_block_stride;
+
+		for (size_t reduction_block_offset = 0; reduction_block_offset < reduction_block_stride; reduction_block_offset += 1) {
+			const size_t reduction_index = reduction_block_start + reduction_block_offset;
+			int8_t* packed_pair = packed_kernel +
+				(reduction_block_offset / 2) * output_channels_subblock_max * 2 + reduction_block_offset % 2;
+			for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_max; output_channels_subblock_offset += 1) {
+				int8_t value = 0;
+				if (output_channels_subblock_offset < output_channels_subblock_size && reduction_index < reduction_size) {
+					value = kernel[output_channels_subblock_offset * reduction_size + reduction_index];
+				}
+				packed_pair[output_channels_subblock_offset * 2] = value;
+			}
+		}
+	}
+
+	for (size_t output_channels_subblock_offset = 0; output_channels_subblock_offset < output_channels_subblock_size; output_channels_subblock_offset += 1) {
+		const size_t output_channel = output_channels_subblock_start + output_channels_subblock_offset;
+		int32_t kernel_sum = 0;
+		for (size_t reduction_index = 0; reduction_index < reduction_size; reduction_index += 1) {
+			kernel_sum += (int32_t) kernel[output_channels_subblock_offset * reduction_size + reduction_index];
+		}
+		context->packed_bias[output_channel] = context->bias[output_channel] - context->input_zero_point * kernel_sum;
+	}
+}
+
+struct NNP_CACHE_ALIGN q8_input_packing_context {
+	const uint8_t* input;
+	uint8_t* packed_input;
+
+	uint8_t input_zero_point;
+	size_t reduction_block_start;
+	size_t reduction_block_size;
+	size_t output_image_block_start;
+	size_t output_image_block_size;
+	size_t output_image_subblock_max;
+	struct nnp_size input_size;
+	size_t input_padding_top;
+	size_t input_padding_left;
+	struct fxdiv_divisor_size_t kernel_elements;
+	struct fxdiv_divisor_size_t kernel_width;
+	size_t kernel_height;
+	struct fxdiv_divisor_size_t output_width;
+	struct nnp_size output_subsampling;
+};
+
+static void compute_q8_input_packing(
+	const struct q8_input_packing_context context[restrict static 1],
+	size_t output_image_subblock)
+{
+	const uint8_t input_zero_point                    = context->input_zero_point;
+	const size_t reduction_block_start                = context->reduction_block_start;
+	const size_t reduction_block_size                 = context->reduction_block_size;
+	const size_t output_image_subblock_max            = context->output_image_subblock_max;
+	const struct nnp_size input_size                  = context->input_size;
+	const size_t input_padding_top                    = context->input_padding_top;
+	const size_t input_padding_left                   = context->input_padding_left;
+	const size_t kernel_width                         = context->kernel_width.value;
+	const size_t kernel_height                        = context->kernel_height;
+	const struct fxdiv_divisor_size_t output_width    = context->output_width;
+	const struct nnp_size output_subsampling          = context->output_subsampling;
+
+	const size_t reduction_block_stride = round_up(reduction_block_size, 2);
+	const size_t output_image_subblock_start = output_image_subblock * output_image_subblock_max;
+	const size_t output_image_subblock_size =
+		min(context->output_image_block_size - output_image_subblock_start, output_image_subblock_max);
+	uint8_t* packed_input = context->packed_input + output_image_subblock_start * reduction_block_stride;
+
+	/* The reduction index of the block start is decomposed once, and then advanced incrementally */
+	const struct fxdiv_result_size_t reduction_index_divmod =
+		fxdiv_divide_size_t(reduction_block_start, context->kernel_elements);
+	const struct fxdiv_result_size_t kernel_xy =
+		fxdiv_divide_size_t(reduction_index_divmod.remainder, context->kernel_width);
+
+	const struct fxdiv_result_size_t output_xy =
+		fxdiv_divide_size_t(context->output_image_block_start + output_image_subblock_start, output_width);
+	size_t output_y = output_xy.quotient;
+	size_t output_x = output_xy.remainder;
+	for (size_t output_image_subblock_offset = 0; output_image_subblock_offset < output_image_subblock_max; output_image_subblock_offset += 1) {
+		uint8_t* packed_column = packed_input + output_image_subblock_offset * 2;
+		if (output_image_subblock_offset >= output_image_subblock_size) {
+			/* Columns past the end of the image are computed, but never stored */
+			for (size_t reduction_block_offset = 0; reduction_block_offset < reduction_block_stride; reduction_block_offset += 1) {
+				packed_column[(reduction_block_offset / 2) * output_image_subblock_max * 2 + reduction_block_offset % 2] = 0;
+			}
+			continue;
+		}
+
+		size_t input_channel = reduction_index_divmod.quotient;
+		size_t kernel_y = kernel_xy.quotient;
+		size_t kernel_x = kernel_xy.remainder;
+		for (size_t reduction_block_offset = 0; reduction_block_offset < reduction_block_size; reduction_block_offset += 1) {
+			const size_t input_y = output_y * output_subsampling.height + kernel_y - input_padding_top;
+			const size_t input_x = output_x * output_subsampling.width  + kernel_x - input_padding_left;
+
+			uint8_t value = input_zero_point;
+			if ((input_x < input_size.width) && (input_y < input_size.height)) {
+				value = context->input[(input_channel * input_size.height + input_y) * input_size.width + input_x];
+			}
+			packed_column[(reduction_block_offset / 2) * output_image_subblock_max * 2 + reduction_block_offset % 2] = value;
+
+			if (++kernel_x == kernel_width) {
+				kernel_x = 0;
+				if (++kernel_y == kernel_height) {
+					kernel_y = 0;
+					input_channel += 1;
+				}
+			}
+		}
+		if (reduction_block_size % 2 != 0) {
+			/* Pairs with the zero padding of the kernel */
+			packed_column[(reduction_block_size / 2) * output_image_subblock_max * 2 + 1] = 0;
+		}
+
+		if (++output_x == output_width.value) {
+			output_x = 0;
+			output_y += 1;
+		}
+	}
+}
+
+/*
+ * Input packing for 1x1 kernels: every reduction index is an input channel, and there is no padding, so the packed
+ * input interleaves pairs of input channels at the (possibly subsampled) pixels of the subblock.
+ */
+static void compute_q8_pointwise_input_packing(
+	const struct q8_input_packing_context context[restrict static 1],
+	size_t output_image_subblock)
+{
+	const size_t reduction_block_start                = context->reduction_block_start;
+	const size_t reduction_block_size                 = context->reduction_block_size;
+	const size_t output_image_subblock_max            = context->output_image_subblock_max;
+	const struct nnp_size input_size                  = context->input_size;
+	const struct fxdiv_divisor_size_t output_width    = context->output_width;
+	const struct nnp_size output_subsampling          = context->output_subsampling;
+
+	const size_t input_image_size = input_size.height * input_size.width;
+	const size_t reduction_block_stride = round_up(reduction_block_size, 2);
+	const size_t output_image_subblock_start = output_image_subblock * output_image_subblock_max;
+	const size_t output_image_subblock_size =
+		min(context->output_image_block_size - output_image_subblock_start, output_image_subblock_max);
+	const uint8_t* input = context->input + reduction_block_start * input_image_size;
+	uint8_t* packed_input = context->packed_input + output_image_subblock_start * reduction_block_stride;
+
+	const struct fxdiv_result_size_t output_xy =
+		fxdiv_divide_size_t(context->output_image_block_start + output_image_subblock_start, output_width);
+	size_t output_y = output_xy.quotient;
+	size_t output_x = output_xy.remainder;
+	for (size_t output_image_subblock_offset = 0; output_image_subblock_offset < output_image_subblock_max; output_image_subblock_offset += 1) {
+		uint8_t* packed_column = packed_input + output_image_subblock_offset * 2;
+		const size_t input_offset = output_y * output_subsampling.height * input_size.width + output_x * output_subsampling.width;
+		const bool valid = output_image_subblock_offset < output_image_subblock_size;
+		for (size_t reduction_block_offset = 0; reduction_block_offset < reduction_block_stride; reduction_block_offset += 1) {
+			uint8_t value = 0;
+			if (valid && reduction_block_offset < reduction_block_size) {
+				value = input[reduction_block_offset * input_image_size + input_offset];
+			}
+			packed_column[(reduction_block_offset / 2) * output_image_subblock_max * 2 + reduction_block_offset % 2] = value;
+		}
+
+		if (valid && ++output_x == output_width.value) {
+			output_x = 0;
+			output_y += 1;
+		}
+	}
+}
+
+struct NNP_CACHE_ALIGN q8_matrix_multiplication_context {
+	const int8_t* packed_kernel;
+	const uint8_t* packed_input;
+	const int32_t* packed_bias;
+	int32_t* accumulators;
+	uint8_t* output;
+	const float* requantization_scales;
+
+	int32_t output_zero_point;
+	int32_t output_min;
+	int32_t output_max;
+	size_t reduction_size;
+	size_t reduction_block_start;
+	size_t reduction_block_size;
+	size_t output_image_size;
+	size_t output_image_block_start;
+	size_t output_image_subblock_max;
+	size_t output_channels_subblock_max;
+	size_t accumulators_row_stride;
+};
+
+static void compute_q8_matrix_multiplication(
+	const struct q8_matrix_multiplication_context context[restrict static 1],
+	size_t output_channels_block_start, size_t output_image_subblock_start,
+	size_t output_channels_block_size,  size_t output_image_subblock_size)
+{
+	const size_t reduction_block_start        = context->reduction_block_start;
+	const size_t reduction_block_size         = context->reduction_block_size;
+	const size_t output_image_size            = context->output_image_size;
+	const size_t output_image_block_start     = context->output_image_block_start;
+	const size_t output_image_subblock_max    = context->output_image_subblock_max;
+	const size_t output_channels_subblock_max = context->output_channels_subblock_max;
+	const size_t accumulators_row_stride      = context->accumulators_row_stride;
+
+	const size_t reduction_block_stride = round_up(reduction_block_size, 2);
+	const int8_t* packed_kernel = context->packed_kernel + output_channels_block_start * reduction_block_stride;
+	const uint8_t* packed_input = context->packed_input + output_image_subblock_start * reduction_block_stride;
+	int32_t* accumulators_block = context->accumulators +
+		output_channels_block_start * accumulators_row_stride + output_image_subblock_start;
+	int32_t* accumulators = accumulators_block;
+
+	/* The first reduction block overwrites the accumulators, and the following ones add to them */
+	const size_t update = reduction_block_start != 0;
+	const size_t reduction_pairs = reduction_block_stride / 2;
+	for (size_t output_channels_block_offset = 0; output_channels_block_offset < output_channels_block_size; output_channels_block_offset += output_channels_subblock_max) {
+		const size_t output_channels_subblock_size =
+			min(output_channels_block_size - output_channels_block_offset, output_channels_subblock_max);
+		if (output_channels_subblock_size == output_channels_subblock_max && output_image_subblock_size == output_image_subblock_max) {
+			nnp_hwinfo.q8gemm.only_mr_x_nr(
+				reduction_pairs, update,
+				packed_kernel, packed_input, accumulators,
+				accumulators_row_stride);
+		} else {
+			nnp_hwinfo.q8gemm.upto_mr_x_nr(
+				output_channels_subblock_size, output_image_subblock_size,
+				reduction_pairs, update,
+				packed_kernel, packed_input, accumulators,
+				accumulators_row_stride);
+		}
+
+		packed_kernel += reduction_block_stride  * output_channels_subblock_max;
+		accumulators  += accumulators_row_stride * output_channels_subblock_max;
+	}
+
+	/* The last reduction block requantizes the accumulators while they are still in cache */
+	if (reduction_block_start + reduction_block_size == context->reduction_size) {
+		const float output_min = (float) (context->output_min - context->output_zero_point);
+		const float output_max = (float) (context->output_max - context->output_zero_point);
+		for (size_t output_channels_block_offset = 0; output_channels_block_offset < output_channels_block_size; output_channels_block_offset += 1) {
+			const size_t output_channel = output_channels_block_start + output_channels_block_offset;
+			const int32_t bias = context->packed_bias[output_channel];
+			const float scale = context->requantization_scales[output_channel];
+			const int32_t* accumulators_row = accumulators_block + output_channels_block_offset * accumulators_row_stride;
+			uint8_t* output = context->output +
+				output_channel * output_image_size + output_image_block_start + output_image_subblock_start;
+			for (size_t index = 0; index < output_image_subblock_size; index += 1) {
+				const float scaled = (float) (accumulators_row[index] + bias) * scale;
+				output[index] = (uint8_t) (lrintf(minf(maxf(scaled, output_min), output_max)) + context->output_zero_point);
+			}
+		}
+	}
+}
+
+enum nnp_status nnp_convolution_inference_q8(
+	enum nnp_convolution_algorithm algorithm,
+	size_t batch_size,
+	size_t input_channels,
+	size_t output_channels,
+	struct nnp_size input_size,
+	struct nnp_padding input_padding,
+	struct nnp_size kernel_size,
+	struct nnp_size output_subsampling,
+	const uint8_t* input,
+	const int8_t* kernel,
+	const int32_t* bias,
+	uint8_t* output,
+	const struct nnp_q8_convolution_parameters* quantization,
+	void* workspace_buffer,
+	size_t* workspace_size,
+	pthreadpool_t threadpool,
+	struct nnp_profile* profile)
+{
+	NNP_TOTAL_START(profile)
+
+	void* memory_block = NULL;
+	size_t memory_size = 0;
+
+	/* Basic validation of parameters. This check detects invalid, but not unsupported parameters. */
+	enum nnp_status status = validate_convolution_arguments(
+		batch_size, input_channels, output_channels,
+		input_size, input_padding, kernel_size, output_subsampling,
+		nnp_activation_identity, NULL);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	status = validate_q8_convolution_quantization(output_channels, quantization);
+	if (status != nnp_status_success) {
+		goto cleanup;
+	}
+
+	/* Padding is smaller than the kernel, so 1x1 kernels are never padded */
+	const bool pointwise = kernel_size.height * kernel_size.width == 1;
+	switch (algorithm) {
+		case nnp_convolution_algorithm_auto:
+		case nnp_convolution_algorithm_implicit_gemm:
+			break;
+		case nnp_convolution_algorithm_direct:
+			if (!pointwise) {
+				status = nnp_status_unsupported_algorithm;
+				goto cleanup;
+			}
+			break;
+		case nnp_convolution_algorithm_ft8x8:
+		case nnp_convolution_algorithm_ft16x16:
+		case nnp_convolution_algorithm_wt8x8:
+		case nnp_convolution_algorithm_wt8x8_fp16:
+		case nnp_convolution_algorithm_wt4x4:
+		case nnp_convolution_algorithm_wt6x6:
+			status = nnp_status_unsupported_algorithm;
+			goto cleanup;
+		default:
+			status = nnp_status_invalid_algorithm;
+			goto cleanup;
+	}
+
+	const struct nnp_size output_size = {
+		.width = (input_padding.left + input_size.width + input_padding.right - kernel_size.width) / output_subsampling.width + 1,
+		.height = (input_padding.top + input_size.height + input_padding.bottom - kernel_size.height) / output_subsampling.height + 1
+	};
+	const size_t input_image_size = input_size.height * input_size.width;
+	const size_t output_image_size = output_size.height * output_size.width;
+	const size_t reduction_size = input_channels * kernel_size.height * kernel_size.width;
+
+	const struct gemm_blocking blocking = gemm_blocking(nnp_hwinfo.q8gemm.mr, nnp_hwinfo.q8gemm.nr, sizeof(uint8_t));
+	const size_t output_channels_subblock_max = blocking.output_channels_subblock_max;
+	const size_t output_image_subblock_max = blocking.output_image_subblock_max;
+	const size_t reduction_block_max = blocking.reduction_block_max;
+	const size_t output_channels_block_max = blocking.output_channels_block_max;
+	const size_t output_image_block_max = min(blocking.output_image_block_max, output_image_size);
+
+	/*
+	 * The packed kernel holds all reduction blocks, so it is packed once and reused for every image. Partial sums of
+	 * an image block stay in int32 accumulators until the last reduction block requantizes them.
+	 */
+	const size_t output_channels_range = round_up(output_channels, output_channels_subblock_max);
+	const size_t packed_kernel_size = round_up(output_channels_range * round_up(reduction_size, 2) * sizeof(int8_t), 64);
+	const size_t packed_bias_size = round_up(output_channels * sizeof(int32_t), 64);
+	const size_t packed_input_size = round_up(round_up(output_image_block_max, output_image_subblock_max) *
+		round_up(min(reduction_block_max, reduction_size), 2) * sizeof(uint8_t), 64);
+	const size_t accumulators_size = output_channels * output_image_block_max * sizeof(int32_t);
+	memory_size = packed_kernel_size + packed_bias_size + packed_input_size + accumulators_size;
+
+	if (workspace_buffer == NULL) {
+		if (workspace_size == NULL) {
+			memory_block = nnp_workspace_acquire_block(memory_size);
+			if (memory_block == NULL) {
+				status = nnp_status_out_of_memory;
+				goto cleanup;
+			}
+		} else {
+			*workspace_size = memory_size;
+			goto cleanup;
+		}
+	} else {
+		if (*workspace_size < memory_size) {
+			status = nnp_status_insufficient_buffer;
+			goto cleanup;
+		}
+		memory_block = workspace_buffer;
+	}
+
+	int8_t* packed_kernel = memory_block;
+	int32_t* packed_bias = memory_block + packed_kernel_size;
+	uint8_t* packed_input = memory_block + packed_kernel_size + packed_bias_size;
+	int32_t* accumulators = memory_block + packed_kernel_size + packed_bias_size + packed_input_size;
+
+	NNP_KERNEL_TRANSFORM_START(profile)
+	struct q8_kernel_packing_context kernel_packing_context = {
+		.kernel = kernel,
+		.bias = bias,
+		.packed_kernel = packed_kernel,
+		.packed_bias = packed_bias,
+		.input_zero_point = (int32_t) quantization->input_zero_point,
+		.output_channels = output_channels,
+		.output_channels_range = output_channels_range,
+		.output_channels_subblock_max = output_channels_subblock_max,
+		.reduction_size = reduction_size,
+		.reduction_block_max = reduction_block_max,
+	};
+	pthreadpool_compute_1d(threadpool,
+		(pthreadpool_function_1d_t) compute_q8_kernel_packing,
+		&kernel_packing_context,
+		output_channels_range / output_channels_subblock_max);
+	NNP_KERNEL_TRANSFORM_END(profile)
+
+	const struct fxdiv_divisor_size_t kernel_elements_divisor = fxdiv_init_size_t(kernel_size.height * kernel_size.width);
+	const struct fxdiv_divisor_size_t kernel_width_divisor = fxdiv_init_size_t(kernel_size.width);
+	const struct fxdiv_divisor_size_t output_width_divisor = fxdiv_init_size_t(output_size.width);
+	for (size_t sample = 0; sample < batch_size; sample += 1) {
+		for (size_t output_image_block_start = 0; output_image_block_start < output_image_size; output_image_block_start += output_image_block_max) {
+			const size_t output_image_block_size = min(output_image_size - output_image_block_start, output_image_block_max);
+
+			for (size_t reduction_block_start = 0; reduction_block_start < reduction_size; reduction_block_start += reduction_block_max) {
+				const size_t reduction_block_size = min(reduction_size - reduction_block_start, reduction_block_max);
+
+				/* Pack image into L3 block */
+				NNP_INPUT_TRANSFORM_START(profile)
+				struct q8_input_packing_context input_packing_context = {
+					.input = input + sample * input_channels * input_image_size,
+					.packed_input = packed_input,
+					.input_zero_point = quantization->input_zero_point,
+					.reduction_block_start = reduction_block_start,
+					.reduction_block_size = reduction_block_size,
+					.output_image_block_start = output_image_block_start,
+					.output_image_block_size = output_image_block_size,
+					.output_image_subblock_max = output_image_subblock_max,
+					.input_size = input_size,
+					.input_padding_top = input_padding.top,
+					.input_padding_left = input_padding.left,
+					.kernel_elements = kernel_elements_divisor,
+					.kernel_width = kernel_width_divisor,
+					.kernel_height = kernel_size.height,
+					.output_width = output_width_divisor,
+					.output_subsampling = output_subsampling,
+				};
+				pthreadpool_compute_1d(threadpool,
+					(pthreadpool_function_1d_t)
+						(pointwise ? compute_q8_pointwise_input_packing : compute_q8_input_packing),
+					&input_packing_context,
+					divide_round_up(output_image_block_size, output_image_subblock_max));
+				NNP_INPUT_TRANSFORM_END(profile)
+
+				NNP_BLOCK_MULTIPLICATION_START(profile)
+				struct q8_matrix_multiplication_context matrix_multiplication_context = {
+					.packed_kernel = packed_kernel + reduction_block_start * output_channels_range,
+					.packed_input = packed_input,
+					.packed_bias = packed_bias,
+					.accumulators = accumulators,
+					.output = output + sample * output_channels * output_image_size,
+					.requantization_scales = quantization->requantization_scales,
+					.output_zero_point = (int32_t) quantization->output_zero_point,
+					.output_min = (int32_t) quantization->output_min,
+					.output_max = (int32_t) quantization->output_max,
+					.reduction_size = reduction_size,
+					.reduction_block_start = reduction_block_start,
+					.reduction_block_size = reduction_block_size,
+					.output_image_size = output_image_size,
+					.output_image_block_start = output_image_block_start,
+					.output_image_subblock_max = output_image_subblock_max,
+					.output_channels_subblock_max = output_channels_subblock_max,
+					.accumulators_row_stride = output_image_block_max,
+				};
+				pthreadpool_compute_2d_tiled(threadpool,
+					(pthreadpool_function_2d_tiled_t) compute_q8_matrix_multiplication,
+					&matrix_multiplication_context,
+					output_channels,           output_image_block_size,
+					output_channels_block_max, output_image_subblock_max);
+				NNP_BLOCK_MULTIPLICATION_END(profile)
+			}
+		}
+	}
+
+cleanup:
+	if (memory_block != workspace_buffer) {
+		nnp_workspace_release_block(memory_block, memory_size);
+	}
+	NNP_TOTAL_END(profile)
+	return status;
+}
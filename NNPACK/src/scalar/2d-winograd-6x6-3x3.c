@@ -0,0 +1,182 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <nnpack/macros.h>
+#include <nnpack/activations.h>
+
+#include <scalar/winograd/f4x4k3x3.h>
+
+
+#define BLOCK_SIZE 6
+#define KERNEL_SIZE 3
+#define OUTPUT_SIZE (BLOCK_SIZE - KERNEL_SIZE + 1)
+
+
+void nnp_iwt6x6_3x3_with_offset__scalar(
+	const float data[restrict static 1],
+	float transform[restrict static 1],
+	size_t data_stride, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	transform_stride /= sizeof(float);
+
+	float block[BLOCK_SIZE][BLOCK_SIZE] = { { 0.0f } };
+	for (uint32_t row = 0; row < row_count; row++) {
+		for (uint32_t column = 0; column < column_count; column++) {
+			block[row_offset + row][column_offset + column] = data[row * data_stride + column];
+		}
+	}
+
+	for (uint32_t row = 0; row < BLOCK_SIZE; row++) {
+		winograd_f4k3_input_transform(
+			block[row][0], block[row][1], block[row][2], block[row][3], block[row][4], block[row][5],
+			&block[row][0], &block[row][1], &block[row][2], &block[row][3], &block[row][4], &block[row][5]);
+	}
+
+	for (uint32_t column = 0; column < BLOCK_SIZE; column++) {
+		float wd0, wd1, wd2, wd3, wd4, wd5;
+		winograd_f4k3_input_transform(
+			block[0][column], block[1][column], block[2][column], block[3][column], block[4][column], block[5][column],
+			&wd0, &wd1, &wd2, &wd3, &wd4, &wd5);
+		*transform = wd0;
+		transform += transform_stride;
+		*transform = wd1;
+		transform += transform_stride;
+		*transform = wd2;
+		transform += transform_stride;
+		*transform = wd3;
+		transform += transform_stride;
+		*transform = wd4;
+		transform += transform_stride;
+		*transform = wd5;
+		transform += transform_stride;
+	}
+}
+
+void nnp_kwt6x6_3x3__scalar(
+	const float g[restrict static 9],
+	float transform[restrict static 1],
+	size_t stride_g, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	transform_stride /= sizeof(float);
+
+	float block[KERNEL_SIZE][BLOCK_SIZE];
+	for (uint32_t row = 0; row < KERNEL_SIZE; row++) {
+		winograd_f4k3_kernel_transform(
+			g[0], g[1], g[2],
+			&block[row][0], &block[row][1], &block[row][2], &block[row][3], &block[row][4], &block[row][5]);
+		g += KERNEL_SIZE;
+	}
+
+	for (uint32_t column = 0; column < BLOCK_SIZE; column++) {
+		float w0, w1, w2, w3, w4, w5;
+		winograd_f4k3_kernel_transform(
+			block[0][column], block[1][column], block[2][column],
+			&w0, &w1, &w2, &w3, &w4, &w5);
+		*transform = w0;
+		transform += transform_stride;
+		*transform = w1;
+		transform += transform_stride;
+		*transform = w2;
+		transform += transform_stride;
+		*transform = w3;
+		transform += transform_stride;
+		*transform = w4;
+		transform += transform_stride;
+		*transform = w5;
+		transform += transform_stride;
+	}
+}
+
+void nnp_owt6x6_3x3_with_bias__scalar(
+	const float transform[restrict static 1],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	transform_stride /= sizeof(float);
+
+	float block[OUTPUT_SIZE][BLOCK_SIZE];
+	for (uint32_t column = 0; column < BLOCK_SIZE; column++) {
+		float m[BLOCK_SIZE];
+		m[0] = *transform;
+		transform += transform_stride;
+		m[1] = *transform;
+		transform += transform_stride;
+		m[2] = *transform;
+		transform += transform_stride;
+		m[3] = *transform;
+		transform += transform_stride;
+		m[4] = *transform;
+		transform += transform_stride;
+		m[5] = *transform;
+		transform += transform_stride;
+
+		if (column == 1) {
+			m[1] += *bias;
+		}
+
+		winograd_f4k3_output_transform(
+			m[0], m[1], m[2], m[3], m[4], m[5],
+			&block[0][column], &block[1][column], &block[2][column], &block[3][column]);
+	}
+
+	for (uint32_t row = 0; row < row_count; row++) {
+		float s[OUTPUT_SIZE];
+		winograd_f4k3_output_transform(
+			block[row][0], block[row][1], block[row][2], block[row][3], block[row][4], block[row][5],
+			&s[0], &s[1], &s[2], &s[3]);
+		for (uint32_t column = 0; column < column_count; column++) {
+			output[row * output_stride + column] = s[column];
+		}
+	}
+}
+
+void nnp_owt6x6_3x3_with_bias_with_relu__scalar(
+	const float transform[restrict static 1],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	transform_stride /= sizeof(float);
+
+	float block[OUTPUT_SIZE][BLOCK_SIZE];
+	for (uint32_t column = 0; column < BLOCK_SIZE; column++) {
+		float m[BLOCK_SIZE];
+		m[0] = *transform;
+		transform += transform_stride;
+		m[1] = *transform;
+		transform += transform_stride;
+		m[2] = *transform;
+		transform += transform_stride;
+		m[3] = *transform;
+		transform += transform_stride;
+		m[4] = *transform;
+		transform += transform_stride;
+		m[5] = *transform;
+		transform += transform_stride;
+
+		if (column == 1) {
+			m[1] += *bias;
+		}
+
+		winograd_f4k3_output_transform(
+			m[0], m[1], m[2], m[3], m[4], m[5],
+			&block[0][column], &block[1][column], &block[2][column], &block[3][column]);
+	}
+
+	for (uint32_t row = 0; row < row_count; row++) {
+		float s[OUTPUT_SIZE];
+		winograd_f4k3_output_transform(
+			block[row][0], block[row][1], block[row][2], block[row][3], block[row][4], block[row][5],
+			&s[0], &s[1], &s[2], &s[3]);
+		for (uint32_t column = 0; column < column_count; column++) {
+			output[row * output_stride + column] = relu(s[column], 0.0f);
+		}
+	}
+}
@@ -0,0 +1,54 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack/macros.h>
+
+
+static inline void q8gemm_4x4(size_t k, const int8_t* a, const uint8_t* b, int32_t acc[restrict static 4 * 4]) {
+	for (size_t i = 0; i < 4 * 4; i++) {
+		acc[i] = 0;
+	}
+	do {
+		for (size_t m = 0; m < 4; m++) {
+			const int32_t a0 = (int32_t) a[m * 2];
+			const int32_t a1 = (int32_t) a[m * 2 + 1];
+			for (size_t n = 0; n < 4; n++) {
+				acc[m * 4 + n] += a0 * (int32_t) b[n * 2] + a1 * (int32_t) b[n * 2 + 1];
+			}
+		}
+		a += 4 * 2;
+		b += 4 * 2;
+	} while (--k);
+}
+
+void nnp_q8gemm_only_4x4__scalar(size_t k, size_t update, const int8_t* a, const uint8_t* b, int32_t* c, size_t row_stride_c) {
+	int32_t acc[4 * 4];
+	q8gemm_4x4(k, a, b, acc);
+
+	for (size_t m = 0; m < 4; m++) {
+		for (size_t n = 0; n < 4; n++) {
+			if (update) {
+				c[n] += acc[m * 4 + n];
+			} else {
+				c[n] = acc[m * 4 + n];
+			}
+		}
+		c += row_stride_c;
+	}
+}
+
+void nnp_q8gemm_upto_4x4__scalar(uint32_t mr, uint32_t nr, size_t k, size_t update, const int8_t* a, const uint8_t* b, int32_t* c, size_t row_stride_c) {
+	int32_t acc[4 * 4];
+	q8gemm_4x4(k, a, b, acc);
+
+	for (size_t m = 0; m < mr; m++) {
+		for (size_t n = 0; n < nr; n++) {
+			if (update) {
+				c[n] += acc[m * 4 + n];
+			} else {
+				c[n] = acc[m * 4 + n];
+			}
+		}
+		c += row_stride_c;
+	}
+}
@@ -0,0 +1,93 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <nnpack/utils.h>
+#include <nnpack/depthwise.h>
+
+
+static inline float dwconv_pixel_with_padding(
+	const float* input, const float* kernel,
+	size_t input_width, size_t input_x, uint32_t kernel_rows,
+	float bias, const uint32_t kernel_width)
+{
+	float acc = bias;
+	for (uint32_t i = 0; i < kernel_rows; i++) {
+		for (uint32_t j = 0; j < kernel_width; j++) {
+			/* Columns left of the input row wrap around to large values */
+			const size_t t = input_x + j;
+			if (t < input_width) {
+				acc += input[t] * kernel[j];
+			}
+		}
+		input += input_width;
+		kernel += kernel_width;
+	}
+	return acc;
+}
+
+static inline void dwconv_row(
+	const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max,
+	const uint32_t kernel_width, const uint32_t stride)
+{
+	const size_t interior_start = min(divide_round_up(padding_left, stride), output_width);
+	const size_t interior_end = depthwise_interior_end(input_width, padding_left, output_width, kernel_width, stride);
+
+	size_t x = 0;
+	for (; x < interior_start; x++) {
+		const float acc = dwconv_pixel_with_padding(input, kernel,
+			input_width, x * stride - padding_left, kernel_rows, bias, kernel_width);
+		output[x] = minf(maxf(acc, output_min), output_max);
+	}
+	for (; x < interior_end; x++) {
+		const float* input_row = input + (x * stride - padding_left);
+		const float* kernel_row = kernel;
+		float acc = bias;
+		for (uint32_t i = 0; i < kernel_rows; i++) {
+			for (uint32_t j = 0; j < kernel_width; j++) {
+				acc += input_row[j] * kernel_row[j];
+			}
+			input_row += input_width;
+			kernel_row += kernel_width;
+		}
+		output[x] = minf(maxf(acc, output_min), output_max);
+	}
+	for (; x < output_width; x++) {
+		const float acc = dwconv_pixel_with_padding(input, kernel,
+			input_width, x * stride - padding_left, kernel_rows, bias, kernel_width);
+		output[x] = minf(maxf(acc, output_min), output_max);
+	}
+}
+
+void nnp_dwconv3x3__scalar(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 3, 1);
+}
+
+void nnp_dwconv3x3s2__scalar(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 3, 2);
+}
+
+void nnp_dwconv5x5__scalar(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 5, 1);
+}
+
+void nnp_dwconv5x5s2__scalar(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 5, 2);
+}
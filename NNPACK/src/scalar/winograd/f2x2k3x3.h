@@ -0,0 +1,54 @@
+#pragma once
+
+#include <nnpack/macros.h>
+
+
+static NNP_INLINE void winograd_f2k3_input_transform(
+	const float d0, const float d1, const float d2, const float d3,
+	float transform0[restrict static 1],
+	float transform1[restrict static 1],
+	float transform2[restrict static 1],
+	float transform3[restrict static 1])
+{
+	// Compute wd0 := d0 - d2
+	*transform0 = d0 - d2;
+	// Compute wd1 := d1 + d2
+	*transform1 = d1 + d2;
+	// Compute wd2 := d2 - d1
+	*transform2 = d2 - d1;
+	// Compute wd3 := d1 - d3
+	*transform3 = d1 - d3;
+}
+
+static NNP_INLINE void winograd_f2k3_kernel_transform(
+	const float g0, const float g1, const float g2,
+	float transform0[restrict static 1],
+	float transform1[restrict static 1],
+	float transform2[restrict static 1],
+	float transform3[restrict static 1])
+{
+	const float const_half = 0.5f;
+
+	// Compute
+	//   w1 := 0.5 * (g0 + g1 + g2)
+	//   w2 := 0.5 * (g0 - g1 + g2)
+	const float half_g0_add_g2 = const_half * (g0 + g2);
+	const float half_g1 = const_half * g1;
+
+	*transform0 = g0;
+	*transform1 = half_g0_add_g2 + half_g1;
+	*transform2 = half_g0_add_g2 - half_g1;
+	*transform3 = g2;
+}
+
+static NNP_INLINE void winograd_f2k3_output_transform(
+	const float m0, const float m1, const float m2, const float m3,
+	float output0[restrict static 1],
+	float output1[restrict static 1])
+{
+	// Compute
+	//   s0 := m0 + m1 + m2
+	//   s1 := m1 - m2 - m3
+	*output0 = m0 + m1 + m2;
+	*output1 = (m1 - m2) - m3;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <nnpack/macros.h>
+
+
+static NNP_INLINE void winograd_f4k3_input_transform(
+	const float d0, const float d1, const float d2, const float d3, const float d4, const float d5,
+	float transform0[restrict static 1],
+	float transform1[restrict static 1],
+	float transform2[restrict static 1],
+	float transform3[restrict static 1],
+	float transform4[restrict static 1],
+	float transform5[restrict static 1])
+{
+	const float const_2 = 2.0f;
+	const float const_4 = 4.0f;
+
+	const float d4_sub_d2 = d4 - d2;
+	const float d3_sub_d1 = d3 - d1;
+
+	// Compute
+	//   wd0 := 4 * d0 - 5 * d2 + d4
+	//   wd5 := 4 * d1 - 5 * d3 + d5
+	const float wd0 = const_4 * (d0 - d2) + d4_sub_d2;
+	const float wd5 = const_4 * (d1 - d3) + (d5 - d3);
+
+	// Compute
+	//   wd1 := (d4 - 4 * d2) + (d3 - 4 * d1)
+	//   wd2 := (d4 - 4 * d2) - (d3 - 4 * d1)
+	const float d4_sub_4d2 = d4 - const_4 * d2;
+	const float d3_sub_4d1 = d3 - const_4 * d1;
+
+	// Compute
+	//   wd3 := (d4 - d2) + 2 * (d3 - d1)
+	//   wd4 := (d4 - d2) - 2 * (d3 - d1)
+	const float d3_sub_d1_times_2 = const_2 * d3_sub_d1;
+
+	*transform0 = wd0;
+	*transform1 = d4_sub_4d2 + d3_sub_4d1;
+	*transform2 = d4_sub_4d2 - d3_sub_4d1;
+	*transform3 = d4_sub_d2 + d3_sub_d1_times_2;
+	*transform4 = d4_sub_d2 - d3_sub_d1_times_2;
+	*transform5 = wd5;
+}
+
+static NNP_INLINE void winograd_f4k3_kernel_transform(
+	const float g0, const float g1, const float g2,
+	float transform0[restrict static 1],
+	float transform1[restrict static 1],
+	float transform2[restrict static 1],
+	float transform3[restrict static 1],
+	float transform4[restrict static 1],
+	float transform5[restrict static 1])
+{
+	const float const_1_6 = 0x1.555556p-3f;
+
+	// Compute
+	//   w1 := -(g0 + g1 + g2) / 6
+	//   w2 := -(g0 - g1 + g2) / 6
+	const float g0_add_g2 = g0 + g2;
+	const float w1 = (g0_add_g2 + g1) * -const_1_6;
+	const float w2 = (g0_add_g2 - g1) * -const_1_6;
+
+	// Compute
+	//   w3 := g0 / 24 + g1 / 12 + g2 / 6
+	//   w4 := g0 / 24 - g1 / 12 + g2 / 6
+	const float g0_div_24_add_g2_div_6 = 0x1.555556p-5f * g0 + const_1_6 * g2;
+	const float g1_div_12 = 0x1.555556p-4f * g1;
+
+	*transform0 = 0.25f * g0;
+	*transform1 = w1;
+	*transform2 = w2;
+	*transform3 = g0_div_24_add_g2_div_6 + g1_div_12;
+	*transform4 = g0_div_24_add_g2_div_6 - g1_div_12;
+	*transform5 = g2;
+}
+
+static NNP_INLINE void winograd_f4k3_output_transform(
+	const float m0, const float m1, const float m2, const float m3, const float m4, const float m5,
+	float output0[restrict static 1],
+	float output1[restrict static 1],
+	float output2[restrict static 1],
+	float output3[restrict static 1])
+{
+	const float m1_add_m2 = m1 + m2;
+	const float m1_sub_m2 = m1 - m2;
+	const float m3_add_m4 = m3 + m4;
+	const float m3_sub_m4 = m3 - m4;
+
+	// Compute
+	//   s0 := m0 + (m1 + m2) + (m3 + m4)
+	//   s1 := (m1 - m2) + 2 * (m3 - m4)
+	//   s2 := (m1 + m2) + 4 * (m3 + m4)
+	//   s3 := (m1 - m2) + 8 * (m3 - m4) + m5
+	*output0 = m0 + m1_add_m2 + m3_add_m4;
+	*output1 = m1_sub_m2 + 2.0f * m3_sub_m4;
+	*output2 = m1_add_m2 + 4.0f * m3_add_m4;
+	*output3 = m1_sub_m2 + 8.0f * m3_sub_m4 + m5;
+}
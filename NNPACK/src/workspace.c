@@ -0,0 +1,239 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <pthread.h>
+
+#include <nnpack.h>
+#include <nnpack/macros.h>
+#include <nnpack/utils.h>
+#include <nnpack/system.h>
+#include <nnpack/workspace.h>
+
+/*
+ * Workspace arena.
+ *
+ * Every slab is a single allocation obtained from allocate_memory, i.e. pre-faulted and backed by huge pages
+ * where the OS permits. Slabs only grow: once a slab is big enough for a layer, subsequent calls reuse it
+ * without touching the virtual memory system. A slab is used by at most one call at a time, and remembers
+ * the thread that used it last, so that a thread which repeatedly runs the same network keeps getting the
+ * same (already warm) slab. If all slabs are busy, the call falls back to a one-off allocation.
+ */
+
+#define NNP_WORKSPACE_SLABS 16
+
+/* Granularity of slab sizes: large slabs are rounded to 2 MB huge pages, small slabs to 64 KB */
+#define NNP_WORKSPACE_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#define NNP_WORKSPACE_SMALL_SLAB_SIZE (64 * 1024)
+
+struct workspace_slab {
+	void* memory;
+	size_t size;
+	pthread_t owner;
+	bool owned;
+	bool busy;
+};
+
+static struct {
+	pthread_mutex_t mutex;
+	struct workspace_slab slabs[NNP_WORKSPACE_SLABS];
+} workspace_arena = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static inline size_t round_slab_size(size_t memory_size) {
+	if (memory_size >= NNP_WORKSPACE_HUGE_PAGE_SIZE) {
+		return round_up_by_power_of_2(memory_size, NNP_WORKSPACE_HUGE_PAGE_SIZE);
+	} else {
+		return round_up_by_power_of_2(memory_size, NNP_WORKSPACE_SMALL_SLAB_SIZE);
+	}
+}
+
+/*
+ * Selects a free slab for the calling thread. Preference order:
+ *  1. A big enough slab last used by this thread
+ *  2. The smallest big enough slab
+ *  3. A free slab last used by this thread (to be grown)
+ *  4. An empty slab (to be allocated)
+ *  5. The largest free slab (to be grown)
+ * Must be called with the arena mutex locked.
+ */
+static struct workspace_slab* select_slab(size_t memory_size, pthread_t thread) {
+	struct workspace_slab* own_fit = NULL;
+	struct workspace_slab* best_fit = NULL;
+	struct workspace_slab* own_slab = NULL;
+	struct workspace_slab* empty_slab = NULL;
+	struct workspace_slab* largest_slab = NULL;
+	for (size_t i = 0; i < NNP_WORKSPACE_SLABS; i++) {
+		struct workspace_slab* slab = &workspace_arena.slabs[i];
+		if (slab->busy) {
+			continue;
+		}
+
+		if (slab->memory == NULL) {
+			if (empty_slab == NULL) {
+				empty_slab = slab;
+			}
+			continue;
+		}
+
+		const bool own = slab->owned && pthread_equal(slab->owner, thread);
+		if (slab->size >= memory_size) {
+			if (own && own_fit == NULL) {
+				own_fit = slab;
+			}
+			if (best_fit == NULL || slab->size < best_fit->size) {
+				best_fit = slab;
+			}
+		} else {
+			if (own && own_slab == NULL) {
+				own_slab = slab;
+			}
+			if (largest_slab == NULL || slab->size > largest_slab->size) {
+				largest_slab = slab;
+			}
+		}
+	}
+
+	if (own_fit != NULL) {
+		return own_fit;
+	} else if (best_fit != NULL) {
+		return best_fit;
+	} else if (own_slab != NULL) {
+		return own_slab;
+	} else if (empty_slab != NULL) {
+		return empty_slab;
+	} else {
+		return largest_slab;
+	}
+}
+
+/*
+ * Replaces the memory of a slab reserved by the caller (i.e. marked busy) with an allocation of at least memory_size
+ * bytes. Must be called with the arena mutex unlocked: populating a large slab takes a while, and other threads should
+ * not wait for it. Only the new pointer and size are published under the mutex.
+ */
+static void* grow_slab(struct workspace_slab slab[restrict static 1], size_t memory_size) {
+	const size_t slab_size = round_slab_size(memory_size);
+	void* memory = allocate_memory(slab_size);
+	if (memory == NULL) {
+		return NULL;
+	}
+
+	pthread_mutex_lock(&workspace_arena.mutex);
+	void* old_memory = slab->memory;
+	const size_t old_size = slab->size;
+	slab->memory = memory;
+	slab->size = slab_size;
+	pthread_mutex_unlock(&workspace_arena.mutex);
+
+	release_memory(old_memory, old_size);
+	return memory;
+}
+
+void* nnp_workspace_acquire_block(size_t memory_size) {
+	if (memory_size == 0) {
+		memory_size = 1;
+	}
+
+	const pthread_t thread = pthread_self();
+	void* memory_block = NULL;
+
+	pthread_mutex_lock(&workspace_arena.mutex);
+	struct workspace_slab* slab = select_slab(memory_size, thread);
+	if (slab != NULL) {
+		slab->busy = true;
+		slab->owned = true;
+		slab->owner = thread;
+		if (slab->size >= memory_size) {
+			memory_block = slab->memory;
+		}
+	}
+	pthread_mutex_unlock(&workspace_arena.mutex);
+
+	if (slab != NULL && memory_block == NULL) {
+		memory_block = grow_slab(slab, memory_size);
+		if (memory_block == NULL) {
+			pthread_mutex_lock(&workspace_arena.mutex);
+			slab->busy = false;
+			pthread_mutex_unlock(&workspace_arena.mutex);
+		}
+	}
+
+	if (memory_block == NULL) {
+		/* All slabs are in use by concurrent calls, or growing the slab failed: use a one-off allocation */
+		memory_block = allocate_memory(memory_size);
+	}
+	return memory_block;
+}
+
+void nnp_workspace_release_block(void* memory_block, size_t memory_size) {
+	if (memory_block == NULL) {
+		return;
+	}
+
+	pthread_mutex_lock(&workspace_arena.mutex);
+	for (size_t i = 0; i < NNP_WORKSPACE_SLABS; i++) {
+		struct workspace_slab* slab = &workspace_arena.slabs[i];
+		if (slab->busy && slab->memory == memory_block) {
+			slab->busy = false;
+			pthread_mutex_unlock(&workspace_arena.mutex);
+			return;
+		}
+	}
+	pthread_mutex_unlock(&workspace_arena.mutex);
+
+	/* Not a slab: the block came from a one-off allocation */
+	release_memory(memory_block, memory_size);
+}
+
+enum nnp_status nnp_workspace_reserve(size_t workspace_size) {
+	if (workspace_size == 0) {
+		return nnp_status_success;
+	}
+
+	enum nnp_status status = nnp_status_success;
+	const pthread_t thread = pthread_self();
+	bool grow = false;
+
+	pthread_mutex_lock(&workspace_arena.mutex);
+	struct workspace_slab* slab = select_slab(workspace_size, thread);
+	if (slab == NULL) {
+		status = nnp_status_out_of_memory;
+	} else {
+		slab->owned = true;
+		slab->owner = thread;
+		if (slab->size < workspace_size) {
+			/* Keep other calls off the slab while it grows outside of the lock */
+			slab->busy = true;
+			grow = true;
+		}
+	}
+	pthread_mutex_unlock(&workspace_arena.mutex);
+
+	if (grow) {
+		if (grow_slab(slab, workspace_size) == NULL) {
+			status = nnp_status_out_of_memory;
+		}
+		pthread_mutex_lock(&workspace_arena.mutex);
+		slab->busy = false;
+		pthread_mutex_unlock(&workspace_arena.mutex);
+	}
+
+	return status;
+}
+
+enum nnp_status nnp_workspace_release(void) {
+	pthread_mutex_lock(&workspace_arena.mutex);
+	for (size_t i = 0; i < NNP_WORKSPACE_SLABS; i++) {
+		struct workspace_slab* slab = &workspace_arena.slabs[i];
+		/* Slabs used by concurrently running calls stay in the arena */
+		if (!slab->busy) {
+			release_memory(slab->memory, slab->size);
+			*slab = (struct workspace_slab) { 0 };
+		}
+	}
+	pthread_mutex_unlock(&workspace_arena.mutex);
+
+	return nnp_status_success;
+}
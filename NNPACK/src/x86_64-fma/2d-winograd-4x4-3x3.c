@@ -0,0 +1,182 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <immintrin.h>
+
+#include <nnpack/macros.h>
+
+
+#define BLOCK_SIZE 4
+#define OUTPUT_SIZE 2
+
+/*
+ * Transformed 4x4 tiles are stored transposed, as in the psimd backend: each transform then needs a single transpose.
+ * The 16 elements of a tile fill 2 tuples of 8 elements (the tuple width of the AVX2 s8gemm micro-kernel), with two
+ * rows of the transposed tile in each tuple.
+ */
+
+static inline void winograd_f2k3_input_transform(
+	const __m128 d0, const __m128 d1, const __m128 d2, const __m128 d3,
+	__m128 transform[restrict static 4])
+{
+	transform[0] = _mm_sub_ps(d0, d2);
+	transform[1] = _mm_add_ps(d1, d2);
+	transform[2] = _mm_sub_ps(d2, d1);
+	transform[3] = _mm_sub_ps(d1, d3);
+}
+
+static inline void winograd_f2k3_kernel_transform(
+	const __m128 g0, const __m128 g1, const __m128 g2,
+	__m128 transform[restrict static 4])
+{
+	const __m128 const_half = _mm_set1_ps(0.5f);
+
+	// Compute
+	//   w1 := 0.5 * (g0 + g1 + g2)
+	//   w2 := 0.5 * (g0 - g1 + g2)
+	const __m128 half_g0_add_g2 = _mm_mul_ps(const_half, _mm_add_ps(g0, g2));
+	transform[0] = g0;
+	transform[1] = _mm_fmadd_ps(const_half, g1, half_g0_add_g2);
+	transform[2] = _mm_fnmadd_ps(const_half, g1, half_g0_add_g2);
+	transform[3] = g2;
+}
+
+static inline void winograd_f2k3_output_transform(
+	const __m128 m0, const __m128 m1, const __m128 m2, const __m128 m3,
+	__m128 output[restrict static 2])
+{
+	// Compute
+	//   s0 := m0 + m1 + m2
+	//   s1 := m1 - m2 - m3
+	output[0] = _mm_add_ps(_mm_add_ps(m0, m1), m2);
+	output[1] = _mm_sub_ps(_mm_sub_ps(m1, m2), m3);
+}
+
+static inline void store_tuples(
+	float transform[restrict static 8],
+	size_t transform_stride,
+	const __m128 rows[restrict static 4])
+{
+	_mm256_storeu_ps(transform, _mm256_insertf128_ps(_mm256_castps128_ps256(rows[0]), rows[1], 1));
+	transform = (float*) ((uintptr_t) transform + transform_stride);
+	_mm256_storeu_ps(transform, _mm256_insertf128_ps(_mm256_castps128_ps256(rows[2]), rows[3], 1));
+}
+
+void nnp_iwt4x4_3x3_with_offset__avx2(
+	const float data[restrict static 1],
+	float transform[restrict static 8],
+	size_t data_stride, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	__m128 d[BLOCK_SIZE];
+	if (row_count == BLOCK_SIZE && column_count == BLOCK_SIZE) {
+		for (size_t row = 0; row < BLOCK_SIZE; row++) {
+			d[row] = _mm_loadu_ps(&data[row * data_stride]);
+		}
+	} else {
+		NNP_SIMD_ALIGN float block[BLOCK_SIZE][BLOCK_SIZE] = { { 0.0f } };
+		for (size_t row = 0; row < row_count; row++) {
+			for (size_t column = 0; column < column_count; column++) {
+				block[row_offset + row][column_offset + column] = data[row * data_stride + column];
+			}
+		}
+		for (size_t row = 0; row < BLOCK_SIZE; row++) {
+			d[row] = _mm_load_ps(&block[row][0]);
+		}
+	}
+
+	__m128 wd[BLOCK_SIZE];
+	winograd_f2k3_input_transform(d[0], d[1], d[2], d[3], wd);
+	_MM_TRANSPOSE4_PS(wd[0], wd[1], wd[2], wd[3]);
+	winograd_f2k3_input_transform(wd[0], wd[1], wd[2], wd[3], wd);
+	store_tuples(transform, transform_stride, wd);
+}
+
+void nnp_kwt4x4_3x3__avx2(
+	const float g[restrict static 9],
+	float transform[restrict static 8],
+	size_t stride_g, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	/* The last element of each row vector is not part of the row, and ends up in the unused 4th row of the transpose */
+	const __m128 g0 = _mm_loadu_ps(g);
+	const __m128 g1 = _mm_loadu_ps(g + 3);
+	const __m128 g5678 = _mm_loadu_ps(g + 5);
+	const __m128 g2 = _mm_shuffle_ps(g5678, g5678, _MM_SHUFFLE(3, 3, 2, 1));
+
+	__m128 w[BLOCK_SIZE];
+	winograd_f2k3_kernel_transform(g0, g1, g2, w);
+	_MM_TRANSPOSE4_PS(w[0], w[1], w[2], w[3]);
+
+	__m128 wg[BLOCK_SIZE];
+	winograd_f2k3_kernel_transform(w[0], w[1], w[2], wg);
+	store_tuples(transform, transform_stride, wg);
+}
+
+static inline void owt4x4_3x3(
+	const float transform[restrict static 8],
+	size_t transform_stride,
+	float bias,
+	__m128 output[restrict static OUTPUT_SIZE])
+{
+	const __m256 m01 = _mm256_loadu_ps(transform);
+	transform = (const float*) ((uintptr_t) transform + transform_stride);
+	const __m256 m23 = _mm256_loadu_ps(transform);
+
+	__m128 s[4];
+	winograd_f2k3_output_transform(
+		_mm256_castps256_ps128(m01),
+		_mm_add_ps(_mm256_extractf128_ps(m01, 1), _mm_set_ps(0.0f, 0.0f, bias, 0.0f)),
+		_mm256_castps256_ps128(m23),
+		_mm256_extractf128_ps(m23, 1),
+		s);
+	s[2] = s[3] = _mm_setzero_ps();
+	_MM_TRANSPOSE4_PS(s[0], s[1], s[2], s[3]);
+	winograd_f2k3_output_transform(s[0], s[1], s[2], s[3], output);
+}
+
+static inline void store_output(
+	float output[restrict static 1],
+	size_t output_stride,
+	uint32_t row_count, uint32_t column_count,
+	const __m128 rows[restrict static OUTPUT_SIZE])
+{
+	if (column_count == OUTPUT_SIZE) {
+		for (size_t row = 0; row < row_count; row++) {
+			_mm_storel_pi((__m64*) &output[row * output_stride], rows[row]);
+		}
+	} else {
+		for (size_t row = 0; row < row_count; row++) {
+			_mm_store_ss(&output[row * output_stride], rows[row]);
+		}
+	}
+}
+
+void nnp_owt4x4_3x3_with_bias__avx2(
+	const float transform[restrict static 8],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	__m128 s[OUTPUT_SIZE];
+	owt4x4_3x3(transform, transform_stride, *bias, s);
+	store_output(output, output_stride, row_count, column_count, s);
+}
+
+void nnp_owt4x4_3x3_with_bias_with_relu__avx2(
+	const float transform[restrict static 8],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	__m128 s[OUTPUT_SIZE];
+	owt4x4_3x3(transform, transform_stride, *bias, s);
+	for (size_t row = 0; row < OUTPUT_SIZE; row++) {
+		s[row] = _mm_max_ps(s[row], _mm_setzero_ps());
+	}
+	store_output(output, output_stride, row_count, column_count, s);
+}
@@ -0,0 +1,292 @@
+#include <stdint.h>
+#include <stddef.h>
+
+#include <immintrin.h>
+
+#include <nnpack/macros.h>
+
+
+#define BLOCK_SIZE 6
+#define OUTPUT_SIZE 4
+#define TUPLE_ELEMENTS 8
+#define TUPLE_COUNT ((BLOCK_SIZE * BLOCK_SIZE + TUPLE_ELEMENTS - 1) / TUPLE_ELEMENTS)
+
+/*
+ * Transformed 6x6 tiles are stored transposed, as in the psimd backend: each transform then needs a single transpose.
+ * Rows of the transposed tile are packed back to back into TUPLE_COUNT tuples of 8 elements (the tuple width of the
+ * AVX2 s8gemm micro-kernel). Elements which pad the last tuple are zero in input and kernel transforms.
+ * Rows are processed in 8-wide vectors, in which lanes 6 and 7 are not part of the row, and are packed into tuples
+ * and unpacked from them in registers.
+ */
+
+static inline void winograd_f4k3_input_transform(
+	const __m256 d0, const __m256 d1, const __m256 d2, const __m256 d3, const __m256 d4, const __m256 d5,
+	__m256 transform[restrict static 6])
+{
+	const __m256 const_2 = _mm256_set1_ps(2.0f);
+	const __m256 const_4 = _mm256_set1_ps(4.0f);
+
+	const __m256 d4_sub_d2 = _mm256_sub_ps(d4, d2);
+	const __m256 d3_sub_d1 = _mm256_sub_ps(d3, d1);
+
+	// Compute
+	//   wd0 := 4 * d0 - 5 * d2 + d4
+	//   wd5 := 4 * d1 - 5 * d3 + d5
+	transform[0] = _mm256_fmadd_ps(const_4, _mm256_sub_ps(d0, d2), d4_sub_d2);
+	transform[5] = _mm256_fmadd_ps(const_4, _mm256_sub_ps(d1, d3), _mm256_sub_ps(d5, d3));
+
+	// Compute
+	//   wd1 := (d4 - 4 * d2) + (d3 - 4 * d1)
+	//   wd2 := (d4 - 4 * d2) - (d3 - 4 * d1)
+	const __m256 d4_sub_4d2 = _mm256_fnmadd_ps(const_4, d2, d4);
+	const __m256 d3_sub_4d1 = _mm256_fnmadd_ps(const_4, d1, d3);
+	transform[1] = _mm256_add_ps(d4_sub_4d2, d3_sub_4d1);
+	transform[2] = _mm256_sub_ps(d4_sub_4d2, d3_sub_4d1);
+
+	// Compute
+	//   wd3 := (d4 - d2) + 2 * (d3 - d1)
+	//   wd4 := (d4 - d2) - 2 * (d3 - d1)
+	transform[3] = _mm256_fmadd_ps(const_2, d3_sub_d1, d4_sub_d2);
+	transform[4] = _mm256_fnmadd_ps(const_2, d3_sub_d1, d4_sub_d2);
+}
+
+static inline void winograd_f4k3_kernel_transform(
+	const __m256 g0, const __m256 g1, const __m256 g2,
+	__m256 transform[restrict static 6])
+{
+	const __m256 const_1_6 = _mm256_set1_ps(0x1.555556p-3f);
+
+	// Compute
+	//   w1 := -(g0 + g1 + g2) / 6
+	//   w2 := -(g0 - g1 + g2) / 6
+	const __m256 g0_add_g2 = _mm256_add_ps(g0, g2);
+	const __m256 minus_const_1_6 = _mm256_set1_ps(-0x1.555556p-3f);
+	transform[1] = _mm256_mul_ps(_mm256_add_ps(g0_add_g2, g1), minus_const_1_6);
+	transform[2] = _mm256_mul_ps(_mm256_sub_ps(g0_add_g2, g1), minus_const_1_6);
+
+	// Compute
+	//   w3 := g0 / 24 + g1 / 12 + g2 / 6
+	//   w4 := g0 / 24 - g1 / 12 + g2 / 6
+	const __m256 g0_div_24_add_g2_div_6 = _mm256_fmadd_ps(_mm256_set1_ps(0x1.555556p-5f), g0, _mm256_mul_ps(const_1_6, g2));
+	const __m256 g1_div_12 = _mm256_mul_ps(_mm256_set1_ps(0x1.555556p-4f), g1);
+	transform[3] = _mm256_add_ps(g0_div_24_add_g2_div_6, g1_div_12);
+	transform[4] = _mm256_sub_ps(g0_div_24_add_g2_div_6, g1_div_12);
+
+	transform[0] = _mm256_mul_ps(_mm256_set1_ps(0.25f), g0);
+	transform[5] = g2;
+}
+
+static inline void winograd_f4k3_output_transform(
+	const __m256 m0, const __m256 m1, const __m256 m2, const __m256 m3, const __m256 m4, const __m256 m5,
+	__m256 output[restrict static 4])
+{
+	const __m256 m1_add_m2 = _mm256_add_ps(m1, m2);
+	const __m256 m1_sub_m2 = _mm256_sub_ps(m1, m2);
+	const __m256 m3_add_m4 = _mm256_add_ps(m3, m4);
+	const __m256 m3_sub_m4 = _mm256_sub_ps(m3, m4);
+
+	// Compute
+	//   s0 := m0 + (m1 + m2) + (m3 + m4)
+	//   s1 := (m1 - m2) + 2 * (m3 - m4)
+	//   s2 := (m1 + m2) + 4 * (m3 + m4)
+	//   s3 := (m1 - m2) + 8 * (m3 - m4) + m5
+	output[0] = _mm256_add_ps(_mm256_add_ps(m0, m1_add_m2), m3_add_m4);
+	output[1] = _mm256_fmadd_ps(_mm256_set1_ps(2.0f), m3_sub_m4, m1_sub_m2);
+	output[2] = _mm256_fmadd_ps(_mm256_set1_ps(4.0f), m3_add_m4, m1_add_m2);
+	output[3] = _mm256_add_ps(_mm256_fmadd_ps(_mm256_set1_ps(8.0f), m3_sub_m4, m1_sub_m2), m5);
+}
+
+static inline void transpose8x8(__m256 rows[restrict static 8]) {
+	const __m256 t0 = _mm256_unpacklo_ps(rows[0], rows[1]);
+	const __m256 t1 = _mm256_unpackhi_ps(rows[0], rows[1]);
+	const __m256 t2 = _mm256_unpacklo_ps(rows[2], rows[3]);
+	const __m256 t3 = _mm256_unpackhi_ps(rows[2], rows[3]);
+	const __m256 t4 = _mm256_unpacklo_ps(rows[4], rows[5]);
+	const __m256 t5 = _mm256_unpackhi_ps(rows[4], rows[5]);
+	const __m256 t6 = _mm256_unpacklo_ps(rows[6], rows[7]);
+	const __m256 t7 = _mm256_unpackhi_ps(rows[6], rows[7]);
+
+	const __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+	const __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+	const __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+	const __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+	const __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+	const __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+	const __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+	const __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+	rows[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+	rows[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+	rows[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+	rows[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+	rows[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+	rows[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+	rows[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+	rows[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+
+/* Rotate lanes of a vector down by 2 or 6: lane i of the result is lane (i + 2) or (i + 6) mod 8 of the argument */
+static inline __m256 rotate2(__m256 v) {
+	return _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(2, 3, 4, 5, 6, 7, 0, 1));
+}
+
+static inline __m256 rotate6(__m256 v) {
+	return _mm256_permutevar8x32_ps(v, _mm256_setr_epi32(6, 7, 0, 1, 2, 3, 4, 5));
+}
+
+/* Packs lanes 0-5 of 6 rows back to back into tuples, and zeroes the padding of the last tuple */
+static inline void store_tuples(
+	float transform[restrict static TUPLE_ELEMENTS],
+	size_t transform_stride,
+	const __m256 rows[restrict static BLOCK_SIZE])
+{
+	const __m256 r1 = rotate2(rows[1]);
+	const __m256 r2 = _mm256_permute2f128_ps(rows[2], rows[2], 0x01);
+	const __m256 r5 = rotate2(rows[5]);
+	const __m256 tuples[TUPLE_COUNT] = {
+		_mm256_blend_ps(rows[0], r1, 0xC0),
+		_mm256_blend_ps(r1, r2, 0xF0),
+		_mm256_blend_ps(r2, rotate6(rows[3]), 0xFC),
+		_mm256_blend_ps(rows[4], r5, 0xC0),
+		_mm256_blend_ps(r5, _mm256_setzero_ps(), 0xF0),
+	};
+
+	for (size_t tuple = 0; tuple < TUPLE_COUNT; tuple++) {
+		_mm256_storeu_ps(transform, tuples[tuple]);
+		transform = (float*) ((uintptr_t) transform + transform_stride);
+	}
+}
+
+void nnp_iwt6x6_3x3_with_offset__avx2(
+	const float data[restrict static 1],
+	float transform[restrict static TUPLE_ELEMENTS],
+	size_t data_stride, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	__m256 d[TUPLE_ELEMENTS];
+	if (row_count == BLOCK_SIZE && column_count == BLOCK_SIZE) {
+		const __m256i row_mask = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+		for (size_t row = 0; row < BLOCK_SIZE; row++) {
+			d[row] = _mm256_maskload_ps(&data[row * data_stride], row_mask);
+		}
+	} else {
+		NNP_SIMD_ALIGN float block[BLOCK_SIZE][TUPLE_ELEMENTS] = { { 0.0f } };
+		for (size_t row = 0; row < row_count; row++) {
+			for (size_t column = 0; column < column_count; column++) {
+				block[row_offset + row][column_offset + column] = data[row * data_stride + column];
+			}
+		}
+		for (size_t row = 0; row < BLOCK_SIZE; row++) {
+			d[row] = _mm256_load_ps(&block[row][0]);
+		}
+	}
+
+	winograd_f4k3_input_transform(d[0], d[1], d[2], d[3], d[4], d[5], d);
+	d[6] = d[7] = _mm256_setzero_ps();
+	transpose8x8(d);
+	winograd_f4k3_input_transform(d[0], d[1], d[2], d[3], d[4], d[5], d);
+	store_tuples(transform, transform_stride, d);
+}
+
+void nnp_kwt6x6_3x3__avx2(
+	const float g[restrict static 9],
+	float transform[restrict static TUPLE_ELEMENTS],
+	size_t stride_g, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	const __m256i row_mask = _mm256_setr_epi32(-1, -1, -1, 0, 0, 0, 0, 0);
+	const __m256 g0 = _mm256_maskload_ps(g, row_mask);
+	const __m256 g1 = _mm256_maskload_ps(g + 3, row_mask);
+	const __m256 g2 = _mm256_maskload_ps(g + 6, row_mask);
+
+	__m256 w[TUPLE_ELEMENTS];
+	winograd_f4k3_kernel_transform(g0, g1, g2, w);
+	w[6] = w[7] = _mm256_setzero_ps();
+	transpose8x8(w);
+	winograd_f4k3_kernel_transform(w[0], w[1], w[2], w);
+	store_tuples(transform, transform_stride, w);
+}
+
+static inline void owt6x6_3x3(
+	const float transform[restrict static TUPLE_ELEMENTS],
+	size_t transform_stride,
+	float bias,
+	__m128 output[restrict static OUTPUT_SIZE])
+{
+	__m256 t[TUPLE_COUNT];
+	for (size_t tuple = 0; tuple < TUPLE_COUNT; tuple++) {
+		t[tuple] = _mm256_loadu_ps(transform);
+		transform = (const float*) ((uintptr_t) transform + transform_stride);
+	}
+
+	/* Unpack rows from tuples. Lanes 6 and 7 of rows are not part of the rows, and end up in unused rows of the transpose. */
+	__m256 m[TUPLE_ELEMENTS];
+	m[0] = t[0];
+	m[1] = _mm256_add_ps(rotate6(_mm256_blend_ps(t[0], t[1], 0x0F)), _mm256_setr_ps(0.0f, bias, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+	m[2] = _mm256_permute2f128_ps(t[1], t[2], 0x21);
+	m[3] = rotate2(t[2]);
+	m[4] = t[3];
+	m[5] = rotate6(_mm256_blend_ps(t[3], t[4], 0x0F));
+
+	winograd_f4k3_output_transform(m[0], m[1], m[2], m[3], m[4], m[5], m);
+	m[4] = m[5] = m[6] = m[7] = _mm256_setzero_ps();
+	transpose8x8(m);
+
+	__m256 s[OUTPUT_SIZE];
+	winograd_f4k3_output_transform(m[0], m[1], m[2], m[3], m[4], m[5], s);
+	for (size_t row = 0; row < OUTPUT_SIZE; row++) {
+		output[row] = _mm256_castps256_ps128(s[row]);
+	}
+}
+
+static inline void store_output(
+	float output[restrict static 1],
+	size_t output_stride,
+	uint32_t row_count, uint32_t column_count,
+	const __m128 rows[restrict static OUTPUT_SIZE])
+{
+	if (column_count == OUTPUT_SIZE) {
+		for (size_t row = 0; row < row_count; row++) {
+			_mm_storeu_ps(&output[row * output_stride], rows[row]);
+		}
+	} else {
+		NNP_SIMD_ALIGN float block[OUTPUT_SIZE][OUTPUT_SIZE];
+		for (size_t row = 0; row < OUTPUT_SIZE; row++) {
+			_mm_store_ps(&block[row][0], rows[row]);
+		}
+		for (size_t row = 0; row < row_count; row++) {
+			for (size_t column = 0; column < column_count; column++) {
+				output[row * output_stride + column] = block[row][column];
+			}
+		}
+	}
+}
+
+void nnp_owt6x6_3x3_with_bias__avx2(
+	const float transform[restrict static TUPLE_ELEMENTS],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	__m128 s[OUTPUT_SIZE];
+	owt6x6_3x3(transform, transform_stride, *bias, s);
+	store_output(output, output_stride, row_count, column_count, s);
+}
+
+void nnp_owt6x6_3x3_with_bias_with_relu__avx2(
+	const float transform[restrict static TUPLE_ELEMENTS],
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	__m128 s[OUTPUT_SIZE];
+	owt6x6_3x3(transform, transform_stride, *bias, s);
+	for (size_t row = 0; row < OUTPUT_SIZE; row++) {
+		s[row] = _mm_max_ps(s[row], _mm_setzero_ps());
+	}
+	store_output(output, output_stride, row_count, column_count, s);
+}
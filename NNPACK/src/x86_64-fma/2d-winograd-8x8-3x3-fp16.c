@@ -0,0 +1,164 @@
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <immintrin.h>
+
+#include <nnpack/macros.h>
+#include <nnpack/activations.h>
+
+#include <scalar/winograd/f6x6k3x3.h>
+
+
+#define BLOCK_SIZE 8
+#define KERNEL_SIZE 3
+#define OUTPUT_SIZE (BLOCK_SIZE - KERNEL_SIZE + 1)
+#define TUPLE_ELEMENTS 8
+
+/*
+ * Transformed 8x8 tiles are stored in row-major order as 8 tuples of 8 IEEE half-precision elements, the tuple width
+ * of the h8gemm micro-kernel. Transforms are computed in single precision and only converted (F16C) on tuple
+ * stores and loads, so the precision loss is limited to the storage of transformed tiles.
+ */
+
+static inline void store_tuples(
+	void* transform,
+	size_t transform_stride,
+	const float tile[restrict static BLOCK_SIZE * TUPLE_ELEMENTS])
+{
+	for (size_t tuple = 0; tuple < BLOCK_SIZE; tuple++) {
+		_mm_storeu_si128((__m128i*) transform,
+			_mm256_cvtps_ph(_mm256_loadu_ps(tile), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+		transform = (void*) ((uintptr_t) transform + transform_stride);
+		tile += TUPLE_ELEMENTS;
+	}
+}
+
+static inline void load_tuples(
+	const void* transform,
+	size_t transform_stride,
+	float tile[restrict static BLOCK_SIZE * TUPLE_ELEMENTS])
+{
+	for (size_t tuple = 0; tuple < BLOCK_SIZE; tuple++) {
+		_mm256_storeu_ps(tile, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) transform)));
+		transform = (const void*) ((uintptr_t) transform + transform_stride);
+		tile += TUPLE_ELEMENTS;
+	}
+}
+
+void nnp_iwt8x8_3x3_fp16_with_offset__avx2(
+	const float data[restrict static 1],
+	void* transform,
+	size_t data_stride, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	float block[BLOCK_SIZE][BLOCK_SIZE] = { { 0.0f } };
+	for (uint32_t row = 0; row < row_count; row++) {
+		for (uint32_t column = 0; column < column_count; column++) {
+			block[row_offset + row][column_offset + column] = data[row * data_stride + column];
+		}
+	}
+
+	for (uint32_t row = 0; row < BLOCK_SIZE; row++) {
+		winograd_f6k3_input_transform(
+			block[row][0], block[row][1], block[row][2], block[row][3], block[row][4], block[row][5], block[row][6], block[row][7],
+			&block[row][0], &block[row][1], &block[row][2], &block[row][3], &block[row][4], &block[row][5], &block[row][6], &block[row][7]);
+	}
+
+	float wd[BLOCK_SIZE * TUPLE_ELEMENTS];
+	for (uint32_t column = 0; column < BLOCK_SIZE; column++) {
+		winograd_f6k3_input_transform(
+			block[0][column], block[1][column], block[2][column], block[3][column], block[4][column], block[5][column], block[6][column], block[7][column],
+			&wd[0 * BLOCK_SIZE + column], &wd[1 * BLOCK_SIZE + column], &wd[2 * BLOCK_SIZE + column], &wd[3 * BLOCK_SIZE + column],
+			&wd[4 * BLOCK_SIZE + column], &wd[5 * BLOCK_SIZE + column], &wd[6 * BLOCK_SIZE + column], &wd[7 * BLOCK_SIZE + column]);
+	}
+	store_tuples(transform, transform_stride, wd);
+}
+
+void nnp_kwt8x8_3x3_fp16__avx2(
+	const float g[restrict static 9],
+	void* transform,
+	size_t stride_g, size_t transform_stride,
+	uint32_t row_count, uint32_t column_count,
+	uint32_t row_offset, uint32_t column_offset)
+{
+	float block[KERNEL_SIZE][BLOCK_SIZE];
+	for (uint32_t row = 0; row < KERNEL_SIZE; row++) {
+		winograd_f6k3_kernel_transform(
+			g[0], g[1], g[2],
+			&block[row][0], &block[row][1], &block[row][2], &block[row][3], &block[row][4], &block[row][5], &block[row][6], &block[row][7],
+			true /* rescale coefficients */);
+		g += KERNEL_SIZE;
+	}
+
+	float wg[BLOCK_SIZE * TUPLE_ELEMENTS];
+	for (uint32_t column = 0; column < BLOCK_SIZE; column++) {
+		winograd_f6k3_kernel_transform(
+			block[0][column], block[1][column], block[2][column],
+			&wg[0 * BLOCK_SIZE + column], &wg[1 * BLOCK_SIZE + column], &wg[2 * BLOCK_SIZE + column], &wg[3 * BLOCK_SIZE + column],
+			&wg[4 * BLOCK_SIZE + column], &wg[5 * BLOCK_SIZE + column], &wg[6 * BLOCK_SIZE + column], &wg[7 * BLOCK_SIZE + column],
+			true /* rescale coefficients */);
+	}
+	store_tuples(transform, transform_stride, wg);
+}
+
+static inline void owt8x8_3x3_fp16(
+	const void* transform,
+	size_t transform_stride,
+	float bias,
+	float block[restrict static OUTPUT_SIZE][BLOCK_SIZE])
+{
+	float m[BLOCK_SIZE * TUPLE_ELEMENTS];
+	load_tuples(transform, transform_stride, m);
+	m[1 * BLOCK_SIZE + 1] += bias;
+
+	for (uint32_t column = 0; column < BLOCK_SIZE; column++) {
+		winograd_f6k3_output_transform(
+			m[0 * BLOCK_SIZE + column], m[1 * BLOCK_SIZE + column], m[2 * BLOCK_SIZE + column], m[3 * BLOCK_SIZE + column],
+			m[4 * BLOCK_SIZE + column], m[5 * BLOCK_SIZE + column], m[6 * BLOCK_SIZE + column], m[7 * BLOCK_SIZE + column],
+			&block[0][column], &block[1][column], &block[2][column], &block[3][column], &block[4][column], &block[5][column]);
+	}
+}
+
+void nnp_owt8x8_3x3_fp16_with_bias__avx2(
+	const void* transform,
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	float block[OUTPUT_SIZE][BLOCK_SIZE];
+	owt8x8_3x3_fp16(transform, transform_stride, *bias, block);
+
+	for (uint32_t row = 0; row < row_count; row++) {
+		float s[OUTPUT_SIZE];
+		winograd_f6k3_output_transform(
+			block[row][0], block[row][1], block[row][2], block[row][3], block[row][4], block[row][5], block[row][6], block[row][7],
+			&s[0], &s[1], &s[2], &s[3], &s[4], &s[5]);
+		for (uint32_t column = 0; column < column_count; column++) {
+			output[row * output_stride + column] = s[column];
+		}
+	}
+}
+
+void nnp_owt8x8_3x3_fp16_with_bias_with_relu__avx2(
+	const void* transform,
+	float output[restrict static 1],
+	const float bias[restrict static 1],
+	size_t transform_stride, size_t output_stride,
+	uint32_t row_count, uint32_t column_count)
+{
+	float block[OUTPUT_SIZE][BLOCK_SIZE];
+	owt8x8_3x3_fp16(transform, transform_stride, *bias, block);
+
+	for (uint32_t row = 0; row < row_count; row++) {
+		float s[OUTPUT_SIZE];
+		winograd_f6k3_output_transform(
+			block[row][0], block[row][1], block[row][2], block[row][3], block[row][4], block[row][5], block[row][6], block[row][7],
+			&s[0], &s[1], &s[2], &s[3], &s[4], &s[5]);
+		for (uint32_t column = 0; column < column_count; column++) {
+			output[row * output_stride + column] = relu(s[column], 0.0f);
+		}
+	}
+}
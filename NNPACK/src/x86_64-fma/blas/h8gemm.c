@@ -0,0 +1,106 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+
+/*
+ * Tuples of 8 IEEE half-precision elements are widened with F16C on load and accumulated in single precision with FMA.
+ * Only the stores of the result tuples round to half precision, as in the NEON h4gemm micro-kernels.
+ */
+static inline __m256 load_tuple(const uint16_t* tuple) {
+	return _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*) tuple));
+}
+
+static inline void store_tuple(uint16_t* tuple, __m256 value) {
+	_mm_storeu_si128((__m128i*) tuple, _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+}
+
+static inline void h8gemm_3x4(size_t k, const uint16_t* a, const uint16_t* b, __m256 acc[restrict static 3][4]) {
+	__m256 acc00 = _mm256_setzero_ps(), acc01 = _mm256_setzero_ps(), acc02 = _mm256_setzero_ps(), acc03 = _mm256_setzero_ps();
+	__m256 acc10 = _mm256_setzero_ps(), acc11 = _mm256_setzero_ps(), acc12 = _mm256_setzero_ps(), acc13 = _mm256_setzero_ps();
+	__m256 acc20 = _mm256_setzero_ps(), acc21 = _mm256_setzero_ps(), acc22 = _mm256_setzero_ps(), acc23 = _mm256_setzero_ps();
+	do {
+		const __m256 a0 = load_tuple(a +  0);
+		const __m256 a1 = load_tuple(a +  8);
+		const __m256 a2 = load_tuple(a + 16);
+		a += 3 * 8;
+
+		const __m256 b0 = load_tuple(b + 0);
+		acc00 = _mm256_fmadd_ps(a0, b0, acc00);
+		acc10 = _mm256_fmadd_ps(a1, b0, acc10);
+		acc20 = _mm256_fmadd_ps(a2, b0, acc20);
+		const __m256 b1 = load_tuple(b + 8);
+		acc01 = _mm256_fmadd_ps(a0, b1, acc01);
+		acc11 = _mm256_fmadd_ps(a1, b1, acc11);
+		acc21 = _mm256_fmadd_ps(a2, b1, acc21);
+		const __m256 b2 = load_tuple(b + 16);
+		acc02 = _mm256_fmadd_ps(a0, b2, acc02);
+		acc12 = _mm256_fmadd_ps(a1, b2, acc12);
+		acc22 = _mm256_fmadd_ps(a2, b2, acc22);
+		const __m256 b3 = load_tuple(b + 24);
+		acc03 = _mm256_fmadd_ps(a0, b3, acc03);
+		acc13 = _mm256_fmadd_ps(a1, b3, acc13);
+		acc23 = _mm256_fmadd_ps(a2, b3, acc23);
+		b += 4 * 8;
+	} while (--k);
+
+	acc[0][0] = acc00; acc[0][1] = acc01; acc[0][2] = acc02; acc[0][3] = acc03;
+	acc[1][0] = acc10; acc[1][1] = acc11; acc[1][2] = acc12; acc[1][3] = acc13;
+	acc[2][0] = acc20; acc[2][1] = acc21; acc[2][2] = acc22; acc[2][3] = acc23;
+}
+
+void nnp_h8gemm_only_3x4__avx2(
+	size_t k, size_t update,
+	const void* a, const void* b, void* c_ptr,
+	size_t row_stride_c)
+{
+	__m256 acc[3][4];
+	h8gemm_3x4(k, a, b, acc);
+
+	uint16_t* c = c_ptr;
+	for (size_t m = 0; m < 3; m++) {
+		for (size_t n = 0; n < 4; n++) {
+			__m256 vc = acc[m][n];
+			if (update != 0) {
+				vc = _mm256_add_ps(vc, load_tuple(c + n * 8));
+			}
+			store_tuple(c + n * 8, vc);
+		}
+		c += row_stride_c;
+	}
+}
+
+void nnp_h8gemm_upto_3x4__avx2(
+	uint32_t mr, uint32_t nr,
+	size_t k, size_t update,
+	const void* a_ptr, const void* b_ptr, void* c_ptr,
+	size_t row_stride_c)
+{
+	const uint16_t* a = a_ptr;
+	const uint16_t* b = b_ptr;
+
+	__m256 acc[3][4] = { { _mm256_setzero_ps() } };
+	do {
+		for (uint32_t m = 0; m < mr; m++) {
+			const __m256 va = load_tuple(a + m * 8);
+			for (uint32_t n = 0; n < nr; n++) {
+				acc[m][n] = _mm256_fmadd_ps(va, load_tuple(b + n * 8), acc[m][n]);
+			}
+		}
+		a += mr * 8;
+		b += nr * 8;
+	} while (--k);
+
+	uint16_t* c = c_ptr;
+	for (uint32_t m = 0; m < mr; m++) {
+		for (uint32_t n = 0; n < nr; n++) {
+			__m256 vc = acc[m][n];
+			if (update != 0) {
+				vc = _mm256_add_ps(vc, load_tuple(c + n * 8));
+			}
+			store_tuple(c + n * 8, vc);
+		}
+		c += row_stride_c;
+	}
+}
@@ -0,0 +1,69 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+
+/*
+ * Both operands are widened to 16 bits, and _mm256_madd_epi16 multiplies a pair of input elements of each of 8 columns
+ * by the broadcast pair of kernel elements of one row, and adds the two products into a 32-bit lane. Products of
+ * uint8 and int8 values are within [-32640, 32385], so the pairwise sums are exact.
+ */
+static inline void q8gemm_4x8(size_t k, const int8_t* a, const uint8_t* b,
+	__m256i acc[restrict static 4])
+{
+	__m256i acc0 = _mm256_setzero_si256();
+	__m256i acc1 = _mm256_setzero_si256();
+	__m256i acc2 = _mm256_setzero_si256();
+	__m256i acc3 = _mm256_setzero_si256();
+	do {
+		const __m256i vb = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*) b));
+		b += 8 * 2;
+
+		const __m256i va = _mm256_broadcastsi128_si256(_mm_cvtepi8_epi16(_mm_loadl_epi64((const __m128i*) a)));
+		a += 4 * 2;
+
+		acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(vb, _mm256_shuffle_epi32(va, _MM_SHUFFLE(0, 0, 0, 0))));
+		acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(vb, _mm256_shuffle_epi32(va, _MM_SHUFFLE(1, 1, 1, 1))));
+		acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(vb, _mm256_shuffle_epi32(va, _MM_SHUFFLE(2, 2, 2, 2))));
+		acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(vb, _mm256_shuffle_epi32(va, _MM_SHUFFLE(3, 3, 3, 3))));
+	} while (--k);
+	acc[0] = acc0;
+	acc[1] = acc1;
+	acc[2] = acc2;
+	acc[3] = acc3;
+}
+
+void nnp_q8gemm_only_4x8__avx2(size_t k, size_t update, const int8_t* a, const uint8_t* b, int32_t* c, size_t row_stride_c) {
+	__m256i acc[4];
+	q8gemm_4x8(k, a, b, acc);
+
+	for (size_t m = 0; m < 4; m++) {
+		__m256i vc = acc[m];
+		if (update) {
+			vc = _mm256_add_epi32(vc, _mm256_loadu_si256((const __m256i*) c));
+		}
+		_mm256_storeu_si256((__m256i*) c, vc);
+		c += row_stride_c;
+	}
+}
+
+void nnp_q8gemm_upto_4x8__avx2(uint32_t mr, uint32_t nr, size_t k, size_t update, const int8_t* a, const uint8_t* b, int32_t* c, size_t row_stride_c) {
+	__m256i acc[4];
+	q8gemm_4x8(k, a, b, acc);
+
+	int32_t tile[4 * 8];
+	for (size_t m = 0; m < 4; m++) {
+		_mm256_storeu_si256((__m256i*) &tile[m * 8], acc[m]);
+	}
+	for (size_t m = 0; m < mr; m++) {
+		for (size_t n = 0; n < nr; n++) {
+			if (update) {
+				c[n] += tile[m * 8 + n];
+			} else {
+				c[n] = tile[m * 8 + n];
+			}
+		}
+		c += row_stride_c;
+	}
+}
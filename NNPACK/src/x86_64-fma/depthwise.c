@@ -0,0 +1,121 @@
+#include <stddef.h>
+#include <stdint.h>
+
+#include <immintrin.h>
+
+#include <nnpack/utils.h>
+#include <nnpack/depthwise.h>
+
+
+static inline float dwconv_pixel_with_padding(
+	const float* input, const float* kernel,
+	size_t input_width, size_t input_x, uint32_t kernel_rows,
+	float bias, const uint32_t kernel_width)
+{
+	float acc = bias;
+	for (uint32_t i = 0; i < kernel_rows; i++) {
+		for (uint32_t j = 0; j < kernel_width; j++) {
+			/* Columns left of the input row wrap around to large values */
+			const size_t t = input_x + j;
+			if (t < input_width) {
+				acc += input[t] * kernel[j];
+			}
+		}
+		input += input_width;
+		kernel += kernel_width;
+	}
+	return acc;
+}
+
+static inline __m256 load_even_ps(const float* input) {
+	/* [a0 a2 b0 b2 | a4 a6 b4 b6] -> [a0 a2 a4 a6 | b0 b2 b4 b6] */
+	const __m256 even = _mm256_shuffle_ps(_mm256_loadu_ps(input), _mm256_loadu_ps(input + 8), _MM_SHUFFLE(2, 0, 2, 0));
+	return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), _MM_SHUFFLE(3, 1, 2, 0)));
+}
+
+static inline void dwconv_row(
+	const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max,
+	const uint32_t kernel_width, const uint32_t stride)
+{
+	const size_t interior_start = min(divide_round_up(padding_left, stride), output_width);
+	const size_t interior_end = depthwise_interior_end(input_width, padding_left, output_width, kernel_width, stride);
+	/* Strided loads read stride - 1 columns past the footprint of the last output in a vector */
+	const size_t vector_end = depthwise_interior_end(input_width, padding_left, output_width, kernel_width + stride - 1, stride);
+
+	size_t x = 0;
+	for (; x < interior_start; x++) {
+		const float acc = dwconv_pixel_with_padding(input, kernel,
+			input_width, x * stride - padding_left, kernel_rows, bias, kernel_width);
+		output[x] = minf(maxf(acc, output_min), output_max);
+	}
+
+	const __m256 vmin = _mm256_set1_ps(output_min);
+	const __m256 vmax = _mm256_set1_ps(output_max);
+	for (; x + 8 <= vector_end; x += 8) {
+		const float* input_row = input + (x * stride - padding_left);
+		const float* kernel_row = kernel;
+		__m256 vacc = _mm256_set1_ps(bias);
+		for (uint32_t i = 0; i < kernel_rows; i++) {
+			for (uint32_t j = 0; j < kernel_width; j++) {
+				const __m256 vi = stride == 1 ? _mm256_loadu_ps(input_row + j) : load_even_ps(input_row + j);
+				vacc = _mm256_fmadd_ps(vi, _mm256_broadcast_ss(kernel_row + j), vacc);
+			}
+			input_row += input_width;
+			kernel_row += kernel_width;
+		}
+		_mm256_storeu_ps(output + x, _mm256_min_ps(_mm256_max_ps(vacc, vmin), vmax));
+	}
+
+	for (; x < interior_end; x++) {
+		const float* input_row = input + (x * stride - padding_left);
+		const float* kernel_row = kernel;
+		float acc = bias;
+		for (uint32_t i = 0; i < kernel_rows; i++) {
+			for (uint32_t j = 0; j < kernel_width; j++) {
+				acc += input_row[j] * kernel_row[j];
+			}
+			input_row += input_width;
+			kernel_row += kernel_width;
+		}
+		output[x] = minf(maxf(acc, output_min), output_max);
+	}
+	for (; x < output_width; x++) {
+		const float acc = dwconv_pixel_with_padding(input, kernel,
+			input_width, x * stride - padding_left, kernel_rows, bias, kernel_width);
+		output[x] = minf(maxf(acc, output_min), output_max);
+	}
+}
+
+void nnp_dwconv3x3__avx2(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 3, 1);
+}
+
+void nnp_dwconv3x3s2__avx2(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 3, 2);
+}
+
+void nnp_dwconv5x5__avx2(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 5, 1);
+}
+
+void nnp_dwconv5x5s2__avx2(const float* input, const float* kernel, float* output,
+	size_t input_width, size_t padding_left, size_t output_width, uint32_t kernel_rows,
+	float bias, float output_min, float output_max)
+{
+	dwconv_row(input, kernel, output, input_width, padding_left, output_width, kernel_rows,
+		bias, output_min, output_max, 5, 2);
+}
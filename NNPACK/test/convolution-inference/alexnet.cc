@@ -33,6 +33,42 @@ TEST(IMPLICIT_GEMM_PREPACK, conv1_with_relu) {
 		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu, true);
 }
 
+TEST(FT8x8, conv1) {
+	AlexNet::conv1()
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+}
+
+TEST(FT8x8, conv1_with_relu) {
+	AlexNet::conv1()
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(FT16x16, conv1) {
+	AlexNet::conv1()
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_identity);
+}
+
+TEST(FT16x16, conv1_with_relu) {
+	AlexNet::conv1()
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_relu);
+}
+
+TEST(FT8x8_PRECOMPUTE, conv1) {
+	AlexNet::conv1()
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity, true);
+}
+
+TEST(FT16x16_PRECOMPUTE, conv1) {
+	AlexNet::conv1()
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_identity, true);
+}
+
 /*
  * AlexNet conv2 layer
  */
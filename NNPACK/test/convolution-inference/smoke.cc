@@ -1,3 +1,8 @@
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include <nnpack.h>
@@ -1780,6 +1785,2682 @@ TEST(DIRECT_1x1, odd_image_size_with_relu) {
 	}
 }
 
+/*
+ * Test that the implementation handles minibatches of multiple images
+ */
+
+TEST(FT8x8, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+	}
+}
+
+TEST(FT8x8, small_batch_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+	}
+}
+
+TEST(FT16x16, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(29, 29)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_identity);
+	}
+}
+
+TEST(FT16x16, small_batch_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(29, 29)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_relu);
+	}
+}
+
+TEST(WT8x8, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+	}
+}
+
+TEST(WT8x8, small_batch_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+	}
+}
+
+TEST(FT8x8_PRECOMPUTE, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity, true);
+	}
+}
+
+TEST(FT8x8_PRECOMPUTE, small_batch_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_relu, true);
+	}
+}
+
+TEST(FT16x16_PRECOMPUTE, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(29, 29)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_identity, true);
+	}
+}
+
+TEST(FT16x16_PRECOMPUTE, small_batch_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(29, 29)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_relu, true);
+	}
+}
+
+TEST(WT8x8_PRECOMPUTE, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity, true);
+	}
+}
+
+TEST(WT8x8_PRECOMPUTE, small_batch_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu, true);
+	}
+}
+
+TEST(IMPLICIT_GEMM, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity);
+	}
+}
+
+TEST(IMPLICIT_GEMM, small_batch_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+	}
+}
+
+TEST(IMPLICIT_GEMM_PREPACK, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity, true);
+	}
+}
+
+TEST(IMPLICIT_GEMM_PREPACK, small_batch_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu, true);
+	}
+}
+
+TEST(DIRECT_1x1, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(8, 8)
+		.kernelSize(1, 1)
+		.inputChannels(nnp_hwinfo.conv1x1.mr + 1)
+		.outputChannels(nnp_hwinfo.conv1x1.nr + 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_direct, nnp_activation_identity);
+	}
+}
+
+TEST(DIRECT_1x1, small_batch_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(8, 8)
+		.kernelSize(1, 1)
+		.inputChannels(nnp_hwinfo.conv1x1.mr + 1)
+		.outputChannels(nnp_hwinfo.conv1x1.nr + 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_direct, nnp_activation_relu);
+	}
+}
+
+/*
+ * Test that the implementation works with scratch memory from the library-owned workspace arena
+ */
+
+TEST(FT8x8, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.internalWorkspace(true)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+}
+
+TEST(FT16x16, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.internalWorkspace(true)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_identity);
+}
+
+TEST(WT8x8, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.internalWorkspace(true)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+}
+
+TEST(WT8x8_PRECOMPUTE, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.internalWorkspace(true)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity, true);
+}
+
+TEST(IMPLICIT_GEMM, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.internalWorkspace(true)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity);
+}
+
+TEST(WORKSPACE_ARENA, reserve_and_release) {
+	ASSERT_EQ(nnp_status_success, nnp_workspace_reserve(1024 * 1024));
+	ConvolutionTester tester;
+	tester.inputSize(29, 29)
+		.inputChannels(4)
+		.outputChannels(4)
+		.internalWorkspace(true)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	tester.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+	ASSERT_EQ(nnp_status_success, nnp_workspace_release());
+	tester.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_identity);
+	ASSERT_EQ(nnp_status_success, nnp_workspace_release());
+}
+
+TEST(WORKSPACE_ARENA, concurrent_growth) {
+	ASSERT_EQ(nnp_status_success, nnp_workspace_release());
+	std::vector<std::thread> threads;
+	for (size_t thread = 0; thread < 4; thread++) {
+		threads.emplace_back([thread]() {
+			/* Every thread grows its slab several times while the others run on theirs */
+			for (size_t size = 9 + thread; size <= 57; size += 16) {
+				EXPECT_EQ(nnp_status_success, nnp_workspace_reserve(size * size * 1024));
+				ConvolutionTester tester;
+				tester.inputSize(size, size)
+					.inputChannels(4)
+					.outputChannels(4)
+					.internalWorkspace(true)
+					.iterations(3)
+					.errorLimit(1.0e-3);
+				tester.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+			}
+		});
+	}
+	for (std::thread& thread : threads) {
+		thread.join();
+	}
+	ASSERT_EQ(nnp_status_success, nnp_workspace_release());
+}
+
+/*
+ * Test that convolution plans compute the same results as one-shot calls
+ */
+
+TEST(FT8x8, plan) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInferencePlan(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+	}
+}
+
+TEST(FT16x16, plan) {
+	ConvolutionTester tester;
+	tester.inputSize(29, 29)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInferencePlan(nnp_convolution_algorithm_ft16x16, nnp_activation_identity);
+	}
+}
+
+TEST(WT8x8, plan) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInferencePlan(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+	}
+}
+
+TEST(WT8x8, plan_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferencePlan(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM, plan) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInferencePlan(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity);
+	}
+}
+
+TEST(IMPLICIT_GEMM, plan_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferencePlan(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(DIRECT_1x1, plan) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInferencePlan(nnp_convolution_algorithm_direct, nnp_activation_identity);
+	}
+}
+
+TEST(AUTO, plan) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferencePlan(nnp_convolution_algorithm_auto, nnp_activation_identity);
+}
+
+/*
+ * Test that Winograd transforms with 4x4 and 6x6 tiles work for small feature maps
+ */
+
+TEST(WT4x4, single_tile) {
+	ConvolutionTester()
+		.inputSize(4, 4)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt4x4, nnp_activation_identity);
+}
+
+TEST(WT4x4, single_tile_with_relu) {
+	ConvolutionTester()
+		.inputSize(4, 4)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt4x4, nnp_activation_relu);
+}
+
+TEST(WT4x4, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt4x4, nnp_activation_identity);
+}
+
+TEST(WT4x4, multi_tile_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt4x4, nnp_activation_relu);
+}
+
+TEST(WT4x4, implicit_padding) {
+	ConvolutionTester tester;
+	tester.inputSize(7, 7)
+		.kernelSize(3, 3)
+		.iterations(15)
+		.errorLimit(1.0e-3);
+	for (size_t padding = 0; padding < tester.kernelHeight(); padding++) {
+		tester.inputPadding(padding, padding, padding, padding)
+			.testInference(nnp_convolution_algorithm_wt4x4, nnp_activation_identity);
+	}
+}
+
+TEST(WT4x4, few_channels) {
+	ConvolutionTester()
+		.inputSize(5, 5)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt4x4, nnp_activation_identity);
+}
+
+TEST(WT4x4_PRECOMPUTE, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt4x4, nnp_activation_identity, true);
+}
+
+TEST(WT4x4, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(9, 9)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_wt4x4, nnp_activation_identity);
+	}
+}
+
+TEST(WT4x4, plan) {
+	ConvolutionTester tester;
+	tester.inputSize(9, 9)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInferencePlan(nnp_convolution_algorithm_wt4x4, nnp_activation_relu);
+	}
+}
+
+TEST(WT6x6, single_tile) {
+	ConvolutionTester()
+		.inputSize(6, 6)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_identity);
+}
+
+TEST(WT6x6, single_tile_with_relu) {
+	ConvolutionTester()
+		.inputSize(6, 6)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_relu);
+}
+
+TEST(WT6x6, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_identity);
+}
+
+TEST(WT6x6, multi_tile_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_relu);
+}
+
+TEST(WT6x6, implicit_padding) {
+	ConvolutionTester tester;
+	tester.inputSize(7, 7)
+		.kernelSize(3, 3)
+		.iterations(15)
+		.errorLimit(1.0e-3);
+	for (size_t padding = 0; padding < tester.kernelHeight(); padding++) {
+		tester.inputPadding(padding, padding, padding, padding)
+			.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_identity);
+	}
+}
+
+TEST(WT6x6, few_channels) {
+	ConvolutionTester()
+		.inputSize(5, 5)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_identity);
+}
+
+TEST(WT6x6_PRECOMPUTE, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.iterations(100)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_identity, true);
+}
+
+TEST(WT6x6, small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(9, 9)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 2; batchSize <= 5; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_identity);
+	}
+}
+
+TEST(WT6x6, plan) {
+	ConvolutionTester tester;
+	tester.inputSize(9, 9)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInferencePlan(nnp_convolution_algorithm_wt6x6, nnp_activation_relu);
+	}
+}
+
+TEST(WT4x4, subsample2x2_unsupported) {
+	const struct nnp_size inputSize = { 8, 8 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 2, 2 };
+	size_t workspaceSize = 0;
+	EXPECT_EQ(nnp_status_unsupported_algorithm,
+		nnp_convolution_inference(
+			nnp_convolution_algorithm_wt4x4, nnp_convolution_transform_strategy_compute,
+			1, 1, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+}
+
+/*
+ * Test strided convolutions with Fourier transform algorithms (polyphase decomposition)
+ */
+
+TEST(FT8x8, subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(19, 19)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+}
+
+TEST(FT8x8, subsample2x2_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(24, 24)
+		.kernelSize(7, 7)
+		.inputPadding(3, 3, 3, 3)
+		.outputSubsampling(2, 2)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(FT8x8, subsample_anisotropic) {
+	ConvolutionTester tester;
+	tester.inputSize(21, 17)
+		.kernelSize(6, 4)
+		.inputPadding(1, 2, 3, 0)
+		.outputSubsampling(3, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+}
+
+TEST(FT8x8, subsample2x2_groups) {
+	ConvolutionTester tester;
+	tester.inputSize(19, 19)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(2, 2)
+		.groups(2)
+		.inputChannels(6)
+		.outputChannels(10)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+}
+
+TEST(FT8x8, subsample2x2_plan) {
+	ConvolutionTester tester;
+	tester.inputSize(19, 19)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(2, 2)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInferencePlan(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(FT8x8_PRECOMPUTE, subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(19, 19)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity, true);
+}
+
+TEST(FT16x16, subsample4x4) {
+	ConvolutionTester tester;
+	tester.inputSize(47, 47)
+		.kernelSize(11, 11)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(4, 4)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_identity);
+}
+
+TEST(FT16x16_PRECOMPUTE, subsample4x4_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(47, 47)
+		.kernelSize(11, 11)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(4, 4)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_relu, true);
+}
+
+TEST(AUTO, subsample2x2_plan) {
+	ConvolutionTester tester;
+	tester.inputSize(19, 19)
+		.kernelSize(7, 7)
+		.inputPadding(3, 3, 3, 3)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInferencePlan(nnp_convolution_algorithm_auto, nnp_activation_identity);
+}
+
+TEST(FT8x8, subsample_kernel_too_large) {
+	const struct nnp_size inputSize = { 32, 32 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 17, 17 };
+	const struct nnp_size outputSubsampling = { 2, 2 };
+	size_t workspaceSize = 0;
+	EXPECT_EQ(nnp_status_unsupported_algorithm,
+		nnp_convolution_inference(
+			nnp_convolution_algorithm_ft8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+}
+
+/*
+ * Test that tuned algorithm choices are cached, used by plans, and persisted in tuning files
+ */
+
+static enum nnp_convolution_algorithm planAlgorithm(
+	size_t channels, struct nnp_size inputSize, struct nnp_padding inputPadding, struct nnp_size kernelSize)
+{
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	std::vector<float> kernel(channels * channels * kernelSize.width * kernelSize.height);
+	std::vector<float> bias(channels);
+	nnp_convolution_plan_t plan = nullptr;
+	enum nnp_status status = nnp_convolution_plan_create(
+		nnp_convolution_algorithm_auto,
+		1, channels, channels,
+		inputSize, inputPadding, kernelSize, outputSubsampling,
+		kernel.data(), bias.data(),
+		nnp_activation_identity, nullptr,
+		nullptr, &plan);
+	EXPECT_EQ(nnp_status_success, status);
+	const enum nnp_convolution_algorithm algorithm = nnp_convolution_plan_get_algorithm(plan);
+	nnp_convolution_plan_destroy(plan);
+	return algorithm;
+}
+
+TEST(AUTOTUNE, tune_and_plan) {
+	const struct nnp_size inputSize = { 13, 13 };
+	const struct nnp_padding inputPadding = { 1, 1, 1, 1 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+
+	enum nnp_convolution_algorithm algorithm = nnp_convolution_algorithm_auto;
+	enum nnp_convolution_transform_strategy transformStrategy = nnp_convolution_transform_strategy_precompute;
+	ASSERT_EQ(nnp_status_success,
+		nnp_convolution_autotune(1, 4, 4, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nnp_activation_identity, nullptr, &algorithm, &transformStrategy));
+	ASSERT_NE(nnp_convolution_algorithm_auto, algorithm);
+	ASSERT_NE(nnp_convolution_algorithm_direct, algorithm);
+	ASSERT_TRUE(transformStrategy == nnp_convolution_transform_strategy_compute ||
+		transformStrategy == nnp_convolution_transform_strategy_reuse);
+	EXPECT_EQ(algorithm, planAlgorithm(4, inputSize, inputPadding, kernelSize));
+
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(4)
+		.outputChannels(4)
+		.multithreading(false)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferencePlan(nnp_convolution_algorithm_auto, nnp_activation_identity);
+
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+}
+
+TEST(AUTOTUNE, measure_mode) {
+	const struct nnp_size inputSize = { 9, 9 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 5, 5 };
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+
+	ASSERT_EQ(nnp_status_success, nnp_autotune_set_mode(nnp_autotune_mode_measure));
+	const enum nnp_convolution_algorithm measuredAlgorithm = planAlgorithm(3, inputSize, inputPadding, kernelSize);
+	ASSERT_EQ(nnp_status_success, nnp_autotune_set_mode(nnp_autotune_mode_cached));
+	EXPECT_NE(nnp_convolution_algorithm_auto, measuredAlgorithm);
+	EXPECT_NE(nnp_convolution_algorithm_wt8x8, measuredAlgorithm);
+
+	/* The measured choice is cached, and a plan for the same shape does not tune again */
+	EXPECT_EQ(measuredAlgorithm, planAlgorithm(3, inputSize, inputPadding, kernelSize));
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+}
+
+TEST(AUTOTUNE, save_and_load) {
+	const struct nnp_size inputSize = { 13, 13 };
+	const struct nnp_padding inputPadding = { 1, 1, 1, 1 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	const std::string path = testing::TempDir() + "nnpack-tuning-smoketest.txt";
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+
+	enum nnp_convolution_algorithm algorithm = nnp_convolution_algorithm_auto;
+	ASSERT_EQ(nnp_status_success,
+		nnp_convolution_autotune(1, 2, 2, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nnp_activation_identity, nullptr, &algorithm, nullptr));
+	ASSERT_EQ(nnp_status_success, nnp_autotune_save(path.c_str()));
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+
+	ASSERT_EQ(nnp_status_success, nnp_autotune_load(path.c_str()));
+	EXPECT_EQ(algorithm, planAlgorithm(2, inputSize, inputPadding, kernelSize));
+
+	/* Tuned choices are ignored when autotuning is disabled */
+	ASSERT_EQ(nnp_status_success, nnp_autotune_set_mode(nnp_autotune_mode_disabled));
+	EXPECT_EQ(nnp_convolution_algorithm_wt8x8, planAlgorithm(2, inputSize, inputPadding, kernelSize));
+	ASSERT_EQ(nnp_status_success, nnp_autotune_set_mode(nnp_autotune_mode_cached));
+
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+	std::remove(path.c_str());
+}
+
+TEST(AUTOTUNE, malformed_file) {
+	const std::string path = testing::TempDir() + "nnpack-tuning-malformed.txt";
+	std::FILE* file = std::fopen(path.c_str(), "w");
+	ASSERT_NE(nullptr, file);
+	std::fputs("# NNPACK convolution tuning file\n1 2 2 13 13 1 1 1 1 3 3 1 1 identity 1 wt9x9 reuse\n", file);
+	std::fclose(file);
+
+	EXPECT_EQ(nnp_status_invalid_file_format, nnp_autotune_load(path.c_str()));
+	EXPECT_EQ(nnp_status_io_error, nnp_autotune_load((path + ".missing").c_str()));
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+	std::remove(path.c_str());
+}
+
+TEST(AUTO, small_feature_maps) {
+	const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+
+	EXPECT_EQ(nnp_convolution_algorithm_wt4x4, planAlgorithm(4, nnp_size{ 4, 4 }, noPadding, kernelSize));
+	EXPECT_EQ(nnp_convolution_algorithm_wt6x6, planAlgorithm(4, nnp_size{ 9, 9 }, noPadding, kernelSize));
+	EXPECT_EQ(nnp_convolution_algorithm_wt8x8, planAlgorithm(4, nnp_size{ 30, 30 }, noPadding, kernelSize));
+}
+
+/*
+ * Test that one-shot calls with the compute transform strategy reuse kernel transforms from the kernel cache
+ */
+
+TEST(KERNEL_CACHE, wt8x8) {
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(16 * 1024 * 1024));
+	/* Every iteration writes a new kernel into the same buffer, which must not hit the previous transform */
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_wt8x8);
+	struct nnp_kernel_cache_stats stats = { 0 };
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_get_stats(&stats));
+	EXPECT_GE(stats.misses, 10);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(0));
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+}
+
+TEST(KERNEL_CACHE, ft16x16) {
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(16 * 1024 * 1024));
+	ConvolutionTester()
+		.inputSize(19, 19)
+		.kernelSize(5, 5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(0));
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+}
+
+TEST(KERNEL_CACHE, implicit_gemm) {
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(16 * 1024 * 1024));
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(0));
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+}
+
+/* Runs a 3x3 convolution of 4 channels of 13x13 images into 6 channels */
+static std::vector<float> cachedInference(
+	enum nnp_convolution_algorithm algorithm,
+	const std::vector<float>& input,
+	const std::vector<float>& kernel)
+{
+	const struct nnp_size inputSize = { 13, 13 };
+	const struct nnp_padding inputPadding = { 1, 1, 1, 1 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	const std::vector<float> bias(6, 0.5f);
+	std::vector<float> output(6 * 13 * 13, nanf(""));
+	EXPECT_EQ(nnp_status_success,
+		nnp_convolution_inference(algorithm, nnp_convolution_transform_strategy_compute,
+			4, 6, inputSize, inputPadding, kernelSize, outputSubsampling,
+			input.data(), kernel.data(), bias.data(), output.data(), nullptr, nullptr,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+	return output;
+}
+
+static size_t transformedKernelSize(enum nnp_convolution_algorithm algorithm) {
+	const struct nnp_size inputSize = { 13, 13 };
+	const struct nnp_padding inputPadding = { 1, 1, 1, 1 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	size_t transformedKernelSize = 0;
+	EXPECT_EQ(nnp_status_success,
+		nnp_convolution_inference(algorithm, nnp_convolution_transform_strategy_precompute,
+			4, 6, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &transformedKernelSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+	return transformedKernelSize;
+}
+
+static std::vector<float> randomVector(size_t size, uint_fast32_t seed) {
+	auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+	std::vector<float> vector(size);
+	std::generate(vector.begin(), vector.end(), std::ref(rng));
+	return vector;
+}
+
+TEST(KERNEL_CACHE, hit) {
+	const std::vector<float> input = randomVector(4 * 13 * 13, 1);
+	const std::vector<float> kernel = randomVector(6 * 4 * 3 * 3, 2);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+	const std::vector<float> referenceOutput = cachedInference(nnp_convolution_algorithm_wt8x8, input, kernel);
+
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(16 * 1024 * 1024));
+	EXPECT_EQ(referenceOutput, cachedInference(nnp_convolution_algorithm_wt8x8, input, kernel));
+	EXPECT_EQ(referenceOutput, cachedInference(nnp_convolution_algorithm_wt8x8, input, kernel));
+	struct nnp_kernel_cache_stats stats = { 0 };
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_get_stats(&stats));
+	EXPECT_EQ(1, stats.misses);
+	EXPECT_EQ(1, stats.hits);
+	EXPECT_EQ(0, stats.evictions);
+	EXPECT_EQ(1, stats.entries);
+	EXPECT_EQ(transformedKernelSize(nnp_convolution_algorithm_wt8x8), stats.size);
+
+	/* Another algorithm has a different transform of the same kernel */
+	cachedInference(nnp_convolution_algorithm_ft8x8, input, kernel);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_get_stats(&stats));
+	EXPECT_EQ(2, stats.misses);
+	EXPECT_EQ(2, stats.entries);
+
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(0));
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_get_stats(&stats));
+	EXPECT_EQ(0, stats.entries);
+	EXPECT_EQ(0, stats.size);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+}
+
+TEST(KERNEL_CACHE, kernel_updated_in_place) {
+	const std::vector<float> input = randomVector(4 * 13 * 13, 3);
+	std::vector<float> kernel = randomVector(6 * 4 * 3 * 3, 4);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(16 * 1024 * 1024));
+	cachedInference(nnp_convolution_algorithm_wt8x8, input, kernel);
+
+	kernel[0] += 1.0f;
+	const std::vector<float> output = cachedInference(nnp_convolution_algorithm_wt8x8, input, kernel);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(0));
+	EXPECT_EQ(cachedInference(nnp_convolution_algorithm_wt8x8, input, kernel), output);
+
+	struct nnp_kernel_cache_stats stats = { 0 };
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_get_stats(&stats));
+	EXPECT_EQ(0, stats.hits);
+	EXPECT_EQ(2, stats.misses);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+}
+
+TEST(KERNEL_CACHE, lru_eviction) {
+	const std::vector<float> input = randomVector(4 * 13 * 13, 5);
+	const std::vector<float> kernelA = randomVector(6 * 4 * 3 * 3, 6);
+	const std::vector<float> kernelB = randomVector(6 * 4 * 3 * 3, 7);
+	const std::vector<float> kernelC = randomVector(6 * 4 * 3 * 3, 8);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+
+	/* Room for two transforms: using A after B makes B the least recently used one, which C evicts */
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(2 * transformedKernelSize(nnp_convolution_algorithm_wt8x8)));
+	cachedInference(nnp_convolution_algorithm_wt8x8, input, kernelA);
+	cachedInference(nnp_convolution_algorithm_wt8x8, input, kernelB);
+	cachedInference(nnp_convolution_algorithm_wt8x8, input, kernelA);
+	cachedInference(nnp_convolution_algorithm_wt8x8, input, kernelC);
+	cachedInference(nnp_convolution_algorithm_wt8x8, input, kernelA);
+
+	struct nnp_kernel_cache_stats stats = { 0 };
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_get_stats(&stats));
+	EXPECT_EQ(2, stats.hits);
+	EXPECT_EQ(3, stats.misses);
+	EXPECT_EQ(1, stats.evictions);
+	EXPECT_EQ(2, stats.entries);
+
+	cachedInference(nnp_convolution_algorithm_wt8x8, input, kernelB);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_get_stats(&stats));
+	EXPECT_EQ(4, stats.misses);
+	EXPECT_EQ(2, stats.evictions);
+
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(0));
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+}
+
+TEST(KERNEL_CACHE, over_budget) {
+	const std::vector<float> input = randomVector(4 * 13 * 13, 9);
+	const std::vector<float> kernel = randomVector(6 * 4 * 3 * 3, 10);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+	const std::vector<float> referenceOutput = cachedInference(nnp_convolution_algorithm_wt8x8, input, kernel);
+
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(transformedKernelSize(nnp_convolution_algorithm_wt8x8) - 1));
+	EXPECT_EQ(referenceOutput, cachedInference(nnp_convolution_algorithm_wt8x8, input, kernel));
+
+	struct nnp_kernel_cache_stats stats = { 0 };
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_get_stats(&stats));
+	EXPECT_EQ(0, stats.entries);
+	EXPECT_EQ(0, stats.size);
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_set_budget(0));
+	ASSERT_EQ(nnp_status_success, nnp_kernel_cache_reset());
+}
+
+/*
+ * Test that grouped convolution computes every group from its own input channels
+ */
+
+TEST(FT8x8, groups) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * 3)
+			.outputChannels(groups * 5)
+			.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+	}
+}
+
+TEST(FT16x16, groups_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(29, 29)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * 3)
+			.outputChannels(groups * 5)
+			.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_relu);
+	}
+}
+
+TEST(WT8x8, groups) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * 3)
+			.outputChannels(groups * 5)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+	}
+}
+
+TEST(WT8x8, groups_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * 3)
+			.outputChannels(groups * 5)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+	}
+}
+
+TEST(WT8x8_PRECOMPUTE, groups) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * 3)
+			.outputChannels(groups * 5)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity, true);
+	}
+}
+
+TEST(WT8x8, groups_wide) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.groups(2)
+		.inputChannels(2 * 17)
+		.outputChannels(2 * (nnp_hwinfo.sxgemm.nr * 2 + 1))
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+}
+
+TEST(WT8x8, groups_small_batch) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.groups(3)
+		.inputChannels(6)
+		.outputChannels(9)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 2; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+	}
+}
+
+TEST(WT6x6, groups) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.groups(4)
+		.inputChannels(8)
+		.outputChannels(12)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_identity);
+}
+
+TEST(IMPLICIT_GEMM, groups) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * 3)
+			.outputChannels(groups * 5)
+			.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity);
+	}
+}
+
+TEST(IMPLICIT_GEMM, groups_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * 3)
+			.outputChannels(groups * 5)
+			.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+	}
+}
+
+TEST(IMPLICIT_GEMM, groups_with_subsampling) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.outputSubsampling(2, 2)
+		.groups(3)
+		.inputChannels(6)
+		.outputChannels(9)
+		.batchSize(2)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity);
+}
+
+TEST(IMPLICIT_GEMM_PREPACK, groups) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * 3)
+			.outputChannels(groups * 5)
+			.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity, true);
+	}
+}
+
+TEST(DIRECT_1x1, groups) {
+	ConvolutionTester tester;
+	tester.inputSize(8, 8)
+		.kernelSize(1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * (nnp_hwinfo.conv1x1.mr + 1))
+			.outputChannels(groups * (nnp_hwinfo.conv1x1.nr + 1))
+			.testInference(nnp_convolution_algorithm_direct, nnp_activation_identity);
+	}
+}
+
+TEST(DIRECT_1x1, groups_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(8, 8)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * (nnp_hwinfo.conv1x1.mr + 1))
+			.outputChannels(groups * (nnp_hwinfo.conv1x1.nr + 1))
+			.testInference(nnp_convolution_algorithm_direct, nnp_activation_relu);
+	}
+}
+
+/*
+ * Test direct 1x1 convolution on the packed GEMM engine: layers which exceed L2 cache, and strided layers
+ */
+
+TEST(DIRECT_1x1, large_input) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.kernelSize(1, 1)
+		.inputChannels(nnp_hwinfo.blocking.l2 / (16 * 16 * sizeof(float)) + 1)
+		.outputChannels(nnp_hwinfo.conv1x1.nr * 2 + 1)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_direct, nnp_activation_identity);
+}
+
+TEST(DIRECT_1x1, large_input_with_relu) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(nnp_hwinfo.blocking.l2 / (16 * 16 * sizeof(float)) + 1)
+		.outputChannels(nnp_hwinfo.conv1x1.nr * 2 + 1)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_direct, nnp_activation_relu);
+}
+
+TEST(DIRECT_1x1, subsample2x2) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(nnp_hwinfo.conv1x1.mr * 3 + 1)
+		.outputChannels(nnp_hwinfo.conv1x1.nr * 3 + 1)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInference(nnp_convolution_algorithm_direct, nnp_activation_identity);
+	}
+}
+
+TEST(DIRECT_1x1, subsample2x2_with_relu) {
+	ConvolutionTester()
+		.inputSize(14, 14)
+		.kernelSize(1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(nnp_hwinfo.conv1x1.mr * 3 + 1)
+		.outputChannels(nnp_hwinfo.conv1x1.nr * 3 + 1)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_direct, nnp_activation_relu);
+}
+
+TEST(DIRECT_1x1, subsample_anisotropic) {
+	ConvolutionTester()
+		.inputSize(11, 13)
+		.kernelSize(1, 1)
+		.outputSubsampling(3, 2)
+		.inputChannels(5)
+		.outputChannels(7)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_direct, nnp_activation_identity);
+}
+
+TEST(DIRECT_1x1, subsample2x2_groups) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.outputSubsampling(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t groups = 2; groups <= 4; groups++) {
+		tester.groups(groups)
+			.inputChannels(groups * (nnp_hwinfo.conv1x1.mr + 1))
+			.outputChannels(groups * (nnp_hwinfo.conv1x1.nr + 1))
+			.testInference(nnp_convolution_algorithm_direct, nnp_activation_relu);
+	}
+}
+
+TEST(DIRECT_1x1, subsample2x2_plan) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(nnp_hwinfo.conv1x1.mr * 3 + 1)
+		.outputChannels(nnp_hwinfo.conv1x1.nr * 3 + 1)
+		.iterations(3)
+		.errorLimit(1.0e-5);
+	for (size_t batchSize = 1; batchSize <= 3; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInferencePlan(nnp_convolution_algorithm_direct, nnp_activation_relu);
+	}
+}
+
+TEST(AUTO, subsample2x2_1x1_plan) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(5)
+		.outputChannels(7)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInferencePlan(nnp_convolution_algorithm_auto, nnp_activation_identity);
+}
+
+TEST(IMPLICIT_GEMM, pointwise) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.inputChannels(17)
+		.outputChannels(19)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t subsampling = 1; subsampling <= 3; subsampling++) {
+		tester.outputSubsampling(subsampling, subsampling)
+			.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+	}
+}
+
+TEST(WT8x8, groups_plan) {
+	ConvolutionTester tester;
+	tester.inputSize(13, 13)
+		.groups(4)
+		.inputChannels(8)
+		.outputChannels(12)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t batchSize = 1; batchSize <= 2; batchSize++) {
+		tester.batchSize(batchSize)
+			.testInferencePlan(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+	}
+}
+
+TEST(IMPLICIT_GEMM, groups_plan) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.groups(4)
+		.inputChannels(8)
+		.outputChannels(12)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferencePlan(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(AUTO, groups_plan) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.groups(4)
+		.inputChannels(8)
+		.outputChannels(12)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferencePlan(nnp_convolution_algorithm_auto, nnp_activation_identity);
+}
+
+TEST(GROUPS, invalid_groups) {
+	const struct nnp_size inputSize = { 8, 8 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	size_t workspaceSize = 0;
+	EXPECT_EQ(nnp_status_invalid_groups,
+		nnp_convolution_inference_grouped(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 0, 4, 4, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+	EXPECT_EQ(nnp_status_invalid_groups,
+		nnp_convolution_inference_grouped(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 2, 3, 4, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+	EXPECT_EQ(nnp_status_invalid_groups,
+		nnp_convolution_inference_grouped(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 2, 4, 3, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+}
+
+TEST(FT8x8, dilation) {
+	ConvolutionTester tester;
+	tester.inputSize(19, 19)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_identity);
+}
+
+TEST(FT16x16, dilation_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(29, 29)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(3, 3)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_relu);
+}
+
+TEST(WT8x8, dilation) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(2, 2, 2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-3);
+	for (size_t dilation = 2; dilation <= 4; dilation++) {
+		tester.kernelDilation(dilation, dilation)
+			.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+	}
+}
+
+TEST(WT8x8, dilation_anisotropic) {
+	ConvolutionTester tester;
+	tester.inputSize(15, 22)
+		.inputPadding(1, 3, 2, 5)
+		.kernelDilation(2, 3)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+}
+
+TEST(WT8x8, dilation_with_relu) {
+	ConvolutionTester tester;
+	tester.inputSize(20, 20)
+		.inputPadding(4, 4, 4, 4)
+		.kernelDilation(4, 4)
+		.batchSize(3)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8, dilation_groups) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(2, 2)
+		.groups(2)
+		.inputChannels(6)
+		.outputChannels(10)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity);
+}
+
+TEST(WT8x8, dilation_plan) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(2, 2)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(3)
+		.errorLimit(1.0e-3)
+		.testInferencePlan(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8_PRECOMPUTE, dilation) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_identity, true);
+}
+
+TEST(WT6x6, dilation) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt6x6, nnp_activation_identity);
+}
+
+TEST(IMPLICIT_GEMM, dilation) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(2, 2, 2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5);
+	for (size_t dilation = 2; dilation <= 4; dilation++) {
+		tester.kernelDilation(dilation, dilation)
+			.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity);
+	}
+}
+
+TEST(IMPLICIT_GEMM, dilation_with_subsampling) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(2, 2)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM, dilation_plan) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(2, 3)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInferencePlan(nnp_convolution_algorithm_implicit_gemm, nnp_activation_identity);
+}
+
+TEST(AUTO, dilation_plan) {
+	ConvolutionTester tester;
+	tester.inputSize(17, 17)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(3)
+		.errorLimit(1.0e-3)
+		.testInferencePlan(nnp_convolution_algorithm_auto, nnp_activation_identity);
+}
+
+TEST(DILATION, invalid_kernel_dilation) {
+	const struct nnp_size inputSize = { 8, 8 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	size_t workspaceSize = 0;
+	EXPECT_EQ(nnp_status_invalid_kernel_dilation,
+		nnp_convolution_inference_dilated(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 4, 4, inputSize, inputPadding, kernelSize, nnp_size { 0, 1 }, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+	/* Padding is limited by the dilated kernel size */
+	EXPECT_EQ(nnp_status_success,
+		nnp_convolution_inference_dilated(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 4, 4, inputSize, nnp_padding { 4, 4, 4, 4 }, kernelSize, nnp_size { 2, 2 }, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+	EXPECT_EQ(nnp_status_invalid_input_padding,
+		nnp_convolution_inference_dilated(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 4, 4, inputSize, nnp_padding { 5, 5, 5, 5 }, kernelSize, nnp_size { 2, 2 }, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+	/* Phases of a strided dilated convolution are not dense convolutions */
+	EXPECT_EQ(nnp_status_unsupported_algorithm,
+		nnp_convolution_inference_dilated(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 4, 4, inputSize, inputPadding, kernelSize, nnp_size { 2, 2 }, nnp_size { 2, 2 },
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+}
+
+TEST(WT8x8_NHWC, multi_tile) {
+	ConvolutionTester()
+		.inputSize(19, 15)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(7)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_wt8x8);
+}
+
+TEST(WT8x8_NHWC, multi_tile_with_relu) {
+	ConvolutionTester()
+		.inputSize(19, 15)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(7)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+#if NNP_BACKEND_ARM
+TEST(WT8x8_NHWC, multi_tile_with_subsample2x2) {
+	ConvolutionTester()
+		.inputSize(17, 19)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(4)
+		.outputChannels(6)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_wt8x8);
+}
+#endif
+
+TEST(WT8x8_NHWC, batch_with_groups) {
+	ConvolutionTester()
+		.batchSize(2)
+		.groups(2)
+		.inputSize(13, 13)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(6)
+		.outputChannels(8)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT6x6_NHWC, multi_tile) {
+	ConvolutionTester()
+		.inputSize(11, 13)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(5)
+		.outputChannels(3)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_wt6x6);
+}
+
+TEST(FT8x8_NHWC, multi_tile) {
+	ConvolutionTester()
+		.inputSize(17, 19)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(FT16x16_NHWC, multi_tile) {
+	ConvolutionTester()
+		.inputSize(29, 31)
+		.kernelSize(7, 7)
+		.inputPadding(3, 3, 3, 3)
+		.inputChannels(3)
+		.outputChannels(4)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_ft16x16);
+}
+
+TEST(IMPLICIT_GEMM_NHWC, multi_tile) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(9)
+		.outputChannels(11)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM_NHWC, subsample2x2) {
+	ConvolutionTester()
+		.inputSize(15, 17)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(10)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM_NHWC, dilation2x2_groups) {
+	ConvolutionTester()
+		.groups(2)
+		.inputSize(16, 14)
+		.kernelSize(3, 3)
+		.kernelDilation(2, 2)
+		.inputPadding(2, 2, 2, 2)
+		.inputChannels(4)
+		.outputChannels(6)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM_NHWC, large_reduction) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(300)
+		.outputChannels(19)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(DIRECT_1x1_NHWC, pointwise) {
+	ConvolutionTester()
+		.inputSize(12, 10)
+		.kernelSize(1, 1)
+		.inputChannels(17)
+		.outputChannels(13)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_direct, nnp_activation_relu);
+}
+
+TEST(DIRECT_1x1_NHWC, subsample2x2) {
+	ConvolutionTester()
+		.inputSize(12, 11)
+		.kernelSize(1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(8)
+		.outputChannels(12)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_direct);
+}
+
+TEST(AUTO_NHWC, strided_large_kernel) {
+	ConvolutionTester()
+		.inputSize(23, 23)
+		.kernelSize(7, 7)
+		.inputPadding(3, 3, 3, 3)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(8)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_auto, nnp_activation_relu);
+}
+
+TEST(AUTO_NHWC, dilation2x2) {
+	ConvolutionTester()
+		.inputSize(18, 18)
+		.kernelSize(3, 3)
+		.kernelDilation(2, 2)
+		.inputPadding(2, 2, 2, 2)
+		.inputChannels(5)
+		.outputChannels(7)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_auto);
+}
+
+TEST(NHWC, unsupported_polyphase_algorithms) {
+	const struct nnp_size inputSize = { 16, 16 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	size_t workspaceSize = 0;
+	/* Strided FFT and dilated tiled convolutions are decomposed into phases of planar tensors */
+	EXPECT_EQ(nnp_status_unsupported_algorithm,
+		nnp_convolution_inference_nhwc(
+			nnp_convolution_algorithm_ft8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 4, 4, inputSize, inputPadding, nnp_size { 5, 5 }, nnp_size { 1, 1 }, nnp_size { 2, 2 },
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+	EXPECT_EQ(nnp_status_unsupported_algorithm,
+		nnp_convolution_inference_nhwc(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 4, 4, inputSize, inputPadding, nnp_size { 3, 3 }, nnp_size { 2, 2 }, nnp_size { 1, 1 },
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+}
+
+/*
+ * Test that parameterized activations (leaky ReLU, ReLU6, clamp) are applied by output transforms and epilogues
+ */
+
+TEST(WT8x8, multi_tile_with_leaky_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.reluNegativeSlope(0.25f)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8, multi_tile_with_relu6) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(16)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu6);
+}
+
+TEST(WT8x8_PRECOMPUTE, multi_tile_with_clamp) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(8)
+		.outputChannels(5)
+		.clampRange(0.5f, 3.0f)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_clamp, true);
+}
+
+TEST(FT8x8, multi_tile_with_clamp) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(8)
+		.outputChannels(5)
+		.clampRange(0.5f, 3.0f)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_clamp);
+}
+
+TEST(FT16x16, multi_tile_with_leaky_relu) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.inputChannels(3)
+		.outputChannels(5)
+		.reluNegativeSlope(0.25f)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft16x16, nnp_activation_relu);
+}
+
+TEST(FT8x8, strided_with_relu6) {
+	ConvolutionTester()
+		.inputSize(17, 17)
+		.kernelSize(5, 5)
+		.outputSubsampling(2, 2)
+		.inputChannels(16)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_ft8x8, nnp_activation_relu6);
+}
+
+TEST(IMPLICIT_GEMM, with_leaky_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.inputPadding(1, 1, 1, 1)
+		.reluNegativeSlope(0.25f)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM, many_channels_with_clamp) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.inputChannels(160)
+		.outputChannels(19)
+		.inputPadding(1, 1, 1, 1)
+		.clampRange(-1.0f, 20.0f)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_implicit_gemm, nnp_activation_clamp);
+}
+
+TEST(DIRECT_1x1, with_relu6) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.inputChannels(32)
+		.outputChannels(17)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInference(nnp_convolution_algorithm_direct, nnp_activation_relu6);
+}
+
+TEST(DIRECT_1x1, plan_with_leaky_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.inputChannels(7)
+		.outputChannels(9)
+		.reluNegativeSlope(0.5f)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testInferencePlan(nnp_convolution_algorithm_direct, nnp_activation_relu);
+}
+
+TEST(DILATION, wt8x8_with_clamp) {
+	ConvolutionTester()
+		.inputSize(18, 18)
+		.kernelSize(3, 3)
+		.kernelDilation(2, 2)
+		.inputChannels(8)
+		.outputChannels(4)
+		.clampRange(0.5f, 3.0f)
+		.iterations(5)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_clamp);
+}
+
+TEST(WT8x8_NHWC, with_leaky_relu) {
+	ConvolutionTester()
+		.inputSize(14, 14)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(5)
+		.outputChannels(6)
+		.reluNegativeSlope(0.25f)
+		.iterations(5)
+		.errorLimit(1.0e-3)
+		.testInferenceNHWC(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM_NHWC, with_relu6) {
+	ConvolutionTester()
+		.inputSize(11, 11)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(16)
+		.outputChannels(7)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testInferenceNHWC(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu6);
+}
+
+TEST(ACTIVATION, invalid_parameters) {
+	const struct nnp_size inputSize = { 8, 8 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	const float negativeSlope = -1.0f;
+	const struct nnp_clamp_parameters invertedRange = { 1.0f, 0.0f };
+	size_t workspaceSize = 0;
+	EXPECT_EQ(nnp_status_invalid_activation_parameters,
+		nnp_convolution_inference(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			4, 4, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_relu, &negativeSlope, nullptr, nullptr));
+	EXPECT_EQ(nnp_status_invalid_activation_parameters,
+		nnp_convolution_inference(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			4, 4, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_clamp, nullptr, nullptr, nullptr));
+	EXPECT_EQ(nnp_status_invalid_activation_parameters,
+		nnp_convolution_inference(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			4, 4, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_clamp, &invertedRange, nullptr, nullptr));
+	EXPECT_EQ(nnp_status_invalid_activation_parameters,
+		nnp_convolution_inference(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			4, 4, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_relu6, &negativeSlope, nullptr, nullptr));
+}
+
+/*
+ * Test that residual connections are added by output transforms and epilogues before the activation
+ */
+
+TEST(WT8x8_RESIDUAL, with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceResidual(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8_RESIDUAL, in_place) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceResidual(nnp_convolution_algorithm_wt8x8, nnp_activation_relu, true);
+}
+
+TEST(FT8x8_RESIDUAL, in_place) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceResidual(nnp_convolution_algorithm_ft8x8, nnp_activation_identity, true);
+}
+
+TEST(FT16x16_RESIDUAL, with_relu6) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.inputChannels(8)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceResidual(nnp_convolution_algorithm_ft16x16, nnp_activation_relu6);
+}
+
+TEST(FT8x8_RESIDUAL, strided_with_relu) {
+	ConvolutionTester()
+		.inputSize(17, 17)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceResidual(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8_RESIDUAL, dilation2x2_with_relu) {
+	ConvolutionTester()
+		.inputSize(18, 18)
+		.kernelSize(3, 3)
+		.kernelDilation(2, 2)
+		.inputPadding(2, 2, 2, 2)
+		.inputChannels(3)
+		.outputChannels(4)
+		.iterations(5)
+		.errorLimit(1.0e-3)
+		.testInferenceResidual(nnp_convolution_algorithm_wt8x8, nnp_activation_relu, true);
+}
+
+TEST(IMPLICIT_GEMM_RESIDUAL, many_channels_in_place) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(160)
+		.outputChannels(19)
+		.iterations(3)
+		.errorLimit(1.0e-5)
+		.testInferenceResidual(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu, true);
+}
+
+TEST(IMPLICIT_GEMM_RESIDUAL, grouped) {
+	ConvolutionTester()
+		.inputSize(11, 11)
+		.inputPadding(1, 1, 1, 1)
+		.groups(2)
+		.inputChannels(6)
+		.outputChannels(10)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testInferenceResidual(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(DIRECT_1x1_RESIDUAL, in_place) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.kernelSize(1, 1)
+		.inputChannels(32)
+		.outputChannels(17)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceResidual(nnp_convolution_algorithm_direct, nnp_activation_relu, true);
+}
+
+TEST(DIRECT_1x1_RESIDUAL, strided) {
+	ConvolutionTester()
+		.inputSize(14, 14)
+		.kernelSize(1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(16)
+		.outputChannels(24)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testInferenceResidual(nnp_convolution_algorithm_direct, nnp_activation_relu);
+}
+
+/*
+ * Test that max-pooling is fused into output transforms, or computed after the convolution when it can not be fused
+ */
+
+TEST(WT8x8_MAX_POOLING, pool2x2) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_wt8x8);
+}
+
+TEST(WT8x8_MAX_POOLING, pool2x2_with_relu) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8_MAX_POOLING, pool3x3_with_relu6) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(3, 3)
+		.poolingStride(3, 3)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_wt8x8, nnp_activation_relu6);
+}
+
+TEST(WT8x8_MAX_POOLING, overlapping_pool3x3_stride2) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(WT8x8_MAX_POOLING, grouped) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.groups(2)
+		.inputChannels(4)
+		.outputChannels(6)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_wt8x8);
+}
+
+TEST(FT8x8_MAX_POOLING, pool2x2_with_relu) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_ft8x8, nnp_activation_relu);
+}
+
+TEST(FT8x8_MAX_POOLING, strided_pool2x2) {
+	ConvolutionTester()
+		.inputSize(19, 19)
+		.kernelSize(5, 5)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(FT16x16_MAX_POOLING, pool2x2_with_clamp) {
+	ConvolutionTester()
+		.inputSize(29, 29)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.clampRange(0.5f, 2.0f)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_ft16x16, nnp_activation_clamp);
+}
+
+TEST(IMPLICIT_GEMM_MAX_POOLING, pool3x3_stride2) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(16)
+		.outputChannels(12)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_implicit_gemm, nnp_activation_relu);
+}
+
+TEST(IMPLICIT_GEMM_MAX_POOLING, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(12, 12)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(16)
+		.outputChannels(12)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.internalWorkspace(true)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testInferenceMaxPooling(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(MAX_POOLING, invalid_pooling_stride) {
+	const struct nnp_size inputSize = { 8, 8 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size kernelDilation = { 1, 1 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	const struct nnp_size poolingSize = { 2, 2 };
+	const struct nnp_size poolingStride = { 3, 3 };
+	size_t workspaceSize = 0;
+	EXPECT_EQ(nnp_status_invalid_pooling_stride,
+		nnp_convolution_inference_max_pooling(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 4, 4, inputSize, inputPadding, kernelSize, kernelDilation, outputSubsampling,
+			poolingSize, poolingStride,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+}
+
+/*
+ * Test that layout, residual, and max-pooling options of nnp_convolution_inference_with_options combine
+ */
+
+TEST(WT8x8_OPTIONS, nhwc_residual) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_wt8x8, true, true, 0, nnp_activation_relu);
+}
+
+TEST(WT8x8_OPTIONS, residual_pool2x2) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_wt8x8, false, true, 0, nnp_activation_relu);
+}
+
+TEST(WT8x8_OPTIONS, residual_overlapping_pool3x3_stride2) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_wt8x8, false, true);
+}
+
+TEST(WT8x8_OPTIONS, nhwc_pool2x2) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_wt8x8, true, false, 0, nnp_activation_relu);
+}
+
+TEST(FT8x8_OPTIONS, nhwc_residual_pool2x2) {
+	ConvolutionTester()
+		.inputSize(16, 16)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(2)
+		.inputChannels(4)
+		.outputChannels(6)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(5)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_ft8x8, true, true, 0, nnp_activation_relu6);
+}
+
+TEST(IMPLICIT_GEMM_OPTIONS, nhwc_residual_pool3x3_stride2) {
+	ConvolutionTester()
+		.inputSize(15, 15)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(8)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testInferenceWithOptions(nnp_convolution_algorithm_implicit_gemm, true, true);
+}
+
+TEST(OPTIONS, no_options) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(3)
+		.outputChannels(5)
+		.iterations(5)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_wt8x8, false, false);
+}
+
+/*
+ * Test that tiles of large layers are processed in streams which fit into cache
+ */
+
+TEST(WT8x8_STREAMED, large_batch) {
+	ConvolutionTester()
+		.inputSize(64, 64)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(4)
+		.inputChannels(64)
+		.outputChannels(64)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInference(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
+}
+
+TEST(FT8x8_STREAMED, large_batch) {
+	ConvolutionTester()
+		.inputSize(64, 64)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(4)
+		.inputChannels(64)
+		.outputChannels(64)
+		.iterations(1)
+		.errorLimit(1.0e-4)
+		.testInference(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(WT8x8_STREAMED, workspace_independent_of_image_size) {
+	const struct nnp_padding inputPadding = { 1, 1, 1, 1 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+
+	size_t workspaceSize224 = 0;
+	ASSERT_EQ(nnp_status_success,
+		nnp_convolution_inference(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			256, 256, nnp_size { 224, 224 }, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize224,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+
+	size_t workspaceSize448 = 0;
+	ASSERT_EQ(nnp_status_success,
+		nnp_convolution_inference(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			256, 256, nnp_size { 448, 448 }, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize448,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+
+	EXPECT_EQ(workspaceSize224, workspaceSize448);
+}
+
+static size_t streamedWorkspaceSize(
+	enum nnp_convolution_algorithm algorithm, enum nnp_convolution_transform_strategy transformStrategy,
+	size_t channels, size_t imageSize)
+{
+	size_t workspaceSize = 0;
+	EXPECT_EQ(nnp_status_success,
+		nnp_convolution_inference(
+			algorithm, transformStrategy,
+			channels, channels, nnp_size { imageSize, imageSize }, nnp_padding { 1, 1, 1, 1 }, nnp_size { 3, 3 }, nnp_size { 1, 1 },
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+	return workspaceSize;
+}
+
+/*
+ * Without streams, the workspace holds input and output transforms of all tiles, and at most the whole kernel
+ * transform. Streams must never need more than that.
+ */
+static void testStreamedWorkspaceBound(enum nnp_convolution_algorithm algorithm, size_t tileSize) {
+	const size_t outputTile = tileSize - 2;
+	for (size_t channels = 64; channels <= 512; channels *= 2) {
+		const size_t kernelTransformSize =
+			streamedWorkspaceSize(algorithm, nnp_convolution_transform_strategy_precompute, channels, 14);
+		const size_t transformTileSize = kernelTransformSize / (channels * channels);
+		for (size_t imageSize = outputTile; imageSize <= 224; imageSize *= 2) {
+			const size_t tilesCount = ((imageSize + outputTile - 1) / outputTile) * ((imageSize + outputTile - 1) / outputTile);
+			EXPECT_LE(streamedWorkspaceSize(algorithm, nnp_convolution_transform_strategy_compute, channels, imageSize),
+				kernelTransformSize + tilesCount * 2 * channels * transformTileSize)
+				<< "channels " << channels << ", image " << imageSize << "x" << imageSize;
+		}
+	}
+}
+
+TEST(WT8x8_STREAMED, workspace_never_exceeds_unstreamed) {
+	testStreamedWorkspaceBound(nnp_convolution_algorithm_wt8x8, 8);
+}
+
+TEST(FT8x8_STREAMED, workspace_never_exceeds_unstreamed) {
+	testStreamedWorkspaceBound(nnp_convolution_algorithm_ft8x8, 8);
+}
+
+TEST(FT16x16_STREAMED, workspace_never_exceeds_unstreamed) {
+	testStreamedWorkspaceBound(nnp_convolution_algorithm_ft16x16, 16);
+}
+
+TEST(WT8x8_BOUNDED, row_bands) {
+	ConvolutionTester()
+		.inputSize(62, 27)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInferenceBounded(nnp_convolution_algorithm_wt8x8, 4, nnp_activation_relu);
+}
+
+TEST(WT8x8_BOUNDED, batch_blocks) {
+	ConvolutionTester()
+		.inputSize(30, 30)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(5)
+		.inputChannels(4)
+		.outputChannels(8)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInferenceBounded(nnp_convolution_algorithm_wt8x8, 2);
+}
+
+TEST(WT8x8_BOUNDED, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(62, 27)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.internalWorkspace(true)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInferenceBounded(nnp_convolution_algorithm_wt8x8, 4);
+}
+
+TEST(WT8x8_BOUNDED, dilated) {
+	ConvolutionTester()
+		.inputSize(58, 33)
+		.inputPadding(2, 2, 2, 2)
+		.kernelDilation(2, 2)
+		.inputChannels(4)
+		.outputChannels(8)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInferenceBounded(nnp_convolution_algorithm_wt8x8, 2);
+}
+
+TEST(FT8x8_BOUNDED, row_bands) {
+	ConvolutionTester()
+		.inputSize(61, 29)
+		.inputPadding(2, 1, 2, 1)
+		.kernelSize(5, 5)
+		.inputChannels(8)
+		.outputChannels(8)
+		.iterations(1)
+		.errorLimit(1.0e-4)
+		.testInferenceBounded(nnp_convolution_algorithm_ft8x8, 4);
+}
+
+TEST(FT16x16_BOUNDED, strided) {
+	ConvolutionTester()
+		.inputSize(163, 85)
+		.inputPadding(3, 3, 3, 3)
+		.kernelSize(7, 7)
+		.outputSubsampling(2, 2)
+		.inputChannels(3)
+		.outputChannels(8)
+		.iterations(1)
+		.errorLimit(1.0e-4)
+		.testInferenceBounded(nnp_convolution_algorithm_ft16x16, 2);
+}
+
+TEST(IMPLICIT_GEMM_BOUNDED, strided) {
+	ConvolutionTester()
+		.inputSize(45, 23)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(8)
+		.outputChannels(16)
+		.iterations(1)
+		.errorLimit(1.0e-5)
+		.testInferenceBounded(nnp_convolution_algorithm_implicit_gemm, 2);
+}
+
+TEST(AUTO_BOUNDED, row_bands) {
+	ConvolutionTester()
+		.inputSize(62, 27)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInferenceBounded(nnp_convolution_algorithm_auto, 8);
+}
+
+TEST(WT8x8_BOUNDED, residual_row_bands) {
+	ConvolutionTester()
+		.inputSize(62, 27)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_wt8x8, false, true, 4, nnp_activation_relu);
+}
+
+TEST(WT8x8_BOUNDED, nhwc_residual_row_bands) {
+	ConvolutionTester()
+		.inputSize(62, 27)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_wt8x8, true, true, 4);
+}
+
+TEST(WT8x8_BOUNDED, fused_pool2x2_row_bands) {
+	ConvolutionTester()
+		.inputSize(62, 27)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_wt8x8, false, false, 4, nnp_activation_relu);
+}
+
+TEST(WT8x8_BOUNDED, overlapping_pool3x3_stride2_row_bands) {
+	ConvolutionTester()
+		.inputSize(62, 27)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.internalWorkspace(true)
+		.iterations(1)
+		.errorLimit(1.0e-3)
+		.testInferenceWithOptions(nnp_convolution_algorithm_wt8x8, false, false, 4);
+}
+
+TEST(IMPLICIT_GEMM_BOUNDED, nhwc_pool2x2_row_bands) {
+	ConvolutionTester()
+		.inputSize(62, 27)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(16)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(1)
+		.errorLimit(1.0e-5)
+		.testInferenceWithOptions(nnp_convolution_algorithm_implicit_gemm, true, false, 4, nnp_activation_relu);
+}
+
+TEST(WT8x8_BOUNDED, pooled_residual_not_split) {
+	const struct nnp_size inputSize = { 27, 62 };
+	const struct nnp_padding inputPadding = { 1, 1, 1, 1 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size kernelDilation = { 1, 1 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	std::vector<float> input(8 * 62 * 27), kernel(16 * 8 * 3 * 3), bias(16), residual(16 * 62 * 27), output(16 * 31 * 14);
+	struct nnp_convolution_options options = { };
+	options.residual = residual.data();
+	options.pooling_size = nnp_size { 2, 2 };
+
+	size_t workspaceSize = 0;
+	ASSERT_EQ(nnp_status_success,
+		nnp_convolution_inference_with_options(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 8, 16, inputSize, inputPadding, kernelSize, kernelDilation, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+			nnp_activation_identity, nullptr, &options, nullptr, nullptr));
+
+	/* Pooled rows do not match the rows of the residual, so the layer can not be split into bands */
+	options.workspace_limit = round_up(workspaceSize / 4, 64);
+	EXPECT_EQ(nnp_status_insufficient_buffer,
+		nnp_convolution_inference_with_options(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 8, 16, inputSize, inputPadding, kernelSize, kernelDilation, outputSubsampling,
+			input.data(), kernel.data(), bias.data(), output.data(), nullptr, nullptr,
+			nnp_activation_identity, nullptr, &options, nullptr, nullptr));
+
+	options.workspace_limit = workspaceSize;
+	EXPECT_EQ(nnp_status_success,
+		nnp_convolution_inference_with_options(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			1, 1, 8, 16, inputSize, inputPadding, kernelSize, kernelDilation, outputSubsampling,
+			input.data(), kernel.data(), bias.data(), output.data(), nullptr, nullptr,
+			nnp_activation_identity, nullptr, &options, nullptr, nullptr));
+}
+
+TEST(AUTO_BOUNDED, insufficient_buffer) {
+	const struct nnp_padding inputPadding = { 1, 1, 1, 1 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size kernelDilation = { 1, 1 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	std::vector<float> input(16 * 32 * 32), kernel(16 * 16 * 3 * 3), bias(16), output(16 * 32 * 32);
+
+	EXPECT_EQ(nnp_status_insufficient_buffer,
+		nnp_convolution_inference_bounded(
+			nnp_convolution_algorithm_auto, nnp_convolution_transform_strategy_compute,
+			1, 1, 16, 16, nnp_size { 32, 32 }, inputPadding, kernelSize, kernelDilation, outputSubsampling,
+			input.data(), kernel.data(), bias.data(), output.data(), nullptr, 64,
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
@@ -565,6 +565,30 @@ TEST(WT8x8, non_square_image_with_relu) {
 		.testOutput(nnp_convolution_algorithm_wt8x8, nnp_activation_relu);
 }
 
+/*
+ * Test that the implementation works with scratch memory from the library-owned workspace arena
+ */
+
+TEST(FT8x8, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(3)
+		.internalWorkspace(true)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testOutput(nnp_convolution_algorithm_ft8x8);
+}
+
+TEST(WT8x8, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(13, 13)
+		.batchSize(3)
+		.internalWorkspace(true)
+		.iterations(10)
+		.errorLimit(1.0e-3)
+		.testOutput(nnp_convolution_algorithm_wt8x8);
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	assert(init_status == nnp_status_success);
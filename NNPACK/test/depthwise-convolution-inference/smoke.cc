@@ -0,0 +1,432 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/convolution.h>
+
+TEST(DWCONV3x3, single_channel) {
+	ConvolutionTester()
+		.inputSize(5, 5)
+		.kernelSize(3, 3)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_identity);
+}
+
+TEST(DWCONV3x3, single_channel_with_relu) {
+	ConvolutionTester()
+		.inputSize(5, 5)
+		.kernelSize(3, 3)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV3x3, varying_width) {
+	for (size_t width = 1; width <= 40; width++) {
+		ConvolutionTester()
+			.inputSize(3, width)
+			.kernelSize(3, 3)
+			.inputPadding(0, 1, 0, 1)
+			.iterations(10)
+			.errorLimit(1.0e-5)
+			.testDepthwiseInference();
+	}
+}
+
+TEST(DWCONV3x3, implicit_padding) {
+	for (size_t padding = 0; padding < 3; padding++) {
+		ConvolutionTester()
+			.inputSize(19, 21)
+			.kernelSize(3, 3)
+			.inputPadding(padding, padding, padding, padding)
+			.iterations(10)
+			.errorLimit(1.0e-5)
+			.testDepthwiseInference();
+	}
+}
+
+TEST(DWCONV3x3, asymmetric_padding) {
+	ConvolutionTester()
+		.inputSize(17, 23)
+		.kernelSize(3, 3)
+		.inputPadding(0, 2, 2, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV3x3, small_input) {
+	ConvolutionTester()
+		.inputSize(2, 2)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference();
+}
+
+TEST(DWCONV3x3, multiple_channels) {
+	ConvolutionTester()
+		.inputChannels(37)
+		.inputSize(29, 31)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV3x3, multithreaded) {
+	ConvolutionTester()
+		.inputChannels(37)
+		.inputSize(29, 31)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.multithreading(true)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV3x3_STRIDE2x2, single_channel) {
+	ConvolutionTester()
+		.inputSize(7, 7)
+		.kernelSize(3, 3)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_identity);
+}
+
+TEST(DWCONV3x3_STRIDE2x2, single_channel_with_relu) {
+	ConvolutionTester()
+		.inputSize(7, 7)
+		.kernelSize(3, 3)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV3x3_STRIDE2x2, varying_width) {
+	for (size_t width = 1; width <= 40; width++) {
+		ConvolutionTester()
+			.inputSize(3, width)
+			.kernelSize(3, 3)
+			.inputPadding(0, 1, 0, 1)
+			.outputSubsampling(2, 2)
+			.iterations(10)
+			.errorLimit(1.0e-5)
+			.testDepthwiseInference();
+	}
+}
+
+TEST(DWCONV3x3_STRIDE2x2, implicit_padding) {
+	for (size_t padding = 0; padding < 3; padding++) {
+		ConvolutionTester()
+			.inputSize(19, 21)
+			.kernelSize(3, 3)
+			.inputPadding(padding, padding, padding, padding)
+			.outputSubsampling(2, 2)
+			.iterations(10)
+			.errorLimit(1.0e-5)
+			.testDepthwiseInference();
+	}
+}
+
+TEST(DWCONV3x3_STRIDE2x2, asymmetric_padding) {
+	ConvolutionTester()
+		.inputSize(17, 23)
+		.kernelSize(3, 3)
+		.inputPadding(0, 2, 2, 1)
+		.outputSubsampling(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV3x3_STRIDE2x2, small_input) {
+	ConvolutionTester()
+		.inputSize(2, 2)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference();
+}
+
+TEST(DWCONV3x3_STRIDE2x2, multiple_channels) {
+	ConvolutionTester()
+		.inputChannels(37)
+		.inputSize(29, 31)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV3x3_STRIDE2x2, multithreaded) {
+	ConvolutionTester()
+		.inputChannels(37)
+		.inputSize(29, 31)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.multithreading(true)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV5x5, single_channel) {
+	ConvolutionTester()
+		.inputSize(7, 7)
+		.kernelSize(5, 5)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_identity);
+}
+
+TEST(DWCONV5x5, single_channel_with_relu) {
+	ConvolutionTester()
+		.inputSize(7, 7)
+		.kernelSize(5, 5)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV5x5, varying_width) {
+	for (size_t width = 1; width <= 40; width++) {
+		ConvolutionTester()
+			.inputSize(5, width)
+			.kernelSize(5, 5)
+			.inputPadding(0, 2, 0, 2)
+			.iterations(10)
+			.errorLimit(1.0e-5)
+			.testDepthwiseInference();
+	}
+}
+
+TEST(DWCONV5x5, implicit_padding) {
+	for (size_t padding = 0; padding < 5; padding++) {
+		ConvolutionTester()
+			.inputSize(19, 21)
+			.kernelSize(5, 5)
+			.inputPadding(padding, padding, padding, padding)
+			.iterations(10)
+			.errorLimit(1.0e-5)
+			.testDepthwiseInference();
+	}
+}
+
+TEST(DWCONV5x5, asymmetric_padding) {
+	ConvolutionTester()
+		.inputSize(17, 23)
+		.kernelSize(5, 5)
+		.inputPadding(0, 4, 4, 1)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV5x5, small_input) {
+	ConvolutionTester()
+		.inputSize(2, 2)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference();
+}
+
+TEST(DWCONV5x5, multiple_channels) {
+	ConvolutionTester()
+		.inputChannels(37)
+		.inputSize(29, 31)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV5x5, multithreaded) {
+	ConvolutionTester()
+		.inputChannels(37)
+		.inputSize(29, 31)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.multithreading(true)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV5x5_STRIDE2x2, single_channel) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.kernelSize(5, 5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_identity);
+}
+
+TEST(DWCONV5x5_STRIDE2x2, single_channel_with_relu) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.kernelSize(5, 5)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV5x5_STRIDE2x2, varying_width) {
+	for (size_t width = 1; width <= 40; width++) {
+		ConvolutionTester()
+			.inputSize(5, width)
+			.kernelSize(5, 5)
+			.inputPadding(0, 2, 0, 2)
+			.outputSubsampling(2, 2)
+			.iterations(10)
+			.errorLimit(1.0e-5)
+			.testDepthwiseInference();
+	}
+}
+
+TEST(DWCONV5x5_STRIDE2x2, implicit_padding) {
+	for (size_t padding = 0; padding < 5; padding++) {
+		ConvolutionTester()
+			.inputSize(19, 21)
+			.kernelSize(5, 5)
+			.inputPadding(padding, padding, padding, padding)
+			.outputSubsampling(2, 2)
+			.iterations(10)
+			.errorLimit(1.0e-5)
+			.testDepthwiseInference();
+	}
+}
+
+TEST(DWCONV5x5_STRIDE2x2, asymmetric_padding) {
+	ConvolutionTester()
+		.inputSize(17, 23)
+		.kernelSize(5, 5)
+		.inputPadding(0, 4, 4, 1)
+		.outputSubsampling(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV5x5_STRIDE2x2, small_input) {
+	ConvolutionTester()
+		.inputSize(2, 2)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(2, 2)
+		.iterations(100)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference();
+}
+
+TEST(DWCONV5x5_STRIDE2x2, multiple_channels) {
+	ConvolutionTester()
+		.inputChannels(37)
+		.inputSize(29, 31)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(2, 2)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV5x5_STRIDE2x2, multithreaded) {
+	ConvolutionTester()
+		.inputChannels(37)
+		.inputSize(29, 31)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.outputSubsampling(2, 2)
+		.multithreading(true)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu);
+}
+
+TEST(DWCONV, unsupported_kernel_size) {
+	const struct nnp_size inputSize = { 8, 8 };
+	const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 7, 7 };
+	const struct nnp_size noSubsampling = { 1, 1 };
+	std::vector<float> input(8 * 8), kernel(7 * 7), bias(1), output(2 * 2);
+	EXPECT_EQ(nnp_status_unsupported_kernel_size,
+		nnp_depthwise_convolution_inference(
+			1, inputSize, noPadding, kernelSize, noSubsampling,
+			input.data(), kernel.data(), bias.data(), output.data(),
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+}
+
+TEST(DWCONV, unsupported_stride) {
+	const struct nnp_size inputSize = { 8, 8 };
+	const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size subsampling = { 3, 3 };
+	std::vector<float> input(8 * 8), kernel(3 * 3), bias(1), output(2 * 2);
+	EXPECT_EQ(nnp_status_unsupported_algorithm,
+		nnp_depthwise_convolution_inference(
+			1, inputSize, noPadding, kernelSize, subsampling,
+			input.data(), kernel.data(), bias.data(), output.data(),
+			nnp_activation_identity, nullptr, nullptr, nullptr));
+}
+
+TEST(DWCONV3x3, multiple_channels_with_relu6) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(5)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_relu6);
+}
+
+TEST(DWCONV5x5, multiple_channels_with_clamp) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.inputChannels(5)
+		.clampRange(0.5f, 2.0f)
+		.iterations(10)
+		.errorLimit(1.0e-5)
+		.testDepthwiseInference(nnp_activation_clamp);
+}
+
+TEST(DWCONV, unsupported_leaky_relu) {
+	const struct nnp_size inputSize = { 8, 8 };
+	const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size noSubsampling = { 1, 1 };
+	const float negativeSlope = 0.1f;
+	std::vector<float> input(8 * 8), kernel(3 * 3), bias(1), output(6 * 6);
+	EXPECT_EQ(nnp_status_unsupported_activation_parameters,
+		nnp_depthwise_convolution_inference(
+			1, inputSize, noPadding, kernelSize, noSubsampling,
+			input.data(), kernel.data(), bias.data(), output.data(),
+			nnp_activation_relu, &negativeSlope, nullptr, nullptr));
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include <cpuinfo.h>
+
+#include <testers/gemm-ukernel.h>
+#include <nnpack/blas.h>
+
+#if CPUINFO_ARCH_X86_64
+TEST(FAST_H8GEMM_3x4, avx2) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	if (cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3() && cpuinfo_has_x86_f16c()) {
+		GemmMicroKernelTester tester = GemmMicroKernelTester()
+			.simdWidth(8)
+			.mr(3)
+			.nr(4)
+			.errorLimit(1.0e-3f);
+
+		for (uint32_t kc = 1; kc < 10; kc++) {
+			tester
+				.kc(kc)
+				.accumulateC(true)
+				.testHXGEMM(nnp_fast_tuple_gemm_function(nnp_h8gemm_only_3x4__avx2));
+			tester
+				.accumulateC(false)
+				.testHXGEMM(nnp_fast_tuple_gemm_function(nnp_h8gemm_only_3x4__avx2));
+		}
+	}
+}
+
+TEST(FULL_H8GEMM_3x4, avx2) {
+	ASSERT_TRUE(cpuinfo_initialize());
+	if (cpuinfo_has_x86_avx2() && cpuinfo_has_x86_fma3() && cpuinfo_has_x86_f16c()) {
+		GemmMicroKernelTester tester = GemmMicroKernelTester()
+			.simdWidth(8)
+			.mr(3)
+			.nr(4)
+			.errorLimit(1.0e-3f);
+
+		for (uint32_t kc = 1; kc < 10; kc++) {
+			tester
+				.kc(kc)
+				.accumulateC(true)
+				.testHXGEMM(nnp_full_tuple_gemm_function(nnp_h8gemm_upto_3x4__avx2));
+			tester
+				.accumulateC(false)
+				.testHXGEMM(nnp_full_tuple_gemm_function(nnp_h8gemm_upto_3x4__avx2));
+		}
+	}
+}
+#endif /* CPUINFO_ARCH_X86_64 */
@@ -404,6 +404,44 @@ TEST(MAX_POOLING_2x1, few_channels) {
 	}
 }
 
+TEST(MAX_POOLING_2x2_NHWC, few_channels) {
+	PoolingTester tester;
+	tester.inputSize(12, 12)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(100);
+	for (size_t channels = 1; channels <= 9; channels += 2) {
+		tester.channels(channels)
+			.testOutputNHWC();
+	}
+}
+
+TEST(MAX_POOLING_3x3_STRIDE_2x2_NHWC, implicit_padding) {
+	PoolingTester tester;
+	tester.inputSize(13, 11)
+		.channels(7)
+		.poolingSize(3, 3)
+		.poolingStride(2, 2)
+		.iterations(10);
+	for (size_t paddingTop = 0; paddingTop < 3; paddingTop++) {
+		for (size_t paddingLeft = 0; paddingLeft < 3; paddingLeft++) {
+			tester.inputPadding(paddingTop, 0, 0, paddingLeft)
+				.testOutputNHWC();
+		}
+	}
+}
+
+TEST(MAX_POOLING_2x2_NHWC, small_batch) {
+	PoolingTester()
+		.batchSize(3)
+		.channels(16)
+		.inputSize(9, 7)
+		.poolingSize(2, 2)
+		.poolingStride(2, 2)
+		.iterations(10)
+		.testOutputNHWC();
+}
+
 int main(int argc, char* argv[]) {
 	const enum nnp_status init_status = nnp_initialize();
 	std::cout << init_status << std::endl;
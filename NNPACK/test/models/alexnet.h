@@ -6,6 +6,7 @@
 #include <testers/fully-connected.h>
 #include <testers/pooling.h>
 #include <testers/relu.h>
+#include <testers/network.h>
 
 namespace AlexNet {
 
@@ -204,4 +205,35 @@ namespace AlexNet {
 			.multithreading(true)
 			.channels(1000));
 	}
+
+	/*
+	 * AlexNet network:
+	 *   conv1 + ReLU, 3x3 max-pooling with 2x2 stride,
+	 *   conv2 + ReLU, 3x3 max-pooling with 2x2 stride,
+	 *   conv3 + ReLU, conv4 + ReLU, conv5 + ReLU, 3x3 max-pooling with 2x2 stride and bottom/right padding = 1,
+	 *   fc6 + ReLU, fc7 + ReLU, fc8, softmax
+	 * The pooling layers are not defined above; the last one produces the 256x7x7 input of fc6.
+	 */
+	inline NetworkTester network() {
+		const struct nnp_size poolingSize = { 3, 3 };
+		const struct nnp_size poolingStride = { 2, 2 };
+		const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+		const struct nnp_padding pool5Padding = { 0, 1, 1, 0 };
+		return std::move(NetworkTester()
+			.multithreading(true)
+			.inputChannels(3)
+			.inputSize(224, 224)
+			.convolution(conv1()).relu(conv1_relu())
+			.maxPooling(poolingSize, poolingStride, noPadding)
+			.convolution(conv2()).relu(conv2_relu())
+			.maxPooling(poolingSize, poolingStride, noPadding)
+			.convolution(conv3()).relu(conv3_relu())
+			.convolution(conv4()).relu(conv4_relu())
+			.convolution(conv5()).relu()
+			.maxPooling(poolingSize, poolingStride, pool5Padding)
+			.fullyConnected(fc6()).relu(fc6_relu())
+			.fullyConnected(fc7()).relu()
+			.fullyConnected(fc8())
+			.softmax());
+	}
 }
@@ -6,6 +6,7 @@
 #include <testers/fully-connected.h>
 #include <testers/pooling.h>
 #include <testers/relu.h>
+#include <testers/network.h>
 
 namespace OverFeat_Fast {
 
@@ -264,4 +265,27 @@ namespace OverFeat_Fast {
 			.poolingStride(2, 2));
 	}
 
+
+	/*
+	 * OverFeat (Fast model) network:
+	 *   conv1 + ReLU, pool1, conv2 + ReLU, pool2,
+	 *   conv3 + ReLU, conv4 + ReLU, conv5 + ReLU, pool3,
+	 *   fc6 + ReLU, fc7 + ReLU, fc8, softmax
+	 */
+	inline NetworkTester network() {
+		return std::move(NetworkTester()
+			.multithreading(true)
+			.inputChannels(3)
+			.inputSize(231, 231)
+			.convolution(conv1()).relu(conv1_relu()).maxPooling(pool1())
+			.convolution(conv2()).relu(conv2_relu()).maxPooling(pool2())
+			.convolution(conv3()).relu(conv3_relu())
+			.convolution(conv4()).relu(conv4_relu())
+			.convolution(conv5()).relu().maxPooling(pool3())
+			.fullyConnected(fc6()).relu(fc6_relu())
+			.fullyConnected(fc7()).relu(fc7_relu())
+			.fullyConnected(fc8())
+			.softmax());
+	}
+
 };
@@ -6,6 +6,7 @@
 #include <testers/fully-connected.h>
 #include <testers/pooling.h>
 #include <testers/relu.h>
+#include <testers/network.h>
 
 namespace VGG_A {
 
@@ -336,4 +337,31 @@ namespace VGG_A {
 			.poolingStride(2, 2));
 	}
 
+
+	/*
+	 * VGG model A network:
+	 *   conv1 + ReLU, pool1, conv2 + ReLU, pool2,
+	 *   conv3 + ReLU, conv4 + ReLU, pool3, conv5 + ReLU, conv6 + ReLU, pool4,
+	 *   conv7 + ReLU, conv8 + ReLU, pool5 (conv7 has the same parameters as conv8),
+	 *   fc6 + ReLU, fc7 + ReLU, fc8, softmax
+	 */
+	inline NetworkTester network() {
+		return std::move(NetworkTester()
+			.multithreading(true)
+			.inputChannels(3)
+			.inputSize(224, 224)
+			.convolution(conv1()).relu(conv1_relu()).maxPooling(pool1())
+			.convolution(conv2()).relu(conv2_relu()).maxPooling(pool2())
+			.convolution(conv3()).relu(conv3_relu())
+			.convolution(conv4()).relu().maxPooling(pool3())
+			.convolution(conv5()).relu(conv5_relu())
+			.convolution(conv6()).relu().maxPooling(pool4())
+			.convolution(conv8()).relu(conv8_relu())
+			.convolution(conv8()).relu(conv8_relu()).maxPooling(pool5())
+			.fullyConnected(fc6()).relu(fc6_relu())
+			.fullyConnected(fc7()).relu()
+			.fullyConnected(fc8())
+			.softmax());
+	}
+
 };
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/convolution.h>
+
+TEST(NCHWC_CONV3x3, single_tile) {
+	ConvolutionTester()
+		.inputChannels(8)
+		.outputChannels(8)
+		.inputSize(6, 6)
+		.kernelSize(3, 3)
+		.iterations(20)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference();
+}
+
+TEST(NCHWC_CONV3x3, single_tile_with_relu) {
+	ConvolutionTester()
+		.inputChannels(8)
+		.outputChannels(8)
+		.inputSize(6, 6)
+		.kernelSize(3, 3)
+		.iterations(20)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference(nnp_activation_relu);
+}
+
+TEST(NCHWC_CONV3x3, partial_channel_blocks) {
+	for (size_t channels = 1; channels <= 19; channels += 3) {
+		ConvolutionTester()
+			.inputChannels(channels)
+			.outputChannels(channels + 2)
+			.inputSize(7, 9)
+			.kernelSize(3, 3)
+			.iterations(5)
+			.errorLimit(1.0e-5)
+			.testNCHWcInference(nnp_activation_relu);
+	}
+}
+
+TEST(NCHWC_CONV3x3, varying_width) {
+	for (size_t width = 1; width <= 20; width++) {
+		ConvolutionTester()
+			.inputChannels(5)
+			.outputChannels(7)
+			.inputSize(3, width)
+			.kernelSize(3, 3)
+			.inputPadding(0, 1, 0, 1)
+			.iterations(5)
+			.errorLimit(1.0e-5)
+			.testNCHWcInference();
+	}
+}
+
+TEST(NCHWC_CONV3x3, implicit_padding) {
+	for (size_t padding = 0; padding < 3; padding++) {
+		ConvolutionTester()
+			.inputChannels(12)
+			.outputChannels(10)
+			.inputSize(13, 11)
+			.kernelSize(3, 3)
+			.inputPadding(padding, padding, padding, padding)
+			.iterations(5)
+			.errorLimit(1.0e-5)
+			.testNCHWcInference();
+	}
+}
+
+TEST(NCHWC_CONV3x3, asymmetric_padding) {
+	ConvolutionTester()
+		.inputChannels(9)
+		.outputChannels(11)
+		.inputSize(17, 13)
+		.kernelSize(3, 3)
+		.inputPadding(0, 2, 2, 1)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference(nnp_activation_relu);
+}
+
+TEST(NCHWC_CONV3x3, subsample2x2) {
+	ConvolutionTester()
+		.inputChannels(16)
+		.outputChannels(12)
+		.inputSize(15, 17)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference();
+}
+
+TEST(NCHWC_CONV3x3, batch) {
+	ConvolutionTester()
+		.batchSize(3)
+		.inputChannels(6)
+		.outputChannels(10)
+		.inputSize(9, 9)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference(nnp_activation_relu);
+}
+
+TEST(NCHWC_CONV3x3, multithreaded) {
+	ConvolutionTester()
+		.multithreading(true)
+		.batchSize(2)
+		.inputChannels(24)
+		.outputChannels(20)
+		.inputSize(19, 21)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference();
+}
+
+TEST(NCHWC_CONV3x3, chained_layers) {
+	ConvolutionTester()
+		.inputChannels(5)
+		.outputChannels(13)
+		.inputSize(11, 12)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference(nnp_activation_relu, true);
+}
+
+TEST(NCHWC_CONV1x1, pointwise) {
+	ConvolutionTester()
+		.inputChannels(32)
+		.outputChannels(24)
+		.inputSize(10, 10)
+		.kernelSize(1, 1)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference();
+}
+
+TEST(NCHWC_CONV1x1, subsample2x2_chained) {
+	ConvolutionTester()
+		.inputChannels(12)
+		.outputChannels(9)
+		.inputSize(12, 11)
+		.kernelSize(1, 1)
+		.outputSubsampling(2, 2)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference(nnp_activation_identity, true);
+}
+
+TEST(NCHWC_CONV5x5, implicit_padding) {
+	ConvolutionTester()
+		.inputChannels(7)
+		.outputChannels(9)
+		.inputSize(14, 15)
+		.kernelSize(5, 5)
+		.inputPadding(2, 2, 2, 2)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference(nnp_activation_relu);
+}
+
+TEST(NCHWC, layout_round_trip) {
+	const size_t channelBlock = nnp_nchwc_channel_block_size();
+	const size_t channels = 2 * channelBlock + 1;
+	const struct nnp_size imageSize = { 3, 5 };
+	std::vector<float> input(2 * channels * 3 * 5), output(input.size(), nanf(""));
+	std::vector<float> blocked(2 * 3 * 3 * 5 * channelBlock, nanf(""));
+	for (size_t i = 0; i < input.size(); i++) {
+		input[i] = float(i + 1);
+	}
+	ASSERT_EQ(nnp_status_success,
+		nnp_convert_nchw_to_nchwc(2, channels, imageSize, input.data(), blocked.data(), nullptr));
+	/* Pixel (1, 2) of the last channel of the second image sits in the last lane used by the last block */
+	const size_t channel = channels - 1;
+	EXPECT_EQ(input[((channels + channel) * 3 + 1) * 5 + 2],
+		blocked[(((3 + channel / channelBlock) * 3 + 1) * 5 + 2) * channelBlock + channel % channelBlock]);
+	ASSERT_EQ(nnp_status_success,
+		nnp_convert_nchwc_to_nchw(2, channels, imageSize, blocked.data(), output.data(), nullptr));
+	EXPECT_EQ(input, output);
+}
+
+TEST(NCHWC, invalid_channels) {
+	const struct nnp_size imageSize = { 4, 4 };
+	std::vector<float> input(16), output(16 * 16);
+	EXPECT_EQ(nnp_status_invalid_channels,
+		nnp_convert_nchw_to_nchwc(1, 0, imageSize, input.data(), output.data(), nullptr));
+}
+
+TEST(NCHWC_CONV3x3, chained_layers_with_clamp) {
+	ConvolutionTester()
+		.inputChannels(5)
+		.outputChannels(13)
+		.inputSize(11, 12)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.clampRange(0.5f, 2.0f)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference(nnp_activation_clamp, true);
+}
+
+TEST(NCHWC_CONV3x3, with_leaky_relu) {
+	ConvolutionTester()
+		.inputChannels(6)
+		.outputChannels(10)
+		.inputSize(9, 9)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.reluNegativeSlope(0.25f)
+		.iterations(5)
+		.errorLimit(1.0e-5)
+		.testNCHWcInference(nnp_activation_relu);
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
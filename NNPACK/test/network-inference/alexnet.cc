@@ -0,0 +1,43 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/network.h>
+#include <models/alexnet.h>
+
+/*
+ * AlexNet network
+ */
+
+TEST(NETWORK, memory) {
+	AlexNet::network()
+		.testMemory();
+}
+
+TEST(NETWORK, output) {
+	AlexNet::network()
+		.errorLimit(1.0e-3)
+		.testOutput();
+}
+
+TEST(NETWORK_PRECOMPUTE, output) {
+	AlexNet::network()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.errorLimit(1.0e-3)
+		.testOutput();
+}
+
+TEST(NETWORK_MODEL, precompute) {
+	AlexNet::network()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.errorLimit(1.0e-3)
+		.testModel();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
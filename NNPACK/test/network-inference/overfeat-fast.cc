@@ -0,0 +1,36 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/network.h>
+#include <models/overfeat-fast.h>
+
+/*
+ * OverFeat (Fast model) network
+ */
+
+TEST(NETWORK, memory) {
+	OverFeat_Fast::network()
+		.testMemory();
+}
+
+TEST(NETWORK, output) {
+	OverFeat_Fast::network()
+		.errorLimit(1.0e-3)
+		.testOutput();
+}
+
+TEST(NETWORK_PRECOMPUTE, output) {
+	OverFeat_Fast::network()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.errorLimit(1.0e-3)
+		.testOutput();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,423 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/network.h>
+
+/*
+ * Error limits of network outputs by convolution algorithm. Convolutions without fused ReLU pass outputs close to zero
+ * to the next layer, where the relative error of fast algorithms grows, and differs between backends.
+ */
+static float networkErrorLimit(enum nnp_convolution_algorithm algorithm) {
+	switch (algorithm) {
+		case nnp_convolution_algorithm_ft16x16:
+			return 1.0e-3f;
+		default:
+			return 1.0e-2f;
+	}
+}
+
+/*
+ * Small network: convolutions with and without fused ReLU, pooling, in-place ReLU, and a classifier
+ */
+
+static NetworkTester smallNetwork(enum nnp_convolution_algorithm algorithm = nnp_convolution_algorithm_auto) {
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size unitStride = { 1, 1 };
+	const struct nnp_size doubleStride = { 2, 2 };
+	const struct nnp_padding unitPadding = { 1, 1, 1, 1 };
+	const struct nnp_padding noPadding = { 0, 0, 0, 0 };
+	return std::move(NetworkTester()
+		.algorithm(algorithm)
+		.errorLimit(networkErrorLimit(algorithm))
+		.inputChannels(3)
+		.inputSize(29, 23)
+		.convolution(8, kernelSize, unitPadding, unitStride).relu()
+		.maxPooling(doubleStride, doubleStride, noPadding)
+		.convolution(16, kernelSize, unitPadding, unitStride)
+		.maxPooling(kernelSize, doubleStride, unitPadding).relu(0.25f)
+		.convolution(12, kernelSize, noPadding, doubleStride).relu()
+		.fullyConnected(10).relu()
+		.fullyConnected(7)
+		.softmax());
+}
+
+TEST(NETWORK, output) {
+	smallNetwork()
+		.testOutput();
+}
+
+TEST(NETWORK, batch) {
+	smallNetwork()
+		.batchSize(3)
+		.testOutput();
+}
+
+TEST(NETWORK, multithreading) {
+	smallNetwork()
+		.multithreading(true)
+		.batchSize(2)
+		.testOutput();
+}
+
+TEST(NETWORK, memory) {
+	smallNetwork()
+		.testMemory();
+}
+
+TEST(NETWORK, batch_memory) {
+	smallNetwork()
+		.batchSize(3)
+		.testMemory();
+}
+
+TEST(NETWORK, implicit_gemm) {
+	smallNetwork(nnp_convolution_algorithm_implicit_gemm)
+		.testOutput();
+}
+
+TEST(NETWORK, ft16x16) {
+	smallNetwork(nnp_convolution_algorithm_ft16x16)
+		.testOutput();
+}
+
+TEST(NETWORK, relu_input) {
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size unitStride = { 1, 1 };
+	const struct nnp_padding unitPadding = { 1, 1, 1, 1 };
+	NetworkTester()
+		.inputChannels(4)
+		.inputSize(9, 11)
+		.relu(0.5f)
+		.convolution(5, kernelSize, unitPadding, unitStride)
+		.softmax()
+		.errorLimit(networkErrorLimit(nnp_convolution_algorithm_auto))
+		.testOutput();
+}
+
+TEST(NETWORK, single_layer) {
+	NetworkTester()
+		.inputChannels(24)
+		.fullyConnected(16)
+		.errorLimit(1.0e-5)
+		.testOutput();
+}
+
+TEST(NETWORK_PRECOMPUTE, output) {
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.testOutput();
+}
+
+TEST(NETWORK_PRECOMPUTE, ft8x8) {
+	smallNetwork(nnp_convolution_algorithm_ft8x8)
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.batchSize(2)
+		.testOutput();
+}
+
+/* Plans tune automatic layers which precompute kernel transforms, but keep the precompute strategy */
+TEST(NETWORK_PRECOMPUTE, autotune_measure) {
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+	ASSERT_EQ(nnp_status_success, nnp_autotune_set_mode(nnp_autotune_mode_measure));
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.testOutput();
+	ASSERT_EQ(nnp_status_success, nnp_autotune_set_mode(nnp_autotune_mode_cached));
+	ASSERT_EQ(nnp_status_success, nnp_autotune_reset());
+}
+
+TEST(NETWORK_MODEL, compute) {
+	smallNetwork()
+		.testModel();
+}
+
+TEST(NETWORK_MODEL, precompute) {
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.testModel();
+}
+
+TEST(NETWORK_MODEL, ft8x8) {
+	smallNetwork(nnp_convolution_algorithm_ft8x8)
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.batchSize(2)
+		.testModel();
+}
+
+TEST(NETWORK_MODEL, multithreading) {
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.multithreading(true)
+		.batchSize(2)
+		.testModel();
+}
+
+TEST(NETWORK_MODEL, foreign_hardware) {
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.foreignModel(true)
+		.testModel();
+}
+
+TEST(NETWORK_MODEL, in_memory) {
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.modelInMemory(true)
+		.testModel();
+}
+
+TEST(NETWORK_MODEL, foreign_hardware_in_memory) {
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.foreignModel(true)
+		.modelInMemory(true)
+		.testModel();
+}
+
+TEST(NETWORK_STREAM, compute) {
+	smallNetwork()
+		.streamModel(true)
+		.testModel();
+}
+
+TEST(NETWORK_STREAM, precompute) {
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.streamModel(true)
+		.testModel();
+}
+
+TEST(NETWORK_STREAM, multithreading) {
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.streamModel(true)
+		.multithreading(true)
+		.batchSize(2)
+		.testModel();
+}
+
+TEST(NETWORK_STREAM, foreign_hardware) {
+	smallNetwork()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.foreignModel(true)
+		.streamModel(true)
+		.testModel();
+}
+
+/* The only streamed layer shares a buffer with itself in the next run, and stays there */
+TEST(NETWORK_STREAM, single_layer) {
+	NetworkTester()
+		.inputChannels(24)
+		.fullyConnected(16)
+		.streamModel(true)
+		.errorLimit(1.0e-4)
+		.testModel();
+}
+
+/*
+ * Layers of a model in memory: the transformed kernel and bias of a convolutional layer are used in place by
+ * nnp_convolution_inference, and give the same output as the raw kernel
+ */
+TEST(NETWORK_MODEL, layer_in_place) {
+	const size_t inputChannels = 5;
+	const size_t outputChannels = 7;
+	const struct nnp_size inputSize = { 13, 11 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size unitStride = { 1, 1 };
+	const struct nnp_padding unitPadding = { 1, 1, 1, 1 };
+
+	std::mt19937 rng(42);
+	std::uniform_real_distribution<float> distribution(-1.0f, +1.0f);
+	std::vector<float> kernel(outputChannels * inputChannels * kernelSize.height * kernelSize.width);
+	std::vector<float> bias(outputChannels);
+	std::vector<float> fullyConnectedKernel(3 * outputChannels * inputSize.height * inputSize.width);
+	std::vector<float> input(inputChannels * inputSize.height * inputSize.width);
+	for (float& x : kernel) { x = distribution(rng); }
+	for (float& x : bias) { x = distribution(rng); }
+	for (float& x : fullyConnectedKernel) { x = distribution(rng); }
+	for (float& x : input) { x = distribution(rng); }
+
+	nnp_network_t network = nullptr;
+	ASSERT_EQ(nnp_status_success, nnp_network_create(1, inputChannels, inputSize, &network));
+	ASSERT_EQ(nnp_status_success,
+		nnp_network_add_convolution(network,
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_precompute,
+			outputChannels, unitPadding, kernelSize, unitStride,
+			kernel.data(), bias.data(), nnp_activation_identity, nullptr));
+	ASSERT_EQ(nnp_status_success, nnp_network_add_relu(network, 0.0f));
+	ASSERT_EQ(nnp_status_success, nnp_network_add_fully_connected(network, 3, fullyConnectedKernel.data()));
+	ASSERT_EQ(nnp_status_success, nnp_network_plan(network, nullptr));
+
+	char path[] = "/tmp/nnpack-model-XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_NE(-1, fd);
+	close(fd);
+	const enum nnp_status saveStatus = nnp_network_save(network, path);
+	nnp_network_destroy(network);
+	ASSERT_EQ(nnp_status_success, saveStatus);
+
+	FILE* file = fopen(path, "rb");
+	ASSERT_NE(nullptr, file);
+	ASSERT_EQ(0, fseek(file, 0, SEEK_END));
+	const size_t modelSize = ftell(file);
+	std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> model(modelSize);
+	ASSERT_EQ(0, fseek(file, 0, SEEK_SET));
+	ASSERT_EQ(1, fread(model.data(), modelSize, 1, file));
+	ASSERT_EQ(0, fclose(file));
+	remove(path);
+
+	struct nnp_model_layer layer;
+	ASSERT_EQ(nnp_status_success, nnp_model_get_layer(model.data(), modelSize, 0, &layer));
+	ASSERT_EQ(nnp_model_layer_convolution, layer.type);
+	ASSERT_EQ(nnp_convolution_algorithm_wt8x8, layer.algorithm);
+	ASSERT_EQ(outputChannels, layer.output_channels);
+	ASSERT_EQ(nnp_activation_relu, layer.activation);
+	ASSERT_NE(nullptr, layer.transformed_kernel);
+	ASSERT_TRUE(std::equal(kernel.cbegin(), kernel.cend(), layer.kernel));
+	ASSERT_TRUE(std::equal(bias.cbegin(), bias.cend(), layer.bias));
+
+	std::vector<float> output(outputChannels * inputSize.height * inputSize.width);
+	std::vector<float> modelOutput(output.size());
+	ASSERT_EQ(nnp_status_success,
+		nnp_convolution_inference(
+			nnp_convolution_algorithm_wt8x8, nnp_convolution_transform_strategy_compute,
+			inputChannels, outputChannels, inputSize, unitPadding, kernelSize, unitStride,
+			input.data(), kernel.data(), bias.data(), output.data(),
+			nullptr, nullptr, nnp_activation_relu, nullptr, nullptr, nullptr));
+	ASSERT_EQ(nnp_status_success,
+		nnp_convolution_inference(
+			layer.algorithm, nnp_convolution_transform_strategy_reuse,
+			inputChannels, layer.output_channels, inputSize, layer.input_padding, layer.kernel_size, layer.stride,
+			input.data(), static_cast<const float*>(layer.transformed_kernel), layer.bias, modelOutput.data(),
+			nullptr, nullptr, layer.activation, layer.activation_parameters, nullptr, nullptr));
+	EXPECT_EQ(output, modelOutput);
+
+	ASSERT_EQ(nnp_status_success, nnp_model_get_layer(model.data(), modelSize, 1, &layer));
+	ASSERT_EQ(nnp_model_layer_fully_connected, layer.type);
+	ASSERT_EQ(3, layer.output_channels);
+	ASSERT_TRUE(std::equal(fullyConnectedKernel.cbegin(), fullyConnectedKernel.cend(), layer.kernel));
+	EXPECT_EQ(nnp_status_invalid_network, nnp_model_get_layer(model.data(), modelSize, 2, &layer));
+}
+
+TEST(NETWORK_API, run_before_plan) {
+	nnp_network_t network = nullptr;
+	const struct nnp_size inputSize = { 4, 4 };
+	ASSERT_EQ(nnp_status_success, nnp_network_create(1, 2, inputSize, &network));
+	ASSERT_EQ(nnp_status_success, nnp_network_add_softmax(network));
+	std::vector<float> data(2 * 4 * 4);
+	EXPECT_EQ(nnp_status_invalid_network, nnp_network_run(network, data.data(), data.data(), nullptr, nullptr));
+	nnp_network_destroy(network);
+}
+
+TEST(NETWORK_API, add_after_plan) {
+	nnp_network_t network = nullptr;
+	const struct nnp_size inputSize = { 4, 4 };
+	ASSERT_EQ(nnp_status_success, nnp_network_create(1, 2, inputSize, &network));
+	ASSERT_EQ(nnp_status_success, nnp_network_add_relu(network, 0.0f));
+	ASSERT_EQ(nnp_status_success, nnp_network_plan(network, nullptr));
+	EXPECT_EQ(nnp_status_invalid_network, nnp_network_add_softmax(network));
+	EXPECT_EQ(nnp_status_invalid_network, nnp_network_plan(network, nullptr));
+	nnp_network_destroy(network);
+}
+
+TEST(NETWORK_API, empty_network) {
+	nnp_network_t network = nullptr;
+	const struct nnp_size inputSize = { 4, 4 };
+	ASSERT_EQ(nnp_status_success, nnp_network_create(1, 2, inputSize, &network));
+	EXPECT_EQ(nnp_status_invalid_network, nnp_network_plan(network, nullptr));
+	nnp_network_destroy(network);
+}
+
+TEST(NETWORK_API, save_before_plan) {
+	nnp_network_t network = nullptr;
+	const struct nnp_size inputSize = { 4, 4 };
+	ASSERT_EQ(nnp_status_success, nnp_network_create(1, 2, inputSize, &network));
+	ASSERT_EQ(nnp_status_success, nnp_network_add_softmax(network));
+	EXPECT_EQ(nnp_status_invalid_network, nnp_network_save(network, "/tmp/nnpack-unplanned-model"));
+	nnp_network_destroy(network);
+}
+
+TEST(NETWORK_API, load_missing_file) {
+	nnp_network_t network = nullptr;
+	EXPECT_EQ(nnp_status_io_error, nnp_network_load("/nonexistent/nnpack-model", 1, nullptr, &network));
+	EXPECT_EQ(nullptr, network);
+}
+
+TEST(NETWORK_API, load_invalid_file) {
+	char path[] = "/tmp/nnpack-model-XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_NE(-1, fd);
+	const std::vector<char> data(4096, 'x');
+	ASSERT_EQ(ssize_t(data.size()), write(fd, data.data(), data.size()));
+	close(fd);
+
+	nnp_network_t network = nullptr;
+	EXPECT_EQ(nnp_status_invalid_file_format, nnp_network_load(path, 1, nullptr, &network));
+	EXPECT_EQ(nullptr, network);
+	remove(path);
+}
+
+TEST(NETWORK_API, load_streaming_invalid_file) {
+	char path[] = "/tmp/nnpack-model-XXXXXX";
+	const int fd = mkstemp(path);
+	ASSERT_NE(-1, fd);
+	const std::vector<char> data(4096, 'x');
+	ASSERT_EQ(ssize_t(data.size()), write(fd, data.data(), data.size()));
+	close(fd);
+
+	nnp_network_t network = nullptr;
+	EXPECT_EQ(nnp_status_invalid_file_format, nnp_network_load_streaming(path, 1, nullptr, &network));
+	EXPECT_EQ(nullptr, network);
+	remove(path);
+
+	EXPECT_EQ(nnp_status_io_error, nnp_network_load_streaming("/nonexistent/nnpack-model", 1, nullptr, &network));
+	EXPECT_EQ(nullptr, network);
+}
+
+TEST(NETWORK_API, stream_profile_without_streaming) {
+	nnp_network_t network = nullptr;
+	const struct nnp_size inputSize = { 4, 4 };
+	ASSERT_EQ(nnp_status_success, nnp_network_create(1, 2, inputSize, &network));
+	ASSERT_EQ(nnp_status_success, nnp_network_add_softmax(network));
+	ASSERT_EQ(nnp_status_success, nnp_network_plan(network, nullptr));
+	struct nnp_network_stream_profile profile = { 0 };
+	EXPECT_EQ(nnp_status_invalid_network, nnp_network_get_stream_profile(network, &profile));
+	nnp_network_destroy(network);
+}
+
+TEST(NETWORK_API, load_misaligned_memory) {
+	std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> model(4096);
+	nnp_network_t network = nullptr;
+	EXPECT_EQ(nnp_status_misaligned_buffer, nnp_network_load_memory(model.data() + 4, 4092, 1, nullptr, &network));
+	EXPECT_EQ(nnp_status_invalid_file_format, nnp_network_load_memory(model.data(), model.size(), 1, nullptr, &network));
+	EXPECT_EQ(nullptr, network);
+}
+
+TEST(NETWORK_API, missing_model_image) {
+	EXPECT_EQ(nullptr, nnp_model_image_find("nonexistent model"));
+}
+
+TEST(NETWORK_API, reuse_auto_algorithm) {
+	nnp_network_t network = nullptr;
+	const struct nnp_size inputSize = { 4, 4 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size unitStride = { 1, 1 };
+	const struct nnp_padding unitPadding = { 1, 1, 1, 1 };
+	std::vector<float> kernel(4 * 2 * 3 * 3);
+	ASSERT_EQ(nnp_status_success, nnp_network_create(1, 2, inputSize, &network));
+	EXPECT_EQ(nnp_status_invalid_algorithm,
+		nnp_network_add_convolution(network,
+			nnp_convolution_algorithm_auto, nnp_convolution_transform_strategy_reuse,
+			4, unitPadding, kernelSize, unitStride,
+			kernel.data(), nullptr, nnp_activation_identity, nullptr));
+	nnp_network_destroy(network);
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,44 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/network.h>
+#include <models/vgg-a.h>
+
+/*
+ * VGG model A network
+ */
+
+TEST(NETWORK, memory) {
+	VGG_A::network()
+		.testMemory();
+}
+
+TEST(NETWORK, output) {
+	VGG_A::network()
+		.errorLimit(1.0e-3)
+		.testOutput();
+}
+
+TEST(NETWORK_PRECOMPUTE, output) {
+	VGG_A::network()
+		.transformStrategy(nnp_convolution_transform_strategy_precompute)
+		.errorLimit(1.0e-3)
+		.testOutput();
+}
+
+/* Weights of fully connected layers dominate: only the largest even-indexed and odd-indexed layers are in memory */
+TEST(NETWORK_STREAM, output) {
+	VGG_A::network()
+		.streamModel(true)
+		.errorLimit(1.0e-3)
+		.testModel();
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,293 @@
+#include <gtest/gtest.h>
+
+#include <nnpack.h>
+
+#include <testers/convolution.h>
+
+TEST(IMPLICIT_GEMM, single_tile) {
+	ConvolutionTester()
+		.inputSize(4, 4)
+		.kernelSize(3, 3)
+		.iterations(100)
+		.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, multi_channel) {
+	ConvolutionTester()
+		.inputSize(9, 11)
+		.kernelSize(3, 3)
+		.inputChannels(7)
+		.outputChannels(13)
+		.iterations(10)
+		.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, odd_reduction_size) {
+	for (size_t inputChannels = 1; inputChannels <= 5; inputChannels += 2) {
+		ConvolutionTester()
+			.inputSize(7, 7)
+			.kernelSize(1, 3)
+			.inputChannels(inputChannels)
+			.outputChannels(5)
+			.iterations(10)
+			.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+	}
+}
+
+TEST(IMPLICIT_GEMM, varying_output_channels) {
+	for (size_t outputChannels = 1; outputChannels <= 17; outputChannels++) {
+		ConvolutionTester()
+			.inputSize(5, 5)
+			.kernelSize(3, 3)
+			.inputChannels(3)
+			.outputChannels(outputChannels)
+			.iterations(3)
+			.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+	}
+}
+
+TEST(IMPLICIT_GEMM, varying_width) {
+	for (size_t width = 1; width <= 19; width++) {
+		ConvolutionTester()
+			.inputSize(3, width)
+			.kernelSize(3, 3)
+			.inputPadding(1, 1, 1, 1)
+			.inputChannels(2)
+			.outputChannels(3)
+			.iterations(3)
+			.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+	}
+}
+
+TEST(IMPLICIT_GEMM, implicit_padding) {
+	for (size_t padding = 0; padding < 3; padding++) {
+		ConvolutionTester()
+			.inputSize(12, 13)
+			.kernelSize(3, 3)
+			.inputPadding(padding, padding, padding, padding)
+			.inputChannels(5)
+			.outputChannels(6)
+			.iterations(5)
+			.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+	}
+}
+
+TEST(IMPLICIT_GEMM, asymmetric_padding) {
+	ConvolutionTester()
+		.inputSize(11, 13)
+		.kernelSize(5, 3)
+		.inputPadding(2, 0, 1, 2)
+		.inputChannels(3)
+		.outputChannels(7)
+		.iterations(5)
+		.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, output_subsampling) {
+	ConvolutionTester()
+		.inputSize(15, 16)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(4)
+		.outputChannels(9)
+		.iterations(5)
+		.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, multiple_reduction_blocks) {
+	/* The reduction spans several L1 blocks of every backend */
+	ConvolutionTester()
+		.inputSize(5, 6)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(1031)
+		.outputChannels(6)
+		.iterations(1)
+		.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, batch) {
+	ConvolutionTester()
+		.inputSize(7, 8)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.batchSize(3)
+		.inputChannels(5)
+		.outputChannels(11)
+		.iterations(5)
+		.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, output_range) {
+	ConvolutionTester()
+		.inputSize(9, 9)
+		.kernelSize(3, 3)
+		.inputChannels(6)
+		.outputChannels(10)
+		.iterations(10)
+		.testQ8Inference(nnp_convolution_algorithm_implicit_gemm, 100, 160);
+}
+
+TEST(IMPLICIT_GEMM, multithreading) {
+	ConvolutionTester()
+		.inputSize(13, 14)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(8)
+		.outputChannels(19)
+		.multithreading(true)
+		.iterations(10)
+		.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(IMPLICIT_GEMM, internal_workspace) {
+	ConvolutionTester()
+		.inputSize(9, 10)
+		.kernelSize(3, 3)
+		.inputChannels(5)
+		.outputChannels(7)
+		.internalWorkspace(true)
+		.iterations(5)
+		.testQ8Inference(nnp_convolution_algorithm_implicit_gemm);
+}
+
+TEST(DIRECT_1x1, single_channel) {
+	ConvolutionTester()
+		.inputSize(4, 4)
+		.kernelSize(1, 1)
+		.iterations(100)
+		.testQ8Inference(nnp_convolution_algorithm_direct);
+}
+
+TEST(DIRECT_1x1, multi_channel) {
+	ConvolutionTester()
+		.inputSize(13, 11)
+		.kernelSize(1, 1)
+		.inputChannels(17)
+		.outputChannels(23)
+		.iterations(10)
+		.testQ8Inference(nnp_convolution_algorithm_direct);
+}
+
+TEST(DIRECT_1x1, odd_input_channels) {
+	for (size_t inputChannels = 1; inputChannels <= 9; inputChannels += 2) {
+		ConvolutionTester()
+			.inputSize(6, 7)
+			.kernelSize(1, 1)
+			.inputChannels(inputChannels)
+			.outputChannels(6)
+			.iterations(5)
+			.testQ8Inference(nnp_convolution_algorithm_direct);
+	}
+}
+
+TEST(DIRECT_1x1, output_subsampling) {
+	ConvolutionTester()
+		.inputSize(15, 16)
+		.kernelSize(1, 1)
+		.outputSubsampling(2, 2)
+		.inputChannels(8)
+		.outputChannels(12)
+		.iterations(5)
+		.testQ8Inference(nnp_convolution_algorithm_direct);
+}
+
+TEST(DIRECT_1x1, multiple_reduction_blocks) {
+	ConvolutionTester()
+		.inputSize(5, 7)
+		.kernelSize(1, 1)
+		.inputChannels(9001)
+		.outputChannels(5)
+		.iterations(1)
+		.testQ8Inference(nnp_convolution_algorithm_direct);
+}
+
+TEST(DIRECT_1x1, multithreading) {
+	ConvolutionTester()
+		.inputSize(16, 17)
+		.kernelSize(1, 1)
+		.batchSize(2)
+		.inputChannels(32)
+		.outputChannels(27)
+		.multithreading(true)
+		.iterations(5)
+		.testQ8Inference(nnp_convolution_algorithm_direct);
+}
+
+TEST(AUTO, pointwise) {
+	ConvolutionTester()
+		.inputSize(8, 8)
+		.kernelSize(1, 1)
+		.inputChannels(16)
+		.outputChannels(16)
+		.iterations(5)
+		.testQ8Inference(nnp_convolution_algorithm_auto);
+}
+
+TEST(AUTO, conv3x3) {
+	ConvolutionTester()
+		.inputSize(8, 8)
+		.kernelSize(3, 3)
+		.inputPadding(1, 1, 1, 1)
+		.inputChannels(16)
+		.outputChannels(16)
+		.iterations(5)
+		.testQ8Inference(nnp_convolution_algorithm_auto);
+}
+
+TEST(Q8_CONVOLUTION, unsupported_algorithm) {
+	const float scale = 1.0f;
+	const struct nnp_q8_convolution_parameters quantization = { 0, 0, 0, 255, &scale };
+	const struct nnp_size inputSize = { 4, 4 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 3, 3 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	size_t workspaceSize = 0;
+	EXPECT_EQ(nnp_status_unsupported_algorithm,
+		nnp_convolution_inference_q8(nnp_convolution_algorithm_direct,
+			1, 1, 1, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, &quantization,
+			nullptr, &workspaceSize, nullptr, nullptr));
+	EXPECT_EQ(nnp_status_unsupported_algorithm,
+		nnp_convolution_inference_q8(nnp_convolution_algorithm_wt8x8,
+			1, 1, 1, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, &quantization,
+			nullptr, &workspaceSize, nullptr, nullptr));
+}
+
+TEST(Q8_CONVOLUTION, invalid_quantization_parameters) {
+	const float scales[2] = { 1.0f, -1.0f };
+	const struct nnp_size inputSize = { 4, 4 };
+	const struct nnp_padding inputPadding = { 0, 0, 0, 0 };
+	const struct nnp_size kernelSize = { 1, 1 };
+	const struct nnp_size outputSubsampling = { 1, 1 };
+	size_t workspaceSize = 0;
+	EXPECT_EQ(nnp_status_invalid_quantization_parameters,
+		nnp_convolution_inference_q8(nnp_convolution_algorithm_auto,
+			1, 1, 1, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, nullptr,
+			nullptr, &workspaceSize, nullptr, nullptr));
+
+	const struct nnp_q8_convolution_parameters negativeScale = { 0, 0, 0, 255, scales };
+	EXPECT_EQ(nnp_status_invalid_quantization_parameters,
+		nnp_convolution_inference_q8(nnp_convolution_algorithm_auto,
+			1, 1, 2, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, &negativeScale,
+			nullptr, &workspaceSize, nullptr, nullptr));
+
+	const struct nnp_q8_convolution_parameters emptyRange = { 0, 0, 200, 100, scales };
+	EXPECT_EQ(nnp_status_invalid_quantization_parameters,
+		nnp_convolution_inference_q8(nnp_convolution_algorithm_auto,
+			1, 1, 1, inputSize, inputPadding, kernelSize, outputSubsampling,
+			nullptr, nullptr, nullptr, nullptr, &emptyRange,
+			nullptr, &workspaceSize, nullptr, nullptr));
+}
+
+int main(int argc, char* argv[]) {
+	const enum nnp_status init_status = nnp_initialize();
+	assert(init_status == nnp_status_success);
+	setenv("TERM", "xterm-256color", 0);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
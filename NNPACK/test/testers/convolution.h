@@ -13,6 +13,7 @@
 
 #include <nnpack.h>
 #include <nnpack/reference.h>
+#include <nnpack/utils.h>
 #include <nnpack/AlignedAllocator.h>
 
 #include <testers/relu.h>
@@ -23,14 +24,21 @@ public:
 		iterations_(1),
 		errorLimit_(1.0e-5),
 		multithreading_(false),
+		internalWorkspace_(false),
 		batchSize_(1),
+		groups_(1),
 		inputChannels_(1),
-		outputChannels_(1)
+		outputChannels_(1),
+		reluNegativeSlope_(0.0f)
 	{
 		inputSize(4, 4);
 		kernelSize(3, 3);
+		kernelDilation(1, 1);
 		inputPadding(0, 0, 0, 0);
 		outputSubsampling(1, 1);
+		poolingSize(1, 1);
+		poolingStride(1, 1);
+		clampRange(-INFINITY, INFINITY);
 
 		this->threadpool = nullptr;
 	}
@@ -41,13 +49,20 @@ public:
 		iterations_(tester.iterations_),
 		errorLimit_(tester.errorLimit_),
 		multithreading_(tester.multithreading_),
+		internalWorkspace_(tester.internalWorkspace_),
 		batchSize_(tester.batchSize_),
+		groups_(tester.groups_),
 		inputChannels_(tester.inputChannels_),
 		outputChannels_(tester.outputChannels_),
 		inputSize_(tester.inputSize_),
 		inputPadding_(tester.inputPadding_),
 		kernelSize_(tester.kernelSize_),
+		kernelDilation_(tester.kernelDilation_),
 		outputSubsampling_(tester.outputSubsampling_),
+		poolingSize_(tester.poolingSize_),
+		poolingStride_(tester.poolingStride_),
+		reluNegativeSlope_(tester.reluNegativeSlope_),
+		clampParameters_(tester.clampParameters_),
 		threadpool(tester.threadpool)
 	{
 		tester.threadpool = nullptr;
@@ -95,6 +110,16 @@ public:
 		return this->multithreading_;
 	}
 
+	/* When set, tests pass no scratch buffer and let NNPACK draw scratch memory from its workspace arena */
+	inline ConvolutionTester& internalWorkspace(bool internalWorkspace) {
+		this->internalWorkspace_ = internalWorkspace;
+		return *this;
+	}
+
+	inline bool internalWorkspace() const {
+		return this->internalWorkspace_;
+	}
+
 	inline ConvolutionTester& batchSize(size_t batchSize) {
 		this->batchSize_ = batchSize;
 		return *this;
@@ -104,6 +129,15 @@ public:
 		return this->batchSize_;
 	}
 
+	inline ConvolutionTester& groups(size_t groups) {
+		this->groups_ = groups;
+		return *this;
+	}
+
+	inline size_t groups() const {
+		return this->groups_;
+	}
+
 	inline ConvolutionTester& inputChannels(size_t inputChannels) {
 		this->inputChannels_ = inputChannels;
 		return *this;
@@ -158,6 +192,20 @@ public:
 		return this->kernelSize_.width;
 	}
 
+	inline ConvolutionTester& kernelDilation(size_t height, size_t width) {
+		this->kernelDilation_.height = height;
+		this->kernelDilation_.width = width;
+		return *this;
+	}
+
+	inline struct nnp_size kernelDilation() const {
+		return this->kernelDilation_;
+	}
+
+	inline bool dilated() const {
+		return this->kernelDilation_.height != 1 || this->kernelDilation_.width != 1;
+	}
+
 	inline struct nnp_size outputSize() const {
 		struct nnp_size outputSize;
 		outputSize.height = this->outputHeight();
@@ -166,11 +214,13 @@ public:
 	}
 
 	inline size_t outputHeight() const {
-		return (this->inputPadding_.top + this->inputSize_.height + this->inputPadding_.bottom - this->kernelSize_.height) / this->outputSubsampling_.height + 1;
+		const size_t dilatedKernelHeight = (this->kernelSize_.height - 1) * this->kernelDilation_.height + 1;
+		return (this->inputPadding_.top + this->inputSize_.height + this->inputPadding_.bottom - dilatedKernelHeight) / this->outputSubsampling_.height + 1;
 	}
 
 	inline size_t outputWidth() const {
-		return (this->inputPadding_.left + this->inputSize_.width + this->inputPadding_.right - this->kernelSize_.width) / this->outputSubsampling_.width + 1;
+		const size_t dilatedKernelWidth = (this->kernelSize_.width - 1) * this->kernelDilation_.width + 1;
+		return (this->inputPadding_.left + this->inputSize_.width + this->inputPadding_.right - dilatedKernelWidth) / this->outputSubsampling_.width + 1;
 	}
 
 	inline ConvolutionTester& outputSubsampling(size_t height, size_t width) {
@@ -183,6 +233,53 @@ public:
 		return this->outputSubsampling_;
 	}
 
+	/* Max-pooling of the convolution output in testInferenceMaxPooling and testInferenceWithOptions */
+	inline ConvolutionTester& poolingSize(size_t height, size_t width) {
+		this->poolingSize_.height = height;
+		this->poolingSize_.width = width;
+		return *this;
+	}
+
+	inline struct nnp_size poolingSize() const {
+		return this->poolingSize_;
+	}
+
+	inline ConvolutionTester& poolingStride(size_t height, size_t width) {
+		this->poolingStride_.height = height;
+		this->poolingStride_.width = width;
+		return *this;
+	}
+
+	inline struct nnp_size poolingStride() const {
+		return this->poolingStride_;
+	}
+
+	inline struct nnp_size pooledSize() const {
+		struct nnp_size pooledSize;
+		pooledSize.height = 1 + divide_round_up(
+			std::max(outputHeight(), this->poolingSize_.height) - this->poolingSize_.height, this->poolingStride_.height);
+		pooledSize.width = 1 + divide_round_up(
+			std::max(outputWidth(), this->poolingSize_.width) - this->poolingSize_.width, this->poolingStride_.width);
+		return pooledSize;
+	}
+
+	/* Negative slope of nnp_activation_relu; non-zero slopes run leaky ReLU */
+	inline ConvolutionTester& reluNegativeSlope(float reluNegativeSlope) {
+		this->reluNegativeSlope_ = reluNegativeSlope;
+		return *this;
+	}
+
+	inline float reluNegativeSlope() const {
+		return this->reluNegativeSlope_;
+	}
+
+	/* Output range of nnp_activation_clamp */
+	inline ConvolutionTester& clampRange(float outputMin, float outputMax) {
+		this->clampParameters_.output_min = outputMin;
+		this->clampParameters_.output_max = outputMax;
+		return *this;
+	}
+
 	inline ConvolutionTester& inputPadding(size_t top, size_t right, size_t bottom, size_t left) {
 		this->inputPadding_.top = top;
 		this->inputPadding_.right = right;
@@ -216,6 +313,9 @@ public:
 			activation, nullptr,
 			this->threadpool, nullptr);
 		ASSERT_EQ(nnp_status_success, status);
+		if (internalWorkspace()) {
+			scratchSize = 0;
+		}
 
 		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
 		std::vector<float> maxErrors;
@@ -232,18 +332,7 @@ public:
 				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
 				this->threadpool);
 
-			switch (activation) {
-				case nnp_activation_identity:
-					break;
-				case nnp_activation_relu:
-					nnp_relu_output__reference(
-						batchSize(), outputChannels() * outputHeight() * outputWidth(),
-						referenceOutput.data(), referenceOutput.data(), 0.0,
-						this->threadpool);
-					break;
-				default:
-					FAIL() << "Unexpected activation value: " << activation;
-			}
+			activateReference(activation, referenceOutput);
 
 			enum nnp_status status = nnp_convolution_output(
 				algorithm,
@@ -283,6 +372,9 @@ public:
 			nnp_activation_identity, nullptr,
 			this->threadpool, nullptr);
 		ASSERT_EQ(nnp_status_success, status);
+		if (internalWorkspace()) {
+			scratchSize = 0;
+		}
 
 		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
 		std::vector<float> maxErrors;
@@ -335,6 +427,9 @@ public:
 			nnp_activation_identity, nullptr,
 			this->threadpool, nullptr);
 		ASSERT_EQ(nnp_status_success, status);
+		if (internalWorkspace()) {
+			scratchSize = 0;
+		}
 
 		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
 		std::vector<float> maxErrors;
@@ -370,29 +465,29 @@ public:
 	}
 
 	void testInference(enum nnp_convolution_algorithm algorithm, enum nnp_activation activation = nnp_activation_identity, bool precompute = false) const {
-		ASSERT_EQ(1, batchSize());
-
 		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
 		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed));
 
-		std::vector<float> input(inputChannels() * inputHeight() * inputWidth());
-		std::vector<float> kernel(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+		std::vector<float> input(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernel(outputChannels() * inputChannels() / groups() * kernelHeight() * kernelWidth());
 
 		std::vector<float> bias(outputChannels());
 
-		std::vector<float> output(outputChannels() * outputHeight() * outputWidth());
-		std::vector<float> referenceOutput(outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> output(batchSize() * outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(batchSize() * outputChannels() * outputHeight() * outputWidth());
 
 		size_t scratchSize = 0;
-		enum nnp_status status = nnp_convolution_inference(
+		enum nnp_status status = convolutionInference(
 			algorithm,
 			precompute ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute,
-			inputChannels(), outputChannels(),
 			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
 			nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
-			activation, nullptr,
+			activation, activationParameters(activation),
 			this->threadpool, nullptr);
 		ASSERT_EQ(nnp_status_success, status);
+		if (internalWorkspace()) {
+			scratchSize = 0;
+		}
 
 		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
 
@@ -404,46 +499,33 @@ public:
 			std::fill(output.begin(), output.end(), nanf(""));
 			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
 
-			nnp_convolution_output__reference(
-				1, inputChannels(), outputChannels(),
-				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nnp_dilated_convolution_output__reference(
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
 				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
 				this->threadpool);
 
-			switch (activation) {
-				case nnp_activation_identity:
-					break;
-				case nnp_activation_relu:
-					nnp_relu_output__reference(
-						batchSize(), outputChannels() * outputHeight() * outputWidth(),
-						referenceOutput.data(), referenceOutput.data(), 0.0,
-						this->threadpool);
-					break;
-				default:
-					FAIL() << "Unexpected activation value: " << activation;
-			}
+			activateReference(activation, referenceOutput);
 
 			std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> transformedKernel;
 
 			if (precompute) {
 				size_t transformedKernelSize = 0;
-				enum nnp_status status = nnp_convolution_inference(
+				enum nnp_status status = convolutionInference(
 					algorithm, nnp_convolution_transform_strategy_precompute,
-					inputChannels(), outputChannels(),
 					inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
 					nullptr, nullptr, nullptr, nullptr, nullptr, &transformedKernelSize,
-					activation, nullptr,
+					activation, activationParameters(activation),
 					threadpool, nullptr);
 				ASSERT_EQ(nnp_status_success, status);
 
 				transformedKernel.resize(transformedKernelSize);
 
-				status = nnp_convolution_inference(
+				status = convolutionInference(
 					algorithm, nnp_convolution_transform_strategy_precompute,
-					inputChannels(), outputChannels(),
 					inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
 					nullptr, kernel.data(), nullptr, nullptr, transformedKernel.data(), &transformedKernelSize,
-					activation, nullptr,
+					activation, activationParameters(activation),
 					threadpool, nullptr);
 				ASSERT_EQ(nnp_status_success, status);
 			}
@@ -452,15 +534,517 @@ public:
 			if (precompute) {
 				kernelData = transformedKernel.data();
 			}
-			enum nnp_status status = nnp_convolution_inference(
+			enum nnp_status status = convolutionInference(
 				algorithm,
 				precompute ? nnp_convolution_transform_strategy_reuse : nnp_convolution_transform_strategy_compute,
-				inputChannels(), outputChannels(),
 				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
 				input.data(), static_cast<const float*>(kernelData), bias.data(), output.data(),
 				scratchSize == 0 ? nullptr : scratchBuffer.data(),
 				scratchSize == 0 ? nullptr : &scratchSize,
-				activation, nullptr,
+				activation, activationParameters(activation),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			maxErrors.push_back(maxError);
+		}
+		EXPECT_LT(median(maxErrors), errorLimit());
+	}
+
+	/* Runs nnp_convolution_inference_nhwc on channels-last copies of the input and compares with the planar reference */
+	void testInferenceNHWC(enum nnp_convolution_algorithm algorithm, enum nnp_activation activation = nnp_activation_identity) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed));
+
+		const size_t inputPixels = inputHeight() * inputWidth();
+		const size_t outputPixels = outputHeight() * outputWidth();
+		std::vector<float> input(batchSize() * inputChannels() * inputPixels);
+		std::vector<float> inputNHWC(input.size());
+		std::vector<float> kernel(outputChannels() * inputChannels() / groups() * kernelHeight() * kernelWidth());
+
+		std::vector<float> bias(outputChannels());
+
+		std::vector<float> outputNHWC(batchSize() * outputChannels() * outputPixels);
+		std::vector<float> referenceOutput(batchSize() * outputChannels() * outputPixels);
+
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::fill(outputNHWC.begin(), outputNHWC.end(), nanf(""));
+			for (size_t sample = 0; sample < batchSize(); sample++) {
+				for (size_t channel = 0; channel < inputChannels(); channel++) {
+					for (size_t pixel = 0; pixel < inputPixels; pixel++) {
+						inputNHWC[(sample * inputPixels + pixel) * inputChannels() + channel] =
+							input[(sample * inputChannels() + channel) * inputPixels + pixel];
+					}
+				}
+			}
+
+			nnp_dilated_convolution_output__reference(
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
+				this->threadpool);
+
+			activateReference(activation, referenceOutput);
+
+			enum nnp_status status = nnp_convolution_inference_nhwc(
+				algorithm, nnp_convolution_transform_strategy_compute,
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				inputNHWC.data(), kernel.data(), bias.data(), outputNHWC.data(),
+				nullptr, nullptr,
+				activation, activationParameters(activation),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			float maxError = 0.0f;
+			for (size_t sample = 0; sample < batchSize(); sample++) {
+				for (size_t channel = 0; channel < outputChannels(); channel++) {
+					for (size_t pixel = 0; pixel < outputPixels; pixel++) {
+						maxError = std::max(maxError, relativeError(
+							referenceOutput[(sample * outputChannels() + channel) * outputPixels + pixel],
+							outputNHWC[(sample * outputPixels + pixel) * outputChannels() + channel]));
+					}
+				}
+			}
+			maxErrors.push_back(maxError);
+		}
+		EXPECT_LT(median(maxErrors), errorLimit());
+	}
+
+	/* Runs nnp_convolution_inference_residual; if inPlace is true, the residual is passed in the output buffer */
+	void testInferenceResidual(enum nnp_convolution_algorithm algorithm, enum nnp_activation activation = nnp_activation_identity, bool inPlace = false) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed));
+		auto residualRng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed + 1));
+
+		std::vector<float> input(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernel(outputChannels() * inputChannels() / groups() * kernelHeight() * kernelWidth());
+
+		std::vector<float> bias(outputChannels());
+		std::vector<float> residual(batchSize() * outputChannels() * outputHeight() * outputWidth());
+
+		std::vector<float> output(batchSize() * outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(batchSize() * outputChannels() * outputHeight() * outputWidth());
+
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::generate(residual.begin(), residual.end(), std::ref(residualRng));
+			if (inPlace) {
+				output = residual;
+			} else {
+				std::fill(output.begin(), output.end(), nanf(""));
+			}
+
+			nnp_dilated_convolution_output__reference(
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
+				this->threadpool);
+			for (size_t index = 0; index < referenceOutput.size(); index++) {
+				referenceOutput[index] += residual[index];
+			}
+			activateReference(activation, referenceOutput);
+
+			enum nnp_status status = nnp_convolution_inference_residual(
+				algorithm, nnp_convolution_transform_strategy_compute,
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), inPlace ? output.data() : residual.data(), output.data(),
+				nullptr, nullptr,
+				activation, activationParameters(activation),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			maxErrors.push_back(maxError);
+		}
+		EXPECT_LT(median(maxErrors), errorLimit());
+	}
+
+	void testInferenceMaxPooling(enum nnp_convolution_algorithm algorithm, enum nnp_activation activation = nnp_activation_identity) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernel(outputChannels() * inputChannels() / groups() * kernelHeight() * kernelWidth());
+
+		std::vector<float> bias(outputChannels());
+
+		const struct nnp_size pooledSize = this->pooledSize();
+		std::vector<float> convolutionOutput(batchSize() * outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> output(batchSize() * outputChannels() * pooledSize.height * pooledSize.width);
+		std::vector<float> referenceOutput(batchSize() * outputChannels() * pooledSize.height * pooledSize.width);
+
+		size_t scratchSize = 0;
+		enum nnp_status status = nnp_convolution_inference_max_pooling(
+			algorithm, nnp_convolution_transform_strategy_compute,
+			batchSize(), groups(), inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+			poolingSize(), poolingStride(),
+			nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
+			activation, activationParameters(activation),
+			this->threadpool, nullptr);
+		ASSERT_EQ(nnp_status_success, status);
+		if (internalWorkspace()) {
+			scratchSize = 0;
+		}
+
+		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
+
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), nanf(""));
+			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
+
+			nnp_dilated_convolution_output__reference(
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), convolutionOutput.data(),
+				this->threadpool);
+			activateReference(activation, convolutionOutput);
+			const struct nnp_padding poolingPadding = { 0, 0, 0, 0 };
+			nnp_max_pooling_output__reference(
+				batchSize(), outputChannels(),
+				outputSize(), poolingPadding, poolingSize(), poolingStride(),
+				convolutionOutput.data(), referenceOutput.data(),
+				this->threadpool);
+
+			status = nnp_convolution_inference_max_pooling(
+				algorithm, nnp_convolution_transform_strategy_compute,
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				poolingSize(), poolingStride(),
+				input.data(), kernel.data(), bias.data(), output.data(),
+				scratchSize == 0 ? nullptr : scratchBuffer.data(),
+				scratchSize == 0 ? nullptr : &scratchSize,
+				activation, activationParameters(activation),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			maxErrors.push_back(maxError);
+		}
+		EXPECT_LT(median(maxErrors), errorLimit());
+	}
+
+	/*
+	 * Runs nnp_convolution_inference_bounded with the workspace budget set to 1/workspaceDivisor of the workspace which
+	 * nnp_convolution_inference_dilated queries for the layer, so that layers with workspaceDivisor > 1 are split.
+	 */
+	void testInferenceBounded(enum nnp_convolution_algorithm algorithm, size_t workspaceDivisor, enum nnp_activation activation = nnp_activation_identity) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernel(outputChannels() * inputChannels() / groups() * kernelHeight() * kernelWidth());
+
+		std::vector<float> bias(outputChannels());
+
+		std::vector<float> output(batchSize() * outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(batchSize() * outputChannels() * outputHeight() * outputWidth());
+
+		size_t layerScratchSize = 0;
+		enum nnp_status status = nnp_convolution_inference_dilated(
+			algorithm, nnp_convolution_transform_strategy_compute,
+			batchSize(), groups(), inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+			nullptr, nullptr, nullptr, nullptr, nullptr, &layerScratchSize,
+			activation, activationParameters(activation),
+			this->threadpool, nullptr);
+		ASSERT_EQ(nnp_status_success, status);
+
+		const size_t scratchSize = round_up(layerScratchSize / workspaceDivisor, 64);
+		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
+
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), nanf(""));
+			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
+
+			nnp_dilated_convolution_output__reference(
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
+				this->threadpool);
+			activateReference(activation, referenceOutput);
+
+			status = nnp_convolution_inference_bounded(
+				algorithm, nnp_convolution_transform_strategy_compute,
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), output.data(),
+				internalWorkspace() ? nullptr : scratchBuffer.data(), scratchSize,
+				activation, activationParameters(activation),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			maxErrors.push_back(maxError);
+		}
+		EXPECT_LT(median(maxErrors), errorLimit());
+	}
+
+	/*
+	 * Runs nnp_convolution_inference_with_options with the given combination of options, and max-pooling configured by
+	 * poolingSize/poolingStride. If workspaceDivisor is non-zero, the workspace limit is set to 1/workspaceDivisor of the
+	 * workspace which the unlimited call queries for the layer.
+	 */
+	void testInferenceWithOptions(enum nnp_convolution_algorithm algorithm, bool channelsLast, bool residual,
+		size_t workspaceDivisor = 0, enum nnp_activation activation = nnp_activation_identity) const
+	{
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed));
+		auto residualRng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed + 1));
+
+		const size_t inputPixels = inputHeight() * inputWidth();
+		const size_t outputPixels = outputHeight() * outputWidth();
+		const struct nnp_size pooledSize = this->pooledSize();
+		const size_t pooledPixels = pooledSize.height * pooledSize.width;
+		std::vector<float> input(batchSize() * inputChannels() * inputPixels);
+		std::vector<float> layerInput(input.size());
+		std::vector<float> kernel(outputChannels() * inputChannels() / groups() * kernelHeight() * kernelWidth());
+
+		std::vector<float> bias(outputChannels());
+		std::vector<float> residualInput(batchSize() * outputChannels() * outputPixels);
+		std::vector<float> layerResidual(residualInput.size());
+
+		std::vector<float> convolutionOutput(batchSize() * outputChannels() * outputPixels);
+		std::vector<float> output(batchSize() * outputChannels() * pooledPixels);
+		std::vector<float> referenceOutput(batchSize() * outputChannels() * pooledPixels);
+
+		struct nnp_convolution_options options = { };
+		options.channels_last = channelsLast;
+		options.pooling_size = poolingSize();
+		options.pooling_stride = poolingStride();
+
+		size_t scratchSize = 0;
+		enum nnp_status status = nnp_convolution_inference_with_options(
+			algorithm, nnp_convolution_transform_strategy_compute,
+			batchSize(), groups(), inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+			nullptr, nullptr, nullptr, nullptr, nullptr, &scratchSize,
+			activation, activationParameters(activation), &options,
+			this->threadpool, nullptr);
+		ASSERT_EQ(nnp_status_success, status);
+		if (workspaceDivisor != 0) {
+			scratchSize = round_up(scratchSize / workspaceDivisor, 64);
+			options.workspace_limit = scratchSize;
+
+			size_t boundedScratchSize = 0;
+			status = nnp_convolution_inference_with_options(
+				algorithm, nnp_convolution_transform_strategy_compute,
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				nullptr, nullptr, nullptr, nullptr, nullptr, &boundedScratchSize,
+				activation, activationParameters(activation), &options,
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+			ASSERT_LE(boundedScratchSize, scratchSize);
+		}
+		if (internalWorkspace()) {
+			scratchSize = 0;
+		}
+
+		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
+
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::generate(residualInput.begin(), residualInput.end(), std::ref(residualRng));
+			std::fill(output.begin(), output.end(), nanf(""));
+			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
+
+			if (channelsLast) {
+				toChannelsLast(inputChannels(), inputPixels, input, layerInput);
+				toChannelsLast(outputChannels(), outputPixels, residualInput, layerResidual);
+			} else {
+				layerInput = input;
+				layerResidual = residualInput;
+			}
+
+			nnp_dilated_convolution_output__reference(
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), convolutionOutput.data(),
+				this->threadpool);
+			if (residual) {
+				for (size_t index = 0; index < convolutionOutput.size(); index++) {
+					convolutionOutput[index] += residualInput[index];
+				}
+			}
+			activateReference(activation, convolutionOutput);
+			const struct nnp_padding poolingPadding = { 0, 0, 0, 0 };
+			nnp_max_pooling_output__reference(
+				batchSize(), outputChannels(),
+				outputSize(), poolingPadding, poolingSize(), poolingStride(),
+				convolutionOutput.data(), referenceOutput.data(),
+				this->threadpool);
+
+			options.residual = residual ? layerResidual.data() : nullptr;
+			status = nnp_convolution_inference_with_options(
+				algorithm, nnp_convolution_transform_strategy_compute,
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+				layerInput.data(), kernel.data(), bias.data(), output.data(),
+				scratchSize == 0 ? nullptr : scratchBuffer.data(),
+				scratchSize == 0 ? nullptr : &scratchSize,
+				activation, activationParameters(activation), &options,
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			float maxError = 0.0f;
+			for (size_t sample = 0; sample < batchSize(); sample++) {
+				for (size_t channel = 0; channel < outputChannels(); channel++) {
+					for (size_t pixel = 0; pixel < pooledPixels; pixel++) {
+						const size_t outputIndex = channelsLast ?
+							(sample * pooledPixels + pixel) * outputChannels() + channel :
+							(sample * outputChannels() + channel) * pooledPixels + pixel;
+						maxError = std::max(maxError, relativeError(
+							referenceOutput[(sample * outputChannels() + channel) * pooledPixels + pixel],
+							output[outputIndex]));
+					}
+				}
+			}
+			maxErrors.push_back(maxError);
+		}
+		EXPECT_LT(median(maxErrors), errorLimit());
+	}
+
+	void testInferencePlan(enum nnp_convolution_algorithm algorithm, enum nnp_activation activation = nnp_activation_identity) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed));
+
+		std::vector<float> input(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernel(outputChannels() * inputChannels() / groups() * kernelHeight() * kernelWidth());
+
+		std::vector<float> bias(outputChannels());
+
+		std::vector<float> output(batchSize() * outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(batchSize() * outputChannels() * outputHeight() * outputWidth());
+
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+
+			nnp_convolution_plan_t plan = nullptr;
+			enum nnp_status status;
+			if (dilated()) {
+				status = nnp_convolution_plan_create_dilated(
+					algorithm,
+					batchSize(), groups(), inputChannels(), outputChannels(),
+					inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+					kernel.data(), bias.data(),
+					activation, activationParameters(activation),
+					this->threadpool, &plan);
+			} else if (groups() != 1) {
+				status = nnp_convolution_plan_create_grouped(
+					algorithm,
+					batchSize(), groups(), inputChannels(), outputChannels(),
+					inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+					kernel.data(), bias.data(),
+					activation, activationParameters(activation),
+					this->threadpool, &plan);
+			} else {
+				status = nnp_convolution_plan_create(
+					algorithm,
+					batchSize(), inputChannels(), outputChannels(),
+					inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+					kernel.data(), bias.data(),
+					activation, activationParameters(activation),
+					this->threadpool, &plan);
+			}
+			ASSERT_EQ(nnp_status_success, status);
+			if (algorithm != nnp_convolution_algorithm_auto) {
+				ASSERT_EQ(algorithm, nnp_convolution_plan_get_algorithm(plan));
+			}
+
+			/* The plan must not depend on the original kernel and bias buffers */
+			std::vector<float> planKernel(kernel);
+			std::vector<float> planBias(bias);
+			std::fill(kernel.begin(), kernel.end(), nanf(""));
+			std::fill(bias.begin(), bias.end(), nanf(""));
+
+			/* Execute the plan several times to check that executions do not interfere */
+			for (size_t execution = 0; execution < 2; execution++) {
+				std::generate(input.begin(), input.end(), std::ref(rng));
+				std::fill(output.begin(), output.end(), nanf(""));
+
+				nnp_dilated_convolution_output__reference(
+					batchSize(), groups(), inputChannels(), outputChannels(),
+					inputSize(), inputPadding(), kernelSize(), kernelDilation(), outputSubsampling(),
+					input.data(), planKernel.data(), planBias.data(), referenceOutput.data(),
+					this->threadpool);
+
+				activateReference(activation, referenceOutput);
+
+				status = nnp_convolution_plan_execute(plan, input.data(), output.data(), this->threadpool, nullptr);
+				if (status != nnp_status_success) {
+					nnp_convolution_plan_destroy(plan);
+				}
+				ASSERT_EQ(nnp_status_success, status);
+
+				const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+					[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+				maxErrors.push_back(maxError);
+			}
+			nnp_convolution_plan_destroy(plan);
+		}
+		EXPECT_LT(median(maxErrors), errorLimit());
+	}
+
+	/* Depthwise convolution uses inputChannels() as the number of channels, and ignores outputChannels() */
+	void testDepthwiseInference(enum nnp_activation activation = nnp_activation_identity) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed));
+
+		std::vector<float> input(inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernel(inputChannels() * kernelHeight() * kernelWidth());
+
+		std::vector<float> bias(inputChannels());
+
+		std::vector<float> output(inputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(inputChannels() * outputHeight() * outputWidth());
+
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::fill(output.begin(), output.end(), nanf(""));
+
+			nnp_depthwise_convolution_output__reference(
+				1, inputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
+				this->threadpool);
+
+			activateReference(activation, referenceOutput);
+
+			enum nnp_status status = nnp_depthwise_convolution_inference(
+				inputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), output.data(),
+				activation, activationParameters(activation),
 				this->threadpool, nullptr);
 			ASSERT_EQ(nnp_status_success, status);
 
@@ -471,10 +1055,318 @@ public:
 		EXPECT_LT(median(maxErrors), errorLimit());
 	}
 
+	/*
+	 * Runs nnp_convolution_inference_q8 on random uint8 input and int8 kernel. The reference accumulates exactly in
+	 * int32 and requantizes in the same way, so the output must match bit for bit.
+	 */
+	void testQ8Inference(enum nnp_convolution_algorithm algorithm, uint8_t outputMin = 0, uint8_t outputMax = 255) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		std::mt19937 rng(seed);
+		auto u8rng = std::bind(std::uniform_int_distribution<int>(0, 255), std::ref(rng));
+		auto s8rng = std::bind(std::uniform_int_distribution<int>(-127, 127), std::ref(rng));
+		auto biasrng = std::bind(std::uniform_int_distribution<int32_t>(-10000, 10000), std::ref(rng));
+		auto scalerng = std::bind(std::uniform_real_distribution<float>(0.5f, 1.5f), std::ref(rng));
+
+		const size_t reductionSize = inputChannels() * kernelHeight() * kernelWidth();
+		const size_t outputImageSize = outputHeight() * outputWidth();
+		std::vector<uint8_t> input(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<int8_t> kernel(outputChannels() * reductionSize);
+		std::vector<int32_t> bias(outputChannels());
+		std::vector<float> scales(outputChannels(), 1.0f);
+
+		std::vector<uint8_t> output(batchSize() * outputChannels() * outputImageSize);
+		std::vector<uint8_t> referenceOutput(batchSize() * outputChannels() * outputImageSize);
+
+		struct nnp_q8_convolution_parameters quantization = { 0 };
+		quantization.requantization_scales = scales.data();
+		quantization.output_min = outputMin;
+		quantization.output_max = outputMax;
+
+		size_t scratchSize = 0;
+		enum nnp_status status = nnp_convolution_inference_q8(
+			algorithm,
+			batchSize(), inputChannels(), outputChannels(),
+			inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+			nullptr, nullptr, nullptr, nullptr, &quantization,
+			nullptr, &scratchSize,
+			this->threadpool, nullptr);
+		ASSERT_EQ(nnp_status_success, status);
+		if (internalWorkspace()) {
+			scratchSize = 0;
+		}
+
+		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> scratchBuffer(scratchSize);
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(u8rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(s8rng));
+			std::generate(bias.begin(), bias.end(), std::ref(biasrng));
+			std::fill(output.begin(), output.end(), 0xA5);
+			std::fill(scratchBuffer.begin(), scratchBuffer.end(), 0xA5);
+
+			quantization.input_zero_point = u8rng();
+			quantization.output_zero_point = u8rng();
+			/* Spread the outputs over a few dozen quantization steps around the zero point */
+			const float accumulatorRange = 128.0f * 128.0f * std::sqrt(float(reductionSize));
+			for (float& scale : scales) {
+				scale = scalerng() * 32.0f / accumulatorRange;
+			}
+
+			for (size_t sample = 0; sample < batchSize(); sample++) {
+				for (size_t outputChannel = 0; outputChannel < outputChannels(); outputChannel++) {
+					for (size_t y = 0; y < outputHeight(); y++) {
+						for (size_t x = 0; x < outputWidth(); x++) {
+							int32_t accumulator = bias[outputChannel];
+							for (size_t inputChannel = 0; inputChannel < inputChannels(); inputChannel++) {
+								for (size_t i = 0; i < kernelHeight(); i++) {
+									for (size_t j = 0; j < kernelWidth(); j++) {
+										const size_t s = y * outputSubsampling().height + i - inputPadding().top;
+										const size_t t = x * outputSubsampling().width + j - inputPadding().left;
+										int32_t value = 0;
+										if (s < inputHeight() && t < inputWidth()) {
+											value = int32_t(input[((sample * inputChannels() + inputChannel) * inputHeight() + s) * inputWidth() + t]) -
+												int32_t(quantization.input_zero_point);
+										}
+										accumulator += value *
+											int32_t(kernel[((outputChannel * inputChannels() + inputChannel) * kernelHeight() + i) * kernelWidth() + j]);
+									}
+								}
+							}
+							const long scaled = lrintf(float(accumulator) * scales[outputChannel]) + long(quantization.output_zero_point);
+							referenceOutput[((sample * outputChannels() + outputChannel) * outputHeight() + y) * outputWidth() + x] =
+								uint8_t(std::min<long>(std::max<long>(scaled, outputMin), outputMax));
+						}
+					}
+				}
+			}
+
+			status = nnp_convolution_inference_q8(
+				algorithm,
+				batchSize(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), output.data(), &quantization,
+				scratchSize == 0 ? nullptr : scratchBuffer.data(),
+				scratchSize == 0 ? nullptr : &scratchSize,
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			for (size_t index = 0; index < output.size(); index++) {
+				ASSERT_EQ(int(referenceOutput[index]), int(output[index])) << "at output element " << index;
+			}
+		}
+	}
+
+	/*
+	 * Runs the layer on NCHWc-blocked tensors. If chained is true, the blocked output is fed, without conversion,
+	 * into a second 3x3 convolution with unit padding and outputChannels() channels on both sides.
+	 */
+	void testNCHWcInference(enum nnp_activation activation = nnp_activation_identity, bool chained = false) const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-0.1, 1.0), std::mt19937(seed));
+
+		const size_t channelBlock = nnp_nchwc_channel_block_size();
+		ASSERT_NE(0, channelBlock);
+		const size_t inputChannelBlocks = (inputChannels() + channelBlock - 1) / channelBlock;
+		const size_t outputChannelBlocks = (outputChannels() + channelBlock - 1) / channelBlock;
+		const struct nnp_size chainKernelSize = { 3, 3 };
+		const struct nnp_padding chainPadding = { 1, 1, 1, 1 };
+		const struct nnp_size unitSubsampling = { 1, 1 };
+
+		std::vector<float> input(batchSize() * inputChannels() * inputHeight() * inputWidth());
+		std::vector<float> kernel(outputChannels() * inputChannels() * kernelHeight() * kernelWidth());
+		std::vector<float> bias(outputChannels());
+		std::vector<float> chainKernel(outputChannels() * outputChannels() * 9);
+		std::vector<float> chainBias(outputChannels());
+
+		std::vector<float> blockedInput(batchSize() * inputChannelBlocks * inputHeight() * inputWidth() * channelBlock);
+		std::vector<float> blockedOutput(batchSize() * outputChannelBlocks * outputHeight() * outputWidth() * channelBlock);
+		std::vector<float> blockedChainOutput(blockedOutput.size());
+
+		std::vector<float> output(batchSize() * outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceOutput(batchSize() * outputChannels() * outputHeight() * outputWidth());
+		std::vector<float> referenceChainOutput(referenceOutput.size());
+
+		std::vector<float> maxErrors;
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::generate(kernel.begin(), kernel.end(), std::ref(rng));
+			std::generate(bias.begin(), bias.end(), std::ref(rng));
+			std::generate(chainKernel.begin(), chainKernel.end(), std::ref(rng));
+			std::generate(chainBias.begin(), chainBias.end(), std::ref(rng));
+			std::fill(blockedOutput.begin(), blockedOutput.end(), nanf(""));
+			std::fill(blockedChainOutput.begin(), blockedChainOutput.end(), nanf(""));
+			std::fill(output.begin(), output.end(), nanf(""));
+
+			nnp_convolution_output__reference(
+				batchSize(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				input.data(), kernel.data(), bias.data(), referenceOutput.data(),
+				this->threadpool);
+
+			activateReference(activation, referenceOutput);
+
+			enum nnp_status status = nnp_convert_nchw_to_nchwc(
+				batchSize(), inputChannels(), inputSize(),
+				input.data(), blockedInput.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			status = nnp_convolution_inference_nchwc(
+				batchSize(), inputChannels(), outputChannels(),
+				inputSize(), inputPadding(), kernelSize(), outputSubsampling(),
+				blockedInput.data(), kernel.data(), bias.data(), blockedOutput.data(),
+				nullptr, nullptr,
+				activation, activationParameters(activation),
+				this->threadpool, nullptr);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float* finalBlockedOutput = blockedOutput.data();
+			const float* finalReferenceOutput = referenceOutput.data();
+			if (chained) {
+				nnp_convolution_output__reference(
+					batchSize(), outputChannels(), outputChannels(),
+					outputSize(), chainPadding, chainKernelSize, unitSubsampling,
+					referenceOutput.data(), chainKernel.data(), chainBias.data(), referenceChainOutput.data(),
+					this->threadpool);
+
+				status = nnp_convolution_inference_nchwc(
+					batchSize(), outputChannels(), outputChannels(),
+					outputSize(), chainPadding, chainKernelSize, unitSubsampling,
+					blockedOutput.data(), chainKernel.data(), chainBias.data(), blockedChainOutput.data(),
+					nullptr, nullptr,
+					nnp_activation_identity, nullptr,
+					this->threadpool, nullptr);
+				ASSERT_EQ(nnp_status_success, status);
+
+				finalBlockedOutput = blockedChainOutput.data();
+				finalReferenceOutput = referenceChainOutput.data();
+			}
+
+			/* Lanes past the last output channel must stay zero for the next blocked layer */
+			const size_t outputPixels = batchSize() * outputChannelBlocks * outputHeight() * outputWidth();
+			for (size_t pixel = 0; pixel < outputPixels; pixel++) {
+				const size_t channelStart = (pixel / (outputHeight() * outputWidth()) % outputChannelBlocks) * channelBlock;
+				for (size_t lane = 0; lane < channelBlock; lane++) {
+					if (channelStart + lane >= outputChannels()) {
+						ASSERT_EQ(0.0f, finalBlockedOutput[pixel * channelBlock + lane]);
+					}
+				}
+			}
+
+			status = nnp_convert_nchwc_to_nchw(
+				batchSize(), outputChannels(), outputSize(),
+				finalBlockedOutput, output.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			const float maxError = std::inner_product(finalReferenceOutput, finalReferenceOutput + output.size(), output.cbegin(), 0.0f,
+				[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+			maxErrors.push_back(maxError);
+		}
+		EXPECT_LT(median(maxErrors), errorLimit());
+	}
+
 protected:
 	pthreadpool_t threadpool;
 
 private:
+	/* Use the single-image, dense, and undilated entry points when possible to keep them covered by the same tests */
+	inline enum nnp_status convolutionInference(
+		enum nnp_convolution_algorithm algorithm,
+		enum nnp_convolution_transform_strategy transformStrategy,
+		struct nnp_size inputSize, struct nnp_padding inputPadding,
+		struct nnp_size kernelSize, struct nnp_size outputSubsampling,
+		const float* input, const float* kernel, const float* bias, float* output,
+		void* workspaceBuffer, size_t* workspaceSize,
+		enum nnp_activation activation, const void* activationParameters,
+		pthreadpool_t threadpool, struct nnp_profile* profile) const
+	{
+		if (dilated()) {
+			return nnp_convolution_inference_dilated(
+				algorithm, transformStrategy,
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize, inputPadding, kernelSize, kernelDilation(), outputSubsampling,
+				input, kernel, bias, output,
+				workspaceBuffer, workspaceSize,
+				activation, activationParameters,
+				threadpool, profile);
+		} else if (groups() != 1) {
+			return nnp_convolution_inference_grouped(
+				algorithm, transformStrategy,
+				batchSize(), groups(), inputChannels(), outputChannels(),
+				inputSize, inputPadding, kernelSize, outputSubsampling,
+				input, kernel, bias, output,
+				workspaceBuffer, workspaceSize,
+				activation, activationParameters,
+				threadpool, profile);
+		} else if (batchSize() == 1) {
+			return nnp_convolution_inference(
+				algorithm, transformStrategy,
+				inputChannels(), outputChannels(),
+				inputSize, inputPadding, kernelSize, outputSubsampling,
+				input, kernel, bias, output,
+				workspaceBuffer, workspaceSize,
+				activation, activationParameters,
+				threadpool, profile);
+		} else {
+			return nnp_convolution_inference_batch(
+				algorithm, transformStrategy,
+				batchSize(), inputChannels(), outputChannels(),
+				inputSize, inputPadding, kernelSize, outputSubsampling,
+				input, kernel, bias, output,
+				workspaceBuffer, workspaceSize,
+				activation, activationParameters,
+				threadpool, profile);
+		}
+	}
+
+	/* Converts batchSize() images from NCHW to NHWC layout */
+	void toChannelsLast(size_t channels, size_t pixels, const std::vector<float>& nchw, std::vector<float>& nhwc) const {
+		for (size_t sample = 0; sample < batchSize(); sample++) {
+			for (size_t channel = 0; channel < channels; channel++) {
+				for (size_t pixel = 0; pixel < pixels; pixel++) {
+					nhwc[(sample * pixels + pixel) * channels + channel] = nchw[(sample * channels + channel) * pixels + pixel];
+				}
+			}
+		}
+	}
+
+	inline const void* activationParameters(enum nnp_activation activation) const {
+		switch (activation) {
+			case nnp_activation_relu:
+				return reluNegativeSlope() != 0.0f ? &this->reluNegativeSlope_ : nullptr;
+			case nnp_activation_clamp:
+				return &this->clampParameters_;
+			default:
+				return nullptr;
+		}
+	}
+
+	void activateReference(enum nnp_activation activation, std::vector<float>& output) const {
+		switch (activation) {
+			case nnp_activation_identity:
+				break;
+			case nnp_activation_relu:
+				nnp_relu_output__reference(
+					1, output.size(),
+					output.data(), output.data(), reluNegativeSlope(),
+					this->threadpool);
+				break;
+			case nnp_activation_relu6:
+				for (float& value : output) {
+					value = std::min(std::max(value, 0.0f), 6.0f);
+				}
+				break;
+			case nnp_activation_clamp:
+				for (float& value : output) {
+					value = std::min(std::max(value, clampParameters_.output_min), clampParameters_.output_max);
+				}
+				break;
+			default:
+				ADD_FAILURE() << "Unexpected activation value: " << activation;
+		}
+	}
+
 	inline static float relativeError(float reference, float actual) {
 		return std::abs(reference - actual) / std::max(FLT_MIN, std::abs(reference));
 	}
@@ -487,12 +1379,19 @@ private:
 	size_t iterations_;
 	float errorLimit_;
 	bool multithreading_;
+	bool internalWorkspace_;
 
 	size_t batchSize_;
+	size_t groups_;
 	size_t inputChannels_;
 	size_t outputChannels_;
 	struct nnp_size inputSize_;
 	struct nnp_padding inputPadding_;
 	struct nnp_size kernelSize_;
+	struct nnp_size kernelDilation_;
 	struct nnp_size outputSubsampling_;
+	struct nnp_size poolingSize_;
+	struct nnp_size poolingStride_;
+	float reluNegativeSlope_;
+	struct nnp_clamp_parameters clampParameters_;
 };
@@ -0,0 +1,686 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstdio>
+
+#include <cmath>
+#include <cfloat>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+
+#include <unistd.h>
+
+#include <nnpack.h>
+#include <nnpack/reference.h>
+#include <nnpack/utils.h>
+
+#include <testers/convolution.h>
+#include <testers/fully-connected.h>
+#include <testers/pooling.h>
+#include <testers/relu.h>
+
+class NetworkTester {
+public:
+	NetworkTester() :
+		errorLimit_(1.0e-5),
+		multithreading_(false),
+		batchSize_(1),
+		inputChannels_(1),
+		algorithm_(nnp_convolution_algorithm_auto),
+		transformStrategy_(nnp_convolution_transform_strategy_compute),
+		foreignModel_(false),
+		modelInMemory_(false),
+		streamModel_(false)
+	{
+		inputSize(1, 1);
+
+		this->threadpool = nullptr;
+	}
+
+	NetworkTester(const NetworkTester&) = delete;
+
+	inline NetworkTester(NetworkTester&& tester) :
+		errorLimit_(tester.errorLimit_),
+		multithreading_(tester.multithreading_),
+		batchSize_(tester.batchSize_),
+		inputChannels_(tester.inputChannels_),
+		inputHeight_(tester.inputHeight_),
+		inputWidth_(tester.inputWidth_),
+		algorithm_(tester.algorithm_),
+		transformStrategy_(tester.transformStrategy_),
+		foreignModel_(tester.foreignModel_),
+		modelInMemory_(tester.modelInMemory_),
+		streamModel_(tester.streamModel_),
+		layers_(std::move(tester.layers_)),
+		threadpool(tester.threadpool)
+	{
+		tester.threadpool = nullptr;
+	}
+
+	NetworkTester& operator=(const NetworkTester&) = delete;
+
+	~NetworkTester() {
+		if (this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+	}
+
+	inline NetworkTester& errorLimit(float errorLimit) {
+		this->errorLimit_ = errorLimit;
+		return *this;
+	}
+
+	inline float errorLimit() const {
+		return this->errorLimit_;
+	}
+
+	inline NetworkTester& multithreading(bool multithreading) {
+		this->multithreading_ = multithreading;
+		if (multithreading && this->threadpool == nullptr) {
+			this->threadpool = pthreadpool_create(0);
+		} else if (!multithreading && this->threadpool != nullptr) {
+			pthreadpool_destroy(this->threadpool);
+			this->threadpool = nullptr;
+		}
+		return *this;
+	}
+
+	inline bool multithreading() const {
+		return this->multithreading_;
+	}
+
+	inline NetworkTester& batchSize(size_t batchSize) {
+		this->batchSize_ = batchSize;
+		return *this;
+	}
+
+	inline size_t batchSize() const {
+		return this->batchSize_;
+	}
+
+	inline NetworkTester& inputChannels(size_t inputChannels) {
+		this->inputChannels_ = inputChannels;
+		return *this;
+	}
+
+	inline size_t inputChannels() const {
+		return this->inputChannels_;
+	}
+
+	inline NetworkTester& inputSize(size_t height, size_t width) {
+		this->inputHeight_ = height;
+		this->inputWidth_ = width;
+		return *this;
+	}
+
+	inline struct nnp_size inputSize() const {
+		struct nnp_size inputSize;
+		inputSize.height = this->inputHeight_;
+		inputSize.width = this->inputWidth_;
+		return inputSize;
+	}
+
+	inline NetworkTester& algorithm(enum nnp_convolution_algorithm algorithm) {
+		this->algorithm_ = algorithm;
+		return *this;
+	}
+
+	inline enum nnp_convolution_algorithm algorithm() const {
+		return this->algorithm_;
+	}
+
+	inline NetworkTester& transformStrategy(enum nnp_convolution_transform_strategy transformStrategy) {
+		this->transformStrategy_ = transformStrategy;
+		return *this;
+	}
+
+	inline enum nnp_convolution_transform_strategy transformStrategy() const {
+		return this->transformStrategy_;
+	}
+
+	/* Whether testModel patches the hardware key of the model file, so that the loader can not reuse transformed kernels */
+	inline NetworkTester& foreignModel(bool foreignModel) {
+		this->foreignModel_ = foreignModel;
+		return *this;
+	}
+
+	inline bool foreignModel() const {
+		return this->foreignModel_;
+	}
+
+	/* Whether testModel reads the model file into memory and loads it with nnp_network_load_memory */
+	inline NetworkTester& modelInMemory(bool modelInMemory) {
+		this->modelInMemory_ = modelInMemory;
+		return *this;
+	}
+
+	inline bool modelInMemory() const {
+		return this->modelInMemory_;
+	}
+
+	/* Whether testModel loads the model file with nnp_network_load_streaming, and runs the network twice */
+	inline NetworkTester& streamModel(bool streamModel) {
+		this->streamModel_ = streamModel;
+		return *this;
+	}
+
+	inline bool streamModel() const {
+		return this->streamModel_;
+	}
+
+	inline NetworkTester& convolution(size_t outputChannels,
+		struct nnp_size kernelSize, struct nnp_padding inputPadding, struct nnp_size outputSubsampling)
+	{
+		Layer layer = { Layer::Convolution };
+		layer.outputChannels = outputChannels;
+		layer.kernelSize = kernelSize;
+		layer.inputPadding = inputPadding;
+		layer.outputSubsampling = outputSubsampling;
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	/* Convolutional layer with the parameters of a layer definition in test/models */
+	inline NetworkTester& convolution(const ConvolutionTester& model) {
+		return convolution(model.outputChannels(), model.kernelSize(), model.inputPadding(), model.outputSubsampling());
+	}
+
+	inline NetworkTester& maxPooling(struct nnp_size poolingSize, struct nnp_size poolingStride, struct nnp_padding inputPadding) {
+		Layer layer = { Layer::MaxPooling };
+		layer.kernelSize = poolingSize;
+		layer.outputSubsampling = poolingStride;
+		layer.inputPadding = inputPadding;
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	inline NetworkTester& maxPooling(const PoolingTester& model) {
+		return maxPooling(model.poolingSize(), model.poolingStride(), model.inputPadding());
+	}
+
+	inline NetworkTester& relu(float negativeSlope = 0.0f) {
+		Layer layer = { Layer::ReLU };
+		layer.negativeSlope = negativeSlope;
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	inline NetworkTester& relu(const ReLUTester& model) {
+		return relu();
+	}
+
+	inline NetworkTester& fullyConnected(size_t outputChannels) {
+		Layer layer = { Layer::FullyConnected };
+		layer.outputChannels = outputChannels;
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	inline NetworkTester& fullyConnected(const FullyConnectedTester& model) {
+		return fullyConnected(model.outputChannels());
+	}
+
+	inline NetworkTester& softmax() {
+		Layer layer = { Layer::Softmax };
+		this->layers_.push_back(layer);
+		return *this;
+	}
+
+	void testOutput() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+
+		const std::vector<Shape> shapes = layerShapes();
+		const std::vector<Weights> weights = generateWeights(rng);
+
+		std::vector<float> input(batchSize() * inputShape().elements());
+		std::vector<float> output(batchSize() * shapes.back().elements());
+		std::generate(input.begin(), input.end(), std::ref(rng));
+		std::fill(output.begin(), output.end(), nanf(""));
+		const std::vector<float> referenceOutput = computeReferenceOutput(input, weights);
+
+		nnp_network_t network = nullptr;
+		ASSERT_EQ(nnp_status_success, createNetwork(weights, &network));
+
+		enum nnp_status status = nnp_network_plan(network, this->threadpool);
+		ASSERT_EQ(nnp_status_success, status);
+
+		size_t outputChannels = 0;
+		struct nnp_size outputSize = { 0, 0 };
+		ASSERT_EQ(nnp_status_success, nnp_network_get_output_shape(network, &outputChannels, &outputSize));
+		ASSERT_EQ(shapes.back().channels, outputChannels);
+		ASSERT_EQ(shapes.back().size.height, outputSize.height);
+		ASSERT_EQ(shapes.back().size.width, outputSize.width);
+
+		struct nnp_profile profile = { 0 };
+		status = nnp_network_run(network, input.data(), output.data(), this->threadpool, &profile);
+		nnp_network_destroy(network);
+		ASSERT_EQ(nnp_status_success, status);
+		EXPECT_GT(profile.total, 0.0);
+
+		const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+			[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+		EXPECT_LT(maxError, errorLimit());
+	}
+
+	/*
+	 * Saves the planned network to a model file and checks the output of the network loaded from it. Weights are
+	 * overwritten before loading, so the loaded network can only read them from the file. Unless the model is foreign,
+	 * the loaded network reuses transformed kernels from the file and owns no parameters.
+	 */
+	void testModel() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(-1.0f, +1.0f), std::mt19937(seed));
+
+		const std::vector<Shape> shapes = layerShapes();
+		std::vector<Weights> weights = generateWeights(rng);
+
+		std::vector<float> input(batchSize() * inputShape().elements());
+		std::vector<float> output(batchSize() * shapes.back().elements());
+		std::generate(input.begin(), input.end(), std::ref(rng));
+		std::fill(output.begin(), output.end(), nanf(""));
+		const std::vector<float> referenceOutput = computeReferenceOutput(input, weights);
+
+		char path[] = "/tmp/nnpack-model-XXXXXX";
+		const int fd = mkstemp(path);
+		ASSERT_NE(-1, fd);
+		close(fd);
+
+		nnp_network_t network = nullptr;
+		ASSERT_EQ(nnp_status_success, createNetwork(weights, &network));
+		enum nnp_status status = nnp_network_plan(network, this->threadpool);
+		struct nnp_network_memory savedMemory = { 0 };
+		if (status == nnp_status_success) {
+			status = nnp_network_get_memory(network, &savedMemory);
+		}
+		if (status == nnp_status_success) {
+			status = nnp_network_save(network, path);
+		}
+		nnp_network_destroy(network);
+		ASSERT_EQ(nnp_status_success, status);
+
+		if (foreignModel()) {
+			/* The backend is the first field of the hardware key, after the magic, version, and byte order mark */
+			FILE* file = fopen(path, "r+b");
+			ASSERT_NE(nullptr, file);
+			const uint32_t foreignBackend = UINT32_MAX;
+			ASSERT_EQ(0, fseek(file, 16, SEEK_SET));
+			ASSERT_EQ(1, fwrite(&foreignBackend, sizeof(foreignBackend), 1, file));
+			ASSERT_EQ(0, fclose(file));
+		}
+
+		for (Weights& layerWeights : weights) {
+			std::fill(layerWeights.kernel.begin(), layerWeights.kernel.end(), nanf(""));
+			std::fill(layerWeights.bias.begin(), layerWeights.bias.end(), nanf(""));
+		}
+
+		network = nullptr;
+		std::vector<uint8_t, AlignedAllocator<uint8_t, 64>> model;
+		if (modelInMemory()) {
+			FILE* file = fopen(path, "rb");
+			ASSERT_NE(nullptr, file);
+			ASSERT_EQ(0, fseek(file, 0, SEEK_END));
+			const size_t modelSize = ftell(file);
+			model.resize(modelSize);
+			ASSERT_EQ(0, fseek(file, 0, SEEK_SET));
+			ASSERT_EQ(1, fread(model.data(), modelSize, 1, file));
+			ASSERT_EQ(0, fclose(file));
+			status = nnp_network_load_memory(model.data(), modelSize, batchSize(), this->threadpool, &network);
+		} else if (streamModel()) {
+			status = nnp_network_load_streaming(path, batchSize(), this->threadpool, &network);
+		} else {
+			status = nnp_network_load(path, batchSize(), this->threadpool, &network);
+		}
+		remove(path);
+		ASSERT_EQ(nnp_status_success, status);
+
+		struct nnp_network_memory memory = { 0 };
+		struct nnp_network_stream_profile streamProfile = { 0 };
+		status = nnp_network_get_memory(network, &memory);
+		if (status == nnp_status_success) {
+			status = nnp_network_run(network, input.data(), output.data(), this->threadpool, nullptr);
+		}
+		if (status == nnp_status_success && streamModel()) {
+			/* The second run starts with parameters read ahead at the end of the first one */
+			std::fill(output.begin(), output.end(), nanf(""));
+			status = nnp_network_run(network, input.data(), output.data(), this->threadpool, nullptr);
+			if (status == nnp_status_success) {
+				status = nnp_network_get_stream_profile(network, &streamProfile);
+			}
+		}
+		nnp_network_destroy(network);
+		ASSERT_EQ(nnp_status_success, status);
+
+		if (streamModel() && foreignModel()) {
+			/* Streamed layers transform raw kernels in every run, in workspaces in the arena */
+			EXPECT_GE(memory.arena_size, savedMemory.arena_size);
+		} else {
+			EXPECT_EQ(savedMemory.arena_size, memory.arena_size);
+		}
+		if (streamModel()) {
+			EXPECT_GT(streamProfile.reads, 0);
+			EXPECT_GT(streamProfile.bytes_read, 0);
+			if (foreignModel() || transformStrategy() == nnp_convolution_transform_strategy_compute) {
+				/* Raw kernels are streamed: each buffer fits the largest kernel and bias of the layers which use it */
+				size_t bufferSize[2] = { 0, 0 };
+				size_t streamedLayers = 0;
+				for (const Weights& layerWeights : weights) {
+					if (!layerWeights.kernel.empty()) {
+						const size_t kernelSize = (layerWeights.kernel.size() * sizeof(float) + 63) / 64 * 64;
+						size_t& size = bufferSize[streamedLayers++ % 2];
+						size = std::max(size, kernelSize + layerWeights.bias.size() * sizeof(float));
+					}
+				}
+				EXPECT_EQ(bufferSize[0] + bufferSize[1], memory.parameters_size);
+			}
+		} else {
+			EXPECT_EQ(foreignModel() ? savedMemory.parameters_size : 0, memory.parameters_size);
+		}
+
+		const float maxError = std::inner_product(referenceOutput.cbegin(), referenceOutput.cend(), output.cbegin(), 0.0f,
+			[](float x, float y)->float { return std::max<float>(y, x); }, relativeError);
+		EXPECT_LT(maxError, errorLimit());
+	}
+
+	/*
+	 * Checks the memory plan of the network against the lifetimes of its buffers: an output tensor lives from the layer
+	 * which produces it to the last layer which reads it (element-wise layers update their input in place), and a
+	 * workspace lives only in its layer. Weights are not read by nnp_network_plan with the compute transform strategy.
+	 */
+	void testMemory() const {
+		ASSERT_EQ(nnp_convolution_transform_strategy_compute, transformStrategy());
+
+		const std::vector<Shape> shapes = layerShapes();
+		std::vector<Weights> weights(this->layers_.size());
+
+		nnp_network_t network = nullptr;
+		ASSERT_EQ(nnp_status_success, createNetwork(weights, &network));
+		enum nnp_status status = nnp_network_plan(network, this->threadpool);
+		struct nnp_network_memory memory = { 0 };
+		if (status == nnp_status_success) {
+			status = nnp_network_get_memory(network, &memory);
+		}
+		nnp_network_destroy(network);
+		ASSERT_EQ(nnp_status_success, status);
+
+		/* Buffers of the network, with the first and the last step (non-fused layer) where they are live */
+		struct Buffer {
+			size_t size;
+			size_t first;
+			size_t last;
+		};
+		std::vector<Buffer> buffers;
+		size_t steps = 0;
+		ptrdiff_t tensor = -1;
+		for (size_t i = 0; i < this->layers_.size(); i++) {
+			const Layer& layer = this->layers_[i];
+			if (fusedIntoConvolution(i)) {
+				continue;
+			}
+
+			if (tensor >= 0) {
+				buffers[tensor].last = steps;
+			}
+			const bool inPlace = (layer.type == Layer::ReLU || layer.type == Layer::Softmax) && tensor >= 0;
+			if (!inPlace) {
+				buffers.push_back(Buffer { round_up(batchSize() * shapes[i].elements() * sizeof(float), 64), steps, steps });
+				tensor = buffers.size() - 1;
+			}
+
+			if (layer.type == Layer::Convolution) {
+				const Shape& input = i == 0 ? inputShape() : shapes[i - 1];
+				const bool relu = i + 1 < this->layers_.size() && fusedIntoConvolution(i + 1);
+				size_t workspaceSize = 0;
+				ASSERT_EQ(nnp_status_success,
+					nnp_convolution_inference_batch(
+						algorithm(), nnp_convolution_transform_strategy_compute,
+						batchSize(), input.channels, layer.outputChannels,
+						input.size, layer.inputPadding, layer.kernelSize, layer.outputSubsampling,
+						nullptr, nullptr, nullptr, nullptr, nullptr, &workspaceSize,
+						relu ? nnp_activation_relu : nnp_activation_identity, nullptr,
+						this->threadpool, nullptr));
+				buffers.push_back(Buffer { round_up(workspaceSize, 64), steps, steps });
+			}
+			steps++;
+		}
+		/* The last tensor is the caller's output buffer */
+		buffers[tensor].size = 0;
+
+		std::vector<size_t> liveSize(steps, 0);
+		size_t unplannedSize = 0;
+		for (const Buffer& buffer : buffers) {
+			for (size_t step = buffer.first; step <= buffer.last; step++) {
+				liveSize[step] += buffer.size;
+			}
+			unplannedSize += buffer.size;
+		}
+
+		const size_t peakLiveSize = *std::max_element(liveSize.cbegin(), liveSize.cend());
+		EXPECT_EQ(peakLiveSize, memory.peak_live_size);
+		EXPECT_EQ(unplannedSize, memory.unplanned_size);
+		EXPECT_EQ(peakLiveSize, memory.arena_size);
+		EXPECT_EQ(0, memory.parameters_size);
+	}
+
+protected:
+	pthreadpool_t threadpool;
+
+private:
+	struct Layer {
+		enum Type {
+			Convolution,
+			MaxPooling,
+			ReLU,
+			FullyConnected,
+			Softmax,
+		} type;
+		size_t outputChannels;
+		/* Kernel size and stride for convolutional layers, pooling size and stride for pooling layers */
+		struct nnp_size kernelSize;
+		struct nnp_size outputSubsampling;
+		struct nnp_padding inputPadding;
+		float negativeSlope;
+	};
+
+	struct Shape {
+		size_t channels;
+		struct nnp_size size;
+
+		inline size_t elements() const {
+			return channels * size.height * size.width;
+		}
+	};
+
+	struct Weights {
+		std::vector<float> kernel;
+		std::vector<float> bias;
+	};
+
+	inline Shape inputShape() const {
+		return Shape { inputChannels(), inputSize() };
+	}
+
+	/* Whether the ReLU layer at the index follows a convolution without activation, and thus the network fuses it */
+	inline bool fusedIntoConvolution(size_t index) const {
+		return this->layers_[index].type == Layer::ReLU && index != 0 &&
+			this->layers_[index - 1].type == Layer::Convolution;
+	}
+
+	std::vector<Shape> layerShapes() const {
+		std::vector<Shape> shapes;
+		Shape shape = inputShape();
+		for (const Layer& layer : this->layers_) {
+			switch (layer.type) {
+				case Layer::Convolution:
+					shape.channels = layer.outputChannels;
+					shape.size.height = (layer.inputPadding.top + shape.size.height + layer.inputPadding.bottom - layer.kernelSize.height) /
+						layer.outputSubsampling.height + 1;
+					shape.size.width = (layer.inputPadding.left + shape.size.width + layer.inputPadding.right - layer.kernelSize.width) /
+						layer.outputSubsampling.width + 1;
+					break;
+				case Layer::MaxPooling:
+					shape.size.height = divide_round_up(
+						doz(layer.inputPadding.top + shape.size.height + layer.inputPadding.bottom, layer.kernelSize.height),
+						layer.outputSubsampling.height) + 1;
+					shape.size.width = divide_round_up(
+						doz(layer.inputPadding.left + shape.size.width + layer.inputPadding.right, layer.kernelSize.width),
+						layer.outputSubsampling.width) + 1;
+					break;
+				case Layer::FullyConnected:
+					shape.channels = layer.outputChannels;
+					shape.size.height = 1;
+					shape.size.width = 1;
+					break;
+				case Layer::ReLU:
+				case Layer::Softmax:
+					break;
+			}
+			shapes.push_back(shape);
+		}
+		return shapes;
+	}
+
+	template <class RNG>
+	std::vector<Weights> generateWeights(RNG& rng) const {
+		const std::vector<Shape> shapes = layerShapes();
+		std::vector<Weights> weights(this->layers_.size());
+		for (size_t i = 0; i < this->layers_.size(); i++) {
+			const Layer& layer = this->layers_[i];
+			const Shape& input = i == 0 ? inputShape() : shapes[i - 1];
+			switch (layer.type) {
+				case Layer::Convolution:
+				{
+					/* Scale weights by the fan-in to keep activations of a deep network in a comparable range */
+					const size_t fanIn = input.channels * layer.kernelSize.height * layer.kernelSize.width;
+					weights[i].kernel.resize(layer.outputChannels * fanIn);
+					weights[i].bias.resize(layer.outputChannels);
+					std::generate(weights[i].kernel.begin(), weights[i].kernel.end(), std::ref(rng));
+					std::generate(weights[i].bias.begin(), weights[i].bias.end(), std::ref(rng));
+					for (float& w : weights[i].kernel) {
+						w /= std::sqrt(float(fanIn));
+					}
+					break;
+				}
+				case Layer::FullyConnected:
+				{
+					const size_t fanIn = input.elements();
+					weights[i].kernel.resize(layer.outputChannels * fanIn);
+					std::generate(weights[i].kernel.begin(), weights[i].kernel.end(), std::ref(rng));
+					for (float& w : weights[i].kernel) {
+						w /= std::sqrt(float(fanIn));
+					}
+					break;
+				}
+				default:
+					break;
+			}
+		}
+		return weights;
+	}
+
+	/* Reference output: every layer computed by the reference implementation into its own buffer */
+	std::vector<float> computeReferenceOutput(const std::vector<float>& input, const std::vector<Weights>& weights) const {
+		const std::vector<Shape> shapes = layerShapes();
+		std::vector<float> referenceInput(input);
+		std::vector<float> referenceOutput;
+		for (size_t i = 0; i < this->layers_.size(); i++) {
+			const Layer& layer = this->layers_[i];
+			const Shape& layerInput = i == 0 ? inputShape() : shapes[i - 1];
+			referenceOutput.assign(batchSize() * shapes[i].elements(), nanf(""));
+			switch (layer.type) {
+				case Layer::Convolution:
+					nnp_convolution_output__reference(
+						batchSize(), layerInput.channels, layer.outputChannels,
+						layerInput.size, layer.inputPadding, layer.kernelSize, layer.outputSubsampling,
+						referenceInput.data(), weights[i].kernel.data(), weights[i].bias.data(), referenceOutput.data(),
+						this->threadpool);
+					break;
+				case Layer::MaxPooling:
+					nnp_max_pooling_output__reference(
+						batchSize(), layerInput.channels,
+						layerInput.size, layer.inputPadding, layer.kernelSize, layer.outputSubsampling,
+						referenceInput.data(), referenceOutput.data(),
+						this->threadpool);
+					break;
+				case Layer::ReLU:
+					nnp_relu_output__reference(
+						batchSize(), layerInput.elements(),
+						referenceInput.data(), referenceOutput.data(), layer.negativeSlope,
+						this->threadpool);
+					break;
+				case Layer::FullyConnected:
+					nnp_fully_connected_output_f32__reference(
+						batchSize(), layerInput.elements(), layer.outputChannels,
+						referenceInput.data(), weights[i].kernel.data(), referenceOutput.data(),
+						this->threadpool);
+					break;
+				case Layer::Softmax:
+					nnp_softmax_output__reference(
+						batchSize(), layerInput.elements(),
+						referenceInput.data(), referenceOutput.data(),
+						this->threadpool);
+					break;
+			}
+			referenceInput.swap(referenceOutput);
+		}
+		return referenceInput;
+	}
+
+	enum nnp_status createNetwork(const std::vector<Weights>& weights, nnp_network_t* networkOut) const {
+		nnp_network_t network = nullptr;
+		enum nnp_status status = nnp_network_create(batchSize(), inputChannels(), inputSize(), &network);
+		for (size_t i = 0; i < this->layers_.size() && status == nnp_status_success; i++) {
+			const Layer& layer = this->layers_[i];
+			switch (layer.type) {
+				case Layer::Convolution:
+					status = nnp_network_add_convolution(network,
+						algorithm(), transformStrategy(),
+						layer.outputChannels, layer.inputPadding, layer.kernelSize, layer.outputSubsampling,
+						weights[i].kernel.data(), weights[i].bias.data(),
+						nnp_activation_identity, nullptr);
+					break;
+				case Layer::MaxPooling:
+					status = nnp_network_add_max_pooling(network, layer.inputPadding, layer.kernelSize, layer.outputSubsampling);
+					break;
+				case Layer::ReLU:
+					status = nnp_network_add_relu(network, layer.negativeSlope);
+					break;
+				case Layer::FullyConnected:
+					status = nnp_network_add_fully_connected(network, layer.outputChannels, weights[i].kernel.data());
+					break;
+				case Layer::Softmax:
+					status = nnp_network_add_softmax(network);
+					break;
+			}
+		}
+		if (status != nnp_status_success) {
+			nnp_network_destroy(network);
+			return status;
+		}
+		*networkOut = network;
+		return nnp_status_success;
+	}
+
+	inline static float relativeError(float reference, float actual) {
+		return std::abs(reference - actual) / std::max(FLT_MIN, std::abs(reference));
+	}
+
+	float errorLimit_;
+	bool multithreading_;
+
+	size_t batchSize_;
+	size_t inputChannels_;
+	size_t inputHeight_;
+	size_t inputWidth_;
+	enum nnp_convolution_algorithm algorithm_;
+	enum nnp_convolution_transform_strategy transformStrategy_;
+	bool foreignModel_;
+	bool modelInMemory_;
+	bool streamModel_;
+	std::vector<Layer> layers_;
+};
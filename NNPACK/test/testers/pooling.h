@@ -217,6 +217,56 @@ public:
 		}
 	}
 
+	void testOutputNHWC() const {
+		const uint_fast32_t seed = std::chrono::system_clock::now().time_since_epoch().count();
+		auto rng = std::bind(std::uniform_real_distribution<float>(), std::mt19937(seed));
+
+		const size_t inputPixels = inputHeight() * inputWidth();
+		const size_t outputPixels = outputHeight() * outputWidth();
+		std::vector<float> input(batchSize() * channels() * inputPixels);
+		std::vector<float> inputNHWC(input.size());
+		std::vector<float> outputNHWC(batchSize() * channels() * outputPixels);
+		std::vector<float> referenceOutput(batchSize() * channels() * outputPixels);
+
+		for (size_t iteration = 0; iteration < iterations(); iteration++) {
+			std::generate(input.begin(), input.end(), std::ref(rng));
+			std::fill(outputNHWC.begin(), outputNHWC.end(), nanf(""));
+			for (size_t sample = 0; sample < batchSize(); sample++) {
+				for (size_t channel = 0; channel < channels(); channel++) {
+					for (size_t pixel = 0; pixel < inputPixels; pixel++) {
+						inputNHWC[(sample * inputPixels + pixel) * channels() + channel] =
+							input[(sample * channels() + channel) * inputPixels + pixel];
+					}
+				}
+			}
+
+			nnp_max_pooling_output__reference(
+				batchSize(), channels(),
+				inputSize(), inputPadding(), poolingSize(), poolingStride(),
+				input.data(), referenceOutput.data(),
+				this->threadpool);
+
+			enum nnp_status status = nnp_max_pooling_output_nhwc(
+				batchSize(), channels(),
+				inputSize(), inputPadding(), poolingSize(), poolingStride(),
+				inputNHWC.data(), outputNHWC.data(),
+				this->threadpool);
+			ASSERT_EQ(nnp_status_success, status);
+
+			float maxError = 0.0f;
+			for (size_t sample = 0; sample < batchSize(); sample++) {
+				for (size_t channel = 0; channel < channels(); channel++) {
+					for (size_t pixel = 0; pixel < outputPixels; pixel++) {
+						maxError = std::max(maxError, relativeError(
+							referenceOutput[(sample * channels() + channel) * outputPixels + pixel],
+							outputNHWC[(sample * outputPixels + pixel) * channels() + channel]));
+					}
+				}
+			}
+			EXPECT_LT(maxError, errorLimit());
+		}
+	}
+
 protected:
 	pthreadpool_t threadpool;
 
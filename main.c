@@ -35,51 +35,36 @@ void benchmark_convolution(
 {
 	enum nnp_status status = nnp_status_success;
 	void* memory_block = NULL;
-	void* transformed_kernel = NULL;
-	size_t memory_size = 0, transformed_kernel_size = 0;
+	size_t memory_size = 0;
 
 	if (transform_strategy == nnp_convolution_transform_strategy_precompute) {
-		status = nnp_convolution_inference(
-			algorithm, transform_strategy,
-			input_channels, output_channels,
+		/* A plan transforms the kernel and allocates the workspace once, and then only runs the convolution */
+		nnp_convolution_plan_t plan = NULL;
+		status = nnp_convolution_plan_create(
+			algorithm,
+			batch_size, input_channels, output_channels,
 			input_size, input_padding, kernel_size, output_subsampling,
-			NULL, NULL, NULL, NULL, NULL, &transformed_kernel_size,
+			kernel, bias,
 			nnp_activation_identity, NULL,
-			threadpool, NULL);
+			threadpool, &plan);
 		switch (status) {
 			case nnp_status_success:
 				break;
 			case nnp_status_invalid_algorithm:
 			case nnp_status_unsupported_algorithm:
-				break;
-			case nnp_status_unsupported_transform_strategy:
-				/* Fall back to compute strategy */
-				transform_strategy = nnp_convolution_transform_strategy_compute;
-				break;
+				return;
 			default:
-				fprintf(stderr, "Error: failed to detect transformed kernel size: status %d\n", status);
+				fprintf(stderr, "Error: failed to create convolution plan: status %d\n", status);
 				exit(EXIT_FAILURE);
 		}
-	}
-	if (transform_strategy == nnp_convolution_transform_strategy_precompute) {
-		transformed_kernel = malloc_with_alignment(transformed_kernel_size, 64);
-		if (transformed_kernel == NULL) {
-			fprintf(stderr, "Error: failed to allocate %zu bytes for transformed kernel\n", memory_size);
-			exit(EXIT_FAILURE);
-		}
 
-		status = nnp_convolution_inference(
-			algorithm, transform_strategy,
-			input_channels, output_channels,
-			input_size, input_padding, kernel_size, output_subsampling,
-			NULL, kernel, NULL, NULL, transformed_kernel, &transformed_kernel_size,
-			nnp_activation_identity, NULL,
-			threadpool, NULL);
+		status = nnp_convolution_plan_execute(plan, input, output, threadpool, NULL);
+		nnp_convolution_plan_destroy(plan);
 		if (status != nnp_status_success) {
-			fprintf(stderr, "Error: failed to pre-compute kernel transform: status %d\n", status);
+			fprintf(stderr, "Error: failed to execute convolution plan: status %d\n", status);
 			exit(EXIT_FAILURE);
 		}
-		transform_strategy = nnp_convolution_transform_strategy_reuse;
+		return;
 	}
 
 	status = nnp_convolution_inference(
@@ -113,7 +98,7 @@ void benchmark_convolution(
 		algorithm, transform_strategy,
 		input_channels, output_channels,
 		input_size, input_padding, kernel_size, output_subsampling,
-		input, transformed_kernel == NULL ? kernel : transformed_kernel, bias, output,
+		input, kernel, bias, output,
 		memory_block, memory_size == 0 ? NULL : &memory_size,
 		nnp_activation_identity, NULL,
 		threadpool,